@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+#
+# © Copyright 2020, Septentrio NV/SA.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#    1. Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#    2. Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#    3. Neither the name of the copyright holder nor the names of its
+#       contributors may be used to endorse or promote products derived
+#       from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+# *****************************************************************************
+
+"""Generates the benchmark corpus rover.sbf.
+
+The corpus holds EPOCHS epochs of an INS rover at 1 Hz, each consisting of all
+SBF blocks ROSaic decodes and of GGA, RMC, GSA and GSV sentences, interleaved as
+output by the Rx. The values are synthetic but plausible, the block revisions are
+the latest ones known to the parsers, such that all their fields are decoded.
+"""
+
+import math
+import struct
+import sys
+
+EPOCHS = 10
+TOW_START = 475200000  # ms, Saturday 12:00 GPST
+WNC = 2337
+
+CRC_POLY = 0x1021
+
+
+def crc16_ccitt(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ CRC_POLY) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def sbf_block(block_id, revision, tow, payload):
+    """Frames payload as SBF block, padded to a multiple of 4 bytes."""
+    length = 14 + len(payload)
+    payload += b"\x00" * (-length % 4)
+    length = 14 + len(payload)
+    body = struct.pack("<HHIH", block_id | (revision << 13), length, tow, WNC)
+    body += payload
+    return b"$@" + struct.pack("<H", crc16_ccitt(body)) + body
+
+
+def nmea(sentence):
+    checksum = 0
+    for char in sentence:
+        checksum ^= ord(char)
+    return ("$%s*%02X\r\n" % (sentence, checksum)).encode("ascii")
+
+
+def text(value, size):
+    return value.encode("ascii").ljust(size, b"\x00")
+
+
+def epoch(k):
+    tow = TOW_START + 1000 * k
+    lat = math.radians(50.8503 + 1e-6 * k)
+    lon = math.radians(4.3517 + 2e-6 * k)
+    heading = 45.0 + 0.1 * k
+    frames = []
+
+    # INS blocks first, as configured for a 1 Hz rover
+    frames.append(sbf_block(4050, 0, tow, struct.pack(
+        "<BB", 3, 28) +
+        struct.pack("<BBBBddd", 0, 0, 0, 0, 0.012, -0.034, 9.806) +
+        struct.pack("<BBBBddd", 0, 0, 1, 0, 0.1, -0.2, 0.05) +
+        struct.pack("<BBBBh22x", 0, 0, 3, 0, 3512)))
+    ins_common = struct.pack("<BBHH", 4, 0, 0x0D, 10)
+    frames.append(sbf_block(4226, 0, tow, ins_common + struct.pack(
+        "<dddfHHBxH", lat, lon, 112.3, 47.0, 3, 12, 0, 0x3F) +
+        struct.pack("<3f", 0.02, 0.02, 0.04) +
+        struct.pack("<3f", heading, 1.5, -0.8) +
+        struct.pack("<3f", 0.1, 0.05, 0.05) +
+        struct.pack("<3f", 0.5, 0.5, 0.0) +
+        struct.pack("<3f", 0.01, 0.01, 0.02) +
+        struct.pack("<3f", 1e-4, 2e-4, 3e-4)))
+    frames.append(sbf_block(4225, 0, tow, ins_common + struct.pack(
+        "<dddHHBxH", 4027881.3, 306998.6, 4919499.0, 3, 12, 0, 0x3F) +
+        struct.pack("<3f", 0.02, 0.02, 0.04) +
+        struct.pack("<3f", heading, 1.5, -0.8) +
+        struct.pack("<3f", 0.1, 0.05, 0.05) +
+        struct.pack("<3f", -0.3, 0.4, 0.2) +
+        struct.pack("<3f", 0.01, 0.01, 0.02) +
+        struct.pack("<3f", 1e-4, 2e-4, 3e-4)))
+
+    # PVT and covariances
+    pvt = (4, 0)
+    pvt_tail = struct.pack("<fdfBBBBHHIBBHHHHB", 0.7, 0.123, 0.01, 0, 0, 24, 0,
+                           0, 100, 0x0F5F, 0, 1, 0, 20, 2, 3, 0)
+    frames.append(sbf_block(4007, 2, tow, struct.pack(
+        "<BBdddffff", *pvt, lat, lon, 112.3, 47.0, 0.5, 0.5, 0.0) + pvt_tail))
+    frames.append(sbf_block(4006, 2, tow, struct.pack(
+        "<BBdddffff", *pvt, 4027881.3, 306998.6, 4919499.0, 47.0, -0.3, 0.4,
+        0.2) + pvt_tail))
+    cov = struct.pack("<BB10f", 4, 0, 4e-4, 4e-4, 16e-4, 1e-4, 1e-5, 2e-5,
+                      1e-6, 3e-5, 2e-6, 3e-6)
+    for block_id in (5906, 5905, 5908, 5907):
+        frames.append(sbf_block(block_id, 0, tow, cov))
+    frames.append(sbf_block(5938, 0, tow, struct.pack(
+        "<BBH2x6f", 24, 0, 4, heading, 1.5, -0.8, 0.01, -0.02, 0.03)))
+    frames.append(sbf_block(5939, 0, tow, struct.pack(
+        "<xB6f", 0, 0.01, 0.0025, 0.0025, 1e-4, 2e-4, 3e-4)))
+    frames.append(sbf_block(4001, 0, tow, struct.pack(
+        "<BxHHHHff", 24, 120, 80, 60, 100, 1.2, 1.8)))
+
+    # Measurements and channels
+    channels = 40
+    meas = struct.pack("<BBBBBx", channels, 20, 12, 0, 0)
+    for ch in range(channels):
+        meas += struct.pack("<BBBBIiHbBHBB", ch, 0, 1 + ch % 36, 0,
+                            20000000 + 1000 * ch + k, -1500 + 37 * ch,
+                            (5000 * ch + k) & 0xFFFF, ch % 8 - 4, 180 + ch % 40,
+                            600 + ch, 0x1D, 2)
+        for sig in range(2):
+            meas += struct.pack("<BBBBbBHHH", 2 + sig, 60, 170 + ch % 40, 0x11,
+                                -1, 0x1D, 120 + ch, 3000 + ch * 7, 300 + sig)
+    frames.append(sbf_block(4027, 1, tow, meas))
+    status = struct.pack("<BBBxxx", 30, 12, 8)
+    for sat in range(30):
+        status += struct.pack("<BBxxHHbBBx", 1 + sat, 0, 0x3000 + 11 * sat, 0,
+                              10 + 2 * sat, 2, sat)
+        for sig in range(2):
+            status += struct.pack("<BxHHH", 0, 0x3333, 0x0101 * sig, 0)
+    frames.append(sbf_block(4013, 0, tow, status))
+    frames.append(sbf_block(4014, 0, tow, struct.pack(
+        "<BBIIIBBBB", 35, 0, 3600 + k, 0x00000101, 0, 3, 4, 0, 145) +
+        struct.pack("<BbBB", 0, 40, 50, 0) * 3))
+    frames.append(sbf_block(4082, 0, tow, struct.pack(
+        "<Bx4H", 4, 0x0A01, 0x0A02, 0x0911, 0x0A15)))
+
+    # NMEA
+    lat_deg = math.degrees(lat)
+    lon_deg = math.degrees(lon)
+    lat_nmea = "%02d%010.7f" % (int(lat_deg), (lat_deg % 1) * 60)
+    lon_nmea = "%03d%010.7f" % (int(lon_deg), (lon_deg % 1) * 60)
+    utc = "%02d%02d%05.2f" % (11, 59, 42 + k)
+    frames.append(nmea("GPGGA,%s,%s,N,%s,E,4,24,0.6,112.300,M,47.000,M,1.0,0000"
+                       % (utc, lat_nmea, lon_nmea)))
+    frames.append(nmea("GPRMC,%s,A,%s,N,%s,E,1.4,%.1f,191026,0.0,E,R"
+                       % (utc, lat_nmea, lon_nmea, heading)))
+    frames.append(nmea("GPGSA,A,3,02,05,07,09,13,15,18,20,23,27,29,30,1.2,0.6,1.0"))
+    sats = [(2 + 3 * i, 10 + 7 * i, (40 * i) % 360, 38 + i % 10)
+            for i in range(11)]
+    for msg in range(3):
+        fields = ["GPGSV", "3", str(msg + 1), str(len(sats))]
+        for sat in sats[4 * msg:4 * msg + 4]:
+            fields += ["%02d" % sat[0], "%02d" % sat[1], "%03d" % sat[2],
+                       "%02d" % sat[3]]
+        frames.append(nmea(",".join(fields)))
+    return frames
+
+
+def setup(tow):
+    """Setup blocks output once, on change"""
+    frames = []
+    frames.append(sbf_block(5902, 4, tow, b"\x00\x00" +
+        text("ROVER", 60) + text("0001", 20) + text("ROSaic", 20) +
+        text("Septentrio", 40) + text("3234567", 20) + text("AsteRx SBi3", 20) +
+        text("1.4.0", 20) + text("12345", 20) + text("PolaNt-x MF", 20) +
+        struct.pack("<fff", 0.1, 0.0, 0.0) + text("GEODETIC", 20) +
+        text("4.12.1", 40) + text("AsteRx SBi3 Pro+", 40) +
+        struct.pack("<ddf", math.radians(50.8503), math.radians(4.3517), 112.3) +
+        text("ROVR", 10) + struct.pack("<BB", 0, 0) + text("BEL", 3)))
+    frames.append(sbf_block(4224, 0, tow, struct.pack(
+        "<xBffffff", 1, 0.5, 0.1, -0.3, 0.0, 0.0, 90.0)))
+    frames.append(sbf_block(4244, 0, tow, struct.pack(
+        "<xBfff", 2, -0.4, 0.0, 0.2)))
+    return frames
+
+
+def main(path):
+    frames = setup(TOW_START)
+    for k in range(EPOCHS):
+        frames += epoch(k)
+    with open(path, "wb") as out:
+        out.write(b"".join(frames))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else "rover.sbf")
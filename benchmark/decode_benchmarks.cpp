@@ -0,0 +1,386 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+// Google Benchmark includes
+#include <benchmark/benchmark.h>
+// Boost includes
+#include <boost/tokenizer.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/communication/rx_message.hpp>
+
+/**
+ * @file decode_benchmarks.cpp
+ * @date 19/10/26
+ * @brief Microbenchmarks of the decode hot path over the frames of the corpus in
+ * benchmark/corpus, run without ROS master
+ *
+ * The results are written as JSON unless another --benchmark_format is given,
+ * such that runs of different commits can be compared, e.g. with compare.py of
+ * Google Benchmark.
+ */
+
+namespace {
+
+    //! Iterator the parsers are fed with, as by RxMessage::read()
+    typedef const uint8_t* It;
+
+    //! Single SBF block or NMEA sentence of the corpus
+    struct Frame
+    {
+        It begin;
+        It end;
+    };
+
+    //! The corpus and its frames by message ID, e.g. "4027" or "$GPGSV"
+    struct Corpus
+    {
+        std::vector<uint8_t> data;
+        std::map<std::string, std::vector<Frame>> frames;
+    };
+
+    Corpus corpus;
+
+    /**
+     * @brief Reads the corpus and indexes its frames
+     * @param[in] file_name The name of (or path to) the corpus
+     * @return False if the corpus could not be read or has no frames
+     */
+    bool loadCorpus(const std::string& file_name)
+    {
+        std::ifstream file(file_name, std::ios::binary);
+        if (!file.good())
+            return false;
+        corpus.data.assign(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+        It data = corpus.data.data();
+        std::size_t size = corpus.data.size();
+        std::size_t pos = 0;
+        while (pos + 2 < size)
+        {
+            if ((data[pos] == SBF_SYNC_BYTE_1) && (data[pos + 1] == SBF_SYNC_BYTE_2) &&
+                (pos + 8 <= size))
+            {
+                uint16_t length = parsing_utilities::getLength(data + pos);
+                if ((length > 8) && (pos + length <= size) && isValid(data + pos))
+                {
+                    std::string id =
+                        std::to_string(parsing_utilities::getId(data + pos) & 8191);
+                    corpus.frames[id].push_back({data + pos, data + pos + length});
+                    pos += length;
+                    continue;
+                }
+            } else if ((data[pos] == NMEA_SYNC_BYTE_1) &&
+                       (data[pos + 1] == NMEA_SYNC_BYTE_2_1))
+            {
+                It end = std::search(data + pos, data + size, "\r\n", "\r\n" + 2);
+                if ((end != data + size) && (end - (data + pos) > 6))
+                {
+                    std::string id(reinterpret_cast<const char*>(data + pos), 6);
+                    corpus.frames[id].push_back({data + pos, end});
+                    pos = end + 2 - data;
+                    continue;
+                }
+            }
+            ++pos;
+        }
+        return !corpus.frames.empty();
+    }
+
+    //! First frame with the message ID, e.g. "4027"
+    const Frame& frame(const std::string& id) { return corpus.frames.at(id).front(); }
+
+    //! Node without node handle, for logging only
+    ROSaicNodeBase* node()
+    {
+        static ROSaicNodeBase node{ROSaicNodeBase::Offline()};
+        return &node;
+    }
+
+    void BM_compute16CCITT(benchmark::State& state, const std::string& id)
+    {
+        const Frame& block = frame(id);
+        std::size_t length = block.end - block.begin - 4;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(compute16CCITT(block.begin + 4, length));
+        state.SetBytesProcessed(state.iterations() * length);
+    }
+    BENCHMARK_CAPTURE(BM_compute16CCITT, PVTGeodetic, std::string("4007"));
+    BENCHMARK_CAPTURE(BM_compute16CCITT, MeasEpoch, std::string("4027"));
+
+    template <typename Val>
+    void BM_qiLittleEndianParser(benchmark::State& state)
+    {
+        std::size_t count = corpus.data.size() / sizeof(Val);
+        for (auto _ : state)
+        {
+            It it = corpus.data.data();
+            Val val;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                qiLittleEndianParser(it, val);
+                benchmark::DoNotOptimize(val);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * count);
+        state.SetBytesProcessed(state.iterations() * count * sizeof(Val));
+    }
+    BENCHMARK_TEMPLATE(BM_qiLittleEndianParser, uint8_t);
+    BENCHMARK_TEMPLATE(BM_qiLittleEndianParser, uint16_t);
+    BENCHMARK_TEMPLATE(BM_qiLittleEndianParser, uint32_t);
+    BENCHMARK_TEMPLATE(BM_qiLittleEndianParser, float);
+    BENCHMARK_TEMPLATE(BM_qiLittleEndianParser, double);
+
+    //! Finds all frames of the corpus and checks the CRCs of the SBF blocks, as
+    //! CallbackHandlers::readCallback() does before reading them
+    void BM_RxMessageSearch(benchmark::State& state)
+    {
+        Settings settings{};
+        io_comm_rx::RxMessage rx_message(node(), &settings);
+        int64_t frames = 0;
+        for (auto _ : state)
+        {
+            std::size_t size = corpus.data.size();
+            rx_message.newData(0, corpus.data.data(), size);
+            while ((rx_message.search() != rx_message.getEndBuffer()) &&
+                   rx_message.found())
+            {
+                if (rx_message.isSBF())
+                    rx_message.checkCrc();
+                ++frames;
+            }
+        }
+        state.SetItemsProcessed(frames);
+        state.SetBytesProcessed(state.iterations() * corpus.data.size());
+    }
+    BENCHMARK(BM_RxMessageSearch);
+
+    void BM_BlockHeaderParser(benchmark::State& state)
+    {
+        const Frame& block = frame("4007");
+        for (auto _ : state)
+        {
+            It it = block.begin;
+            BlockHeaderMsg msg;
+            BlockHeaderParser(node(), it, msg);
+            benchmark::DoNotOptimize(msg);
+        }
+    }
+    BENCHMARK(BM_BlockHeaderParser);
+
+    /**
+     * @brief Registers the benchmark of an SBF block parser
+     *
+     * The message is constructed in each iteration, as in RxMessage::read().
+     * @param[in] name Name of the benchmark
+     * @param[in] id ID of the block in the corpus
+     * @param[in] parse Calls the parser with begin and end of the block
+     */
+    template <typename Msg, typename Parse>
+    void registerSBFParser(const std::string& name, const std::string& id,
+                           Parse parse)
+    {
+        benchmark::RegisterBenchmark(
+            name.c_str(), [id, parse](benchmark::State& state) {
+                const Frame& block = frame(id);
+                for (auto _ : state)
+                {
+                    Msg msg;
+                    if (!parse(block.begin, block.end, msg))
+                    {
+                        state.SkipWithError("Parsing failed");
+                        break;
+                    }
+                    benchmark::DoNotOptimize(msg);
+                }
+                state.SetBytesProcessed(state.iterations() *
+                                        (block.end - block.begin));
+            });
+    }
+
+    /**
+     * @brief Registers the benchmark of an NMEA parser, the sentence is tokenized
+     * beforehand as in RxMessage::read()
+     * @param[in] name Name of the benchmark
+     * @param[in] id ID of the sentence in the corpus
+     */
+    template <typename Parser>
+    void registerNMEAParser(const std::string& name, const std::string& id)
+    {
+        const Frame& sentence = frame(id);
+        std::string one_message(reinterpret_cast<const char*>(sentence.begin),
+                                sentence.end - sentence.begin);
+        typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
+        boost::char_separator<char> sep(",*", "", boost::keep_empty_tokens);
+        tokenizer tokens(one_message, sep);
+        NMEASentence nmea(id, std::vector<std::string>(tokens.begin(), tokens.end()));
+        benchmark::RegisterBenchmark(name.c_str(), [nmea](benchmark::State& state) {
+            Parser parser;
+            for (auto _ : state)
+            {
+                try
+                {
+                    benchmark::DoNotOptimize(
+                        parser.parseASCII(nmea, "gnss", false, 0));
+                } catch (ParseException& e)
+                {
+                    state.SkipWithError(e.what());
+                    break;
+                }
+            }
+        });
+    }
+
+    void registerParsers()
+    {
+        ROSaicNodeBase* n = node();
+        registerSBFParser<PVTGeodeticMsg>(
+            "PVTGeodeticParser", "4007",
+            [n](It it, It end, PVTGeodeticMsg& msg) {
+                return PVTGeodeticParser(n, it, end, msg);
+            });
+        registerSBFParser<PVTCartesianMsg>(
+            "PVTCartesianParser", "4006",
+            [n](It it, It end, PVTCartesianMsg& msg) {
+                return PVTCartesianParser(n, it, end, msg);
+            });
+        registerSBFParser<PosCovGeodeticMsg>(
+            "PosCovGeodeticParser", "5906",
+            [n](It it, It end, PosCovGeodeticMsg& msg) {
+                return PosCovGeodeticParser(n, it, end, msg);
+            });
+        registerSBFParser<PosCovCartesianMsg>(
+            "PosCovCartesianParser", "5905",
+            [n](It it, It end, PosCovCartesianMsg& msg) {
+                return PosCovCartesianParser(n, it, end, msg);
+            });
+        registerSBFParser<VelCovGeodeticMsg>(
+            "VelCovGeodeticParser", "5908",
+            [n](It it, It end, VelCovGeodeticMsg& msg) {
+                return VelCovGeodeticParser(n, it, end, msg);
+            });
+        registerSBFParser<VelCovCartesianMsg>(
+            "VelCovCartesianParser", "5907",
+            [n](It it, It end, VelCovCartesianMsg& msg) {
+                return VelCovCartesianParser(n, it, end, msg);
+            });
+        registerSBFParser<AttEulerMsg>(
+            "AttEulerParser", "5938", [n](It it, It end, AttEulerMsg& msg) {
+                return AttEulerParser(n, it, end, msg, false);
+            });
+        registerSBFParser<AttCovEulerMsg>(
+            "AttCovEulerParser", "5939", [n](It it, It end, AttCovEulerMsg& msg) {
+                return AttCovEulerParser(n, it, end, msg, false);
+            });
+        registerSBFParser<DOP>("DOPParser", "4001", [n](It it, It end, DOP& msg) {
+            return DOPParser(n, it, end, msg);
+        });
+        registerSBFParser<MeasEpochMsg>(
+            "MeasEpochParser", "4027", [n](It it, It end, MeasEpochMsg& msg) {
+                return MeasEpochParser(n, it, end, msg);
+            });
+        registerSBFParser<ChannelStatus>(
+            "ChannelStatusParser", "4013", [n](It it, It end, ChannelStatus& msg) {
+                return ChannelStatusParser(n, it, end, msg);
+            });
+        registerSBFParser<ReceiverStatus>(
+            "ReceiverStatusParser", "4014",
+            [n](It it, It end, ReceiverStatus& msg) {
+                return ReceiverStatusParser(n, it, end, msg);
+            });
+        registerSBFParser<QualityInd>(
+            "QualityIndParser", "4082", [n](It it, It end, QualityInd& msg) {
+                return QualityIndParser(n, it, end, msg);
+            });
+        registerSBFParser<ReceiverSetup>(
+            "ReceiverSetupParser", "5902", [n](It it, It end, ReceiverSetup& msg) {
+                return ReceiverSetupParser(n, it, end, msg);
+            });
+        registerSBFParser<INSNavGeodMsg>(
+            "INSNavGeodParser", "4226", [n](It it, It end, INSNavGeodMsg& msg) {
+                return INSNavGeodParser(n, it, end, msg, false);
+            });
+        registerSBFParser<INSNavCartMsg>(
+            "INSNavCartParser", "4225", [n](It it, It end, INSNavCartMsg& msg) {
+                return INSNavCartParser(n, it, end, msg, false);
+            });
+        registerSBFParser<IMUSetupMsg>(
+            "IMUSetupParser", "4224", [n](It it, It end, IMUSetupMsg& msg) {
+                return IMUSetupParser(n, it, end, msg, false);
+            });
+        registerSBFParser<VelSensorSetupMsg>(
+            "VelSensorSetupParser", "4244",
+            [n](It it, It end, VelSensorSetupMsg& msg) {
+                return VelSensorSetupParser(n, it, end, msg, false);
+            });
+        registerSBFParser<ExtSensorMeasMsg>(
+            "ExtSensorMeasParser", "4050", [n](It it, It end, ExtSensorMeasMsg& msg) {
+                return ExtSensorMeasParser(n, it, end, msg, false);
+            });
+
+        registerNMEAParser<GpggaParser>("GpggaParser", "$GPGGA");
+        registerNMEAParser<GprmcParser>("GprmcParser", "$GPRMC");
+        registerNMEAParser<GpgsaParser>("GpgsaParser", "$GPGSA");
+        registerNMEAParser<GpgsvParser>("GpgsvParser", "$GPGSV");
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // Wall time without ROS master, for ROSaicNodeBase::getTime()
+    ros::Time::init();
+    if (!loadCorpus(ROSAIC_BENCHMARK_CORPUS))
+    {
+        std::cerr << "Could not read the corpus " << ROSAIC_BENCHMARK_CORPUS
+                  << std::endl;
+        return 1;
+    }
+    registerParsers();
+
+    std::vector<char*> args(argv, argv + argc);
+    std::string json_format = "--benchmark_format=json";
+    if (std::none_of(args.begin(), args.end(), [](const char* arg) {
+            return std::strncmp(arg, "--benchmark_format", 18) == 0;
+        }))
+        args.insert(args.begin() + 1, &json_format[0]);
+    int args_count = static_cast<int>(args.size());
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,140 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef INTERFACES_HPP
+#define INTERFACES_HPP
+
+// std includes
+#include <cstdint>
+#include <ostream>
+#include <string>
+// Boost includes
+#include <boost/function.hpp>
+
+/**
+ * @file interfaces.hpp
+ * @date 19/10/26
+ * @brief Declares the interfaces through which the decoder logs, gets the time
+ * and hands over its messages, implemented by ROSaicNodeBase for ROS
+ *
+ * Nothing in here depends on roscpp, such that the decoder library can be used
+ * without ROS.
+ */
+
+// Timestamp in nanoseconds (Unix epoch)
+typedef uint64_t  Timestamp;
+
+/**
+ * @brief Log level for ROS logging
+ */
+enum LogLevel
+{
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    FATAL
+};
+
+/**
+ * @brief Logs via node->log() only if the log level is enabled, such that the
+ * message, e.g. a concatenation of strings, is not even built otherwise
+ */
+#define ROSAIC_LOG(node, level, message)                                         \
+    do                                                                           \
+    {                                                                            \
+        if ((node)->logEnabled(level))                                           \
+            (node)->log(level, message);                                         \
+    } while (0)
+
+//! Logs a DEBUG message, see ROSAIC_LOG
+#define ROSAIC_DEBUG(node, message) ROSAIC_LOG(node, LogLevel::DEBUG, message)
+
+/**
+ * @class Logger
+ * @brief Receives the log messages of the decoder
+ */
+class Logger
+{
+public:
+    virtual ~Logger() {}
+
+    /**
+     * @brief Whether messages of a log level are output
+     * @param[in] logLevel Log level
+     * @return True if messages of the log level are output, false otherwise
+     */
+    virtual bool logEnabled(LogLevel logLevel) = 0;
+
+    /**
+     * @brief Logs a message
+     * @param[in] logLevel Log level
+     * @param[in] s String to log
+     */
+    virtual void log(LogLevel logLevel, const std::string& s) = 0;
+};
+
+/**
+ * @class Clock
+ * @brief Provides the time at which data is received
+ */
+class Clock
+{
+public:
+    virtual ~Clock() {}
+
+    /**
+     * @brief Gets current timestamp
+     * @return Timestamp
+     */
+    virtual Timestamp getTime() = 0;
+};
+
+/**
+ * @class PublishSink
+ * @brief Receives the messages of a node instead of its ROS publishers, e.g. to
+ * compare the output of a replayed file with a golden one
+ */
+class PublishSink
+{
+public:
+    virtual ~PublishSink() {}
+
+    /**
+     * @brief Called for each message instead of publishing it
+     * @param[in] topic Topic without namespace, e.g. "/pvtgeodetic"
+     * @param[in] print Prints the message in the format of rostopic echo, only
+     * valid during the call
+     */
+    virtual void publish(const std::string& topic,
+                         const boost::function<void(std::ostream&)>& print) = 0;
+};
+
+#endif // INTERFACES_HPP
@@ -32,140 +32,72 @@
 #define Typedefs_HPP
 
 // std includes
+#include <ostream>
 #include <unordered_map>
+#include <vector>
+// Boost includes
+#include <boost/function.hpp>
 // ROS includes
 #include <ros/ros.h>
 // tf2 includes
 #include <tf2_ros/transform_broadcaster.h>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
-// ROS msg includes
-#include <diagnostic_msgs/DiagnosticArray.h>
-#include <diagnostic_msgs/DiagnosticStatus.h>
-#include <geometry_msgs/Quaternion.h>
-#include <geometry_msgs/PoseWithCovarianceStamped.h>
-#include <gps_common/GPSFix.h>
-#include <sensor_msgs/NavSatFix.h>
-#include <sensor_msgs/TimeReference.h>
-#include <sensor_msgs/Imu.h>
-#include <nav_msgs/Odometry.h>
-// GNSS msg includes
-#include <septentrio_gnss_driver/BlockHeader.h>
-#include <septentrio_gnss_driver/MeasEpoch.h>
-#include <septentrio_gnss_driver/MeasEpochChannelType1.h>
-#include <septentrio_gnss_driver/MeasEpochChannelType2.h>
-#include <septentrio_gnss_driver/AttCovEuler.h>
-#include <septentrio_gnss_driver/AttEuler.h>
-#include <septentrio_gnss_driver/PVTCartesian.h>
-#include <septentrio_gnss_driver/PVTGeodetic.h>
-#include <septentrio_gnss_driver/PosCovCartesian.h>
-#include <septentrio_gnss_driver/PosCovGeodetic.h>
-#include <septentrio_gnss_driver/VelCovCartesian.h>
-#include <septentrio_gnss_driver/VelCovGeodetic.h>
-// NMEA msg includes
-#include <nmea_msgs/Gpgga.h>
-#include <nmea_msgs/Gpgsa.h>
-#include <nmea_msgs/Gpgsv.h>
-#include <nmea_msgs/Gprmc.h>
-// INS msg includes
-#include <septentrio_gnss_driver/INSNavCart.h>
-#include <septentrio_gnss_driver/INSNavGeod.h>
-#include <septentrio_gnss_driver/IMUSetup.h>
-#include <septentrio_gnss_driver/VelSensorSetup.h>
-#include <septentrio_gnss_driver/ExtSensorMeas.h>
+// ROS srv includes
+#include <std_srvs/Trigger.h>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/interfaces.hpp>
+#include <septentrio_gnss_driver/abstraction/message_typedefs.hpp>
+#include <septentrio_gnss_driver/communication/trace.hpp>
 
-// Timestamp in nanoseconds (Unix epoch)
-typedef uint64_t  Timestamp;
-// ROS timestamp
-typedef ros::Time TimestampRos;
-
-// ROS messages
-typedef diagnostic_msgs::DiagnosticArray            DiagnosticArrayMsg;
-typedef diagnostic_msgs::DiagnosticStatus           DiagnosticStatusMsg;
-typedef geometry_msgs::Quaternion                   QuaternionMsg;
-typedef geometry_msgs::PoseWithCovarianceStamped    PoseWithCovarianceStampedMsg;
-typedef geometry_msgs::TransformStamped             TransformStampedMsg;
-typedef gps_common::GPSFix                          GPSFixMsg;
-typedef gps_common::GPSStatus                       GPSStatusMsg;
-typedef sensor_msgs::NavSatFix                      NavSatFixMsg;
-typedef sensor_msgs::NavSatStatus                   NavSatStatusMsg;
-typedef sensor_msgs::TimeReference                  TimeReferenceMsg;
-typedef sensor_msgs::Imu                            ImuMsg;
-typedef nav_msgs::Odometry                          LocalizationUtmMsg;
-
-// Septentrio GNSS SBF messages
-typedef septentrio_gnss_driver::BlockHeader           BlockHeaderMsg;
-typedef septentrio_gnss_driver::MeasEpoch             MeasEpochMsg;
-typedef septentrio_gnss_driver::MeasEpochChannelType1 MeasEpochChannelType1Msg;
-typedef septentrio_gnss_driver::MeasEpochChannelType2 MeasEpochChannelType2Msg;
-typedef septentrio_gnss_driver::AttCovEuler           AttCovEulerMsg;
-typedef septentrio_gnss_driver::AttEuler              AttEulerMsg;
-typedef septentrio_gnss_driver::PVTCartesian          PVTCartesianMsg;
-typedef septentrio_gnss_driver::PVTGeodetic           PVTGeodeticMsg;
-typedef septentrio_gnss_driver::PosCovCartesian       PosCovCartesianMsg;
-typedef septentrio_gnss_driver::PosCovGeodetic        PosCovGeodeticMsg;
-typedef septentrio_gnss_driver::VelCovCartesian       VelCovCartesianMsg;
-typedef septentrio_gnss_driver::VelCovGeodetic        VelCovGeodeticMsg;
-
-// NMEA messages
-typedef nmea_msgs::Gpgga    GpggaMsg;
-typedef nmea_msgs::Gpgsa    GpgsaMsg;
-typedef nmea_msgs::Gpgsv    GpgsvMsg;
-typedef nmea_msgs::Gprmc    GprmcMsg;
-
-// Septentrio INS+GNSS SBF messages
-typedef septentrio_gnss_driver::INSNavCart            INSNavCartMsg;
-typedef septentrio_gnss_driver::INSNavGeod            INSNavGeodMsg;
-typedef septentrio_gnss_driver::IMUSetup              IMUSetupMsg;
-typedef septentrio_gnss_driver::VelSensorSetup        VelSensorSetupMsg;
-typedef septentrio_gnss_driver::ExtSensorMeas         ExtSensorMeasMsg;
-
-/**
- * @brief Convert nsec timestamp to ROS timestamp
- * @param[in] ts timestamp in nanoseconds (Unix epoch)
- * @return ROS timestamp
- */
-inline TimestampRos timestampToRos(Timestamp ts)
-{
-    TimestampRos tsr;
-    tsr.fromNSec(ts);
-    return tsr;
-}
-
-/**
- * @brief Convert ROS timestamp to nsec timestamp 
- * @param[in] ts ROS timestamp
- * @return timestamp in nanoseconds (Unix epoch)
- */
-inline Timestamp timestampFromRos(const TimestampRos& tsr)
-{
-    return tsr.toNSec();
-}
-
-/**
- * @brief Log level for ROS logging
- */
-enum LogLevel
-{
-    DEBUG,
-    INFO,
-    WARN,
-    ERROR,
-    FATAL
-};
+// ROS services
+typedef std_srvs::Trigger TriggerSrv;
 
 /**
  * @class ROSaicNodeBase
- * @brief This class is the base class for abstraction
+ * @brief This class is the base class for abstraction, the ROS implementation of
+ * the interfaces of the decoder
  */
-class ROSaicNodeBase
+class ROSaicNodeBase : public Logger, public Clock
 {
 public:
     ROSaicNodeBase() :
-    pNh_(new ros::NodeHandle("~"))
+    pNh_(new ros::NodeHandle("~")),
+    tf2Publisher_(new tf2_ros::TransformBroadcaster)
     {}
 
+    /**
+     * @brief Constructor for one of several Rxs handled by the same node
+     *
+     * Parameters are looked up in the private sub-namespace of the Rx first, e.g.
+     * ~rx1/device, falling back to the private namespace of the node, topics are
+     * published into the namespace of the Rx, e.g. /rx1/pvtgeodetic.
+     * @param[in] receiver_name Name of the Rx, no namespaces if empty
+     */
+    explicit ROSaicNodeBase(const std::string& receiver_name) :
+    pNh_(new ros::NodeHandle("~")),
+    receiverName_(receiver_name),
+    topicPrefix_(receiver_name.empty() ? std::string() : "/" + receiver_name),
+    tf2Publisher_(new tf2_ros::TransformBroadcaster)
+    {}
+
+    //! Tag selecting the constructor without node handle
+    struct Offline {};
+
+    /**
+     * @brief Constructor without node handle, e.g. to decode data in benchmarks,
+     * where neither ros::init() nor a ROS master are available
+     *
+     * Parameters take their default values, services are not advertised and
+     * messages are not published. ros::Time::init() has to be called before
+     * getTime() is used.
+     */
+    explicit ROSaicNodeBase(Offline) {}
+
     virtual ~ROSaicNodeBase(){}
 
+    //! Name of the Rx, empty if the node handles a single Rx
+    const std::string& receiverName() const { return receiverName_; }
+
     /**
      * @brief Gets an integer or unsigned integer value from the parameter server
      * @param[in] name The key to be used in the parameter server's dictionary
@@ -177,7 +109,10 @@ public:
     bool getUint32Param(const std::string& name, uint32_t& val, uint32_t defaultVal)
     {
         int32_t tempVal;
-        if ((!pNh_->getParam(name, tempVal)) || (tempVal < 0))
+        bool found = pNh_ && ((!receiverName_.empty() &&
+                               pNh_->getParam(receiverName_ + "/" + name, tempVal)) ||
+                              pNh_->getParam(name, tempVal));
+        if (!found || (tempVal < 0))
         {            
             val = defaultVal;
             return false;
@@ -197,32 +132,72 @@ public:
     template<typename T>
     bool param(const std::string& name, T& val, const T& defaultVal)
     {
+        if (!pNh_)
+        {
+            val = defaultVal;
+            return false;
+        }
+        if (!receiverName_.empty() && pNh_->getParam(receiverName_ + "/" + name, val))
+            return true;
         return pNh_->param(name, val, defaultVal);
     };
 
+    /**
+     * @brief Whether messages of a log level are output
+     *
+     * DEBUG messages are compiled out if ROSCONSOLE_MIN_SEVERITY is above
+     * ROSCONSOLE_SEVERITY_DEBUG, as those of the ROS loggers.
+     * @param[in] logLevel Log level
+     * @return True if messages of the log level are output, false otherwise
+     */
+    bool logEnabled(LogLevel logLevel) final
+    {
+        switch (logLevel)
+        {
+        case LogLevel::DEBUG:
+        {
+#if ROSCONSOLE_MIN_SEVERITY > ROSCONSOLE_SEVERITY_DEBUG
+            return false;
+#else
+            ROSCONSOLE_DEFINE_LOCATION(true, ::ros::console::levels::Debug,
+                                       ROSCONSOLE_DEFAULT_NAME);
+            return __rosconsole_define_location__enabled;
+#endif
+        }
+        case LogLevel::INFO:
+        {
+            ROSCONSOLE_DEFINE_LOCATION(true, ::ros::console::levels::Info,
+                                       ROSCONSOLE_DEFAULT_NAME);
+            return __rosconsole_define_location__enabled;
+        }
+        default:
+            return true;
+        }
+    }
+
     /**
      * @brief Log function to provide abstraction of ROS loggers
      * @param[in] logLevel Log level
      * @param[in] s String to log
      */
-    void log(LogLevel logLevel, const std::string& s)
+    void log(LogLevel logLevel, const std::string& s) final
     {
         switch (logLevel)
         {
         case LogLevel::DEBUG:
-            ROS_DEBUG_STREAM(ros::this_node::getName() << ": " << s);
+            ROS_DEBUG_STREAM(ros::this_node::getName() << topicPrefix_ << ": " << s);
             break;
         case LogLevel::INFO:
-            ROS_INFO_STREAM(ros::this_node::getName() << ": " << s);
+            ROS_INFO_STREAM(ros::this_node::getName() << topicPrefix_ << ": " << s);
             break;
         case LogLevel::WARN:
-            ROS_WARN_STREAM(ros::this_node::getName() << ": " << s);
+            ROS_WARN_STREAM(ros::this_node::getName() << topicPrefix_ << ": " << s);
             break;
         case LogLevel::ERROR:
-            ROS_ERROR_STREAM(ros::this_node::getName() << ": " << s);
+            ROS_ERROR_STREAM(ros::this_node::getName() << topicPrefix_ << ": " << s);
             break;
         case LogLevel::FATAL:
-            ROS_FATAL_STREAM(ros::this_node::getName() << ": " << s);
+            ROS_FATAL_STREAM(ros::this_node::getName() << topicPrefix_ << ": " << s);
             break;    
         default:
             break;
@@ -233,7 +208,7 @@ public:
      * @brief Gets current timestamp
      * @return Timestamp
      */
-    Timestamp getTime()
+    Timestamp getTime() final
     {
         return ros::Time::now().toNSec();
     }    
@@ -246,17 +221,67 @@ public:
     template <typename M>
     void publishMessage(const std::string& topic, const M& msg)
     {
-        auto it = topicMap_.find(topic);
-        if (it != topicMap_.end())
+        ROSAIC_TRACE_SCOPE("publish", topic);
+        Timestamp start = publishCallback_ ? getTime() : 0;
+        if (publishSink_)
         {
-            it->second.publish(msg);
-        }
-        else
+            publishSink_->publish(topic, [&msg](std::ostream& os) { os << msg; });
+        } else
         {
-            ros::Publisher pub = pNh_->advertise<M>(topic, queueSize_);
-            topicMap_.insert(std::make_pair(topic, pub));
-            pub.publish(msg);
+            auto it = topicMap_.find(topic);
+            if (it != topicMap_.end())
+            {
+                it->second.publish(msg);
+            }
+            else if (pNh_)
+            {
+                ros::Publisher pub = pNh_->advertise<M>(topicPrefix_ + topic, queueSize_);
+                topicMap_.insert(std::make_pair(topic, pub));
+                pub.publish(msg);
+            }
         }
+        if (publishCallback_)
+            publishCallback_(topic, start);
+    }
+
+    /**
+     * @brief Sets a function to be called after each publication, e.g. to
+     * measure latencies
+     * @param[in] callback Called with the topic and the time publishing started
+     */
+    void setPublishCallback(
+        const boost::function<void(const std::string&, Timestamp)>& callback)
+    {
+        publishCallback_ = callback;
+    }
+
+    /**
+     * @brief Hands all messages over to a sink instead of publishing them
+     * @param[in] sink The sink, not owned, null to publish again
+     */
+    void setPublishSink(PublishSink* sink)
+    {
+        publishSink_ = sink;
+    }
+
+    /**
+     * @brief Advertises a service without arguments
+     * @param[in] service Name of the service
+     * @param[in] callback Function to be called on request, returns whether it
+     * succeeded and sets a message for the caller
+     */
+    void advertiseTrigger(const std::string& service,
+                          const boost::function<bool(std::string&)>& callback)
+    {
+        if (!pNh_)
+            return;
+        boost::function<bool(TriggerSrv::Request&, TriggerSrv::Response&)> cb =
+            [callback](TriggerSrv::Request&, TriggerSrv::Response& res) {
+                res.success = callback(res.message);
+                return true;
+            };
+        services_.push_back(pNh_->advertiseService(
+            receiverName_.empty() ? service : receiverName_ + "/" + service, cb));
     }
 
     /**
@@ -265,7 +290,8 @@ public:
      */
     void publishTf(const LocalizationUtmMsg& loc)
     {
-        if (std::isnan(loc.pose.pose.orientation.w))
+        if ((!tf2Publisher_ && !publishSink_) ||
+            std::isnan(loc.pose.pose.orientation.w))
             return;
         geometry_msgs::TransformStamped transformStamped;
         transformStamped.header.stamp            = loc.header.stamp;
@@ -279,20 +305,38 @@ public:
         transformStamped.transform.rotation.z    = loc.pose.pose.orientation.z;
         transformStamped.transform.rotation.w    = loc.pose.pose.orientation.w;
 
-        tf2Publisher_.sendTransform(transformStamped);
+        if (publishSink_)
+            publishSink_->publish("/tf", [&transformStamped](std::ostream& os) {
+                os << transformStamped;
+            });
+        else
+            tf2Publisher_->sendTransform(transformStamped);
     }
 
 protected:
     //! Node handle pointer
     std::shared_ptr<ros::NodeHandle> pNh_;    
 
+    //! Name of the Rx if several are handled by the node, empty otherwise
+    std::string receiverName_;
+
+    //! Namespace prepended to all topics and log messages, empty or "/" +
+    //! receiverName_
+    std::string topicPrefix_;
+
 private:
     //! Map of topics and publishers
     std::unordered_map<std::string, ros::Publisher> topicMap_;
+    //! Advertised services
+    std::vector<ros::ServiceServer> services_;
     //! Publisher queue size
     uint32_t queueSize_ = 1;
-    //! Transform publisher
-    tf2_ros::TransformBroadcaster tf2Publisher_;
+    //! Called after each publication, if set
+    boost::function<void(const std::string&, Timestamp)> publishCallback_;
+    //! Transform publisher, null without node handle
+    std::unique_ptr<tf2_ros::TransformBroadcaster> tf2Publisher_;
+    //! Receives the messages instead of the publishers if set
+    PublishSink* publishSink_ = nullptr;
 };
 
 #endif // Typedefs_HPP
\ No newline at end of file
@@ -66,8 +66,21 @@
 #include <boost/thread.hpp>
 #include <boost/thread/condition.hpp>
 
+// C++ library includes
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 // ROSaic includes
 #include <septentrio_gnss_driver/communication/circular_buffer.hpp>
+#include <septentrio_gnss_driver/communication/latency_statistics.hpp>
+#include <septentrio_gnss_driver/communication/receive_timeline.hpp>
+#include <septentrio_gnss_driver/communication/thread_configuration.hpp>
 
 #ifndef ASYNC_MANAGER_HPP
 #define ASYNC_MANAGER_HPP
@@ -91,10 +104,15 @@ namespace io_comm_rx {
     class Manager
     {
     public:
-        typedef boost::function<void(Timestamp, const uint8_t*, std::size_t&)> Callback;
+        typedef boost::function<void(Timestamp, const uint8_t*, std::size_t&,
+                                     const ReceiveTimeline*)>
+            Callback;
+        typedef boost::function<void(Timestamp, const uint8_t*, std::size_t)> RawCallback;
         virtual ~Manager() {}
         //! Sets the callback function
         virtual void setCallback(const Callback& callback) = 0;
+        //! Adds a callback that sees every received chunk of raw bytes before parsing
+        virtual void addRawCallback(const RawCallback& callback) = 0;
         //! Sends commands to the receiver
         virtual bool send(std::string cmd, std::size_t size) = 0;
         //! Waits count seconds before throwing ROS_INFO message in case no message
@@ -102,6 +120,21 @@ namespace io_comm_rx {
         virtual void wait(uint16_t* count) = 0;
         //! Determines whether or not the connection is open
         virtual bool isOpen() const = 0;
+        //! Applies scheduling policy, priority and CPU affinity to the threads
+        //! reading and parsing
+        virtual void configureThreads(const ThreadSettings& io,
+                                      const ThreadSettings& parsing) = 0;
+        //! Sets the function to be called from the I/O thread once the connection
+        //! is lost
+        virtual void setDisconnectCallback(const boost::function<void()>& callback) = 0;
+        //! Whether the connection has been lost, reading has stopped then
+        virtual bool linkLost() const = 0;
+        //! Number of bytes received
+        virtual uint64_t bytesReceived() const = 0;
+        //! Monotonic time of the first receipt, 0 if nothing was received yet
+        virtual Timestamp firstReceiveTime() const = 0;
+        //! Monotonic time of the last receipt, 0 if nothing was received yet
+        virtual Timestamp lastReceiveTime() const = 0;
     };
 
     /**
@@ -109,7 +142,9 @@ namespace io_comm_rx {
      * @brief This is the central interface between ROSaic and the Rx(s), managing
      * I/O operations such as reading messages and sending commands..
      *
-     * StreamT is either boost::asio::serial_port or boost::asio::tcp::ip
+     * StreamT is either boost::asio::serial_port, boost::asio::ip::tcp::socket,
+     * boost::asio::ip::udp::socket, boost::asio::local::stream_protocol::socket or
+     * boost::asio::posix::stream_descriptor
      */
     template <typename StreamT>
     class AsyncManager : public Manager
@@ -117,16 +152,20 @@ namespace io_comm_rx {
     public:
         /**
          * @brief Class constructor
-         * @param stream Whether TCP/IP or serial communication, either
-         * boost::asio::serial_port or boost::asio::tcp::ip
+         * @param stream Whether TCP/IP, UDP, Unix domain socket, named pipe or serial
+         * communication, i.e. one of the stream types above
          * @param io_service The io_context object. The io_context represents your
          * program's link to the operating system's I/O services
          * @param[in] buffer_size Size of the circular buffer in bytes
+         * @param[in] shared_io_service Whether io_service is run by a thread pool
+         * shared with other Rxs, otherwise it is run (and stopped) by a thread of
+         * this object
          */
         AsyncManager(ROSaicNodeBase* node, 
                      boost::shared_ptr<StreamT> stream,
                      boost::shared_ptr<boost::asio::io_service> io_service,
-                     std::size_t buffer_size = 131072);
+                     std::size_t buffer_size = 131072,
+                     bool shared_io_service = false);
         virtual ~AsyncManager();
 
         /**
@@ -136,6 +175,19 @@ namespace io_comm_rx {
          */
         void setCallback(const Callback& callback) { read_callback_ = callback; }
 
+        /**
+         * @brief Adds a tap on the raw byte stream, e.g. for recording
+         *
+         * The callback is invoked from the I/O thread for each chunk read from the
+         * stream (for UDP each datagram), hence it must not block. It is added on
+         * the I/O thread, too, since reading has already started.
+         * @param callback The function to be called with the raw bytes
+         */
+        void addRawCallback(const RawCallback& callback)
+        {
+            strand_.post([this, callback]() { raw_callbacks_.push_back(callback); });
+        }
+
         void wait(uint16_t* count);
 
         /**
@@ -147,22 +199,116 @@ namespace io_comm_rx {
 
         bool isOpen() const { return stream_->is_open(); }
 
+        /**
+         * @brief Sets whether TCP quick ACKs are re-enabled after each read, such
+         * that the Rx's Nagle algorithm does not wait for delayed ACKs. Has no
+         * effect on other streams.
+         */
+        void setQuickAck(bool quick_ack) { quick_ack_ = quick_ack; }
+
+        /**
+         * @brief Applies scheduling policy, priority and CPU affinity to the I/O
+         * and parsing threads, and reports their scheduling latencies at INFO
+         * level from then on rather than DEBUG
+         *
+         * The I/O thread also handles the timer of wait(), the waiting thread only
+         * starts it. If io_service_ is shared, its threads are configured by their
+         * owner.
+         */
+        void configureThreads(const ThreadSettings& io,
+                              const ThreadSettings& parsing);
+
+        /**
+         * @brief Sets the function to be called once reading fails, e.g. since the
+         * Rx closed the connection or was unplugged. It is called from the I/O
+         * thread, hence it must not block, let alone destroy this object.
+         */
+        void setDisconnectCallback(const boost::function<void()>& callback)
+        {
+            strand_.post([this, callback]() {
+                disconnect_callback_ = callback;
+                if (link_lost_)
+                    disconnect_callback_();
+            });
+        }
+
+        bool linkLost() const { return link_lost_; }
+
+        uint64_t bytesReceived() const { return bytes_received_; }
+
+        Timestamp firstReceiveTime() const { return first_receive_time_; }
+
+        Timestamp lastReceiveTime() const { return last_receive_time_; }
+
     private:
         //! Pointer to the node
         ROSaicNodeBase* node_;
 
     protected:
-        //! Reads in via async_read_some and hands certain number of bytes
-        //! (bytes_transferred) over to async_read_some_handler
+        //! Waits via async_read_some until the stream is readable, then
+        //! asyncReadyHandler() reads
         void read();
 
-        //!  Handler for async_read_some (Boost library)..
+        //! Handler for async_read_some, reads the available bytes via receive()
+        void asyncReadyHandler(const boost::system::error_code& error);
+
+        /**
+         * @brief Reads the available bytes into in_ without blocking
+         * @param[out] error Error of the read, would_block if nothing was available
+         * @param[out] recv_time Time the bytes were received, taken from the kernel
+         * for sockets, otherwise right after reading
+         * @return Number of bytes read
+         */
+        std::size_t receive(boost::system::error_code& error, Timestamp& recv_time);
+
+        //! receive() for sockets with kernel receive timestamps enabled
+        std::size_t receiveFromSocket(boost::system::error_code& error,
+                                      Timestamp& recv_time);
+
+        //! Enables kernel receive timestamps, if supported by the stream
+        void enableKernelTimestamps() {}
+
+        //! Duration of the transmission of one byte via the link in nanoseconds
+        double bytePeriod() { return 0.0; }
+
+        /**
+         * @brief Adds a scheduling latency and logs the statistics every
+         * SCHEDULING_REPORT_PERIOD
+         * @param[in,out] statistics Statistics of the thread at hand
+         * @param[in,out] report_time Monotonic time of the last report
+         * @param[in] latency Latency in nanoseconds
+         * @param[in] description What the latency consists of
+         */
+        void recordSchedulingLatency(LatencyStatistics& statistics,
+                                     Timestamp& report_time, Timestamp latency,
+                                     const std::string& description);
+
+        //! Hands the bytes read over to the raw callbacks and the parsing thread
         void asyncReadSomeHandler(const boost::system::error_code& error,
-                                  std::size_t bytes_transferred);
+                                  std::size_t bytes_transferred, Timestamp inTime);
+
+        /**
+         * @brief Copies the bytes read into circular_buffer_ and notifies the
+         * parsing thread, unless it has not picked up the previous bytes yet
+         *
+         * In the latter case the bytes are left in in_ and no read is armed, such
+         * that a thread of a shared io_service_ is never blocked by a slow parsing
+         * thread. The parsing thread posts resumeHandoff() once it has picked up the
+         * previous bytes.
+         * @return True if the bytes were handed over
+         */
+        bool handOver(std::size_t bytes_transferred, Timestamp inTime);
+
+        //! Hands over the bytes left in in_ by handOver() and arms the next read
+        void resumeHandoff();
 
         //! Sends command "cmd" to the Rx
         void write(std::string cmd, std::size_t size);
 
+        //! Waits until no handler of this object is queued in a shared io_service_
+        //! anymore
+        void drainHandlers();
+
         //! Closes stream "stream_"
         void close();
 
@@ -180,6 +326,16 @@ namespace io_comm_rx {
         //! into the circular buffer
         bool allow_writing_;
 
+        //! Whether bytes wait in in_ for the parsing thread to pick up the previous
+        //! ones, protected by parse_mutex_
+        bool handoff_waiting_ = false;
+
+        //! Number of bytes waiting in in_
+        std::size_t waiting_bytes_ = 0;
+
+        //! Receive time of the bytes waiting in in_
+        Timestamp waiting_recv_time_ = 0;
+
         //! Condition variable complementing "parse_mutex"
         boost::condition_variable parsing_condition_;
 
@@ -189,6 +345,13 @@ namespace io_comm_rx {
         //! io_context object
         boost::shared_ptr<boost::asio::io_service> io_service_;
 
+        //! Whether io_service_ is run by a thread pool shared with other Rxs
+        bool shared_io_service_;
+
+        //! Serializes the handlers of this stream in case io_service_ is run by
+        //! several threads
+        boost::asio::io_service::strand strand_;
+
         //! Buffer for async_read_some() to read continuous SBF/NMEA stream
         std::vector<uint8_t> in_;
 
@@ -212,8 +375,11 @@ namespace io_comm_rx {
         //! Callback to be called once message arrives
         Callback read_callback_;
 
+        //! Callbacks to be called with the raw bytes of each chunk read
+        std::vector<RawCallback> raw_callbacks_;
+
         //! Whether or not we want to sever the connection to the Rx
-        bool stopping_;
+        std::atomic<bool> stopping_;
 
         /// Size of in_ buffers
         const std::size_t buffer_size_;
@@ -229,12 +395,73 @@ namespace io_comm_rx {
         //! Handles the ROS_INFO throwing (if no incoming message)
         void callAsyncWait(uint16_t* count);
 
+        //! Number of seconds wait() has waited for incoming messages
+        uint16_t wait_count_ = 0;
+
         //! Number of times the DoRead() method has been called (only counts
         //! initially)
         uint16_t do_read_count_;
 
         //! Timestamp of receiving buffer
         Timestamp recvTime_;
+
+        //! Byte period of the link when the buffer was received
+        double recvBytePeriod_ = 0.0;
+
+        //! Time the I/O thread handed the buffer over to the parsing thread
+        Timestamp handoffTime_ = 0;
+
+        //! Whether TCP quick ACKs are re-enabled after each read
+        std::atomic<bool> quick_ack_{false};
+
+        //! Receive times of the bytes to be parsed, only used by tryParsing()
+        ReceiveTimeline timeline_;
+
+        //! Monotonic time the parsing thread was last notified of new bytes
+        Timestamp notify_time_ = 0;
+
+        //! Latencies from the arrival of bytes in the kernel until the I/O thread
+        //! has read them, only used by the I/O thread
+        LatencyStatistics io_latency_;
+
+        //! Monotonic time of the last report of io_latency_
+        Timestamp io_report_time_ = 0;
+
+        //! Latencies from notifying the waiting parsing thread until it runs, only
+        //! used by the parsing thread
+        LatencyStatistics wakeup_latency_;
+
+        //! Monotonic time of the last report of wakeup_latency_
+        Timestamp wakeup_report_time_ = 0;
+
+        //! Whether scheduling latencies are reported at INFO level
+        std::atomic<bool> report_scheduling_{false};
+
+        //! Called once the connection is lost, only used by the I/O thread
+        boost::function<void()> disconnect_callback_;
+
+        //! Whether the connection has been lost
+        std::atomic<bool> link_lost_{false};
+
+        //! Number of bytes received
+        std::atomic<uint64_t> bytes_received_{0};
+
+        //! Monotonic time of the first receipt
+        std::atomic<Timestamp> first_receive_time_{0};
+
+        //! Monotonic time of the last receipt
+        std::atomic<Timestamp> last_receive_time_{0};
+
+        //! Number of asynchronous operations of this object whose handlers have
+        //! not finished yet
+        std::atomic<int> pending_{0};
+
+        //! Period of the scheduling latency reports in nanoseconds
+        static const Timestamp SCHEDULING_REPORT_PERIOD = 10000000000;
+
+        //! Maximum deviation of a kernel receive timestamp from the current time
+        //! for it to be used, e.g. it is not if ROS time is simulated
+        static const Timestamp KERNEL_TIME_TOLERANCE = 1000000000;
     };
 
     template <typename StreamT>
@@ -242,61 +469,98 @@ namespace io_comm_rx {
     {
         uint8_t* to_be_parsed = new uint8_t[buffer_size_];
         to_be_parsed_ = to_be_parsed;
-        bool timed_out = false;
         std::size_t shift_bytes = 0;
         std::size_t arg_for_read_callback = 0;
 
-        while (!timed_out  && !stopping_) // Loop will stop if condition variable timed out
+        // Keeps waiting while the Rx is silent, the connection may come back
+        while (!stopping_)
         {
             boost::mutex::scoped_lock lock(parse_mutex_);
-            parsing_condition_.wait_for(lock, boost::chrono::seconds(10),
-                                        [this]() { return try_parsing_; });
-            bool timed_out = !try_parsing_;
-            if (timed_out)
+            // Only a thread that actually waits has a wake-up latency, otherwise
+            // the bytes arrived while it was parsing
+            bool waiting = !try_parsing_;
+            if (!parsing_condition_.wait_for(lock, boost::chrono::seconds(10),
+                                             [this]() { return try_parsing_; }))
+            {
+                ROSAIC_DEBUG(node_,
+                           "Nothing to parse received for 10 seconds.");
+                continue;
+            }
+            if (stopping_)
                 break;
+            if (waiting && !stopping_)
+                recordSchedulingLatency(wakeup_latency_, wakeup_report_time_,
+                                        monotonicTime() - notify_time_,
+                                        "Parsing thread wake-up");
             try_parsing_ = false;
             allow_writing_ = true;
+            if (handoff_waiting_)
+            {
+                // Posted under the lock, such that drainHandlers() accounts for it
+                handoff_waiting_ = false;
+                ++pending_;
+                strand_.post(boost::bind(&AsyncManager<StreamT>::resumeHandoff, this));
+            }
             std::size_t current_buffer_size = circular_buffer_.size();
+            if (shift_bytes + current_buffer_size > buffer_size_)
+            {
+                // The incomplete message kept from the previous call cannot be
+                // completed anymore, hence it is discarded
+                ROSAIC_DEBUG(node_, "Discarding " +
+                                                std::to_string(shift_bytes) +
+                                                " bytes of an incomplete message.");
+                shift_bytes = 0;
+                arg_for_read_callback = 0;
+                timeline_.clear();
+            }
             arg_for_read_callback += current_buffer_size;
             circular_buffer_.read(to_be_parsed + shift_bytes, current_buffer_size);
             Timestamp revcTime = recvTime_;
+            Timestamp pickup_time = node_->getTime();
+            timeline_.append(current_buffer_size, revcTime, recvBytePeriod_,
+                             handoffTime_, pickup_time);
+            ROSAIC_TRACE_SPAN("parsing", "handoff", handoffTime_, pickup_time);
             lock.unlock();
-            parsing_condition_.notify_one();
 
+            to_be_parsed_ = to_be_parsed;
             try
             {
-                node_->log(LogLevel::DEBUG, 
+                ROSAIC_TRACE_SCOPE("parsing", "read callback");
+                ROSAIC_DEBUG(node_, 
                     "Calling read_callback_() method, with number of bytes to be parsed being " +
                     std::to_string(arg_for_read_callback));
-                read_callback_(revcTime, to_be_parsed_, arg_for_read_callback);
+                read_callback_(revcTime, to_be_parsed_, arg_for_read_callback,
+                               &timeline_);
             } catch (std::size_t& parsing_failed_here)
             {
-                to_be_parsed_ += parsing_failed_here;
-                arg_for_read_callback -= parsing_failed_here;
-                node_->log(LogLevel::DEBUG, 
+                ROSAIC_DEBUG(node_, 
                     "Current buffer size is " + std::to_string(current_buffer_size) + 
                     " and parsing_failed_here is " + std::to_string(parsing_failed_here));
-                if (arg_for_read_callback < 0) // In case some parsing error was not
-                                               // caught, which should never happen..
+                if (parsing_failed_here > arg_for_read_callback) // In case some parsing
+                                                                 // error was not caught,
+                                                                 // which should never
+                                                                 // happen..
                 {
-                    delete[] to_be_parsed; // Freeing memory
-                    uint8_t* to_be_parsed = new uint8_t[buffer_size_];
-                    to_be_parsed_ = to_be_parsed;
                     shift_bytes = 0;
                     arg_for_read_callback = 0;
+                    timeline_.clear();
                     continue;
                 }
-                shift_bytes += current_buffer_size;
+                // Keep the incomplete message at the start of the buffer, the next
+                // data is appended to it
+                arg_for_read_callback -= parsing_failed_here;
+                std::memmove(to_be_parsed, to_be_parsed + parsing_failed_here,
+                             arg_for_read_callback);
+                shift_bytes = arg_for_read_callback;
+                timeline_.consume(parsing_failed_here);
                 continue;
             }
-            delete[] to_be_parsed; // Freeing memory
-            uint8_t* to_be_parsed = new uint8_t[buffer_size_];
-            to_be_parsed_ = to_be_parsed;
             shift_bytes = 0;
             arg_for_read_callback = 0;
+            timeline_.clear();
         }
-        node_->log(LogLevel::INFO, 
-            "TryParsing() method finished since it did not receive anything to parse for 10 seconds..");
+        delete[] to_be_parsed; // Freeing memory
+        ROSAIC_DEBUG(node_, "TryParsing() method finished.");
     }
 
     template <typename StreamT>
@@ -311,7 +575,7 @@ namespace io_comm_rx {
         std::vector<uint8_t> vector_temp(cmd.begin(), cmd.end());
         uint8_t* p = &vector_temp[0];
 
-        io_service_->post(
+        strand_.post(
             boost::bind(&AsyncManager<StreamT>::write, this, cmd, size));
         return true;
     }
@@ -319,15 +583,27 @@ namespace io_comm_rx {
     template <typename StreamT>
     void AsyncManager<StreamT>::write(std::string cmd, std::size_t size)
     {
-        boost::asio::write(*stream_, boost::asio::buffer(cmd.data(), size));
+        if (stopping_)
+            return;
+        boost::system::error_code error;
+        boost::asio::write(*stream_, boost::asio::buffer(cmd.data(), size), error);
+        if (error)
+        {
+            node_->log(LogLevel::ERROR, "Could not send the following command to the Rx: " +
+                                            cmd + ": " + error.message());
+            return;
+        }
         // Prints the data that was sent
-        node_->log(LogLevel::DEBUG, "Sent the following " + std::to_string(size) + " bytes to the Rx: \n" + cmd);
+        ROSAIC_DEBUG(node_, "Sent the following " + std::to_string(size) + " bytes to the Rx: \n" + cmd);
     }
 
     template <typename StreamT>
     void AsyncManager<StreamT>::callAsyncWait(uint16_t* count)
     {
-        timer_.async_wait(boost::bind(&AsyncManager::wait, this, count));
+        ++pending_;
+        // On the strand, since wait() reads do_read_count_, which read() changes
+        timer_.async_wait(
+            strand_.wrap(boost::bind(&AsyncManager::wait, this, count)));
     }
 
     template <typename StreamT>
@@ -335,8 +611,9 @@ namespace io_comm_rx {
         ROSaicNodeBase* node, 
         boost::shared_ptr<StreamT> stream,
         boost::shared_ptr<boost::asio::io_service> io_service,
-        std::size_t buffer_size) :
+        std::size_t buffer_size, bool shared_io_service) :
         node_(node),
+        shared_io_service_(shared_io_service), strand_(*io_service),
         timer_(*(io_service.get()), boost::posix_time::seconds(1)),
         stopping_(false), try_parsing_(false), allow_writing_(true),
         do_read_count_(0), buffer_size_(buffer_size), count_max_(6),
@@ -344,13 +621,22 @@ namespace io_comm_rx {
     // Since buffer_size = 131072 in declaration, no need in definition anymore (even
     // yields error message, due to "overwrite").
     {
-        node_->log(LogLevel::DEBUG, 
+        ROSAIC_DEBUG(node_, 
             "Setting the private stream variable of the AsyncManager instance.");
         stream_ = stream;
         io_service_ = io_service;
         in_.resize(buffer_size_);
+        // receive() reads by itself once the stream is readable, hence it must
+        // not block. Asio's own synchronous writes cope with a non-blocking
+        // descriptor.
+        int flags = ::fcntl(stream_->native_handle(), F_GETFL, 0);
+        if ((flags == -1) ||
+            (::fcntl(stream_->native_handle(), F_SETFL, flags | O_NONBLOCK) == -1))
+            node_->log(LogLevel::ERROR, "Could not make the stream non-blocking: " +
+                                            std::string(std::strerror(errno)));
+        enableKernelTimestamps();
 
-        io_service_->post(boost::bind(&AsyncManager<StreamT>::read, this));
+        strand_.post(boost::bind(&AsyncManager<StreamT>::read, this));
         // This function is used to ask the io_service to execute the given handler,
         // but without allowing the io_service to call the handler from inside this
         // function. The function signature of the handler must be: void handler();
@@ -359,8 +645,9 @@ namespace io_comm_rx {
         // member functions is currently being invoked. So the fundamental difference
         // is that dispatch will execute the work right away if it can and queue it
         // otherwise while post queues the work no matter what.
-        async_background_thread_.reset(new boost::thread(
-            boost::bind(&boost::asio::io_service::run, io_service_)));
+        if (!shared_io_service_)
+            async_background_thread_.reset(new boost::thread(
+                boost::bind(&boost::asio::io_service::run, io_service_)));
         // Note that io_service_ is already pointer, hence need dereferencing
         // operator & (ampersand). If the value of the pointer for the current thread
         // is changed using reset(), then the previous value is destroyed by calling
@@ -368,10 +655,10 @@ namespace io_comm_rx {
         // and the prior value returned by calling the release() member function,
         // allowing the application to take back responsibility for destroying the
         // object.
-        uint16_t count = 0;
-        waiting_thread_.reset(new boost::thread(boost::bind(&AsyncManager::callAsyncWait, this, &count)));
+        waiting_thread_.reset(new boost::thread(
+            boost::bind(&AsyncManager::callAsyncWait, this, &wait_count_)));
 
-        node_->log(LogLevel::DEBUG, "Launching tryParsing() thread..");
+        ROSAIC_DEBUG(node_, "Launching tryParsing() thread..");
         parsing_thread_.reset(new boost::thread(boost::bind(&AsyncManager::tryParsing, this)));
     } // Calls std::terminate() on thread just created
 
@@ -379,58 +666,245 @@ namespace io_comm_rx {
     AsyncManager<StreamT>::~AsyncManager()
     {
         close();
-        io_service_->stop();
-        try_parsing_ = true;
-        parsing_condition_.notify_one();
-        parsing_thread_->join();
         waiting_thread_->join();
-        async_background_thread_->join();
+        boost::system::error_code error;
+        timer_.cancel(error);
+        {
+            boost::mutex::scoped_lock lock(parse_mutex_);
+            try_parsing_ = true;
+        }
+        parsing_condition_.notify_all();
+        if (shared_io_service_)
+            drainHandlers();
+        else
+            io_service_->stop();
+        parsing_thread_->join();
+        if (async_background_thread_)
+            async_background_thread_->join();
+    }
+
+    template <typename StreamT>
+    void AsyncManager<StreamT>::drainHandlers()
+    {
+        // Once no operation is pending anymore, whatever the handlers posted
+        // before has run when a handler posted afterwards has. Nothing runs
+        // anymore if the io_service has been stopped, e.g. by its owner.
+        while (!io_service_->stopped())
+        {
+            if (pending_ > 0)
+            {
+                boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+                continue;
+            }
+            boost::mutex mutex;
+            boost::condition_variable condition;
+            bool drained = false;
+            strand_.post([&]() {
+                boost::mutex::scoped_lock lock(mutex);
+                drained = true;
+                condition.notify_one();
+            });
+            boost::mutex::scoped_lock lock(mutex);
+            while (!drained && !io_service_->stopped())
+                condition.wait_for(lock, boost::chrono::milliseconds(10));
+            if (drained && pending_ == 0)
+                break;
+        }
     }
 
     template <typename StreamT>
     void AsyncManager<StreamT>::read()
     {
+        if (stopping_)
+            return;
+        ++pending_;
+        // With null_buffers, the handler is called as soon as the stream is
+        // readable, such that it can read by itself and take the receive time
+        // right there, rather than after Asio has dispatched the completion.
         stream_->async_read_some(
-            boost::asio::buffer(in_.data(), in_.size()),
-            boost::bind(&AsyncManager<StreamT>::asyncReadSomeHandler, this,
-                        boost::asio::placeholders::error,
-                        boost::asio::placeholders::bytes_transferred));
-        // The handler is async_read_some_handler, whose call is postponed to
+            boost::asio::null_buffers(),
+            strand_.wrap(boost::bind(&AsyncManager<StreamT>::asyncReadyHandler,
+                                     this, boost::asio::placeholders::error)));
+        // The handler is asyncReadyHandler, whose call is postponed to
         // when async_read_some completes.
         if (do_read_count_ < 5)
             ++do_read_count_;
     }
 
+    template <typename StreamT>
+    void AsyncManager<StreamT>::asyncReadyHandler(const boost::system::error_code& error)
+    {
+        boost::system::error_code read_error = error;
+        std::size_t bytes_transferred = 0;
+        Timestamp inTime = 0;
+        if (!error)
+            bytes_transferred = receive(read_error, inTime);
+        if (read_error == boost::asio::error::would_block ||
+            read_error == boost::asio::error::interrupted)
+            read();
+        else
+            asyncReadSomeHandler(read_error, bytes_transferred, inTime);
+        --pending_;
+    }
+
+    template <typename StreamT>
+    std::size_t AsyncManager<StreamT>::receive(boost::system::error_code& error,
+                                               Timestamp& recv_time)
+    {
+        ssize_t n = ::read(stream_->native_handle(), in_.data(), in_.size());
+        recv_time = node_->getTime();
+        if (n < 0)
+        {
+            error = boost::system::error_code(errno, boost::system::system_category());
+            return 0;
+        }
+        if (n == 0)
+            error = boost::asio::error::eof;
+        return n;
+    }
+
+    template <typename StreamT>
+    std::size_t AsyncManager<StreamT>::receiveFromSocket(
+        boost::system::error_code& error, Timestamp& recv_time)
+    {
+        iovec iov = {in_.data(), in_.size()};
+        char control[CMSG_SPACE(sizeof(timespec))];
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t n = ::recvmsg(stream_->native_handle(), &msg, MSG_DONTWAIT);
+        recv_time = node_->getTime();
+        if (n < 0)
+        {
+            error = boost::system::error_code(errno, boost::system::system_category());
+            return 0;
+        }
+        if (n == 0)
+        {
+            error = boost::asio::error::eof;
+            return 0;
+        }
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+             cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS)
+            {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                Timestamp kernel_time =
+                    static_cast<Timestamp>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+                if (kernel_time <= recv_time &&
+                    recv_time - kernel_time < KERNEL_TIME_TOLERANCE)
+                {
+                    recordSchedulingLatency(io_latency_, io_report_time_,
+                                            recv_time - kernel_time,
+                                            "Kernel receive to I/O thread read");
+                    recv_time = kernel_time;
+                }
+            }
+        }
+        return n;
+    }
+
     template <typename StreamT>
     void AsyncManager<StreamT>::asyncReadSomeHandler(
-        const boost::system::error_code& error, std::size_t bytes_transferred)
+        const boost::system::error_code& error, std::size_t bytes_transferred,
+        Timestamp inTime)
     {
+        if (stopping_)
+            return;
         if (error)
         {
+            // Reading is not retried, the connection is rebuilt by the owner
             node_->log(LogLevel::ERROR, "Rx ASIO input buffer read error: " + error.message() + ", " + 
                                         std::to_string(bytes_transferred));
+            link_lost_ = true;
+            if (disconnect_callback_)
+                disconnect_callback_();
+            return;
         } else if (bytes_transferred > 0)
         {
-            Timestamp inTime = node_->getTime();
-            if (read_callback_ && !stopping_) // Will be false in InitializeSerial (first call)
-                                // since read_callback_ not added yet..
-            {
-                boost::mutex::scoped_lock lock(parse_mutex_);
-                parsing_condition_.wait(lock, [this]() { return allow_writing_; });
-                circular_buffer_.write(in_.data(), bytes_transferred);
-                allow_writing_ = false;
-                try_parsing_ = true;
-                recvTime_ = inTime;
-                lock.unlock();
-                parsing_condition_.notify_one();
-                std::vector<uint8_t> empty;
-                in_ = empty;
-                in_.resize(buffer_size_);
-            }
+            Timestamp now = monotonicTime();
+            if (bytes_received_ == 0)
+                first_receive_time_ = now;
+            last_receive_time_ = now;
+            bytes_received_ += bytes_transferred;
+            for (const auto& raw_callback : raw_callbacks_)
+                raw_callback(inTime, in_.data(), bytes_transferred);
+            // read_callback_ is not set yet in InitializeSerial (first call). If
+            // the parsing thread is busy, it re-arms reading via resumeHandoff().
+            if (read_callback_ && !handOver(bytes_transferred, inTime))
+                return;
+        }
+
+        strand_.post(boost::bind(&AsyncManager<StreamT>::read, this));
+    }
+
+    template <typename StreamT>
+    bool AsyncManager<StreamT>::handOver(std::size_t bytes_transferred,
+                                         Timestamp inTime)
+    {
+        boost::mutex::scoped_lock lock(parse_mutex_);
+        if (!allow_writing_)
+        {
+            handoff_waiting_ = true;
+            waiting_bytes_ = bytes_transferred;
+            waiting_recv_time_ = inTime;
+            return false;
         }
+        circular_buffer_.write(in_.data(), bytes_transferred);
+        allow_writing_ = false;
+        try_parsing_ = true;
+        recvTime_ = inTime;
+        recvBytePeriod_ = bytePeriod();
+        handoffTime_ = node_->getTime();
+        ROSAIC_TRACE_SPAN("io", "receive", recvTime_, handoffTime_);
+        notify_time_ = monotonicTime();
+        lock.unlock();
+        parsing_condition_.notify_one();
+        return true;
+    }
+
+    template <typename StreamT>
+    void AsyncManager<StreamT>::resumeHandoff()
+    {
+        if (!stopping_ && handOver(waiting_bytes_, waiting_recv_time_))
+            strand_.post(boost::bind(&AsyncManager<StreamT>::read, this));
+        --pending_;
+    }
 
-        if (!stopping_)
-            io_service_->post(boost::bind(&AsyncManager<StreamT>::read, this));
+    template <typename StreamT>
+    void AsyncManager<StreamT>::configureThreads(const ThreadSettings& io,
+                                                 const ThreadSettings& parsing)
+    {
+        if (async_background_thread_ && !io.isDefault())
+            configureThread(node_, async_background_thread_->native_handle(), "I/O",
+                            io);
+        if (!parsing.isDefault())
+            configureThread(node_, parsing_thread_->native_handle(), "parsing",
+                            parsing);
+        report_scheduling_ = !io.isDefault() || !parsing.isDefault();
+    }
+
+    template <typename StreamT>
+    void AsyncManager<StreamT>::recordSchedulingLatency(
+        LatencyStatistics& statistics, Timestamp& report_time, Timestamp latency,
+        const std::string& description)
+    {
+        statistics.add(latency);
+        Timestamp now = monotonicTime();
+        if (report_time == 0)
+            report_time = now;
+        if (now - report_time < SCHEDULING_REPORT_PERIOD)
+            return;
+        node_->log(report_scheduling_ ? LogLevel::INFO : LogLevel::DEBUG,
+                   description + " latency of the last " +
+                       std::to_string(statistics.count()) +
+                       " reads: " + statistics.summary());
+        statistics.reset();
+        report_time = now;
     }
 
     template <typename StreamT>
@@ -449,13 +923,20 @@ namespace io_comm_rx {
     template <typename StreamT>
     void AsyncManager<StreamT>::wait(uint16_t* count)
     {
+        if (stopping_)
+        {
+            --pending_;
+            return;
+        }
         if (*count < count_max_)
         {
             ++(*count);
             timer_.expires_at(timer_.expires_at() + boost::posix_time::seconds(1));
             if (!(*count == count_max_))
             {
-                timer_.async_wait(boost::bind(&AsyncManager::wait, this, count));
+                ++pending_;
+                timer_.async_wait(
+                    strand_.wrap(boost::bind(&AsyncManager::wait, this, count)));
             }
         }
         if ((*count == count_max_) && (do_read_count_ < 3))
@@ -465,8 +946,106 @@ namespace io_comm_rx {
         {
             node_->log(LogLevel::INFO, 
                 "No incoming messages, driver stopped, ros::spin() will spin forever unless you hit Ctrl+C.");
-            async_background_thread_->interrupt();
+            if (async_background_thread_)
+                async_background_thread_->interrupt();
         }
+        --pending_;
+    }
+
+    //! A UDP socket receives one datagram per read, a datagram may end within an
+    //! SBF block or NMEA message, which is completed by the next one
+    template <>
+    inline void AsyncManager<boost::asio::ip::udp::socket>::read()
+    {
+        if (stopping_)
+            return;
+        ++pending_;
+        stream_->async_receive(
+            boost::asio::null_buffers(),
+            strand_.wrap(boost::bind(
+                &AsyncManager<boost::asio::ip::udp::socket>::asyncReadyHandler,
+                this, boost::asio::placeholders::error)));
+        if (do_read_count_ < 5)
+            ++do_read_count_;
+    }
+
+    //! Quick ACK mode ends after a delayed ACK, hence it is re-enabled per read
+    template <>
+    inline std::size_t AsyncManager<boost::asio::ip::tcp::socket>::receive(
+        boost::system::error_code& error, Timestamp& recv_time)
+    {
+        std::size_t n = receiveFromSocket(error, recv_time);
+        if (quick_ack_ && n > 0)
+        {
+            int one = 1;
+            ::setsockopt(stream_->native_handle(), IPPROTO_TCP, TCP_QUICKACK, &one,
+                         sizeof(one));
+        }
+        return n;
+    }
+
+    template <>
+    inline std::size_t AsyncManager<boost::asio::ip::udp::socket>::receive(
+        boost::system::error_code& error, Timestamp& recv_time)
+    {
+        return receiveFromSocket(error, recv_time);
+    }
+
+    //! The kernel stamps each TCP segment and UDP datagram on arrival, recvmsg()
+    //! reports the time of the last one read
+    template <>
+    inline void AsyncManager<boost::asio::ip::tcp::socket>::enableKernelTimestamps()
+    {
+        boost::system::error_code error;
+        stream_->set_option(
+            boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_TIMESTAMPNS>(
+                true),
+            error);
+        if (error)
+            node_->log(LogLevel::WARN,
+                       "Kernel receive timestamps unavailable: " + error.message());
+    }
+
+    template <>
+    inline void AsyncManager<boost::asio::ip::udp::socket>::enableKernelTimestamps()
+    {
+        boost::system::error_code error;
+        stream_->set_option(
+            boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_TIMESTAMPNS>(
+                true),
+            error);
+        if (error)
+            node_->log(LogLevel::WARN,
+                       "Kernel receive timestamps unavailable: " + error.message());
+    }
+
+    //! A serial byte consists of a start bit, 8 data bits and a stop bit
+    template <>
+    inline double AsyncManager<boost::asio::serial_port>::bytePeriod()
+    {
+        boost::asio::serial_port_base::baud_rate baud_rate;
+        boost::system::error_code error;
+        stream_->get_option(baud_rate, error);
+        if (error || baud_rate.value() == 0)
+            return 0.0;
+        return 10.0e9 / baud_rate.value();
+    }
+
+    //! The Ethernet port of the Rx runs at 100 Mbit/s, the segments of a burst
+    //! arrive back to back
+    template <>
+    inline double AsyncManager<boost::asio::ip::tcp::socket>::bytePeriod()
+    {
+        return 80.0;
+    }
+
+    //! A UDP stream only flows from the Rx, hence commands are discarded
+    template <>
+    inline void AsyncManager<boost::asio::ip::udp::socket>::write(std::string cmd,
+                                                                  std::size_t size)
+    {
+        node_->log(LogLevel::WARN,
+                   "Commands cannot be sent to the Rx via UDP, discarding: " + cmd);
     }
 } // namespace io_comm_rx
 
@@ -0,0 +1,140 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef BLACK_BOX_HPP
+#define BLACK_BOX_HPP
+
+// Boost includes
+#include <boost/thread.hpp>
+// C++ library includes
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file black_box.hpp
+ * @date 19/10/26
+ * @brief Declares a memory ring holding the most recent raw data of the Rx
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class BlackBox
+     * @brief Keeps the most recent raw bytes received from the Rx in memory
+     *
+     * Like a flight recorder, the ring is overwritten continuously and only
+     * written to disk on request, e.g. after a localization failure. Besides the
+     * bytes, the receive times of the chunks are kept, at a resolution of
+     * INDEX_RESOLUTION and at most one per INDEX_SPACING bytes. The index is sized
+     * from the ring accordingly, such that it always covers all bytes in the ring
+     * regardless of the data rate.
+     */
+    class BlackBox
+    {
+    public:
+        /**
+         * @brief Allocates the ring
+         * @param[in] node Pointer to the node
+         * @param[in] size Size of the ring in bytes
+         * @param[in] path_prefix Path and prefix of the dump files, a time stamp
+         * and the extension are appended
+         */
+        BlackBox(ROSaicNodeBase* node, std::size_t size,
+                 const std::string& path_prefix);
+
+        //! Waits for a running dump to finish
+        ~BlackBox();
+
+        /**
+         * @brief Copies raw bytes into the ring, overwriting the oldest ones
+         *
+         * Must only be called from one thread at a time, i.e. the I/O thread.
+         * @param[in] recvTime Time the bytes were received
+         * @param[in] data The raw bytes
+         * @param[in] size Number of bytes
+         */
+        void write(Timestamp recvTime, const uint8_t* data, std::size_t size);
+
+        /**
+         * @brief Starts writing the current contents of the ring to disk on a
+         * thread of its own
+         * @param[out] message Name of the dump file or why no dump was started
+         * @return False if a dump is still running
+         */
+        bool dump(std::string& message);
+
+    private:
+        //! Receive time of the byte at a given position of the stream
+        struct IndexEntry
+        {
+            uint64_t position;
+            Timestamp time;
+        };
+
+        /**
+         * @brief Thread function writing the ring to disk
+         * @param[in] file_name Name of the dump file
+         * @param[in] begin Stream position of the first byte to be written
+         * @param[in] end Stream position after the last byte to be written
+         */
+        void writeDump(std::string file_name, uint64_t begin, uint64_t end);
+
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! Path and prefix of the dump files
+        std::string path_prefix_;
+        //! Ring of raw bytes
+        std::vector<uint8_t> ring_;
+        //! Ring of receive times, with room for the entries of a full ring_
+        std::vector<IndexEntry> index_;
+        //! Total number of bytes ever written into the ring
+        uint64_t head_ = 0;
+        //! Total number of entries ever written into index_
+        uint64_t index_head_ = 0;
+        //! Mutex protecting the rings against being overwritten while dumping
+        boost::mutex mutex_;
+        //! Whether a dump is running
+        std::atomic<bool> dumping_{false};
+        //! Dumping thread
+        boost::thread dump_thread_;
+        //! Number of bytes copied out of the ring per lock of mutex_
+        static const std::size_t DUMP_SEGMENT_SIZE = 1024 * 1024;
+        //! Minimum time between two entries of index_ in nanoseconds
+        static const Timestamp INDEX_RESOLUTION = 1000000;
+        //! Minimum number of bytes between two entries of index_
+        static const std::size_t INDEX_SPACING = 256;
+    };
+} // namespace io_comm_rx
+
+#endif // BLACK_BOX_HPP
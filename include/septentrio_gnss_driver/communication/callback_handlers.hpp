@@ -94,6 +94,8 @@
 
 // ROSaic and C++ includes
 #include <algorithm>
+#include <septentrio_gnss_driver/communication/latency_monitor.hpp>
+#include <septentrio_gnss_driver/communication/latency_statistics.hpp>
 #include <septentrio_gnss_driver/communication/rx_message.hpp>
 
 /**
@@ -102,15 +104,6 @@
  * @brief Handles callbacks when reading NMEA/SBF messages
  */
 
-extern bool g_response_received;
-extern boost::mutex g_response_mutex;
-extern boost::condition_variable g_response_condition;
-extern bool g_cd_received;
-extern boost::mutex g_cd_mutex;
-extern boost::condition_variable g_cd_condition;
-extern uint32_t g_cd_count;
-extern std::string g_rx_tcp_port;
-
 namespace io_comm_rx {
     /**
      * @class CallbackHandler
@@ -188,11 +181,7 @@ namespace io_comm_rx {
                               boost::shared_ptr<AbstractCallbackHandler>>
             CallbackMap;
 
-        CallbackHandlers(ROSaicNodeBase* node, Settings* settings) : 
-            node_(node),
-            rx_message_(node, settings),
-            settings_(settings)
-        {}
+        CallbackHandlers(ROSaicNodeBase* node, Settings* settings);
 
         /**
          * @brief Adds a pair to the multimap "callbackmap_", with the message_key
@@ -231,8 +220,32 @@ namespace io_comm_rx {
          * @param[in] recvTimestamp Timestamp of buffer reception passed on from AsyncManager class
          * @param[in] data Buffer passed on from AsyncManager class
          * @param[in] size Size of the buffer
+         * @param[in] timeline Receive times of the bytes of the buffer, if known,
+         * otherwise all messages are stamped with recvTimestamp
+         */
+        void readCallback(Timestamp recvTimestamp, const uint8_t* data, std::size_t& size,
+                          const ReceiveTimeline* timeline = nullptr);
+
+        /**
+         * @brief Prepares the parser to read the connection descriptors of a new
+         * TCP connection, leaving all other parser state untouched
+         *
+         * Must not be called while readCallback() may run.
+         */
+        void resetConnectionDescriptor();
+
+        /**
+         * @brief Hands MeasEpoch blocks over to rinex_writer, null to stop
+         *
+         * Must not be called while readCallback() may run.
          */
-        void readCallback(Timestamp recvTimestamp, const uint8_t* data, std::size_t& size);
+        void setRinexWriter(RinexWriter* rinex_writer);
+
+        /**
+         * @brief Counters of the messages read and of the failures to read them,
+         * which may be read by any thread
+         */
+        const MessageCounters& messageCounters() { return rx_message_.counters(); }
 
         //! Callback handlers multimap for Rx messages; it needs to be public since
         //! we copy-assign (did not work otherwise) new callbackmap_, after inserting
@@ -241,111 +254,214 @@ namespace io_comm_rx {
         CallbackMap callbackmap_;
 
     private:
+        /**
+         * @brief Appends an SBF block to raw_sbf_ if its ID is to be published
+         * @param[in] block The SBF block, its full length must be available and its
+         * CRC must have been validated already
+         */
+        void appendRawSBF(const uint8_t* block);
+
+        /**
+         * @brief Removes the SBF blocks appended to raw_sbf_ behind its first ones
+         * @param[in] blocks Number of blocks to keep
+         */
+        void dropRawSBF(std::size_t blocks);
+
+        /**
+         * @brief Publishes the SBF blocks collected in raw_sbf_, if any, and
+         * empties it
+         * @param[in] recvTimestamp Timestamp of buffer reception
+         */
+        void publishRawSBF(Timestamp recvTimestamp);
+
+        /**
+         * @brief Adds the latency of the message at hand, from the arrival of its
+         * last byte until it has been handled, and reports their statistics every
+         * LATENCY_REPORT_PERIOD
+         */
+        void recordLatency();
+
+        /**
+         * @brief Calls a callback handler, measuring how long decoding or
+         * assembling its message took if latency diagnostics are enabled
+         * @param[in] callback Key and handler
+         */
+        void dispatch(const CallbackMap::value_type& callback);
+
+        /**
+         * @brief Adds the latencies of the message at hand until it was found in
+         * the buffer and publishes the latency diagnostics every
+         * latency_diagnostics_period
+         * @param[in] found_time Time the message was found in the buffer
+         */
+        void recordStages(Timestamp found_time);
+
+        /**
+         * @brief Adds the latencies of a publication
+         * @param[in] topic The topic
+         * @param[in] start Time publishing started
+         */
+        void recordPublication(const std::string& topic, Timestamp start);
+
+        /**
+         * @brief Publishes the message counters as diagnostics every
+         * message_counters_period
+         */
+        void publishMessageCounters();
+
         //! Pointer to Node
         ROSaicNodeBase* node_;
 
+        //! Latencies since the last report
+        LatencyStatistics latency_;
+
+        //! Time of the last report
+        Timestamp latency_report_time_ = 0;
+
+        //! Period of the latency reports in nanoseconds
+        static const Timestamp LATENCY_REPORT_PERIOD = 10000000000;
+
+        //! Latencies per stage for the latency diagnostics
+        LatencyMonitor latency_monitor_;
+
+        //! Whether the latencies of the buffer at hand are monitored
+        bool monitor_latency_ = false;
+
+        //! Receive time of the last byte of the message found last
+        Timestamp message_recv_time_ = 0;
+
+        //! ID of the message handle() was called for last, such that it is built
+        //! once per message rather than per callback and stage
+        std::string message_id_;
+
+        //! Time the latency diagnostics were published last
+        Timestamp latency_diagnostics_time_ = 0;
+
+        //! Time the message counters were published last
+        Timestamp message_counters_time_ = 0;
+
         //! RxMessage parser
         RxMessage rx_message_;
 
+        //! Raw SBF blocks of the buffer at hand
+        RawSBFMsg raw_sbf_;
+
         //! Settings
         Settings* settings_;
 
-        //! The "static" keyword resolves construct-by-copying issues related to this
-        //! mutex by making it available throughout the code unit. The mutex
-        //! constructor list contains "mutex (const mutex&) = delete", hence
-        //! construct-by-copying a mutex is explicitly prohibited. The get_handlers()
-        //! method of the Comm_IO class hence forces us to make this mutex static.
-        static boost::mutex callback_mutex_;
+        //! Mutex protecting callbackmap_ against concurrent insertions while
+        //! handling
+        boost::mutex callback_mutex_;
+
+        //! Mutex to control changes of "response_received_"
+        boost::mutex response_mutex_;
+
+        //! Determines whether a command reply was received from the Rx
+        bool response_received_ = false;
+
+        //! Condition variable complementing "response_mutex_"
+        boost::condition_variable response_condition_;
+
+        //! Mutex to control changes of "cd_received_"
+        boost::mutex cd_mutex_;
+
+        //! Determines whether the connection descriptor was received from the Rx
+        bool cd_received_ = false;
+
+        //! Condition variable complementing "cd_mutex_"
+        boost::condition_variable cd_condition_;
+
+        //! Rx TCP port, e.g. IP10 or IP11, to which ROSaic is connected to
+        std::string rx_tcp_port_;
 
         //! Determines which of the SBF blocks necessary for the gps_common::GPSFix
-        //! ROS message arrives last and thus launches its construction
-        static std::string do_gpsfix_;
+        //! ROS message arrives last and thus launches its construction. Empty, as
+        //! the ones below, until all of them arrived, such that the first block
+        //! does not launch it with the fields of the others left unset
+        std::string do_gpsfix_;
 
         //! Determines which of the INS integrated SBF blocks necessary for the gps_common::GPSFix
         //! ROS message arrives last and thus launches its construction
-        static std::string do_insgpsfix_;
+        std::string do_insgpsfix_;
 
         //! Determines which of the SBF blocks necessary for the
         //! NavSatFixMsg ROS message arrives last and thus launches its
         //! construction
-        static std::string do_navsatfix_;
+        std::string do_navsatfix_;
 
         //! Determines which of the INS integrated SBF blocks necessary for the
         //! NavSatFixMsg ROS message arrives last and thus launches its construction
-        static std::string do_insnavsatfix_;
+        std::string do_insnavsatfix_;
 
         //! Determines which of the SBF blocks necessary for the
         //! geometry_msgs/PoseWithCovarianceStamped ROS message arrives last and thus
         //! launches its construction
-        static std::string do_pose_;
+        std::string do_pose_;
 
         //! Determines which of the INS integrated SBF blocks necessary for the
         //! geometry_msgs/PoseWithCovarianceStamped ROS message arrives last and thus
         //! launches its construction
-        static std::string do_inspose_;
+        std::string do_inspose_;
 
         //! Determines which of the SBF blocks necessary for the
         //! diagnostic_msgs/DiagnosticArray ROS message arrives last and thus
         //! launches its construction
-        static std::string do_diagnostics_;
+        std::string do_diagnostics_;
 
         //! Determines which of the SBF blocks necessary for the
         //! sensor_msgs/Imu ROS message arrives last and thus
         //! launches its construction
-        static std::string do_imu_;
+        std::string do_imu_;
 
         //! Determines which of the SBF blocks necessary for the
         //! nav_msgs/Odometry ROS message arrives last and thus
         //! launches its construction
-        static std::string do_inslocalization_;
+        std::string do_inslocalization_;
 
-        //! Shorthand for the map responsible for matching ROS message identifiers
+        //! Shorthand for the map responsible for matching the block numbers
         //! relevant for GPSFix to a uint32_t
-        typedef std::map<std::string, uint32_t> GPSFixMap;
+        typedef std::map<uint16_t, uint32_t> GPSFixMap;
 
-        //! All instances of the CallbackHandlers class shall have access to the map
-        //! without reinitializing it, hence static
-        static GPSFixMap gpsfix_map;
+        //! Map of the blocks relevant for GPSFix, per instance, since the maps
+        //! are used from the parsing threads of several Rxs
+        GPSFixMap gpsfix_map;
 
-        //! Shorthand for the map responsible for matching ROS message identifiers
+        //! Shorthand for the map responsible for matching the block numbers
         //! relevant for NavSatFix to a uint32_t
-        typedef std::map<std::string, uint32_t> NavSatFixMap;
+        typedef std::map<uint16_t, uint32_t> NavSatFixMap;
 
-        //! All instances of the CallbackHandlers class shall have access to the map
-        //! without reinitializing it, hence static
-        static NavSatFixMap navsatfix_map;
+        //! Map of the blocks relevant for NavSatFix
+        NavSatFixMap navsatfix_map;
 
-        //! Shorthand for the map responsible for matching ROS message identifiers
+        //! Shorthand for the map responsible for matching the block numbers
         //! relevant for PoseWithCovarianceStamped to a uint32_t
-        typedef std::map<std::string, uint32_t> PoseWithCovarianceStampedMap;
+        typedef std::map<uint16_t, uint32_t> PoseWithCovarianceStampedMap;
 
-        //! All instances of the CallbackHandlers class shall have access to the map
-        //! without reinitializing it, hence static
-        static PoseWithCovarianceStampedMap pose_map;
+        //! Map of the blocks relevant for PoseWithCovarianceStamped
+        PoseWithCovarianceStampedMap pose_map;
 
-        //! Shorthand for the map responsible for matching ROS message identifiers
+        //! Shorthand for the map responsible for matching the block numbers
         //! relevant for DiagnosticArray to a uint32_t
-        typedef std::map<std::string, uint32_t> DiagnosticArrayMap;
+        typedef std::map<uint16_t, uint32_t> DiagnosticArrayMap;
 
-        //! All instances of the CallbackHandlers class shall have access to the map
-        //! without reinitializing it, hence static
-        static DiagnosticArrayMap diagnosticarray_map;
+        //! Map of the blocks relevant for DiagnosticArray
+        DiagnosticArrayMap diagnosticarray_map;
 
-        //! Shorthand for the map responsible for matching ROS message identifiers
+        //! Shorthand for the map responsible for matching the block numbers
         //! relevant for Imu to a uint32_t
-        typedef std::map<std::string, uint32_t> ImuMap;
+        typedef std::map<uint16_t, uint32_t> ImuMap;
 
-        //! All instances of the CallbackHandlers class shall have access to the map
-        //! without reinitializing it, hence static
-        static ImuMap imu_map;
+        //! Map of the blocks relevant for Imu
+        ImuMap imu_map;
 
-        //! Shorthand for the map responsible for matching ROS message identifiers
+        //! Shorthand for the map responsible for matching the block numbers
         //! relevant for Localization to a uint32_t
-        typedef std::map<std::string, uint32_t> LocalizationMap;
+        typedef std::map<uint16_t, uint32_t> LocalizationMap;
+
+        //! Map of the blocks relevant for Localization
+        LocalizationMap localization_map;
 
-        //! All instances of the CallbackHandlers class shall have access to the map
-        //! without reinitializing it, hence static
-        static LocalizationMap localization_map;
+        friend class Comm_IO;
     };
 
 } // namespace io_comm_rx
@@ -0,0 +1,154 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef CLOCK_ESTIMATOR_HPP
+#define CLOCK_ESTIMATOR_HPP
+
+// C++ library includes
+#include <cstdint>
+#include <deque>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file clock_estimator.hpp
+ * @date 19/10/26
+ * @brief Declares an estimator of the offset of the host clock from GNSS time
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class ClockEstimator
+     * @brief Estimates offset and drift of the host clock relative to the GNSS
+     * time of the Rx, as well as the transport latency, from the GNSS times of the
+     * SBF blocks and their receive times
+     *
+     * The delay of a block, i.e. its receive time minus its GNSS time, consists of
+     * the clock offset, a minimum delay (processing and transmission) and a
+     * varying part due to queuing. Per BUCKET_DURATION of GNSS time, only the
+     * minimum delay is kept, which is least affected by queuing. A line fitted
+     * through the minima of the last window yields offset and drift. Minima far
+     * above the line, e.g. of a second during which the link was congested, are
+     * rejected once. The minimum delay cannot be told apart from the offset
+     * without a PPS signal, hence the offset includes it, and the latency is the
+     * delay in excess of it.
+     */
+    class ClockEstimator
+    {
+    public:
+        /**
+         * @brief Class constructor
+         * @param[in] window Duration of GNSS time the line is fitted over in
+         * nanoseconds
+         */
+        explicit ClockEstimator(Timestamp window = 30000000000);
+
+        //! Sets the duration of GNSS time the line is fitted over in nanoseconds,
+        //! it takes effect with the next minimum
+        void setWindow(Timestamp window) { window_ = window; }
+
+        /**
+         * @brief Adds the delay of a block
+         * @param[in] gnss_time GNSS time of the block, as Unix epoch time
+         * @param[in] host_time Receive time of the block
+         * @return True if a new estimate was fitted, i.e. once per BUCKET_DURATION
+         */
+        bool update(Timestamp gnss_time, Timestamp host_time);
+
+        //! Whether an estimate is available
+        bool valid() const { return fitted_ > 0; }
+
+        //! Host time corresponding to a GNSS time, as per the estimate
+        Timestamp toHost(Timestamp gnss_time) const;
+
+        //! Host time minus GNSS time (including the minimum delay) in seconds
+        double offset() const { return offset_ * 1.0e-9; }
+
+        //! Drift of the host clock relative to GNSS time, e.g. 1e-6 if it runs
+        //! 1 ppm fast
+        double drift() const { return drift_; }
+
+        //! Mean delay in excess of the minimum delay in seconds
+        double latency() const { return latency_ * 1.0e-9; }
+
+        //! Standard deviation of the delay in seconds
+        double jitter() const;
+
+        //! Number of minima the estimate is fitted to
+        uint32_t samples() const { return fitted_; }
+
+        //! Number of restarts of the estimation due to steps of either clock
+        uint32_t resets() const { return resets_; }
+
+    private:
+        //! Minimum delay within a bucket and the GNSS time it was observed at
+        struct Bucket
+        {
+            Timestamp gnss_time;
+            int64_t delay;
+        };
+
+        //! Fits offset_ and drift_ to the minima of buckets_
+        void fit();
+
+        //! Delay predicted by the estimate for a GNSS time in nanoseconds
+        double predict(Timestamp gnss_time) const;
+
+        //! Duration of GNSS time the line is fitted over
+        Timestamp window_;
+        //! Minimum delays, the last one is still being updated
+        std::deque<Bucket> buckets_;
+        //! Reference GNSS time of the estimate, that of the latest minimum
+        Timestamp reference_ = 0;
+        //! Delay at reference_ in nanoseconds
+        double offset_ = 0.0;
+        //! Increase of the delay per nanosecond of GNSS time
+        double drift_ = 0.0;
+        //! Exponentially weighted mean of the excess delay in nanoseconds
+        double latency_ = 0.0;
+        //! Exponentially weighted mean of the squared excess delay
+        double latency_sq_ = 0.0;
+        //! Number of minima the estimate is fitted to
+        uint32_t fitted_ = 0;
+        //! Number of restarts
+        uint32_t resets_ = 0;
+        //! Duration of GNSS time a minimum is taken over
+        static const Timestamp BUCKET_DURATION = 1000000000;
+        //! Deviation from the estimate regarded as step of a clock in nanoseconds
+        static constexpr double STEP_THRESHOLD = 1.0e9;
+        //! Minimum residual for a minimum to be rejected in nanoseconds
+        static constexpr double MIN_REJECTION_RESIDUAL = 1.0e6;
+        //! Weight of a new excess delay in latency_ and latency_sq_
+        static constexpr double LATENCY_WEIGHT = 0.01;
+    };
+} // namespace io_comm_rx
+
+#endif // CLOCK_ESTIMATOR_HPP
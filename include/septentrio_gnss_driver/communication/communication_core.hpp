@@ -73,11 +73,17 @@
 // C++ library includes
 #include <fstream>
 #include <memory>
+#include <random>
 #include <sstream>
 #include <unistd.h> // for usleep()
 // ROSaic includes
 #include <septentrio_gnss_driver/communication/async_manager.hpp>
+#include <septentrio_gnss_driver/communication/black_box.hpp>
 #include <septentrio_gnss_driver/communication/callback_handlers.hpp>
+#include <septentrio_gnss_driver/communication/prometheus_exporter.hpp>
+#include <septentrio_gnss_driver/communication/raw_recorder.hpp>
+#include <septentrio_gnss_driver/communication/rinex_writer.hpp>
+#include <septentrio_gnss_driver/communication/udp_statistics.hpp>
 
 /**
  * @file communication_core.hpp
@@ -109,15 +115,22 @@ namespace io_comm_rx {
         /**
          * @brief Constructor of the class Comm_IO
          * @param[in] node Pointer to node
+         * @param[in] settings Pointer to the settings of the Rx
+         * @param[in] shared_io_service io_service run by a thread pool shared
+         * with other Rxs, if null each connection runs an io_service of its own
          */
-        Comm_IO(ROSaicNodeBase* node, Settings* settings);
+        Comm_IO(ROSaicNodeBase* node, Settings* settings,
+                boost::shared_ptr<boost::asio::io_service> shared_io_service =
+                    boost::shared_ptr<boost::asio::io_service>());
         /**
          * @brief Default destructor of the class Comm_IO
          */
         ~Comm_IO()
         {
             stopping_ = true;
-            connectionThread_->join();
+            connection_condition_.notify_all();
+            if (connectionThread_ && connectionThread_->joinable())
+                connectionThread_->join();
         }
 
         /**
@@ -128,7 +141,8 @@ namespace io_comm_rx {
         /**
          * @brief Configures Rx: Which SBF/NMEA messages it should output and later
          * correction settings
-         * @param[in] settings The device's settings
+         *
+         * Once called, the Rx is configured again after each reconnection.
          * */
         void configureRx();
 
@@ -138,6 +152,12 @@ namespace io_comm_rx {
          * */
         void defineMessages();        
 
+        /**
+         * @brief Returns once an SBF or PCAP file has been read entirely, right
+         * away if the device is not a file
+         */
+        void waitForFileReading();
+
     private:
         /**
          * @brief Sets up the stage for SBF file reading
@@ -152,15 +172,43 @@ namespace io_comm_rx {
         void preparePCAPFileReading(std::string file_name);
 
         /**
-         * @brief Attempts to (re)connect every reconnect_delay_s_ seconds
+         * @brief Attempts to (re)connect once
          */
         void reconnect();
 
         /**
-         * @brief Calls the reconnect() method
+         * @brief Supervises the connection: calls the reconnect() method with
+         * exponential backoff and jitter until connected, and once the connection
+         * is lost, replaces the manager, i.e. only the transport. The parsing
+         * state, the publishers and the epoch state of the callback handlers are
+         * kept.
          */
         void connect();
 
+        /**
+         * @brief Delay before the next connection attempt, reconnect_delay_s
+         * doubled per failed attempt up to reconnect_max_delay_s, of which a
+         * random part of up to half is left out, such that several drivers do not
+         * reconnect in lockstep
+         * @param[in] attempt Number of failed attempts so far
+         * @return Delay in seconds
+         */
+        double backoffDelay(uint32_t attempt);
+
+        /**
+         * @brief Waits until the connection is lost, has been silent for
+         * reconnect_data_timeout_s or the driver is stopping, and reports the
+         * outage the connection recovered from, if any
+         * @param[in] manager The manager of the connection
+         */
+        void superviseConnection(const boost::shared_ptr<Manager>& manager);
+
+        //! Called by the manager from the I/O thread once the connection is lost
+        void linkLost();
+
+        //! Gets manager_, which may be replaced by the connection thread
+        boost::shared_ptr<Manager> currentManager();
+
         /**
          * @brief Initializes the serial port
          * @param[in] port The device's port address
@@ -181,6 +229,82 @@ namespace io_comm_rx {
          */
         bool initializeTCP(std::string host, std::string port);
 
+        /**
+         * @brief Initializes the UDP I/O, which only receives from the Rx
+         * @param[in] host The local address to listen on, or the multicast group to
+         * join
+         * @param[in] port The UDP port
+         * @return True if the socket could be set up, false otherwise
+         */
+        bool initializeUDP(std::string host, std::string port);
+
+        /**
+         * @brief Initializes the I/O via a Unix domain socket, e.g. of a local
+         * stream multiplexer
+         * @param[in] path The path of the socket
+         * @return True if connection could be established, false otherwise
+         */
+        bool initializeUnix(std::string path);
+
+        /**
+         * @brief Initializes the I/O via a named pipe, e.g. written by a local
+         * stream multiplexer
+         * @param[in] path The path of the named pipe
+         * @return True if the named pipe could be opened, false otherwise
+         */
+        bool initializeFifo(std::string path);
+
+        /**
+         * @brief Tunes a serial port for low latency: the driver is asked to pass
+         * on bytes right away (ASYNC_LOW_LATENCY, e.g. a 1 ms latency timer for FTDI
+         * adapters), and the port is readable as soon as one byte arrived
+         * @param[in] fd File descriptor of the serial port
+         */
+        void configureLowLatency(int fd);
+
+        /**
+         * @brief Tunes a TCP socket for low latency via its receive buffer, low
+         * watermark and, if low_latency_busy_poll_us is set, busy polling. Quick
+         * ACKs are re-enabled by the AsyncManager after each read.
+         * @param[in] socket The connected socket
+         */
+        void configureLowLatency(boost::asio::ip::tcp::socket& socket);
+
+        /**
+         * @brief Detects the baudrate the Rx currently uses on a serial port by
+         * probing candidate baudrates, baudrate_ and the one detected last first
+         * @param[in] serial The opened serial port, not read by a manager yet
+         * @return The detected baudrate, 0 if the Rx did not answer at any
+         */
+        uint32_t detectBaudrate(boost::asio::serial_port& serial);
+
+        /**
+         * @brief Sets a baudrate and checks whether the Rx answers at it, i.e. with
+         * its prompt to the escape sequence sent or with the output it streams
+         * @param[in] serial The opened serial port
+         * @param[in] baudrate The baudrate to try
+         * @return Whether a prompt, an SBF block or an NMEA sentence was received
+         */
+        bool probeBaudrate(boost::asio::serial_port& serial, uint32_t baudrate);
+
+        /**
+         * @brief Asks the Rx to switch its port to baudrate_ in one step and
+         * verifies that it answers at it
+         * @param[in] serial The opened serial port, set to the current baudrate of
+         * the Rx
+         * @return Whether the Rx answered at baudrate_
+         */
+        bool switchBaudrate(boost::asio::serial_port& serial);
+
+        /**
+         * @brief Checks whether bytes received from a serial port are valid Rx
+         * output, such that they were received at the right baudrate
+         * @param[in] data The bytes received
+         * @return Whether data contains a prompt, e.g. "COM1>", an SBF block with
+         * valid CRC or an NMEA sentence with valid checksum
+         */
+        static bool containsRxOutput(const std::string& data);
+
         /**
          * @brief Initializes SBF file reading and reads SBF file by repeatedly
          * calling read_callback_()
@@ -188,6 +312,14 @@ namespace io_comm_rx {
          */
         void initializeSBFFileReading(std::string file_name);
 
+        /**
+         * @brief Reads a gzip or zstd compressed SBF file, decompressing it chunk
+         * by chunk on a separate thread
+         * @param[in] file_name The name of (or path to) the compressed SBF file,
+         * e.g. "xyz.sbf.gz"
+         */
+        void initializeCompressedSBFFileReading(std::string file_name);
+
         /**
          * @brief Initializes PCAP file reading and reads PCAP file by repeatedly
          * calling read_callback_()
@@ -195,6 +327,14 @@ namespace io_comm_rx {
          */
         void initializePCAPFileReading(std::string file_name);
 
+        /**
+         * @brief Hands the whole content of an SBF or PCAP file over to the
+         * callback handlers, skipping messages that are cut off by the end of
+         * the file
+         * @param[in] content The bytes of the file, TCP payloads in case of PCAP
+         */
+        void parseFileContent(const std::vector<uint8_t>& content);
+
         /**
          * @brief Set the I/O manager
          * @param[in] manager An I/O handler
@@ -207,16 +347,40 @@ namespace io_comm_rx {
          */
         void resetSerial(std::string port);
 
+        /**
+         * @brief Gets the io_service for a new connection
+         * @return shared_io_service_ if set, a new io_service otherwise
+         */
+        boost::shared_ptr<boost::asio::io_service> ioService();
+
         /**
          * @brief Hands over to the send() method of manager_
          * @param cmd The command to hand over
          */
         void send(std::string cmd);
 
+        /**
+         * @brief Message counters in the Prometheus text format, labeled with the
+         * name of the Rx if any
+         */
+        std::string prometheusMetrics();
+
+#ifdef ROSAIC_TRACING
+        /**
+         * @brief Dumps the spans of all threads to a Chrome trace file
+         * @param[out] message Name of the file or error message
+         * @return True if the file was written, false otherwise
+         */
+        bool dumpTrace(std::string& message);
+#endif
+
         //! Pointer to Node
         ROSaicNodeBase* node_;
         //! Callback handlers for the inwards streaming messages
         CallbackHandlers handlers_;
+        //! Serves the message counters of handlers_, declared after it to be
+        //! stopped first
+        std::unique_ptr<PrometheusExporter> exporter_;
         //! Settings
         Settings* settings_;
         //! Whether connecting to Rx was successful
@@ -233,15 +397,69 @@ namespace io_comm_rx {
         std::string tcp_host_;
         //! TCP port number
         std::string tcp_port_;
-        //! Whether yet-to-be-established connection to Rx will be serial or TCP
-        bool serial_;
+        //! Host name or address to receive the UDP stream on
+        std::string udp_host_;
+        //! UDP port number
+        std::string udp_port_;
+        //! Path of the Unix domain socket or named pipe
+        std::string local_path_;
+        //! Types of connections to the Rx
+        enum Transport
+        {
+            TRANSPORT_TCP,
+            TRANSPORT_SERIAL,
+            TRANSPORT_UDP,
+            TRANSPORT_UNIX,
+            TRANSPORT_FIFO
+        };
+        //! Type of the yet-to-be-established connection to the Rx
+        Transport transport_ = TRANSPORT_TCP;
         //! Saves the port description
         std::string serial_port_;
+        //! Records the raw stream, declared before manager_ to outlive it
+        std::unique_ptr<RawRecorder> recorder_;
+        //! Keeps the most recent raw stream, declared before manager_ to outlive
+        //! it
+        std::unique_ptr<BlackBox> black_box_;
+        //! Checks the datagrams of a UDP stream, declared before manager_ to
+        //! outlive it
+        std::unique_ptr<UdpStatistics> udp_statistics_;
+        //! Writes MeasEpoch blocks to RINEX files, declared before manager_ to
+        //! outlive it
+        std::unique_ptr<RinexWriter> rinex_writer_;
         //! Processes I/O stream data
         //! This declaration is deliberately stream-independent (Serial or TCP).
         boost::shared_ptr<Manager> manager_;
         //! Baudrate at the moment, unless InitializeSerial or ResetSerial fail
         uint32_t baudrate_;
+        //! Baudrate the Rx answered at last, probed early when reconnecting
+        uint32_t detected_baudrate_ = 0;
+        //! Protects manager_, which is replaced when reconnecting
+        boost::mutex manager_mutex_;
+        //! Whether the connection has been lost, set from the I/O thread
+        std::atomic<bool> link_lost_{false};
+        //! Whether configureRx() has been called, such that the Rx is configured
+        //! again after reconnecting
+        std::atomic<bool> configure_rx_{false};
+        //! Serializes configureRx()
+        boost::mutex configure_mutex_;
+        //! Random numbers for the jitter of backoffDelay()
+        std::mt19937 random_{std::random_device{}()};
+        //! Monotonic time of the last byte before the connection was lost, 0 if it
+        //! has not been lost
+        Timestamp outage_start_ = 0;
+        //! Bytes per second received before the connection was lost
+        double outage_byte_rate_ = 0.0;
+        //! Monotonic time the connection was reestablished
+        Timestamp reconnect_time_ = 0;
+        //! Number of times the connection was lost
+        uint32_t outages_ = 0;
+        //! Total duration of the outages in seconds
+        double outage_duration_total_ = 0.0;
+        //! Estimated number of bytes lost during the outages
+        uint64_t bytes_lost_total_ = 0;
+        //! io_service shared with other Rxs, null if not shared
+        boost::shared_ptr<boost::asio::io_service> shared_io_service_;
 
         //! Connection or reading thread
         std::unique_ptr<boost::thread> connectionThread_;
@@ -255,10 +473,14 @@ namespace io_comm_rx {
         std::string host_;
         //! Port over which TCP/IP connection is currently established
         std::string port_;
-        //! Sleep time in microseconds (there is no Unix command for milliseconds)
-        //! after setting the baudrate to certain value (important between
-        //! increments)
-        const static unsigned int SET_BAUDRATE_SLEEP_ = 500000;
+        //! Time in milliseconds the Rx is given to answer a probe, on top of the
+        //! transmission of the probe and its answer
+        const static int AUTOBAUD_WINDOW_MS_ = 50;
+        //! Requested size of the socket receive buffer of a UDP stream in bytes
+        const static int UDP_RECEIVE_BUFFER_SIZE_ = 4 * 1024 * 1024;
+        //! Size of the socket receive buffer of a TCP stream with low_latency in
+        //! bytes, large enough for bursts without the window closing
+        const static int LOW_LATENCY_RECEIVE_BUFFER_SIZE_ = 1024 * 1024;
     };
 } // namespace io_comm_rx
 
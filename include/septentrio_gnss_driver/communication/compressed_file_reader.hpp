@@ -0,0 +1,158 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef COMPRESSED_FILE_READER_HPP
+#define COMPRESSED_FILE_READER_HPP
+
+// Boost includes
+#include <boost/thread.hpp>
+#include <boost/thread/condition.hpp>
+// C++ library includes
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+// zlib and zstd includes
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file compressed_file_reader.hpp
+ * @date 19/10/26
+ * @brief Declares a class for streaming decompression of SBF logs
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class CompressedFileReader
+     * @brief Decompresses gzip (.gz) and zstd (.zst) files on a thread of its own
+     *
+     * The decompressed data is handed out in chunks of CHUNK_SIZE bytes. At most
+     * QUEUE_LENGTH chunks are buffered, such that the memory used is bounded no
+     * matter how large the file is, and no decompressed copy is ever written to
+     * disk.
+     */
+    class CompressedFileReader
+    {
+    public:
+        /**
+         * @brief Opens the file and starts the decompression thread
+         * @param[in] node Pointer to the node
+         * @param[in] file_name The name of (or path to) the compressed file
+         */
+        CompressedFileReader(ROSaicNodeBase* node, const std::string& file_name);
+
+        //! Stops the decompression thread and closes the file
+        ~CompressedFileReader();
+
+        /**
+         * @brief Waits for the next chunk of decompressed data
+         * @param[in,out] chunk Storage for the chunk, its previous contents are
+         * recycled
+         * @return False once the end of the file has been reached
+         */
+        bool read(std::vector<uint8_t>& chunk);
+
+        /**
+         * @brief Checks whether a file name has an extension handled by this class
+         * @param[in] file_name The name of (or path to) the file
+         * @return True if the file is gzip or zstd compressed
+         */
+        static bool isCompressed(const std::string& file_name);
+
+    private:
+        //! Supported compression formats
+        enum Codec
+        {
+            GZIP,
+            ZSTD
+        };
+
+        //! Thread function filling the queue
+        void decompress();
+
+        /**
+         * @brief Decompresses up to capacity bytes
+         * @param[out] out Storage for the decompressed data
+         * @param[in] capacity Size of out in bytes
+         * @return Number of bytes decompressed, 0 at the end of the file
+         */
+        std::size_t decompressChunk(uint8_t* out, std::size_t capacity);
+
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! Name of the file
+        std::string file_name_;
+        //! Compression format of the file
+        Codec codec_;
+        //! Handle of the gzip file
+        gzFile gz_file_ = nullptr;
+#ifdef HAVE_ZSTD
+        //! Handle of the zstd file
+        FILE* zstd_file_ = nullptr;
+        //! zstd decompression context
+        ZSTD_DCtx* zstd_context_ = nullptr;
+        //! Compressed input data not yet consumed by zstd
+        std::vector<uint8_t> zstd_input_;
+        //! Position within zstd_input_
+        ZSTD_inBuffer zstd_input_buffer_{nullptr, 0, 0};
+        //! Whether the last zstd frame read is not complete yet
+        bool zstd_frame_open_ = false;
+#endif
+        //! Chunks of decompressed data, in file order
+        std::deque<std::vector<uint8_t>> queue_;
+        //! Chunks handed back by read(), reused to avoid reallocations
+        std::vector<std::vector<uint8_t>> free_chunks_;
+        //! Whether the whole file has been decompressed
+        bool done_ = false;
+        //! Indicator for the decompression thread to exit
+        bool stopping_ = false;
+        //! Mutex protecting the queue
+        boost::mutex queue_mutex_;
+        //! Signals new chunks to the reading thread
+        boost::condition_variable chunk_ready_condition_;
+        //! Signals free queue slots to the decompression thread
+        boost::condition_variable chunk_free_condition_;
+        //! Decompression thread
+        boost::thread decompression_thread_;
+        //! Size of one chunk of decompressed data in bytes
+        static const std::size_t CHUNK_SIZE = 1024 * 1024;
+        //! Maximum number of chunks waiting to be read
+        static const std::size_t QUEUE_LENGTH = 8;
+    };
+} // namespace io_comm_rx
+
+#endif // COMPRESSED_FILE_READER_HPP
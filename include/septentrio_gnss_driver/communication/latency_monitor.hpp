@@ -0,0 +1,120 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef LATENCY_MONITOR_HPP
+#define LATENCY_MONITOR_HPP
+
+// C++ library includes
+#include <array>
+#include <map>
+#include <string>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+#include <septentrio_gnss_driver/communication/latency_statistics.hpp>
+
+/**
+ * @file latency_monitor.hpp
+ * @date 19/10/26
+ * @brief Declares the latencies of the stages a message passes from the socket
+ * to its publication
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class LatencyMonitor
+     * @brief Keeps latency histograms per stage, keyed by SBF block ID or NMEA
+     * sentence, composite message or topic, and reports their percentiles as
+     * diagnostics
+     *
+     * All stages are measured by the parsing thread, the times the I/O thread
+     * handed the bytes over travel with them, hence there is neither a lock nor an
+     * atomic operation on the way of a message.
+     */
+    class LatencyMonitor
+    {
+    public:
+        //! Stages of a message, in the order it passes them
+        enum Stage
+        {
+            //! From the arrival of the last byte until the I/O thread handed it
+            //! over to the parsing thread, keyed by message ID
+            RECEIVE,
+            //! From the handover until the parsing thread took the bytes out of the
+            //! circular buffer, keyed by message ID
+            HANDOFF,
+            //! From then until the message was found in the buffer, keyed by
+            //! message ID
+            DETECTION,
+            //! Decoding the message, publishing excluded, keyed by message ID
+            DECODE,
+            //! Assembling a composite message from the last blocks, publishing
+            //! excluded, keyed by composite message, e.g. NavSatFix
+            ASSEMBLY,
+            //! Publishing a message, keyed by topic
+            PUBLISH,
+            //! From the arrival of the last byte of the triggering message until
+            //! its publication has finished, keyed by topic
+            END_TO_END,
+            STAGES
+        };
+
+        /**
+         * @brief Adds the latency of a stage
+         * @param[in] stage The stage
+         * @param[in] key Message ID, composite message or topic
+         * @param[in] start Time the stage started, nothing is added if 0
+         * @param[in] end Time the stage ended
+         */
+        void add(Stage stage, const std::string& key, Timestamp start,
+                 Timestamp end);
+
+        //! Time spent publishing so far, to be excluded from enclosing stages
+        Timestamp publishingTime() const { return publishing_time_; }
+
+        /**
+         * @brief Reports the percentiles of all stages and forgets the latencies
+         * @return One status per stage, with a value per key
+         */
+        DiagnosticArrayMsg report();
+
+    private:
+        //! Name of a stage in the report
+        static const char* name(Stage stage);
+
+        //! Latencies per stage and key, the keys are kept once seen
+        std::array<std::map<std::string, LatencyStatistics>, STAGES> statistics_;
+
+        //! Sum of the durations of the publications
+        Timestamp publishing_time_ = 0;
+    };
+} // namespace io_comm_rx
+
+#endif // LATENCY_MONITOR_HPP
@@ -0,0 +1,104 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef LATENCY_STATISTICS_HPP
+#define LATENCY_STATISTICS_HPP
+
+// C++ library includes
+#include <array>
+#include <cstdint>
+#include <string>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file latency_statistics.hpp
+ * @date 19/10/26
+ * @brief Declares the statistics of latencies reported periodically
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class LatencyStatistics
+     * @brief Accumulates latencies into a histogram with four buckets per octave
+     * from 1 us to about 4 s, such that percentiles are known to within 19 %
+     *
+     * Adding a latency takes constant time and no allocation. It is not thread
+     * safe, each thread measuring latencies has statistics of its own.
+     */
+    class LatencyStatistics
+    {
+    public:
+        //! Adds a latency in nanoseconds
+        void add(Timestamp latency);
+
+        //! Number of latencies added since the last reset
+        uint64_t count() const { return count_; }
+
+        //! Mean latency in nanoseconds
+        Timestamp mean() const;
+
+        //! Maximum latency in nanoseconds
+        Timestamp max() const { return max_; }
+
+        /**
+         * @brief Upper bound of the latency that the given fraction of the
+         * latencies does not exceed
+         * @param[in] fraction Fraction between 0 and 1, e.g. 0.99
+         * @return Latency in nanoseconds, at most max()
+         */
+        Timestamp percentile(double fraction) const;
+
+        //! Mean, 99th percentile and maximum in microseconds for logging
+        std::string summary() const;
+
+        //! Forgets all latencies
+        void reset();
+
+    private:
+        //! Number of buckets, the first one holds latencies below 1 us
+        static const std::size_t BUCKETS = 1 + 4 * 22;
+
+        //! Number of latencies per bucket
+        std::array<uint64_t, BUCKETS> histogram_{};
+
+        //! Sum of the latencies in nanoseconds
+        double sum_ = 0.0;
+
+        //! Maximum latency
+        Timestamp max_ = 0;
+
+        //! Number of latencies
+        uint64_t count_ = 0;
+    };
+} // namespace io_comm_rx
+
+#endif // LATENCY_STATISTICS_HPP
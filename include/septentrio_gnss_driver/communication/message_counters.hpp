@@ -0,0 +1,179 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MESSAGE_COUNTERS_HPP
+#define MESSAGE_COUNTERS_HPP
+
+// C++ library includes
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file message_counters.hpp
+ * @date 19/10/26
+ * @brief Declares the counters of the messages received and of the failures to
+ * read them
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class MessageCounters
+     * @brief Counts frames, bytes, CRC failures, parse failures and NMEA checksum
+     * failures per SBF block ID or NMEA sentence, as well as the bytes skipped to
+     * find the next message
+     *
+     * The message types are added before counting starts and are fixed
+     * afterwards, messages of other types are counted as OTHER_SBF or OTHER_NMEA.
+     * The counters of a message are looked up by its numeric block ID or its
+     * sentence bytes, without building a key string. The counters are relaxed
+     * atomics, hence they may be read by any thread, e.g. an exporter, while the
+     * parsing thread counts.
+     */
+    class MessageCounters
+    {
+    public:
+        //! Counters of a message type
+        struct Counters
+        {
+            std::atomic<uint64_t> frames{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> crc_failures{0};
+            std::atomic<uint64_t> parse_failures{0};
+            std::atomic<uint64_t> checksum_failures{0};
+
+            //! Counts a frame read successfully and its bytes
+            void frame(std::size_t size)
+            {
+                frames.fetch_add(1, std::memory_order_relaxed);
+                bytes.fetch_add(size, std::memory_order_relaxed);
+            }
+
+            //! Counts an SBF block whose CRC is invalid
+            void crcFailure()
+            {
+                crc_failures.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            //! Counts a message that could not be parsed
+            void parseFailure()
+            {
+                parse_failures.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            //! Counts an NMEA sentence whose checksum is invalid
+            void checksumFailure()
+            {
+                checksum_failures.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
+        MessageCounters();
+
+        /**
+         * @brief Adds a message type
+         *
+         * Must only be called before counting starts.
+         * @param[in] key SBF block ID, e.g. "4007", or NMEA sentence, e.g. "$GPGGA"
+         */
+        void addKey(const std::string& key);
+
+        //! Counters of an SBF block number, those of OTHER_SBF if not added
+        Counters& sbf(uint16_t id) { return *sbf_[id & SBF_ID_MASK]; }
+
+        /**
+         * @brief Counters of an NMEA sentence, those of OTHER_NMEA if not added
+         * @param[in] sentence The sentence, starting with '$'
+         * @param[in] size Number of bytes of the sentence available
+         */
+        Counters& nmea(const uint8_t* sentence, std::size_t size);
+
+        //! Counts bytes skipped while searching for the next message
+        void skipped(std::size_t bytes);
+
+        /**
+         * @brief Status holding the counters of all message types seen so far
+         *
+         * Its level is WARN if there were failures since the last call, which
+         * must only be made by one thread.
+         */
+        DiagnosticStatusMsg diagnostics();
+
+        /**
+         * @brief All counters in the Prometheus text exposition format
+         * @param[in] labels Labels added to all samples, e.g. receiver="rx1", may
+         * be empty
+         */
+        std::string prometheus(const std::string& labels) const;
+
+        //! Key of the SBF blocks of types not added
+        static const char* const OTHER_SBF;
+
+        //! Key of the NMEA sentences of types not added
+        static const char* const OTHER_NMEA;
+
+    private:
+        //! Sum of all failures
+        uint64_t failures() const;
+
+        //! Counters per message type, fixed once counting started
+        std::map<std::string, std::unique_ptr<Counters>> counters_;
+
+        //! Counters per SBF block number, pointing into counters_
+        std::vector<Counters*> sbf_;
+
+        //! Counters per NMEA sentence, pointing into counters_
+        std::vector<std::pair<std::string, Counters*>> nmea_;
+
+        //! Counters of OTHER_NMEA in counters_
+        Counters* other_nmea_;
+
+        //! Number of times bytes were skipped to find the next message
+        std::atomic<uint64_t> resyncs_{0};
+
+        //! Number of bytes skipped
+        std::atomic<uint64_t> skipped_bytes_{0};
+
+        //! Sum of all failures at the last call of diagnostics()
+        uint64_t reported_failures_ = 0;
+
+        //! Mask of the block number in an SBF block ID
+        static const uint16_t SBF_ID_MASK = 0x1FFF;
+    };
+} // namespace io_comm_rx
+
+#endif // MESSAGE_COUNTERS_HPP
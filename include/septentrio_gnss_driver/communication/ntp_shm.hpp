@@ -0,0 +1,127 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef NTP_SHM_HPP
+#define NTP_SHM_HPP
+
+// C++ library includes
+#include <cstdint>
+#include <ctime>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file ntp_shm.hpp
+ * @date 19/10/26
+ * @brief Declares the export of time samples to the shared memory reference
+ * clock of ntpd and chrony
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class NtpShm
+     * @brief Writes samples of the Rx clock into the NTP shared memory segment
+     * (SHM reference clock driver, type 28 of ntpd, "refclock SHM" of chrony)
+     *
+     * A sample consists of the GNSS time of an epoch and the time its first SBF
+     * block was received. Writing only touches the shared memory, no system call
+     * is made.
+     */
+    class NtpShm
+    {
+    public:
+        /**
+         * @brief Attaches to the segment of the given unit, creating it if needed
+         *
+         * Units 0 and 1 are only accessible by root, as ntpd expects, higher units
+         * by everyone.
+         * @param[in] node Pointer to the node
+         * @param[in] unit Unit of the segment, i.e. key 0x4e545030 + unit ("NTP0")
+         */
+        NtpShm(ROSaicNodeBase* node, uint32_t unit);
+
+        //! Detaches from the segment
+        ~NtpShm();
+
+        //! Whether the segment could be attached
+        bool attached() const { return shm_ != nullptr; }
+
+        /**
+         * @brief Writes a sample
+         * @param[in] clock_time Time according to the Rx
+         * @param[in] receive_time Host time the sample was received
+         */
+        void write(Timestamp clock_time, Timestamp receive_time);
+
+        /**
+         * @brief Reads the last sample as ntpd and chrony do in mode 1, e.g. to
+         * check the segment locally without a time server
+         *
+         * The sample is consumed, i.e. marked invalid, such that it is only read
+         * once. It is discarded if it was written to while being read.
+         * @param[out] clock_time Time according to the Rx
+         * @param[out] receive_time Host time the sample was received
+         * @return Whether a valid sample was read
+         */
+        bool read(Timestamp& clock_time, Timestamp& receive_time);
+
+        //! Layout of the segment as defined by ntpd
+        struct ShmTime
+        {
+            int mode;
+            volatile int count;
+            time_t clockTimeStampSec;
+            int clockTimeStampUSec;
+            time_t receiveTimeStampSec;
+            int receiveTimeStampUSec;
+            int leap;
+            int precision;
+            int nsamples;
+            volatile int valid;
+            unsigned clockTimeStampNSec;
+            unsigned receiveTimeStampNSec;
+            int dummy[8];
+        };
+
+        //! Key of unit 0
+        static const int KEY_BASE = 0x4e545030;
+
+    private:
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! The attached segment
+        ShmTime* shm_ = nullptr;
+        //! Precision of the samples as power of 2 in seconds, i.e. about 1 ms
+        static const int PRECISION = -10;
+    };
+} // namespace io_comm_rx
+
+#endif // NTP_SHM_HPP
@@ -101,6 +101,12 @@ namespace pcapReader {
          */
         ReadResult read();
 
+        /**
+         * @brief Sets whether read() pauses after each packet, 1 ms by default
+         * @param[in] pause False to read the packets as fast as possible
+         */
+        void setPause(bool pause) { m_pause = pause; }
+
         //! Destructor for PcapDevice
         ~PcapDevice();
 
@@ -115,6 +121,8 @@ namespace pcapReader {
         char m_errBuff[BUFFSIZE]{};
         char* m_deviceName;
         buffer_t m_lastPkt;
+        //! Whether read() pauses after each packet
+        bool m_pause = true;
     };
 } // namespace pcapReader
 
@@ -0,0 +1,121 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef PROMETHEUS_EXPORTER_HPP
+#define PROMETHEUS_EXPORTER_HPP
+
+// Boost includes
+#include <boost/asio.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+// C++ library includes
+#include <cstdint>
+#include <memory>
+#include <string>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file prometheus_exporter.hpp
+ * @date 19/10/26
+ * @brief Declares a minimal HTTP server exposing metrics to Prometheus
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class PrometheusExporter
+     * @brief Answers HTTP GET requests for /metrics with the metrics in the
+     * Prometheus text exposition format, on a thread of its own
+     *
+     * Each connection is answered once and closed, connections that do not send
+     * a request within REQUEST_TIMEOUT_S are closed as well.
+     */
+    class PrometheusExporter
+    {
+    public:
+        /**
+         * @brief Starts listening
+         * @param[in] node Pointer to the node
+         * @param[in] address Local address to listen on, e.g. 127.0.0.1
+         * @param[in] port Port to listen on
+         * @param[in] metrics Returns the metrics, called by the thread of the
+         * exporter
+         */
+        PrometheusExporter(ROSaicNodeBase* node, const std::string& address,
+                           uint16_t port,
+                           const boost::function<std::string()>& metrics);
+
+        //! Stops listening and joins the thread
+        ~PrometheusExporter();
+
+    private:
+        //! A connection to a client
+        struct Session
+        {
+            explicit Session(boost::asio::io_service& io_service) :
+                socket(io_service), timer(io_service), request(MAX_REQUEST_SIZE)
+            {
+            }
+            boost::asio::ip::tcp::socket socket;
+            boost::asio::deadline_timer timer;
+            boost::asio::streambuf request;
+            std::string response;
+        };
+
+        //! Waits for the next connection
+        void accept();
+
+        //! Reads the request of a new connection
+        void handleAccept(const std::shared_ptr<Session>& session,
+                          const boost::system::error_code& error);
+
+        //! Answers the request
+        void handleRequest(const std::shared_ptr<Session>& session,
+                           const boost::system::error_code& error);
+
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! Returns the metrics
+        boost::function<std::string()> metrics_;
+        //! Runs the handlers
+        boost::asio::io_service io_service_;
+        //! Accepts the connections
+        boost::asio::ip::tcp::acceptor acceptor_;
+        //! Thread running io_service_
+        boost::thread thread_;
+        //! Time a client has to send its request in seconds
+        static const long REQUEST_TIMEOUT_S = 5;
+        //! Maximum size of a request in bytes
+        static const std::size_t MAX_REQUEST_SIZE = 8192;
+    };
+} // namespace io_comm_rx
+
+#endif // PROMETHEUS_EXPORTER_HPP
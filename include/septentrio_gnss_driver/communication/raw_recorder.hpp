@@ -0,0 +1,178 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef RAW_RECORDER_HPP
+#define RAW_RECORDER_HPP
+
+// Boost includes
+#include <boost/thread.hpp>
+// C++ library includes
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+// zlib includes
+#include <zlib.h>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file raw_recorder.hpp
+ * @date 19/10/26
+ * @brief Declares a class recording the raw byte stream of the Rx to disk
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class RawRecorder
+     * @brief Tees the raw bytes received from the Rx into rotating files
+     *
+     * write() is called from the I/O thread and only copies into a lock-free ring
+     * buffer. A writer thread of its own drains the ring in large blocks, so the
+     * reading and parsing of the stream never wait for the disk. If the disk
+     * falls behind and the ring is full, the incoming chunk is dropped as a whole
+     * and counted instead. Bytes that cannot be written because no file could be
+     * opened are counted as dropped as well, opening is retried at the next
+     * rotation only.
+     */
+    class RawRecorder
+    {
+    public:
+        /**
+         * @brief Allocates the ring buffer and starts the writer thread
+         * @param[in] node Pointer to the node
+         * @param[in] path_prefix Path and prefix of the files, a time stamp and the
+         * extension are appended, e.g. "/data/rx" yields
+         * "/data/rx_20201019_120000_0.sbf"
+         * @param[in] max_file_size Size in bytes after which a new file is started,
+         * 0 for no size limit
+         * @param[in] rotation_period_s Seconds after which a new file is started, 0
+         * for no time limit
+         * @param[in] compress Whether the files are gzip compressed
+         * @param[in] buffer_size Size of the ring buffer in bytes, rounded up to a
+         * power of two
+         */
+        RawRecorder(ROSaicNodeBase* node, const std::string& path_prefix,
+                    uint64_t max_file_size, uint32_t rotation_period_s,
+                    bool compress, std::size_t buffer_size);
+
+        //! Writes out what is left in the ring buffer and closes the file
+        ~RawRecorder();
+
+        /**
+         * @brief Queues raw bytes for writing, never blocks
+         *
+         * Must only be called from one thread at a time, i.e. the I/O thread.
+         * @param[in] recvTime Time the bytes were received, unused
+         * @param[in] data The raw bytes
+         * @param[in] size Number of bytes
+         */
+        void write(Timestamp recvTime, const uint8_t* data, std::size_t size);
+
+        //! Number of bytes dropped since the start because the disk fell behind or
+        //! no file was open
+        uint64_t droppedBytes() const { return dropped_bytes_.load(); }
+
+    private:
+        //! Thread function draining the ring buffer to disk
+        void run();
+
+        //! Copies at most the free space of the staging buffer out of the ring
+        std::size_t drainRing();
+
+        //! Writes the staging buffer to the current file and empties it
+        void flushStaging();
+
+        /**
+         * @brief Opens a new file named after the current time
+         *
+         * Failures are logged at most once per minute, the number of failures in
+         * between is reported with the next log.
+         */
+        void openFile();
+
+        //! Closes the current file, if any
+        void closeFile();
+
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! Path and prefix of the files
+        std::string path_prefix_;
+        //! Size in bytes after which a new file is started, 0 if unlimited
+        uint64_t max_file_size_;
+        //! Seconds after which a new file is started, 0 if unlimited
+        uint32_t rotation_period_s_;
+        //! Whether the files are gzip compressed
+        bool compress_;
+        //! Ring buffer between the I/O thread and the writer thread
+        std::vector<uint8_t> ring_;
+        //! Size of ring_ minus 1, ring_ size is a power of two
+        std::size_t ring_mask_;
+        //! Total number of bytes ever written into the ring, only the I/O thread
+        //! modifies it
+        std::atomic<uint64_t> ring_head_{0};
+        //! Total number of bytes ever read from the ring, only the writer thread
+        //! modifies it
+        std::atomic<uint64_t> ring_tail_{0};
+        //! Number of bytes dropped because the ring was full or no file was open
+        std::atomic<uint64_t> dropped_bytes_{0};
+        //! Number of dropped bytes that have already been reported
+        uint64_t reported_dropped_bytes_ = 0;
+        //! Buffer collecting data for one large write
+        std::vector<uint8_t> staging_;
+        //! Number of bytes in staging_
+        std::size_t staged_ = 0;
+        //! File descriptor of the current uncompressed file, -1 if none
+        int fd_ = -1;
+        //! Handle of the current compressed file
+        gzFile gz_file_ = nullptr;
+        //! Name of the current file
+        std::string file_name_;
+        //! Number of bytes written to the current file (before compression)
+        uint64_t file_size_ = 0;
+        //! Wall time the current file was opened at
+        boost::chrono::steady_clock::time_point file_start_;
+        //! Running number of the files, avoids name clashes within one second
+        uint32_t file_count_ = 0;
+        //! Number of failures to open a file that have not been logged yet
+        uint32_t open_failures_ = 0;
+        //! Wall time the last failure to open a file was logged at
+        boost::chrono::steady_clock::time_point last_open_error_;
+        //! Indicator for the writer thread to exit
+        std::atomic<bool> stopping_{false};
+        //! Writer thread
+        boost::thread writer_thread_;
+        //! Size of the staging buffer, i.e. of a regular write, in bytes
+        static const std::size_t WRITE_SIZE = 1024 * 1024;
+    };
+} // namespace io_comm_rx
+
+#endif // RAW_RECORDER_HPP
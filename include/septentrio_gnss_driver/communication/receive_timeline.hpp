@@ -0,0 +1,121 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef RECEIVE_TIMELINE_HPP
+#define RECEIVE_TIMELINE_HPP
+
+// C++ library includes
+#include <cstdint>
+#include <deque>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file receive_timeline.hpp
+ * @date 19/10/26
+ * @brief Declares the receive times of the bytes of a buffer that is parsed
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class ReceiveTimeline
+     * @brief Keeps the receive times of the chunks a parsing buffer consists of,
+     * such that each message can be stamped with the time its last byte arrived
+     *
+     * A chunk, i.e. the result of one read from the stream, is stamped only once
+     * when it has been read completely. The earlier bytes of the chunk arrived
+     * earlier though, at most at the rate of the link (the byte period), and not
+     * before the previous chunk. Within these bounds the receive times are
+     * interpolated linearly from the byte offset.
+     */
+    class ReceiveTimeline
+    {
+    public:
+        /**
+         * @brief Appends a chunk to the end of the buffer
+         * @param[in] size Number of bytes of the chunk
+         * @param[in] end_time Time the last byte of the chunk was received
+         * @param[in] byte_period Duration of the transmission of one byte via the
+         * link in nanoseconds, 0 if the chunk arrived at once (e.g. a datagram)
+         * @param[in] handoff_time Time the I/O thread handed the chunk over to the
+         * parsing thread, 0 if unknown
+         * @param[in] pickup_time Time the parsing thread took the chunk over, 0 if
+         * unknown
+         */
+        void append(std::size_t size, Timestamp end_time, double byte_period,
+                    Timestamp handoff_time = 0, Timestamp pickup_time = 0);
+
+        /**
+         * @brief Receive time of a byte of the buffer
+         * @param[in] offset Offset of the byte from the start of the buffer
+         * @return The interpolated receive time, 0 if the buffer is empty
+         */
+        Timestamp at(std::size_t offset) const;
+
+        //! Time the chunk holding the byte at offset was handed over by the I/O
+        //! thread, 0 if unknown
+        Timestamp handoffTime(std::size_t offset) const;
+
+        //! Time the parsing thread took over the chunk holding the byte at offset, 0
+        //! if unknown
+        Timestamp pickupTime(std::size_t offset) const;
+
+        //! Removes size bytes from the start of the buffer, e.g. once parsed
+        void consume(std::size_t size);
+
+        //! Removes all bytes, the time of the last chunk is kept as lower bound
+        void clear() { chunks_.clear(); }
+
+        //! Whether the buffer is empty
+        bool empty() const { return chunks_.empty(); }
+
+    private:
+        //! A chunk spanning the bytes from the end of the previous chunk to end
+        struct Chunk
+        {
+            std::size_t end;
+            Timestamp start_time;
+            Timestamp end_time;
+            Timestamp handoff_time;
+            Timestamp pickup_time;
+        };
+
+        //! The chunk holding the byte at offset, the last one if beyond the end
+        const Chunk* chunk(std::size_t offset) const;
+
+        //! Chunks of the buffer, usually one or two
+        std::deque<Chunk> chunks_;
+        //! Receive time of the last byte of the previous chunk
+        Timestamp last_time_ = 0;
+    };
+} // namespace io_comm_rx
+
+#endif // RECEIVE_TIMELINE_HPP
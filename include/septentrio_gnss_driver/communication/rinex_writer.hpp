@@ -0,0 +1,235 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef RINEX_WRITER_HPP
+#define RINEX_WRITER_HPP
+
+// Boost includes
+#include <boost/thread.hpp>
+// C++ library includes
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file rinex_writer.hpp
+ * @date 19/10/26
+ * @brief Declares a class writing RINEX 3 observation files from MeasEpoch blocks
+ */
+
+struct Settings;
+
+namespace io_comm_rx {
+
+    /**
+     * @class RinexWriter
+     * @brief Converts MeasEpoch blocks into hourly RINEX 3.04 observation files
+     *
+     * write() is called from the parsing thread and only copies the block into a
+     * lock-free ring buffer. A writer thread of its own decodes the blocks, converts
+     * them into pseudoranges, carrier phases, Dopplers and C/N0 and writes them, so
+     * the parsing never waits for the conversion or the disk. If the ring is full,
+     * the block is dropped and counted instead.
+     *
+     * A new file is started at each full hour of GPS time, named after the RINEX 3
+     * convention, e.g. "SEPT00XXX_R_20202931200_01H_01S_MO.rnx". Since the header
+     * precedes the data, it declares all signals the Rx may track for each system,
+     * the ones not tracked remaining blank.
+     *
+     * Several Rxs of one process must not write to the same files, hence a writer
+     * whose directory and station name are already used by another one stays
+     * inactive.
+     */
+    class RinexWriter
+    {
+    public:
+        /**
+         * @brief Allocates the ring buffer and starts the writer thread, unless the
+         * files are already written by another RinexWriter
+         * @param[in] node Pointer to the node
+         * @param[in] settings Settings, of which those of the RINEX files, the
+         * antenna and the polling period are read
+         */
+        RinexWriter(ROSaicNodeBase* node, const Settings* settings);
+
+        //! Converts what is left in the ring buffer and closes the file
+        ~RinexWriter();
+
+        /**
+         * @brief Queues a MeasEpoch block for conversion, never blocks
+         *
+         * Must only be called from one thread at a time, i.e. the parsing thread,
+         * and only if active().
+         * @param[in] block The CRC-checked SBF block
+         */
+        void write(const uint8_t* block);
+
+        //! Number of blocks dropped since the start because the writer fell behind
+        uint64_t droppedBlocks() const { return dropped_blocks_.load(); }
+
+        //! Whether the writer writes files, i.e. no other one writes them
+        bool active() const { return active_; }
+
+    private:
+        //! Observation of one RINEX observation type, blank if not valid
+        struct Observation
+        {
+            double value = 0.0;
+            bool valid = false;
+            //! Loss of lock indicator, only set for carrier phases
+            uint8_t lli = 0;
+            //! Signal strength indicator 1-9, 0 if none
+            uint8_t ssi = 0;
+        };
+
+        //! Observables of one signal, converted from a Type-1 or Type-2 sub-block
+        struct Measurement
+        {
+            //! Pseudorange in m
+            double code = 0.0;
+            bool code_valid = false;
+            //! Carrier phase in cycles
+            double phase = 0.0;
+            bool phase_valid = false;
+            //! Doppler in Hz
+            double doppler = 0.0;
+            bool doppler_valid = false;
+            //! C/N0 in dB-Hz
+            double cn0 = 0.0;
+            bool cn0_valid = false;
+            //! Lock time in seconds
+            uint32_t lock_time = 0;
+            //! Whether the carrier phase has a half-cycle ambiguity
+            bool half_cycle = false;
+        };
+
+        //! Lock state of a signal, to detect losses of lock between epochs
+        struct Lock
+        {
+            //! Lock time in seconds as given by the Rx
+            uint32_t lock_time;
+            //! GPS time of the epoch in ms
+            uint64_t time_ms;
+        };
+
+        //! Thread function converting the blocks in the ring buffer
+        void run();
+
+        //! Copies the next block out of the ring into block_, if any
+        bool readBlock();
+
+        //! Decodes the block in block_ and writes its epoch
+        void convertBlock();
+
+        //! Sets the observations of one signal of satellite sat
+        void setSignal(const std::string& sat, uint8_t signal,
+                       const Measurement& measurement, uint64_t time_ms);
+
+        //! Opens the file of the hour starting at GPS time hour_ms
+        void openFile(uint64_t hour_ms);
+
+        //! Header of the current file, first epoch at GPS time time_ms
+        std::string headerText(uint64_t time_ms);
+
+        //! Writes the header of the current file, first epoch at GPS time time_ms
+        void writeHeader(uint64_t time_ms);
+
+        //! Closes the current file, if any
+        void closeFile();
+
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! Directory of the files
+        std::string directory_;
+        //! Nine-character station name of the file names
+        std::string station_;
+        //! Marker name of the header
+        std::string marker_name_;
+        //! Antenna serial number and type of the header
+        std::string ant_serial_nr_;
+        std::string ant_type_;
+        //! Marker-to-ARP offsets of the header, up, east, north
+        double delta_h_;
+        double delta_e_;
+        double delta_n_;
+        //! Data frequency field of the file names, e.g. "01S"
+        std::string frequency_;
+        //! Ring buffer between the parsing thread and the writer thread
+        std::vector<uint8_t> ring_;
+        //! Size of ring_ minus 1, ring_ size is a power of two
+        std::size_t ring_mask_;
+        //! Total number of bytes ever written into the ring, only the parsing
+        //! thread modifies it
+        std::atomic<uint64_t> ring_head_{0};
+        //! Total number of bytes ever read from the ring, only the writer thread
+        //! modifies it
+        std::atomic<uint64_t> ring_tail_{0};
+        //! Number of blocks dropped because the ring was full
+        std::atomic<uint64_t> dropped_blocks_{0};
+        //! Number of dropped blocks that have already been reported
+        uint64_t reported_dropped_blocks_ = 0;
+        //! Block being converted
+        std::vector<uint8_t> block_;
+        //! Decoded block being converted
+        MeasEpochMsg msg_;
+        //! Observations of the epoch per satellite, e.g. "G01", in the order of
+        //! the observation types of its system
+        std::map<std::string, std::vector<Observation>> epoch_;
+        //! Lock state per satellite and signal number
+        std::map<std::pair<std::string, uint8_t>, Lock> locks_;
+        //! GLONASS frequency numbers per slot, as seen so far, see GLONASS_K
+        std::map<int, int> glonass_k_;
+        //! Formatted epoch
+        std::string text_;
+        //! Current file, null if none
+        FILE* file_ = nullptr;
+        //! Name of the current file
+        std::string file_name_;
+        //! Start of the hour of the current file in GPS time in ms
+        uint64_t file_hour_ms_ = UINT64_MAX;
+        //! Whether the header of the current file has been written
+        bool header_written_ = false;
+        //! Whether directory_ and station_ were not used by another writer yet
+        bool active_ = false;
+        //! Indicator for the writer thread to exit
+        std::atomic<bool> stopping_{false};
+        //! Writer thread
+        boost::thread writer_thread_;
+        //! Size of the ring buffer in bytes, i.e. at least a few hundred epochs
+        static const std::size_t RING_SIZE = 4 * 1024 * 1024;
+    };
+} // namespace io_comm_rx
+
+#endif // RINEX_WRITER_HPP
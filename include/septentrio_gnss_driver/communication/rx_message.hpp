@@ -56,18 +56,6 @@
 //
 // *****************************************************************************
 
-//! 0x24 is ASCII for $ - 1st byte in each message
-#ifndef NMEA_SYNC_BYTE_1
-#define NMEA_SYNC_BYTE_1 0x24
-#endif
-//! 0x47 is ASCII for G - 2nd byte to indicate NMEA-type ASCII message
-#ifndef NMEA_SYNC_BYTE_2_1
-#define NMEA_SYNC_BYTE_2_1 0x47
-#endif
-//! 0x50 is ASCII for P - 2nd byte to indicate proprietary ASCII message
-#ifndef NMEA_SYNC_BYTE_2_2
-#define NMEA_SYNC_BYTE_2_2 0x50
-#endif
 //! 0x24 is ASCII for $ - 1st byte in each response from the Rx
 #ifndef RESPONSE_SYNC_BYTE_1
 #define RESPONSE_SYNC_BYTE_1 0x24
@@ -76,13 +64,10 @@
 #ifndef RESPONSE_SYNC_BYTE_2
 #define RESPONSE_SYNC_BYTE_2 0x52
 #endif
-//! 0x0D is ASCII for "Carriage Return", i.e. "Enter"
-#ifndef CARRIAGE_RETURN
-#define CARRIAGE_RETURN 0x0D
-#endif
-//! 0x0A is ASCII for "Line Feed", i.e. "New Line"
-#ifndef LINE_FEED
-#define LINE_FEED 0x0A
+//! Longest NMEA sentence awaited to be completed by the next chunk, 82 characters
+//! by the standard, but the Rx's increased lat/lon precision exceeds that
+#ifndef NMEA_MAX_LENGTH
+#define NMEA_MAX_LENGTH 128
 #endif
 //! 0x3F is ASCII for ? - 3rd byte in the response message from the Rx in case the
 //! command was invalid
@@ -102,8 +87,10 @@
 
 // C++ libraries
 #include <cassert> // for assert
+#include <cctype>
 #include <cstddef>
 #include <map>
+#include <memory>
 #include <sstream>
 // Boost includes
 #include <boost/call_traits.hpp>
@@ -112,7 +99,13 @@
 #include <boost/tokenizer.hpp>
 // ROSaic includes
 #include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+#include <septentrio_gnss_driver/communication/clock_estimator.hpp>
+#include <septentrio_gnss_driver/communication/message_counters.hpp>
+#include <septentrio_gnss_driver/communication/ntp_shm.hpp>
+#include <septentrio_gnss_driver/communication/receive_timeline.hpp>
+#include <septentrio_gnss_driver/communication/thread_configuration.hpp>
 #include <septentrio_gnss_driver/crc/crc.h>
+#include <septentrio_gnss_driver/parsers/framing.hpp>
 #include <septentrio_gnss_driver/parsers/nmea_parsers/gpgga.hpp>
 #include <septentrio_gnss_driver/parsers/nmea_parsers/gpgsa.hpp>
 #include <septentrio_gnss_driver/parsers/nmea_parsers/gpgsv.hpp>
@@ -128,9 +121,6 @@
  * @brief Defines a class that reads messages handed over from the circular buffer
  */
 
-extern bool g_read_cd;
-extern uint32_t g_cd_count;
-
 //! Settings struct
 struct Settings
 {
@@ -138,16 +128,35 @@ struct Settings
     bool activate_debug_log;
     //! Device port
     std::string device;
-    //! Delay in seconds between reconnection attempts to the connection type
-    //! specified in the parameter connection_type
+    //! Delay in seconds before the second attempt to connect to the device,
+    //! doubled per further attempt
     float reconnect_delay_s;
+    //! Maximum delay in seconds between attempts to connect to the device
+    float reconnect_max_delay_s;
+    //! Seconds without data from the Rx after which the connection is rebuilt, 0
+    //! to wait forever
+    float reconnect_data_timeout_s;
     //! Baudrate
     uint32_t baudrate;
     //! HW flow control
     std::string hw_flow_control;
+    //! Whether or not the baudrate of the Rx is detected and switched to baudrate
+    bool autobaud;
     //! In case of serial communication to Rx, rx_serial_port specifies Rx's
     //! serial port connected to, e.g. USB1 or COM1
     std::string rx_serial_port;
+    //! Whether or not serial and TCP connections are tuned for low latency
+    bool low_latency;
+    //! Microseconds to busy poll the TCP socket for with low_latency, 0 to not
+    uint32_t low_latency_busy_poll_us;
+    //! Scheduling of the thread reading from the Rx
+    io_comm_rx::ThreadSettings realtime_io;
+    //! Scheduling of the thread parsing what was read
+    io_comm_rx::ThreadSettings realtime_parsing;
+    //! Whether or not memory is locked, such that it cannot be paged out
+    bool realtime_lock_memory;
+    //! MB of heap prefaulted once memory is locked
+    uint32_t realtime_prefault_heap_mb;
     //! Datum to be used
     std::string datum;
     //! Polling period for PVT-related SBF blocks
@@ -288,6 +297,34 @@ struct Settings
     bool publish_pose;
     //! Whether or not to publish the DiagnosticArrayMsg message
     bool publish_diagnostics;
+    //! Whether or not to publish the latencies of the stages of the messages as
+    //! DiagnosticArrayMsg message
+    bool publish_latency_diagnostics;
+    //! Period of the latency diagnostics in seconds
+    uint32_t latency_diagnostics_period;
+    //! Whether or not to publish the message counters as DiagnosticArrayMsg
+    //! message
+    bool publish_message_counters;
+    //! Period of the message counters diagnostics in seconds
+    uint32_t message_counters_period;
+    //! Port the message counters are exported on for Prometheus, disabled if 0
+    uint32_t prometheus_port;
+    //! Address the message counters are exported on for Prometheus
+    std::string prometheus_address;
+    //! Whether or not to publish the raw, CRC-validated SBF blocks
+    bool publish_raw_sbf;
+    //! Block numbers of the raw SBF blocks to be published, all if empty
+    std::vector<int32_t> raw_sbf_block_ids;
+    //! Whether or not to publish the ClockEstimateMsg message
+    bool publish_clockestimate;
+    //! Duration of GNSS time the clock estimate is fitted over in seconds
+    double clock_estimate_window;
+    //! Whether or not SBF blocks are stamped with their GNSS time converted to
+    //! host time via the clock estimate, if use_gnss_time is false
+    bool clock_estimate_correct_stamps;
+    //! Unit of the NTP shared memory segment time samples are written to, none if
+    //! negative
+    int32_t ntp_shm_unit;
     //! Whether or not to publish the ImuMsg message
     bool publish_imu;
     //! Whether or not to publish the LocalizationMsg message
@@ -320,6 +357,40 @@ struct Settings
     bool read_from_sbf_log;
     //! Whether or not we are reading from a PCAP file
     bool read_from_pcap;
+    //! Whether or not we only receive from the Rx (UDP, Unix domain socket or named
+    //! pipe), in which case the Rx is not configured
+    bool receive_only;
+    //! Number of threads decoding an SBF file, if greater than 1 the file is
+    //! decoded as fast as possible instead of being played back in real time
+    uint32_t decode_threads;
+    //! Whether SBF and PCAP files are played back in real time, otherwise they
+    //! are decoded as fast as possible
+    bool file_reading_realtime;
+    //! Path and prefix of the files the raw Rx stream is recorded to, empty if
+    //! recording is disabled
+    std::string raw_recording_path;
+    //! Size in MB after which a new recording file is started, 0 for no limit
+    uint32_t raw_recording_max_file_size_mb;
+    //! Period in seconds after which a new recording file is started, 0 for no
+    //! limit
+    uint32_t raw_recording_rotation_period_s;
+    //! Whether or not recording files are gzip compressed
+    bool raw_recording_compress;
+    //! Size in MB of the buffer absorbing disk stalls during recording
+    uint32_t raw_recording_buffer_size_mb;
+    //! Size in MB of the in-memory ring of the most recent raw Rx data, 0 if
+    //! disabled
+    uint32_t black_box_size_mb;
+    //! Path and prefix of the files the black box ring is dumped to
+    std::string black_box_path;
+    //! Directory of the RINEX observation files, empty if RINEX writing is
+    //! disabled
+    std::string rinex_path;
+    //! Marker name of the RINEX observation files, the first four characters
+    //! of which name the files
+    std::string rinex_marker_name;
+    //! Path and prefix of the Chrome trace files, if built with tracing
+    std::string trace_path;
 };
 
 //! Enum for NavSatFix's status.status field, which is obtained from PVTGeodetic's
@@ -381,6 +452,8 @@ enum RxID_Enum
 };
 
 namespace io_comm_rx {
+
+    class RinexWriter;
    
     /**
      * @class RxMessage
@@ -463,6 +536,14 @@ namespace io_comm_rx {
             };
 
             rx_id_map = RxIDMap(rx_id_pairs, rx_id_pairs + evReceiverSetup + 1);
+
+            // Counted per SBF block ID and NMEA sentence, the other keys are no
+            // message identifiers
+            for (const auto& rx_id : rx_id_map)
+            {
+                if (rx_id.first[0] == '$' || std::isdigit(static_cast<unsigned char>(rx_id.first[0])))
+                    counters_.addKey(rx_id.first);
+            }
         }
 
          /**
@@ -470,17 +551,46 @@ namespace io_comm_rx {
          * @param[in] recvTimestamp Timestamp of receiving buffer
          * @param[in] data Pointer to the buffer that is about to be analyzed
          * @param[in] size Size of the buffer (as handed over by async_read_some)
+         * @param[in] timeline Receive times of the bytes of the buffer, if known
          */
-        void newData(Timestamp recvTimestamp, const uint8_t* data, std::size_t& size)
+        void newData(Timestamp recvTimestamp, const uint8_t* data, std::size_t& size,
+                     const ReceiveTimeline* timeline = nullptr)
         {
             recvTimestamp_ = recvTimestamp;
+            timeline_ = timeline;
+            buffer_ = data;
             data_ = data;
             count_ = size;
             found_ = false;
             crc_check_ = false;
             message_size_ = 0;
+            resync_ = true;
         }
 
+        /**
+         * @brief Feeds the GNSS and receive time of the SBF block at hand into the
+         * clock estimator, publishing the estimate once it is updated, and into the
+         * NTP shared memory segment, if enabled
+         *
+         * Must be called once per complete, CRC-validated SBF block.
+         */
+        void updateTimeReferences();
+
+        /**
+         * @brief Receive time of the last byte of the message at hand, interpolated
+         * from its offset within the buffer if the receive times of the bytes are
+         * known, otherwise the receive time of the buffer
+         */
+        Timestamp recvTime();
+
+        //! Time the I/O thread handed the last byte of the message at hand over to
+        //! the parsing thread, 0 if unknown
+        Timestamp handoffTime();
+
+        //! Time the parsing thread took over the last byte of the message at hand, 0
+        //! if unknown
+        Timestamp pickupTime();
+
         //! Determines whether data_ points to the SBF block with ID "ID", e.g. 5003
         bool isMessage(const uint16_t ID);
         //! Determines whether data_ points to the NMEA message with ID "ID", e.g.
@@ -505,6 +615,54 @@ namespace io_comm_rx {
         //! moment, SBF identifiers embellished with inverted commas, e.g. "5003"
         std::string messageID();
 
+        /**
+         * @brief Counts a received connection descriptor, at most up to 3
+         * @return The number of connection descriptors received so far
+         */
+        uint32_t countConnectionDescriptor()
+        {
+            if (cd_count_ < 3)
+                ++cd_count_;
+            return cd_count_;
+        }
+
+        //! Counters of the messages read and of the failures to read them
+        MessageCounters& counters() { return counters_; }
+
+        /**
+         * @brief Counters of the message where data_ is pointing at at the moment,
+         * looked up by its block ID or sentence rather than by messageID()
+         *
+         * For SBF, the header up to the ID must be available.
+         */
+        MessageCounters::Counters& messageCounters();
+
+        //! Reads the connection descriptors anew, e.g. after reconnecting
+        void resetConnectionDescriptor()
+        {
+            read_cd_ = true;
+            cd_count_ = 0;
+        }
+
+        //! Hands MeasEpoch blocks over to rinex_writer, null to stop
+        void setRinexWriter(RinexWriter* rinex_writer)
+        {
+            rinex_writer_ = rinex_writer;
+        }
+
+        /**
+         * @brief Validates the CRC of the SBF block data_ is currently pointing at
+         *
+         * If it fails, the next search starts right after the sync bytes instead of
+         * after the block, since its length field cannot be trusted either.
+         * @return True if the CRC check passed, false otherwise
+         */
+        bool checkCrc()
+        {
+            crc_check_ = isValid(data_);
+            return crc_check_;
+        }
+
         /**
          * @brief Returns the count_ variable
          * @return The variable count_
@@ -614,6 +772,63 @@ namespace io_comm_rx {
          */
         Timestamp recvTimestamp_;
 
+        /**
+         * @brief Receive times of the bytes of the buffer, null if unknown
+         */
+        const ReceiveTimeline* timeline_ = nullptr;
+
+        /**
+         * @brief Converts MeasEpoch blocks into RINEX files, null if disabled
+         */
+        RinexWriter* rinex_writer_ = nullptr;
+
+        //! Offset of the last byte of the message at hand from the start of the
+        //! buffer
+        std::size_t lastByteOffset();
+
+        //! Counts a parse failure of the message at hand
+        void countParseFailure();
+
+        /**
+         * @brief Counters of the messages read and of the failures to read them
+         */
+        MessageCounters counters_;
+
+        /**
+         * @brief Whether bytes skipped by the next search are out of sync, i.e. the
+         * search starts at the beginning of the buffer or after an SBF block
+         *
+         * After NMEA sentences and command replies the search only moves on by
+         * one byte and walks through their remainder.
+         */
+        bool resync_ = true;
+
+        /**
+         * @brief Start of the buffer handed over by newData()
+         */
+        const uint8_t* buffer_ = nullptr;
+
+        /**
+         * @brief Estimates the offset of the host clock from GNSS time
+         */
+        ClockEstimator clock_estimator_;
+
+        /**
+         * @brief NTP shared memory segment, attached once the first sample arrives
+         */
+        std::shared_ptr<NtpShm> ntp_shm_;
+
+        /**
+         * @brief GNSS time of the last sample written to ntp_shm_
+         */
+        Timestamp last_ntp_sample_ = 0;
+
+        /**
+         * @brief Jump back of the GNSS time after which samples are written to
+         * ntp_shm_ again, in nanoseconds
+         */
+        static const Timestamp NTP_SHM_TIME_JUMP = 60000000000;
+
         /**
          * @brief Pointer to the buffer of messages
          */
@@ -746,6 +961,14 @@ namespace io_comm_rx {
         //! time stamps found in the SBF blocks therein.
         Timestamp unix_time_;
 
+        //! Whether or not we still want to read the connection descriptor, which we
+        //! only want in the very beginning to know whether it is IP10, IP11 etc.
+        bool read_cd_ = true;
+
+        //! Since after SSSSSSSSSSS we need to wait for second connection descriptor,
+        //! we have to count the connection descriptors
+        uint32_t cd_count_ = 0;
+
         //! For GPSFix: Whether the ChannelStatus block of the current epoch has arrived or
         //! not
         bool channelstatus_has_arrived_gpsfix_ = false;
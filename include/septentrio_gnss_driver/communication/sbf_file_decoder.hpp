@@ -0,0 +1,167 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef SBF_FILE_DECODER_HPP
+#define SBF_FILE_DECODER_HPP
+
+// Boost includes
+#include <boost/thread.hpp>
+#include <boost/thread/condition.hpp>
+// C++ library includes
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/communication/callback_handlers.hpp>
+#include <septentrio_gnss_driver/parsers/framing.hpp>
+
+/**
+ * @file sbf_file_decoder.hpp
+ * @date 19/10/26
+ * @brief Declares a class for decoding large SBF files with several threads
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class SBFFileDecoder
+     * @brief Decodes an SBF file with several threads instead of one
+     *
+     * The file is memory-mapped and cut into chunks of CHUNK_SIZE bytes. Worker
+     * threads resynchronize each chunk to its first CRC-valid SBF block (or NMEA
+     * sentence with valid checksum) and index all frames starting within it,
+     * sorted by (WNc, TOW). The calling thread merges the indexed chunks in this
+     * order and hands the frames over to the callback handlers. Since the
+     * composite messages (GPSFix, Pose, ...) are thus assembled from one single
+     * ordered stream, blocks of one epoch that straddle a chunk boundary are
+     * combined just as in the single-threaded case.
+     */
+    class SBFFileDecoder
+    {
+    public:
+        /**
+         * @brief Constructor of the class SBFFileDecoder
+         * @param[in] node Pointer to the node
+         * @param[in] handlers Callback handlers the frames are handed over to
+         * @param[in] threads Number of worker threads indexing the chunks
+         */
+        SBFFileDecoder(ROSaicNodeBase* node, CallbackHandlers* handlers,
+                       uint32_t threads);
+
+        //! Unmaps the file, if still mapped
+        ~SBFFileDecoder();
+
+        /**
+         * @brief Decodes the whole file, returns once done or once stopping is set
+         * @param[in] file_name The name of (or path to) the SBF file
+         * @param[in] stopping Indicator for the decoding to be aborted
+         */
+        void decode(const std::string& file_name, const std::atomic<bool>& stopping);
+
+    private:
+        //! Single SBF block or NMEA sentence found in the file
+        struct Frame
+        {
+            //! Ordering key, WNc in the upper and TOW in the lower 32 bits
+            uint64_t key;
+            //! Offset of the first sync byte within the file
+            std::size_t offset;
+            //! Length of the frame in bytes
+            std::size_t length;
+        };
+
+        //! Part of the file indexed by one worker
+        struct Chunk
+        {
+            //! Frames starting within the chunk, sorted by key
+            std::vector<Frame> frames;
+            //! Offset of the first frame found
+            std::size_t lead = 0;
+            //! End of the last frame, may lie beyond the chunk
+            std::size_t tail = 0;
+            //! Number of bytes skipped between the first and the last frame
+            std::size_t skipped = 0;
+            //! Whether the worker is done with this chunk
+            bool ready = false;
+        };
+
+        /**
+         * @brief Takes chunks from the queue and indexes them until all are done
+         */
+        void work();
+
+        /**
+         * @brief Indexes all frames starting within [begin, end)
+         * @param[in] begin Offset of the first byte of the chunk
+         * @param[in] end Offset past the last byte of the chunk
+         * @param[out] chunk Storage for the found frames
+         */
+        void indexChunk(std::size_t begin, std::size_t end, Chunk& chunk) const;
+
+        /**
+         * @brief Hands the frames [first, last) over to the callback handlers,
+         * grouping frames that are contiguous in the file into single calls
+         */
+        void dispatch(std::vector<Frame>::const_iterator first,
+                      std::vector<Frame>::const_iterator last);
+
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! Callback handlers for the decoded frames
+        CallbackHandlers* handlers_;
+        //! Number of worker threads
+        uint32_t threads_;
+        //! Start of the memory-mapped file
+        const uint8_t* data_ = nullptr;
+        //! Size of the file in bytes
+        std::size_t size_ = 0;
+        //! Indexed chunks, in file order
+        std::vector<Chunk> chunks_;
+        //! Next chunk to be taken by a worker
+        std::size_t next_chunk_ = 0;
+        //! Next chunk to be merged by the calling thread
+        std::size_t merged_chunk_ = 0;
+        //! Indicator for the workers to exit
+        bool abort_ = false;
+        //! Mutex protecting the chunk queue
+        boost::mutex chunk_mutex_;
+        //! Signals finished chunks to the calling thread
+        boost::condition_variable chunk_ready_condition_;
+        //! Signals merged chunks to the workers
+        boost::condition_variable chunk_free_condition_;
+        //! Size of one chunk in bytes
+        static const std::size_t CHUNK_SIZE = 32 * 1024 * 1024;
+        //! Number of chunks per thread that may be indexed ahead of the merge
+        static const std::size_t CHUNKS_AHEAD_PER_THREAD = 2;
+    };
+} // namespace io_comm_rx
+
+#endif // SBF_FILE_DECODER_HPP
@@ -0,0 +1,109 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef THREAD_CONFIGURATION_HPP
+#define THREAD_CONFIGURATION_HPP
+
+// C++ library includes
+#include <cstdint>
+#include <pthread.h>
+#include <string>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file thread_configuration.hpp
+ * @date 19/10/26
+ * @brief Declares the real-time configuration of the driver threads and of its
+ * memory
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @brief Scheduling of a driver thread
+     */
+    struct ThreadSettings
+    {
+        //! Scheduling policy, "other", "fifo" or "rr"
+        std::string policy = "other";
+        //! Priority with "fifo" and "rr", from 1 to 99
+        int32_t priority = 0;
+        //! CPUs the thread may run on, any if empty
+        std::vector<int32_t> cpus;
+
+        //! Whether the thread is left as it was created
+        bool isDefault() const { return policy == "other" && cpus.empty(); }
+    };
+
+    /**
+     * @brief Gets the scheduling of a thread from the parameters
+     * realtime/<name>/policy, realtime/<name>/priority and realtime/<name>/cpus
+     * @param[in] node Pointer to the node
+     * @param[in] name Name of the thread in the parameters, e.g. "io"
+     * @param[out] settings Scheduling of the thread
+     */
+    void getThreadSettings(ROSaicNodeBase* node, const std::string& name,
+                           ThreadSettings& settings);
+
+    /**
+     * @brief Applies scheduling policy, priority and CPU affinity to a running
+     * thread
+     *
+     * Real-time policies need CAP_SYS_NICE or a sufficient RLIMIT_RTPRIO,
+     * otherwise the thread keeps its scheduling and a warning is logged.
+     * @param[in] node Pointer to the node
+     * @param[in] thread Native handle of the thread
+     * @param[in] name Name of the thread for logging
+     * @param[in] settings Scheduling of the thread
+     * @return Whether all settings could be applied
+     */
+    bool configureThread(ROSaicNodeBase* node, pthread_t thread,
+                         const std::string& name, const ThreadSettings& settings);
+
+    /**
+     * @brief Locks the current and future memory of the process and prefaults
+     * heap, such that the driver threads do not stall on page faults
+     *
+     * Freed heap is kept by the process from then on rather than returned to the
+     * system, such that the prefaulted heap serves later allocations.
+     * @param[in] node Pointer to the node
+     * @param[in] prefault_heap Number of bytes of heap to prefault
+     * @return Whether memory could be locked
+     */
+    bool lockMemory(ROSaicNodeBase* node, std::size_t prefault_heap);
+
+    //! Current time of the monotonic clock in nanoseconds, for scheduling
+    //! latencies that must not depend on ROS or wall clock time
+    Timestamp monotonicTime();
+} // namespace io_comm_rx
+
+#endif // THREAD_CONFIGURATION_HPP
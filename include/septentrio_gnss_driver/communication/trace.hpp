@@ -0,0 +1,136 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+/**
+ * @file trace.hpp
+ * @date 19/10/26
+ * @brief Declares the tracepoints of the parsing pipeline
+ *
+ * The tracepoints are compiled out unless ROSAIC_TRACING is defined, i.e. unless
+ * built with -DROSAIC_TRACING=ON. If ROSAIC_TRACING_LTTNG is defined as well, the
+ * spans are emitted via LTTng-UST, otherwise they are kept in per-thread
+ * in-memory rings, which may be dumped as Chrome trace JSON.
+ */
+
+#ifdef ROSAIC_TRACING
+
+// C++ library includes
+#include <cstdint>
+#include <string>
+
+namespace io_comm_rx {
+    namespace trace {
+
+        //! Maximum length of span names, longer ones are truncated
+        static const std::size_t NAME_SIZE = 32;
+
+        //! Spans kept per thread, the oldest are overwritten
+        static const std::size_t EVENTS_PER_THREAD = 32768;
+
+        //! Current host time in nanoseconds since the epoch, the time base of
+        //! ROSaic's Timestamps unless simulated time is used
+        uint64_t now();
+
+        /**
+         * @brief Records a span of the calling thread
+         * @param[in] category Category, a string literal
+         * @param[in] name Name, truncated to NAME_SIZE - 1 characters
+         * @param[in] start Start in nanoseconds since the epoch
+         * @param[in] end End in nanoseconds since the epoch
+         */
+        void span(const char* category, const char* name, uint64_t start,
+                  uint64_t end);
+
+        //! Records a span of the calling thread, see above
+        inline void span(const char* category, const std::string& name,
+                         uint64_t start, uint64_t end)
+        {
+            span(category, name.c_str(), start, end);
+        }
+
+        /**
+         * @brief Writes the spans of all threads as Chrome trace JSON, e.g. to be
+         * opened in chrome://tracing or Perfetto
+         * @param[in] file_name Name of the file
+         * @param[out] message Error message, if any
+         * @return True if the file was written, false otherwise
+         */
+        bool dump(const std::string& file_name, std::string& message);
+
+        /**
+         * @class Scope
+         * @brief Records the span from its construction to its destruction
+         */
+        class Scope
+        {
+        public:
+            Scope(const char* category, const char* name);
+
+            Scope(const char* category, const std::string& name) :
+                Scope(category, name.c_str())
+            {
+            }
+
+            ~Scope() { span(category_, name_, start_, now()); }
+
+        private:
+            const char* category_;
+            char name_[NAME_SIZE];
+            uint64_t start_;
+        };
+    } // namespace trace
+} // namespace io_comm_rx
+
+#define ROSAIC_TRACE_CONCAT_(a, b) a##b
+#define ROSAIC_TRACE_CONCAT(a, b) ROSAIC_TRACE_CONCAT_(a, b)
+//! Records the span until the end of the enclosing scope
+#define ROSAIC_TRACE_SCOPE(category, name)                                       \
+    ::io_comm_rx::trace::Scope ROSAIC_TRACE_CONCAT(rosaic_trace_scope_,          \
+                                                   __LINE__)(category, name)
+//! Records a span whose start and end, in nanoseconds since the epoch, are known
+#define ROSAIC_TRACE_SPAN(category, name, start, end)                            \
+    ::io_comm_rx::trace::span(category, name, start, end)
+
+#else
+
+#define ROSAIC_TRACE_SCOPE(category, name)                                       \
+    do                                                                           \
+    {                                                                            \
+    } while (0)
+#define ROSAIC_TRACE_SPAN(category, name, start, end)                            \
+    do                                                                           \
+    {                                                                            \
+    } while (0)
+
+#endif // ROSAIC_TRACING
+
+#endif // TRACE_HPP
@@ -0,0 +1,58 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**
+ * @file trace_tp.h
+ * @date 19/10/26
+ * @brief LTTng-UST tracepoint provider of the spans of the parsing pipeline,
+ * only included with ROSAIC_TRACING_LTTNG
+ */
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER septentrio_gnss_driver
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "septentrio_gnss_driver/communication/trace_tp.h"
+
+#if !defined(TRACE_TP_H) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define TRACE_TP_H
+
+#include <lttng/tracepoint.h>
+
+// Start and end in nanoseconds since the epoch
+TRACEPOINT_EVENT(septentrio_gnss_driver, span,
+                 TP_ARGS(const char*, category, const char*, name, uint64_t, start,
+                         uint64_t, end),
+                 TP_FIELDS(ctf_string(category, category) ctf_string(name, name)
+                               ctf_integer(uint64_t, start, start)
+                                   ctf_integer(uint64_t, end, end)))
+
+#endif // TRACE_TP_H
+
+#include <lttng/tracepoint-event.h>
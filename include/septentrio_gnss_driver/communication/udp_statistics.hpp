@@ -0,0 +1,117 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef UDP_STATISTICS_HPP
+#define UDP_STATISTICS_HPP
+
+// C++ library includes
+#include <cstdint>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+
+/**
+ * @file udp_statistics.hpp
+ * @date 19/10/26
+ * @brief Declares a class detecting lost and reordered datagrams of a UDP stream
+ */
+
+namespace io_comm_rx {
+
+    /**
+     * @class UdpStatistics
+     * @brief Checks the framing of each datagram of an SBF/NMEA stream received
+     * via UDP and periodically reports lost and reordered datagrams
+     *
+     * UDP does not number the datagrams, hence losses are inferred from the
+     * framing: A datagram that does not continue the message the previous one ended
+     * in, or that starts in the middle of a message although the previous one ended
+     * on a message boundary, implies a gap, i.e. at least one datagram was lost in
+     * between or arrives out of order. A datagram is counted as reordered if its
+     * first SBF block is older (in WNc and TOW) than a block of an earlier datagram.
+     */
+    class UdpStatistics
+    {
+    public:
+        /**
+         * @brief Constructor of the class UdpStatistics
+         * @param[in] node Pointer to the node
+         * @param[in] report_period_s Seconds between two reports
+         */
+        UdpStatistics(ROSaicNodeBase* node, uint32_t report_period_s = 10);
+
+        /**
+         * @brief Analyzes a datagram, to be called from the I/O thread for each one
+         * @param[in] recvTime Time the datagram was received
+         * @param[in] data The datagram
+         * @param[in] size Size of the datagram in bytes
+         */
+        void datagram(Timestamp recvTime, const uint8_t* data, std::size_t size);
+
+    private:
+        //! Checks the framing of a datagram and counts gaps, reordering and
+        //! corrupt blocks
+        void analyze(const uint8_t* data, std::size_t size);
+
+        //! Logs the numbers since the last report
+        void report(Timestamp recvTime);
+
+        //! Pointer to the node
+        ROSaicNodeBase* node_;
+        //! Nanoseconds between two reports
+        uint64_t report_period_;
+        //! Time of the last report, 0 before the first datagram
+        Timestamp last_report_ = 0;
+        //! Whether the last datagram ended within a message
+        bool continuation_ = false;
+        //! Bytes missing to complete the message the last datagram ended in, 0 if
+        //! unknown
+        std::size_t pending_ = 0;
+        //! Latest SBF time (WNc and TOW) in ms received so far
+        uint64_t latest_time_ = 0;
+        //! Number of datagrams since the last report
+        uint64_t datagrams_ = 0;
+        //! Number of bytes since the last report
+        uint64_t bytes_ = 0;
+        //! Number of gaps, i.e. lost or reordered datagrams, since the last report
+        uint64_t gaps_ = 0;
+        //! Number of reordered datagrams since the last report
+        uint64_t reordered_ = 0;
+        //! Number of complete SBF blocks failing the CRC check since the last report
+        uint64_t corrupt_ = 0;
+        //! Total number of datagrams
+        uint64_t total_datagrams_ = 0;
+        //! Total number of gaps
+        uint64_t total_gaps_ = 0;
+        //! Total number of reordered datagrams
+        uint64_t total_reordered_ = 0;
+    };
+} // namespace io_comm_rx
+
+#endif // UDP_STATISTICS_HPP
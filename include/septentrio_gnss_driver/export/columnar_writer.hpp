@@ -0,0 +1,254 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef COLUMNAR_WRITER_HPP
+#define COLUMNAR_WRITER_HPP
+
+// C++ library includes
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file columnar_writer.hpp
+ * @date 19/10/26
+ * @brief Declares a writer of column-oriented files, Arrow IPC if built with
+ * Arrow, otherwise a native format
+ */
+
+namespace sbf_export {
+
+    //! Types of the columns, valued as their codes in the native format
+    enum class ColumnType : uint8_t
+    {
+        UInt8 = 0,
+        Int8 = 1,
+        UInt16 = 2,
+        UInt32 = 3,
+        Int32 = 4,
+        Float32 = 5,
+        Float64 = 6
+    };
+
+    //! Size of a value of a column type in bytes
+    std::size_t columnWidth(ColumnType type);
+
+    //! Column type of values of type T, defined for the types of ColumnType only
+    template <typename T>
+    struct ColumnTypeOf;
+    template <>
+    struct ColumnTypeOf<uint8_t>
+    {
+        static const ColumnType value = ColumnType::UInt8;
+    };
+    template <>
+    struct ColumnTypeOf<int8_t>
+    {
+        static const ColumnType value = ColumnType::Int8;
+    };
+    template <>
+    struct ColumnTypeOf<uint16_t>
+    {
+        static const ColumnType value = ColumnType::UInt16;
+    };
+    template <>
+    struct ColumnTypeOf<uint32_t>
+    {
+        static const ColumnType value = ColumnType::UInt32;
+    };
+    template <>
+    struct ColumnTypeOf<int32_t>
+    {
+        static const ColumnType value = ColumnType::Int32;
+    };
+    template <>
+    struct ColumnTypeOf<float>
+    {
+        static const ColumnType value = ColumnType::Float32;
+    };
+    template <>
+    struct ColumnTypeOf<double>
+    {
+        static const ColumnType value = ColumnType::Float64;
+    };
+
+    //! Column of a file
+    struct Column
+    {
+        std::string name;
+        ColumnType type;
+    };
+
+    //! Formats of the files
+    enum class Format
+    {
+        //! Row groups of little-endian columns, see README
+        Native,
+        //! Arrow IPC file, one record batch per row group
+        Arrow
+    };
+
+    //! Whether the Arrow IPC format is available, i.e. built with Arrow
+    bool arrowAvailable();
+
+    /**
+     * @class ColumnarWriter
+     * @brief Writes the rows of one table into a column-oriented file
+     *
+     * Rows are collected column by column into batches of batch_rows rows. Full
+     * batches are handed over to a thread of the writer, which writes them as
+     * row groups while the next batch is filled. If the thread lags behind by
+     * BATCHES_IN_FLIGHT batches, the caller waits for it.
+     */
+    class ColumnarWriter
+    {
+    public:
+        /**
+         * @param[in] file_name Name of the file, overwritten if it exists
+         * @param[in] columns Columns of the table
+         * @param[in] format Format of the file
+         * @param[in] batch_rows Number of rows per batch, i.e. per row group
+         */
+        ColumnarWriter(const std::string& file_name,
+                       const std::vector<Column>& columns, Format format,
+                       std::size_t batch_rows);
+
+        //! Closes the file, if still open
+        ~ColumnarWriter();
+
+        /**
+         * @brief Creates the file, writes its header and starts the thread
+         * @param[out] error Description of the failure if any
+         * @return Whether the file could be created
+         */
+        bool open(std::string& error);
+
+        /**
+         * @brief Sets a value of the current row
+         *
+         * Types without column type do not compile, a value of another type than
+         * its column throws std::invalid_argument, also in release builds.
+         * @param[in] column Index of the column, whose type has to be T
+         * @param[in] value The value
+         */
+        template <typename T>
+        void set(std::size_t column, T value)
+        {
+            if (columns_[column].type != ColumnTypeOf<T>::value)
+                throw std::invalid_argument("Value of another type than column " +
+                                            columns_[column].name);
+            std::memcpy(batch_->columns[column].data() + batch_->rows * sizeof(T),
+                        &value, sizeof(T));
+        }
+
+        //! Completes the current row, all of whose values have been set
+        void endRow()
+        {
+            ++rows_;
+            if (++batch_->rows == batch_rows_)
+                submit();
+        }
+
+        /**
+         * @brief Writes the last batch, stops the thread and closes the file
+         * @param[out] error Description of the first failure to write, if any
+         * @return Whether all rows were written
+         */
+        bool close(std::string& error);
+
+        //! Name of the file
+        const std::string& fileName() const { return file_name_; }
+
+        //! Number of rows completed so far
+        uint64_t rows() const { return rows_; }
+
+    private:
+        //! Rows collected column by column
+        struct Batch
+        {
+            std::size_t rows = 0;
+            std::vector<std::vector<uint8_t>> columns;
+        };
+
+        //! State of the Arrow IPC writer, defined if built with Arrow only
+        struct ArrowState;
+
+        //! Hands the current batch over to the thread and takes a free one
+        void submit();
+
+        //! Writes the batches handed over until closing
+        void run();
+
+        bool writeHeader(std::string& error);
+
+        bool writeBatch(const Batch& batch, std::string& error);
+
+        bool finish(std::string& error);
+
+        std::string file_name_;
+        std::vector<Column> columns_;
+        std::vector<std::size_t> widths_;
+        Format format_;
+        std::size_t batch_rows_;
+
+        //! Batch being filled
+        std::unique_ptr<Batch> batch_;
+        uint64_t rows_ = 0;
+
+        std::mutex mutex_;
+        //! Signals batches to be written to the thread
+        std::condition_variable full_condition_;
+        //! Signals written batches to the caller
+        std::condition_variable free_condition_;
+        std::deque<std::unique_ptr<Batch>> full_batches_;
+        std::deque<std::unique_ptr<Batch>> free_batches_;
+        bool closing_ = false;
+        //! First failure to write, the following batches are discarded
+        std::string error_;
+        std::thread thread_;
+
+        //! File of the native format
+        FILE* file_ = nullptr;
+        std::unique_ptr<ArrowState> arrow_;
+
+        //! Batches allocated per writer, the one being filled included
+        static const std::size_t BATCHES_IN_FLIGHT = 4;
+    };
+} // namespace sbf_export
+
+#endif // COLUMNAR_WRITER_HPP
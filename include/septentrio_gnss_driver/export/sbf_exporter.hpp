@@ -0,0 +1,148 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef SBF_EXPORTER_HPP
+#define SBF_EXPORTER_HPP
+
+// C++ library includes
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/interfaces.hpp>
+#include <septentrio_gnss_driver/export/columnar_writer.hpp>
+#include <septentrio_gnss_driver/packed_structs/sbf_structs.hpp>
+
+/**
+ * @file sbf_exporter.hpp
+ * @date 19/10/26
+ * @brief Declares the export of decoded SBF blocks into column-oriented files
+ */
+
+namespace sbf_export {
+
+    //! Settings of the export, from the command line
+    struct ExportSettings
+    {
+        //! Prefix of the files, followed by "_<block>.<extension>"
+        std::string output_prefix;
+        //! Block types to be exported, see SBFExporter::blockTypes()
+        std::vector<std::string> blocks;
+        //! Format of the files
+        Format format = Format::Native;
+        //! Number of rows per batch, i.e. per row group or record batch
+        std::size_t batch_rows = 65536;
+    };
+
+    /**
+     * @class SBFExporter
+     * @brief Decodes SBF files and writes one table per block type
+     *
+     * Files are memory-mapped and their blocks decoded in the calling thread,
+     * by the parsers of the decoder library. Each block type has its own
+     * ColumnarWriter, whose thread writes the full batches. The tables hold the
+     * fields as decoded, in the units and with the do-not-use values of the SBF
+     * reference guide:
+     * - PVTGeodetic and INSNavGeod: one row per block, the absent sub-blocks of
+     *   INSNavGeod being do-not-use values
+     * - MeasEpoch: one row per signal, the Type-2 sub-blocks following their
+     *   Type-1 sub-block, whose rx_channel and sv_id they repeat
+     * - ChannelStatus: one row per ChannelStateInfo sub-block, with the fields
+     *   of its ChannelSatInfo sub-block
+     */
+    class SBFExporter : public Logger
+    {
+    public:
+        explicit SBFExporter(const ExportSettings& settings);
+
+        //! Block types that can be exported
+        static std::vector<std::string> blockTypes();
+
+        /**
+         * @brief Creates the files
+         * @param[out] error Description of the failure if any
+         * @return Whether all files could be created
+         */
+        bool open(std::string& error);
+
+        /**
+         * @brief Decodes an SBF file, appending its blocks to the tables
+         * @param[in] file_name The name of (or path to) the SBF file
+         * @param[out] error Description of the failure if any
+         * @return Whether the file could be read
+         */
+        bool exportFile(const std::string& file_name, std::string& error);
+
+        /**
+         * @brief Writes the last batches and closes the files
+         * @param[out] error Description of the first failure if any
+         * @return Whether all rows were written
+         */
+        bool close(std::string& error);
+
+        //! Prints the bytes read, the rows written and the failures to stderr
+        void printStatistics(double seconds) const;
+
+        bool logEnabled(LogLevel logLevel) override;
+
+        void log(LogLevel logLevel, const std::string& s) override;
+
+    private:
+        void exportPVTGeodetic(const uint8_t* block, std::size_t length);
+
+        void exportINSNavGeod(const uint8_t* block, std::size_t length);
+
+        void exportMeasEpoch(const uint8_t* block, std::size_t length);
+
+        void exportChannelStatus(const uint8_t* block, std::size_t length);
+
+        ExportSettings settings_;
+
+        std::unique_ptr<ColumnarWriter> pvtgeodetic_;
+        std::unique_ptr<ColumnarWriter> insnavgeod_;
+        std::unique_ptr<ColumnarWriter> measepoch_;
+        std::unique_ptr<ColumnarWriter> channelstatus_;
+
+        //! Decoded blocks, reused such that their vectors keep their capacity
+        PVTGeodeticMsg pvtgeodetic_msg_;
+        INSNavGeodMsg insnavgeod_msg_;
+        MeasEpochMsg measepoch_msg_;
+        ChannelStatus channelstatus_msg_;
+
+        //! Statistics
+        uint64_t bytes_ = 0;
+        uint64_t skipped_ = 0;
+        uint64_t blocks_ = 0;
+        uint64_t parse_failures_ = 0;
+    };
+} // namespace sbf_export
+
+#endif // SBF_EXPORTER_HPP
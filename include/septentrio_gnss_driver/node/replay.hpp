@@ -0,0 +1,140 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <septentrio_gnss_driver/node/rosaic_node.hpp>
+// C++ library includes
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file replay.hpp
+ * @date 19/10/26
+ * @brief Records the messages of a replayed SBF or PCAP file, shared by the replay
+ * tool and test/replay_test.cpp
+ */
+
+namespace rosaic_replay {
+    //! Marks the start of a message in the golden file, followed by the topic
+    const std::string MESSAGE_MARKER = "--- ";
+
+    /**
+     * @class MessageRecorder
+     * @brief Counts the messages and, if asked to, keeps them as text
+     *
+     * The time from the first to the last message is the time spent decoding,
+     * without starting the node and opening the file.
+     */
+    class MessageRecorder : public PublishSink
+    {
+    public:
+        explicit MessageRecorder(bool keep_text) : keep_text_(keep_text) {}
+
+        void publish(const std::string& topic,
+                     const boost::function<void(std::ostream&)>& print) override
+        {
+            last_ = std::chrono::steady_clock::now();
+            if (count_++ == 0)
+                first_ = last_;
+            if (!keep_text_)
+                return;
+            std::ostringstream message;
+            print(message);
+            std::string printed = message.str();
+            text_ << MESSAGE_MARKER << topic << "\n" << printed;
+            // Not all ROS distributions end the last field with a newline
+            if (printed.empty() || printed.back() != '\n')
+                text_ << "\n";
+        }
+
+        uint64_t count() const { return count_; }
+
+        //! Seconds from the first to the last message
+        double seconds() const
+        {
+            return std::chrono::duration<double>(last_ - first_).count();
+        }
+
+        //! Messages per second after the first one, 0 if it cannot be measured
+        double rate() const
+        {
+            double spent = seconds();
+            return spent > 0.0 ? (count_ - 1) / spent : 0.0;
+        }
+
+        std::string text() const { return text_.str(); }
+
+    private:
+        bool keep_text_;
+        uint64_t count_ = 0;
+        std::chrono::steady_clock::time_point first_;
+        std::chrono::steady_clock::time_point last_;
+        std::ostringstream text_;
+    };
+
+    //! Decodes the file given as device parameter into a recorder
+    inline void replay(MessageRecorder& recorder)
+    {
+        rosaic_node::ROSaicNode node(
+            std::string(), boost::shared_ptr<boost::asio::io_service>(), &recorder);
+        node.waitForFileReading();
+    }
+
+    /**
+     * @brief Splits a text into messages, each starting with its marker line
+     *
+     * The lines are stripped of indentation and blank lines are dropped, since
+     * the message printers of the ROS distributions differ in both only.
+     */
+    inline std::vector<std::string> splitMessages(const std::string& text)
+    {
+        std::vector<std::string> messages;
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::size_t begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos)
+                continue;
+            line = line.substr(begin, line.find_last_not_of(" \t\r") + 1 - begin);
+            if (line.compare(0, MESSAGE_MARKER.size(), MESSAGE_MARKER) == 0 ||
+                messages.empty())
+                messages.emplace_back();
+            messages.back() += line + "\n";
+        }
+        return messages;
+    }
+} // namespace rosaic_replay
+
+#endif // REPLAY_HPP
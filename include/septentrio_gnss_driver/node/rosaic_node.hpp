@@ -91,6 +91,25 @@ namespace rosaic_node {
         //! messages, and publishes requested ROS messages...
         ROSaicNode();        
 
+        /**
+         * @brief Initializes and runs one of several Rxs handled by the same node
+         * @param[in] receiver_name Name of the Rx, used as namespace of its
+         * parameters and topics
+         * @param[in] io_service io_service run by a thread pool shared with the
+         * other Rxs
+         * @param[in] sink Receives the messages instead of the ROS publishers if
+         * not null, see PublishSink
+         */
+        ROSaicNode(const std::string& receiver_name,
+                   boost::shared_ptr<boost::asio::io_service> io_service,
+                   PublishSink* sink = nullptr);
+
+        /**
+         * @brief Returns once an SBF or PCAP file given as device has been read
+         * entirely, right away for other devices
+         */
+        void waitForFileReading();
+
     private:
         /**
          * @brief Gets the node parameters from the ROS Parameter Server, parts of
@@ -123,6 +142,39 @@ namespace rosaic_node {
         tf2_ros::Buffer tfBuffer_;
 	    std::unique_ptr<tf2_ros::TransformListener> tfListener_;
     };
+
+    /**
+     * @class ROSaicMultiNode
+     * @brief Handles several Rxs in one process
+     *
+     * Each Rx listed in the parameter "receivers" is handled by a ROSaicNode of its
+     * own, all of them sharing an io_service that is run by a small thread pool.
+     */
+    class ROSaicMultiNode : ROSaicNodeBase
+    {
+    public:
+        /**
+         * @brief Starts the thread pool and the Rxs
+         * @param[in] receivers Names of the Rxs
+         */
+        explicit ROSaicMultiNode(const std::vector<std::string>& receivers);
+
+        //! Stops the thread pool and the Rxs
+        ~ROSaicMultiNode();
+
+    private:
+        //! io_service shared by all Rxs
+        boost::shared_ptr<boost::asio::io_service> io_service_;
+        //! Keeps io_service_ running while there is nothing to do
+        std::unique_ptr<boost::asio::io_service::work> work_;
+        //! Threads running io_service_
+        boost::thread_group io_threads_;
+        //! One node per Rx
+        std::vector<std::unique_ptr<ROSaicNode>> nodes_;
+        //! Threads constructing the nodes, since construction waits for the Rx to
+        //! be connected and configured
+        boost::thread_group startup_threads_;
+    };
 } // namespace rosaic_node
 
 #endif // for ROSAIC_NODE_HPP
\ No newline at end of file
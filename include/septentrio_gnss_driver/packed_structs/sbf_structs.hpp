@@ -113,13 +113,16 @@
 static const uint8_t SBF_SYNC_BYTE_1 = 0x24;
 //! 0x40 is ASCII for @ - 2nd byte to indicate SBF block
 static const uint8_t SBF_SYNC_BYTE_2 = 0x40;
+//! Number of bytes of the SBF header up to and including the length field
+static const uint8_t SBF_LENGTH_FIELD_END = 8;
 
 // C++
 #include <algorithm>
 // Boost
 #include <boost/spirit/include/qi.hpp>
 
-#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+#include <septentrio_gnss_driver/abstraction/interfaces.hpp>
+#include <septentrio_gnss_driver/abstraction/message_typedefs.hpp>
 #include <septentrio_gnss_driver/parsers/parsing_utilities.hpp>
 
 /**
@@ -434,7 +437,7 @@ bool qiCharsToStringParser(It& it, std::string& val, std::size_t num)
  * @brief Qi based parser for the SBF block "BlockHeader" plus receiver time stamp 
  */
 template<typename It, typename Hdr>
-bool BlockHeaderParser(ROSaicNodeBase* node, It& it, Hdr& block_header)
+bool BlockHeaderParser(Logger* node, It& it, Hdr& block_header)
 {  
     qiLittleEndianParser(it, block_header.sync_1);
     if (block_header.sync_1 != SBF_SYNC_BYTE_1)
@@ -479,7 +482,7 @@ void ChannelStateInfoParser(It& it, ChannelStateInfo& msg, uint8_t sb2_length)
  * @brief Qi based parser or the SBF sub-block "ChannelSatInfo"
  */
 template<typename It>
-bool ChannelSatInfoParser(ROSaicNodeBase* node, It& it, ChannelSatInfo& msg, uint8_t sb1_length, uint8_t sb2_length)
+bool ChannelSatInfoParser(Logger* node, It& it, ChannelSatInfo& msg, uint8_t sb1_length, uint8_t sb2_length)
 {
     qiLittleEndianParser(it, msg.sv_id);
     qiLittleEndianParser(it, msg.freq_nr);
@@ -509,7 +512,7 @@ bool ChannelSatInfoParser(ROSaicNodeBase* node, It& it, ChannelSatInfo& msg, uin
  * @brief Qi based parser for the SBF block "ChannelStatus"
  */
 template<typename It>
-bool ChannelStatusParser(ROSaicNodeBase* node, It it, It itEnd, ChannelStatus& msg)
+bool ChannelStatusParser(Logger* node, It it, It itEnd, ChannelStatus& msg)
 {
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -546,7 +549,7 @@ bool ChannelStatusParser(ROSaicNodeBase* node, It it, It itEnd, ChannelStatus& m
  * @brief Qi based parser for the SBF block "DOP"
  */
 template<typename It>
-bool DOPParser(ROSaicNodeBase* node, It it, It itEnd, DOP& msg)
+bool DOPParser(Logger* node, It it, It itEnd, DOP& msg)
 {
     
     if(!BlockHeaderParser(node, it, msg.block_header))
@@ -601,7 +604,7 @@ void MeasEpochChannelType2Parser(It& it, MeasEpochChannelType2Msg& msg, uint8_t
  * @brief Qi based parser for the SBF sub-block "MeasEpochChannelType1"
  */
 template<typename It>
-bool MeasEpochChannelType1Parser(ROSaicNodeBase* node, It& it, MeasEpochChannelType1Msg& msg, uint8_t sb1_length, uint8_t sb2_length)
+bool MeasEpochChannelType1Parser(Logger* node, It& it, MeasEpochChannelType1Msg& msg, uint8_t sb1_length, uint8_t sb2_length)
 {
     qiLittleEndianParser(it, msg.rx_channel);
     qiLittleEndianParser(it, msg.type);
@@ -634,7 +637,7 @@ bool MeasEpochChannelType1Parser(ROSaicNodeBase* node, It& it, MeasEpochChannelT
  * @brief Qi based parser for the SBF block "MeasEpoch"
  */
 template<typename It>
-bool MeasEpochParser(ROSaicNodeBase* node, It it, It itEnd, MeasEpochMsg& msg)
+bool MeasEpochParser(Logger* node, It it, It itEnd, MeasEpochMsg& msg)
 {
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -674,7 +677,7 @@ bool MeasEpochParser(ROSaicNodeBase* node, It it, It itEnd, MeasEpochMsg& msg)
  * @brief Qi based parser for the SBF block "ReceiverSetup"
  */
 template<typename It>
-bool ReceiverSetupParser(ROSaicNodeBase* node, It it, It itEnd, ReceiverSetup& msg)
+bool ReceiverSetupParser(Logger* node, It it, It itEnd, ReceiverSetup& msg)
 {
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -731,7 +734,7 @@ bool ReceiverSetupParser(ROSaicNodeBase* node, It it, It itEnd, ReceiverSetup& m
  * @brief Qi based parser for the SBF block "PVTCartesian"
  */
 template<typename It>
-bool PVTCartesianParser(ROSaicNodeBase* node, It it, It itEnd, PVTCartesianMsg& msg)
+bool PVTCartesianParser(Logger* node, It it, It itEnd, PVTCartesianMsg& msg)
 {
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -785,7 +788,7 @@ bool PVTCartesianParser(ROSaicNodeBase* node, It it, It itEnd, PVTCartesianMsg&
  * @brief Qi based parser for the SBF block "PVTGeodetic"
  */
 template<typename It>
-bool PVTGeodeticParser(ROSaicNodeBase* node, It it, It itEnd, PVTGeodeticMsg& msg)
+bool PVTGeodeticParser(Logger* node, It it, It itEnd, PVTGeodeticMsg& msg)
 {
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -839,7 +842,7 @@ bool PVTGeodeticParser(ROSaicNodeBase* node, It it, It itEnd, PVTGeodeticMsg& ms
  * @brief Qi based parser for the SBF block "AttEuler"
  */
 template<typename It>
-bool AttEulerParser(ROSaicNodeBase* node, It it, It itEnd, AttEulerMsg& msg, bool use_ros_axis_orientation)
+bool AttEulerParser(Logger* node, It it, It itEnd, AttEulerMsg& msg, bool use_ros_axis_orientation)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -882,7 +885,7 @@ bool AttEulerParser(ROSaicNodeBase* node, It it, It itEnd, AttEulerMsg& msg, boo
  * @brief Qi based parser for the SBF block "AttCovEuler"
  */
 template<typename It>
-bool AttCovEulerParser(ROSaicNodeBase* node, It it, It itEnd, AttCovEulerMsg& msg, bool use_ros_axis_orientation)
+bool AttCovEulerParser(Logger* node, It it, It itEnd, AttCovEulerMsg& msg, bool use_ros_axis_orientation)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -919,7 +922,7 @@ bool AttCovEulerParser(ROSaicNodeBase* node, It it, It itEnd, AttCovEulerMsg& ms
  * @brief Qi based parser for the SBF block "INSNavCart"
  */
 template<typename It>
-bool INSNavCartParser(ROSaicNodeBase* node, It it, It itEnd, INSNavCartMsg& msg, bool use_ros_axis_orientation)
+bool INSNavCartParser(Logger* node, It it, It itEnd, INSNavCartMsg& msg, bool use_ros_axis_orientation)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1063,7 +1066,7 @@ bool INSNavCartParser(ROSaicNodeBase* node, It it, It itEnd, INSNavCartMsg& msg,
  * @brief Qi based parser for the SBF block "PosCovCartesian"
  */
 template<typename It>
-bool PosCovCartesianParser(ROSaicNodeBase* node, It it, It itEnd, PosCovCartesianMsg& msg)
+bool PosCovCartesianParser(Logger* node, It it, It itEnd, PosCovCartesianMsg& msg)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1097,7 +1100,7 @@ bool PosCovCartesianParser(ROSaicNodeBase* node, It it, It itEnd, PosCovCartesia
  * @brief Qi based parser for the SBF block "PosCovGeodetic"
  */
 template<typename It>
-bool PosCovGeodeticParser(ROSaicNodeBase* node, It it, It itEnd, PosCovGeodeticMsg& msg)
+bool PosCovGeodeticParser(Logger* node, It it, It itEnd, PosCovGeodeticMsg& msg)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1131,7 +1134,7 @@ bool PosCovGeodeticParser(ROSaicNodeBase* node, It it, It itEnd, PosCovGeodeticM
  * @brief Qi based parser for the SBF block "VelCovCartesian"
  */
 template<typename It>
-bool VelCovCartesianParser(ROSaicNodeBase* node, It it, It itEnd, VelCovCartesianMsg& msg)
+bool VelCovCartesianParser(Logger* node, It it, It itEnd, VelCovCartesianMsg& msg)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1165,7 +1168,7 @@ bool VelCovCartesianParser(ROSaicNodeBase* node, It it, It itEnd, VelCovCartesia
  * @brief Qi based parser for the SBF block "VelCovGeodetic"
  */
 template<typename It>
-bool VelCovGeodeticParser(ROSaicNodeBase* node, It it, It itEnd, VelCovGeodeticMsg& msg)
+bool VelCovGeodeticParser(Logger* node, It it, It itEnd, VelCovGeodeticMsg& msg)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1199,7 +1202,7 @@ bool VelCovGeodeticParser(ROSaicNodeBase* node, It it, It itEnd, VelCovGeodeticM
  * @brief @brief Qi based parser for the SBF block "QualityInd"
  */
 template<typename It>
-bool QualityIndParser(ROSaicNodeBase* node, It it, It itEnd, QualityInd& msg)
+bool QualityIndParser(Logger* node, It it, It itEnd, QualityInd& msg)
 {
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1248,7 +1251,7 @@ void AgcStateParser(It it, AgcState& msg, uint8_t sb_length)
  * @brief Struct for the SBF block "ReceiverStatus"
  */
 template<typename It>
-bool ReceiverStatusParser(ROSaicNodeBase* node, It it, It itEnd, ReceiverStatus& msg)
+bool ReceiverStatusParser(Logger* node, It it, It itEnd, ReceiverStatus& msg)
 {
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1289,7 +1292,7 @@ bool ReceiverStatusParser(ROSaicNodeBase* node, It it, It itEnd, ReceiverStatus&
  * @brief Qi based parser for the SBF block "INSNavGeod"
  */
 template<typename It>
-bool INSNavGeodParser(ROSaicNodeBase* node, It it, It itEnd, INSNavGeodMsg& msg, bool use_ros_axis_orientation)
+bool INSNavGeodParser(Logger* node, It it, It itEnd, INSNavGeodMsg& msg, bool use_ros_axis_orientation)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1434,7 +1437,7 @@ bool INSNavGeodParser(ROSaicNodeBase* node, It it, It itEnd, INSNavGeodMsg& msg,
  * @brief Qi based parser for the SBF block "IMUSetup"
  */
 template<typename It>
-bool IMUSetupParser(ROSaicNodeBase* node, It it, It itEnd, IMUSetupMsg& msg, bool use_ros_axis_orientation)
+bool IMUSetupParser(Logger* node, It it, It itEnd, IMUSetupMsg& msg, bool use_ros_axis_orientation)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1470,7 +1473,7 @@ bool IMUSetupParser(ROSaicNodeBase* node, It it, It itEnd, IMUSetupMsg& msg, boo
  * @brief Qi based parser for the SBF block "VelSensorSetup"
  */
 template<typename It>
-bool VelSensorSetupParser(ROSaicNodeBase* node, It it, It itEnd, VelSensorSetupMsg& msg, bool use_ros_axis_orientation)
+bool VelSensorSetupParser(Logger* node, It it, It itEnd, VelSensorSetupMsg& msg, bool use_ros_axis_orientation)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
@@ -1502,7 +1505,7 @@ bool VelSensorSetupParser(ROSaicNodeBase* node, It it, It itEnd, VelSensorSetupM
  * @brief Qi based parser for the SBF block "ExtSensorMeas"
  */
 template<typename It>
-bool ExtSensorMeasParser(ROSaicNodeBase* node, It it, It itEnd, ExtSensorMeasMsg& msg, bool use_ros_axis_orientation)
+bool ExtSensorMeasParser(Logger* node, It it, It itEnd, ExtSensorMeasMsg& msg, bool use_ros_axis_orientation)
 {    
     if(!BlockHeaderParser(node, it, msg.block_header))
         return false;
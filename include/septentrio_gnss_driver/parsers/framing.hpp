@@ -0,0 +1,95 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef FRAMING_HPP
+#define FRAMING_HPP
+
+//! 0x24 is ASCII for $ - 1st byte in each message
+#ifndef NMEA_SYNC_BYTE_1
+#define NMEA_SYNC_BYTE_1 0x24
+#endif
+//! 0x47 is ASCII for G - 2nd byte to indicate NMEA-type ASCII message
+#ifndef NMEA_SYNC_BYTE_2_1
+#define NMEA_SYNC_BYTE_2_1 0x47
+#endif
+//! 0x50 is ASCII for P - 2nd byte to indicate proprietary ASCII message
+#ifndef NMEA_SYNC_BYTE_2_2
+#define NMEA_SYNC_BYTE_2_2 0x50
+#endif
+//! 0x0D is ASCII for "Carriage Return", i.e. "Enter"
+#ifndef CARRIAGE_RETURN
+#define CARRIAGE_RETURN 0x0D
+#endif
+//! 0x0A is ASCII for "Line Feed", i.e. "New Line"
+#ifndef LINE_FEED
+#define LINE_FEED 0x0A
+#endif
+
+// C++ library includes
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file framing.hpp
+ * @date 19/10/26
+ * @brief Declares functions that find SBF blocks and NMEA sentences in raw data
+ */
+
+namespace framing {
+
+    //! Maximum length of an NMEA sentence accepted during resynchronization
+    static const std::size_t MAX_NMEA_LENGTH = 256;
+
+    /**
+     * @brief Checks whether sentence is a complete NMEA sentence,
+     * $<body>*hh<CR><LF>, with correct checksum
+     * @param[in] sentence First byte of the sentence, i.e. '$'
+     * @param[in] length Number of bytes of the sentence including <CR><LF>
+     * @return True if the sentence is valid, false otherwise
+     */
+    bool isValidNMEA(const uint8_t* sentence, std::size_t length);
+
+    /**
+     * @brief Searches for the first valid frame, i.e. CRC-valid SBF block or NMEA
+     * sentence with correct checksum, starting in [pos, end)
+     *
+     * Frames may extend beyond end, but not beyond size.
+     * @param[in] data Start of the data
+     * @param[in] size Number of bytes of the data
+     * @param[in] pos Offset at which the search starts
+     * @param[in] end Offset at which the search ends
+     * @param[out] length Length of the found frame
+     * @return Offset of the found frame, end if none was found
+     */
+    std::size_t findFrame(const uint8_t* data, std::size_t size, std::size_t pos,
+                          std::size_t end, std::size_t& length);
+} // namespace framing
+
+#endif // FRAMING_HPP
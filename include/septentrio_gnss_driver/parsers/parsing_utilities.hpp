@@ -41,8 +41,8 @@
 #include <Eigen/LU>
 // Boost includes
 #include <boost/math/constants/constants.hpp>
-// ROS includes
-#include <septentrio_gnss_driver/abstraction/typedefs.hpp>
+// ROSaic includes
+#include <septentrio_gnss_driver/abstraction/message_typedefs.hpp>
 
 /**
  * @file parsing_utilities.hpp
@@ -357,6 +357,17 @@ namespace parsing_utilities {
      * @return SBF GPS week counter 
      */
     uint16_t getWnc(const uint8_t* buffer);
+
+    /**
+     * @brief Checks the checksum of an NMEA sentence, i.e. the XOR of the
+     * characters between "$" and "*" against the two hex digits following "*"
+     *
+     * @param[in] sentence A pointer to the sentence starting with "$"
+     * @param[in] size Size of the sentence without line terminator
+     * @return True if the sentence ends with a checksum and it is right, false
+     * otherwise
+     */
+    bool checkNMEAChecksum(const uint8_t* sentence, std::size_t size);
 } // namespace parsing_utilities
 
 #endif // PARSING_UTILITIES_HPP
@@ -0,0 +1,115 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef FRAME_GENERATOR_HPP
+#define FRAME_GENERATOR_HPP
+
+// C++ library includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file frame_generator.hpp
+ * @date 19/10/26
+ * @brief Declares a generator of synthetic SBF blocks and NMEA sentences
+ */
+
+namespace rx_simulator {
+
+    /**
+     * @class FrameGenerator
+     * @brief Generates the SBF blocks and NMEA sentences of a simulated Rx
+     *
+     * The Rx drives on a circle of 50 m radius at 5 m/s. The blocks have the
+     * latest revisions known to ROSaic and valid CRCs, their layouts being those
+     * of benchmark/corpus/generate_corpus.py.
+     */
+    class FrameGenerator
+    {
+    public:
+        /**
+         * @brief Constructor of the class FrameGenerator
+         * @param[in] meas_signals Number of signals in MeasEpoch, distributed over
+         * the satellites with up to 3 signals each
+         */
+        explicit FrameGenerator(uint32_t meas_signals);
+
+        //! Names of the messages that can be generated, e.g. "MeasEpoch" or "GPGGA"
+        static std::vector<std::string> messages();
+
+        /**
+         * @brief Appends a message at the GNSS time given
+         * @param[in] name Name of the message, one of messages()
+         * @param[in] gps_time Nanoseconds since the start of GPS time
+         * @param[out] out Storage the message is appended to
+         * @return False if the message is unknown
+         */
+        bool generate(const std::string& name, uint64_t gps_time,
+                      std::string& out) const;
+
+    private:
+        //! State of the simulated Rx at a point in time
+        struct State
+        {
+            uint32_t tow;
+            uint16_t wnc;
+            //! Seconds since the start of the week
+            double t;
+            //! [rad]
+            double latitude;
+            //! [rad]
+            double longitude;
+            //! Ellipsoidal height [m]
+            double height;
+            //! [m/s]
+            double vn;
+            double ve;
+            //! [deg], clockwise from north
+            double heading;
+        };
+
+        //! Evaluates the trajectory at the GNSS time given
+        State state(uint64_t gps_time) const;
+
+        //! Appends an SBF block with the payload given, padded and with CRC
+        static void appendBlock(uint16_t id, uint8_t revision, const State& s,
+                                const std::string& payload, std::string& out);
+
+        //! Appends an NMEA sentence with checksum and line terminator, the body
+        //! without "$" and "*"
+        static void appendSentence(const std::string& body, std::string& out);
+
+        //! Number of signals in MeasEpoch
+        uint32_t meas_signals_;
+    };
+} // namespace rx_simulator
+
+#endif // FRAME_GENERATOR_HPP
@@ -0,0 +1,190 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef RX_SIMULATOR_HPP
+#define RX_SIMULATOR_HPP
+
+// C++ library includes
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+// ROSaic includes
+#include <septentrio_gnss_driver/simulator/frame_generator.hpp>
+
+/**
+ * @file rx_simulator.hpp
+ * @date 19/10/26
+ * @brief Declares a simulator of a Septentrio Rx for load and soak tests of the
+ * driver
+ */
+
+namespace rx_simulator {
+
+    //! Settings of the simulator, from the command line
+    struct SimulatorSettings
+    {
+        //! TCP port to listen on, 0 for none
+        uint16_t tcp_port = 28784;
+        //! Whether to open a pseudo terminal standing in for a serial port
+        bool pty = false;
+        //! Symbolic link to the pseudo terminal, e.g. /tmp/ttySIM
+        std::string pty_link;
+        //! Synthetic messages and their rates [Hz]
+        std::vector<std::pair<std::string, double>> streams;
+        //! Number of signals in MeasEpoch
+        uint32_t meas_signals = 100;
+        //! Recorded SBF/NMEA file to stream instead of synthetic messages
+        std::string file_name;
+        //! Replay speed of the recorded file relative to real time
+        double speed = 1.0;
+        //! Whether to replay the recorded file in a loop
+        bool loop = false;
+        //! Probability of a frame to have one of its bytes flipped
+        double corrupt_probability = 0.0;
+        //! Probability of a frame to be dropped
+        double drop_probability = 0.0;
+        //! Probability of random bytes to be inserted before a frame
+        double garbage_probability = 0.0;
+        //! Seed of the random number generator of the corruption
+        uint32_t seed = 0;
+        //! Period of the statistics printed to stderr [s], 0 for none
+        double stats_period = 10.0;
+    };
+
+    /**
+     * @class RxSimulator
+     * @brief Simulates the TCP and serial ports of a Septentrio Rx
+     *
+     * Each port answers commands as the Rx does: a "$R" reply echoing the
+     * command followed by the connection descriptor prompt. The output commands
+     * are acknowledged but not honored, all ports streaming the messages
+     * configured on the command line instead. Setup blocks are sent once to a
+     * port on "sso" commands naming them, as the Rx outputs them on change.
+     */
+    class RxSimulator
+    {
+    public:
+        explicit RxSimulator(const SimulatorSettings& settings);
+
+        ~RxSimulator();
+
+        /**
+         * @brief Opens the TCP server and the pseudo terminal
+         * @param[out] error Description of the failure if any
+         * @return Whether the ports could be opened
+         */
+        bool open(std::string& error);
+
+        //! Streams the messages until stopping is set
+        void run(const std::atomic<bool>& stopping);
+
+        //! Path of the slave of the pseudo terminal, empty if none
+        const std::string& ptyName() const { return pty_name_; }
+
+    private:
+        //! A connection to a client of the simulator
+        struct Connection
+        {
+            int fd = -1;
+            //! Connection descriptor, e.g. "IP10" or "COM1"
+            std::string descriptor;
+            //! Writes that would block are dropped, as over a serial line
+            bool drop_on_block = false;
+            std::atomic<bool> closed{false};
+            //! Set when the reader has returned
+            std::atomic<bool> finished{false};
+            //! Serializes command replies and streamed messages
+            std::mutex write_mutex;
+            std::thread reader;
+        };
+
+        //! Accepts TCP clients
+        void acceptClients();
+
+        //! Reads and answers the commands of a client
+        void serve(std::shared_ptr<Connection> connection);
+
+        //! Answers a command line, including the prompt
+        std::string answer(const std::string& line, const Connection& connection);
+
+        //! Writes to a connection, marking it closed on failure
+        void write(Connection& connection, const std::string& data);
+
+        //! Writes to all connections and removes the closed ones
+        void broadcast(const std::string& data);
+
+        //! Appends a frame to out, corrupted, dropped or preceded by garbage
+        //! at random
+        void tamper(const char* frame, size_t size, std::string& out);
+
+        void streamSynthetic(const std::atomic<bool>& stopping);
+
+        void streamRecorded(const std::atomic<bool>& stopping);
+
+        //! Prints the statistics if due
+        void printStatistics(bool force);
+
+        SimulatorSettings settings_;
+
+        FrameGenerator generator_;
+
+        int listen_fd_ = -1;
+        int pty_master_fd_ = -1;
+        std::string pty_name_;
+
+        std::atomic<bool> stopping_{false};
+        std::thread acceptor_;
+
+        std::mutex connections_mutex_;
+        std::list<std::shared_ptr<Connection>> connections_;
+        uint32_t next_ip_descriptor_ = 10;
+
+        std::mt19937 random_;
+
+        //! Statistics
+        uint64_t frames_ = 0;
+        uint64_t bytes_ = 0;
+        uint64_t corrupted_ = 0;
+        uint64_t dropped_ = 0;
+        uint64_t garbage_ = 0;
+        std::atomic<uint64_t> commands_{0};
+        std::atomic<uint64_t> overflows_{0};
+        int64_t last_statistics_ = 0;
+    };
+} // namespace rx_simulator
+
+#endif // RX_SIMULATOR_HPP
@@ -0,0 +1,212 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/black_box.hpp>
+
+// C++ library includes
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+/**
+ * @file black_box.cpp
+ * @date 19/10/26
+ * @brief Defines a memory ring holding the most recent raw data of the Rx
+ */
+
+namespace io_comm_rx {
+
+    BlackBox::BlackBox(ROSaicNodeBase* node, std::size_t size,
+                       const std::string& path_prefix) :
+        node_(node),
+        path_prefix_(path_prefix), ring_(size),
+        // Plus the entry the oldest byte belongs to and the one being added
+        index_(size / INDEX_SPACING + 2)
+    {
+        node_->log(LogLevel::INFO, "Keeping the last " + std::to_string(size) +
+                                       " bytes of raw Rx data in memory.");
+    }
+
+    BlackBox::~BlackBox()
+    {
+        if (dump_thread_.joinable())
+            dump_thread_.join();
+    }
+
+    void BlackBox::write(Timestamp recvTime, const uint8_t* data, std::size_t size)
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        if (size > ring_.size())
+        {
+            // Only the tail of the chunk fits
+            head_ += size - ring_.size();
+            data += size - ring_.size();
+            size = ring_.size();
+        }
+        if (index_head_ == 0)
+        {
+            index_[0] = IndexEntry{head_, recvTime};
+            ++index_head_;
+        } else
+        {
+            const IndexEntry& last = index_[(index_head_ - 1) % index_.size()];
+            if ((recvTime - last.time >= INDEX_RESOLUTION) &&
+                (head_ - last.position >= INDEX_SPACING))
+            {
+                index_[index_head_ % index_.size()] = IndexEntry{head_, recvTime};
+                ++index_head_;
+            }
+        }
+        std::size_t pos = head_ % ring_.size();
+        std::size_t first = std::min(size, ring_.size() - pos);
+        std::memcpy(&ring_[pos], data, first);
+        std::memcpy(&ring_[0], data + first, size - first);
+        head_ += size;
+    }
+
+    bool BlackBox::dump(std::string& message)
+    {
+        if (dumping_.exchange(true))
+        {
+            message = "The previous dump is still being written.";
+            return false;
+        }
+        if (dump_thread_.joinable())
+            dump_thread_.join();
+
+        uint64_t end;
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            end = head_;
+        }
+        uint64_t begin = (end > ring_.size()) ? end - ring_.size() : 0;
+
+        std::time_t now = std::time(nullptr);
+        std::tm utc;
+        gmtime_r(&now, &utc);
+        char time_string[16];
+        std::strftime(time_string, sizeof(time_string), "%Y%m%d_%H%M%S", &utc);
+        std::string file_name = path_prefix_ + "_" + time_string + ".sbf";
+
+        dump_thread_ = boost::thread(
+            boost::bind(&BlackBox::writeDump, this, file_name, begin, end));
+        message = file_name;
+        return true;
+    }
+
+    void BlackBox::writeDump(std::string file_name, uint64_t begin, uint64_t end)
+    {
+        std::string times_name = file_name.substr(0, file_name.size() - 4) +
+                                 "_times.csv";
+        std::ofstream file(file_name, std::ios::binary);
+        std::ofstream times(times_name);
+        if (!file.good() || !times.good())
+        {
+            node_->log(LogLevel::ERROR, "Could not open " + file_name + " or " +
+                                            times_name + " for the black box dump.");
+            dumping_ = false;
+            return;
+        }
+        times << "offset,recv_time_ns\n";
+
+        std::vector<uint8_t> segment(DUMP_SEGMENT_SIZE);
+        std::vector<IndexEntry> entries;
+        uint64_t pos = begin;
+        uint64_t index_pos = 0;
+        uint64_t written = 0;
+        uint64_t lost = 0;
+        while (pos < end)
+        {
+            std::size_t size;
+            entries.clear();
+            {
+                // The lock is only held for one segment at a time, such that the
+                // I/O thread is never delayed noticeably
+                boost::mutex::scoped_lock lock(mutex_);
+                uint64_t oldest = (head_ > ring_.size()) ? head_ - ring_.size() : 0;
+                if (pos < oldest)
+                {
+                    // Overwritten since the dump was requested
+                    lost += std::min(oldest, end) - pos;
+                    pos = oldest;
+                    if (pos >= end)
+                        break;
+                }
+                size = static_cast<std::size_t>(
+                    std::min(static_cast<uint64_t>(DUMP_SEGMENT_SIZE), end - pos));
+                std::size_t ring_pos = pos % ring_.size();
+                std::size_t first = std::min(size, ring_.size() - ring_pos);
+                std::memcpy(segment.data(), &ring_[ring_pos], first);
+                std::memcpy(segment.data() + first, &ring_[0], size - first);
+
+                uint64_t index_oldest = (index_head_ > index_.size())
+                                            ? index_head_ - index_.size()
+                                            : 0;
+                index_pos = std::max(index_pos, index_oldest);
+                // The entry of the chunk the segment starts in may lie before it
+                bool have_carry = false;
+                IndexEntry carry;
+                for (; index_pos < index_head_; ++index_pos)
+                {
+                    const IndexEntry& entry = index_[index_pos % index_.size()];
+                    if (entry.position >= pos + size)
+                        break;
+                    if (entry.position < pos)
+                    {
+                        carry = entry;
+                        have_carry = true;
+                        continue;
+                    }
+                    if (have_carry && (entry.position > pos))
+                        entries.push_back(IndexEntry{pos, carry.time});
+                    have_carry = false;
+                    entries.push_back(entry);
+                }
+                if (have_carry)
+                    entries.push_back(IndexEntry{pos, carry.time});
+            }
+            file.write(reinterpret_cast<const char*>(segment.data()), size);
+            for (const auto& entry : entries)
+                times << written + (entry.position - pos) << "," << entry.time
+                      << "\n";
+            pos += size;
+            written += size;
+        }
+
+        node_->log(LogLevel::INFO, "Black box dumped to " + file_name + " (" +
+                                       std::to_string(written) + " bytes).");
+        if (lost > 0)
+            node_->log(LogLevel::WARN,
+                       std::to_string(lost) +
+                           " of the oldest bytes were overwritten while dumping.");
+        dumping_ = false;
+    }
+} // namespace io_comm_rx
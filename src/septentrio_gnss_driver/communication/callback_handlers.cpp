@@ -36,58 +36,39 @@
  * @brief Handles callbacks when reading NMEA/SBF messages
  */
 
-std::pair<std::string, uint32_t> gpsfix_pairs[] = {
-    std::make_pair("4013", 0), std::make_pair("4027", 1), std::make_pair("4001", 2),
-    std::make_pair("4007", 3), std::make_pair("5906", 4), std::make_pair("5908", 5),
-    std::make_pair("5938", 6), std::make_pair("5939", 7), std::make_pair("4226", 8)};
+std::pair<uint16_t, uint32_t> gpsfix_pairs[] = {
+    std::make_pair(4013, 0), std::make_pair(4027, 1), std::make_pair(4001, 2),
+    std::make_pair(4007, 3), std::make_pair(5906, 4), std::make_pair(5908, 5),
+    std::make_pair(5938, 6), std::make_pair(5939, 7), std::make_pair(4226, 8)};
 
-std::pair<std::string, uint32_t> navsatfix_pairs[] = {std::make_pair("4007", 0),
-                                                      std::make_pair("5906", 1),
-                                                      std::make_pair("4226",2)};
+std::pair<uint16_t, uint32_t> navsatfix_pairs[] = {std::make_pair(4007, 0),
+                                                   std::make_pair(5906, 1),
+                                                   std::make_pair(4226, 2)};
 
-std::pair<std::string, uint32_t> pose_pairs[] = {
-    std::make_pair("4007", 0), std::make_pair("5906", 1), std::make_pair("5938", 2),
-    std::make_pair("5939", 3), std::make_pair("4226",4)};
+std::pair<uint16_t, uint32_t> pose_pairs[] = {
+    std::make_pair(4007, 0), std::make_pair(5906, 1), std::make_pair(5938, 2),
+    std::make_pair(5939, 3), std::make_pair(4226, 4)};
 
-std::pair<std::string, uint32_t> diagnosticarray_pairs[] = {
-    std::make_pair("4014", 0), std::make_pair("4082", 1)};
+std::pair<uint16_t, uint32_t> diagnosticarray_pairs[] = {
+    std::make_pair(4014, 0), std::make_pair(4082, 1)};
 
-std::pair<std::string, uint32_t> imu_pairs[] = {
-    std::make_pair("4226", 0), std::make_pair("4050", 1)};
+std::pair<uint16_t, uint32_t> imu_pairs[] = {
+    std::make_pair(4226, 0), std::make_pair(4050, 1)};
 
-std::pair<std::string, uint32_t> localization_pairs[] = {
-    std::make_pair("4226", 0)};
+std::pair<uint16_t, uint32_t> localization_pairs[] = {
+    std::make_pair(4226, 0)};
 
 namespace io_comm_rx {
-    boost::mutex CallbackHandlers::callback_mutex_;
-
-    CallbackHandlers::GPSFixMap 
-	    CallbackHandlers::gpsfix_map(gpsfix_pairs, gpsfix_pairs + 9);
-    CallbackHandlers::NavSatFixMap
-        CallbackHandlers::navsatfix_map(navsatfix_pairs, navsatfix_pairs + 3);
-    CallbackHandlers::PoseWithCovarianceStampedMap
-        CallbackHandlers::pose_map(pose_pairs, pose_pairs + 5);
-    CallbackHandlers::DiagnosticArrayMap
-        CallbackHandlers::diagnosticarray_map(diagnosticarray_pairs,
-                                              diagnosticarray_pairs + 2);
-    CallbackHandlers::ImuMap
-        CallbackHandlers::imu_map(imu_pairs,
-                                  imu_pairs + 2);
-                                  
-    CallbackHandlers::LocalizationMap
-        CallbackHandlers::localization_map(localization_pairs,
-                                           localization_pairs + 1);
-
-    std::string CallbackHandlers::do_gpsfix_ = "4007";
-    std::string CallbackHandlers::do_navsatfix_ = "4007";
-    std::string CallbackHandlers::do_pose_ = "4007";
-    std::string CallbackHandlers::do_diagnostics_ = "4014";
-    
-    std::string CallbackHandlers::do_insgpsfix_ = "4226";
-    std::string CallbackHandlers::do_insnavsatfix_ = "4226"; 
-    std::string CallbackHandlers::do_inspose_ = "4226"; 
-    std::string CallbackHandlers::do_imu_ = "4226";
-    std::string CallbackHandlers::do_inslocalization_ = "4226";
+    CallbackHandlers::CallbackHandlers(ROSaicNodeBase* node, Settings* settings) :
+        node_(node), rx_message_(node, settings), settings_(settings),
+        gpsfix_map(gpsfix_pairs, gpsfix_pairs + 9),
+        navsatfix_map(navsatfix_pairs, navsatfix_pairs + 3),
+        pose_map(pose_pairs, pose_pairs + 5),
+        diagnosticarray_map(diagnosticarray_pairs, diagnosticarray_pairs + 2),
+        imu_map(imu_pairs, imu_pairs + 2),
+        localization_map(localization_pairs, localization_pairs + 1)
+    {
+    }
 
     //! The for loop forwards to a ROS message specific handle if the latter was
     //! added via callbackmap_.insert at some earlier point.
@@ -96,8 +77,10 @@ namespace io_comm_rx {
         // Find the ROS message callback handler for the equivalent Rx message
         // (SBF/NMEA) at hand & call it
         boost::mutex::scoped_lock lock(callback_mutex_);
-        CallbackMap::key_type key = rx_message_.messageID();
-        std::string ID_temp = rx_message_.messageID();
+        // Kept for dispatch() and recordStages(), see message_id_
+        message_id_ = rx_message_.messageID();
+        CallbackMap::key_type key = message_id_;
+        std::string ID_temp = message_id_;
         if (!(ID_temp == "4013" || ID_temp == "4001" ||
               ID_temp == "4014" || ID_temp == "4082" || ID_temp == "5902"))
         // We only want to handle ChannelStatus, MeasEpoch, DOP, ReceiverStatus, 
@@ -109,7 +92,7 @@ namespace io_comm_rx {
             {
                 try
                 {
-                    callback->second->handle(rx_message_, callback->first);
+                    dispatch(*callback);
                 } catch (std::runtime_error& e)
                 {
                     throw std::runtime_error(e.what());
@@ -122,7 +105,7 @@ namespace io_comm_rx {
 			if (settings_->publish_navsatfix)
 			{
 				CallbackMap::key_type key = "NavSatFix";
-				std::string ID_temp = rx_message_.messageID();
+				std::string ID_temp = message_id_;
 				if (ID_temp == do_navsatfix_)
 				// The last incoming block PVTGeodetic triggers
 				// the publishing of NavSatFix.
@@ -132,7 +115,7 @@ namespace io_comm_rx {
 					{
 						try
 						{
-							callback->second->handle(rx_message_, callback->first);
+							dispatch(*callback);
 						} catch (std::runtime_error& e)
 						{
 							throw std::runtime_error(e.what());
@@ -148,7 +131,7 @@ namespace io_comm_rx {
             if (settings_->publish_navsatfix)
             {
                 CallbackMap::key_type key = "INSNavSatFix";
-                std::string ID_temp = rx_message_.messageID();
+                std::string ID_temp = message_id_;
                 if (ID_temp == do_insnavsatfix_)
                 // The last incoming block INSNavGeod triggers
                 // the publishing of NavSatFix.
@@ -158,7 +141,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -175,7 +158,7 @@ namespace io_comm_rx {
             if (settings_->publish_pose)
             {
                 CallbackMap::key_type key = "PoseWithCovarianceStamped";
-                std::string ID_temp = rx_message_.messageID();
+                std::string ID_temp = message_id_;
                 if (ID_temp == do_pose_)
                 // The last incoming block among PVTGeodetic, PosCovGeodetic, AttEuler
                 // and AttCovEuler triggers the publishing of PoseWithCovarianceStamped.
@@ -185,7 +168,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -202,7 +185,7 @@ namespace io_comm_rx {
             if (settings_->publish_pose)
             {
                 CallbackMap::key_type key = "INSPoseWithCovarianceStamped";
-                std::string ID_temp = rx_message_.messageID();
+                std::string ID_temp = message_id_;
                 if (ID_temp == do_inspose_)
                 // The last incoming block INSNavGeod triggers the publishing of PoseWithCovarianceStamped.
                 {
@@ -211,7 +194,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -225,8 +208,8 @@ namespace io_comm_rx {
         // for the both type of receivers
 		if (settings_->publish_diagnostics)
 		{
-			CallbackMap::key_type key1 = rx_message_.messageID();
-			std::string ID_temp = rx_message_.messageID();
+			CallbackMap::key_type key1 = message_id_;
+			std::string ID_temp = message_id_;
 			if (ID_temp == "4014" || ID_temp == "4082" || ID_temp == "5902")
 			{
 				for (CallbackMap::iterator callback = callbackmap_.lower_bound(key1);
@@ -234,7 +217,7 @@ namespace io_comm_rx {
 				{
 					try
 					{
-						callback->second->handle(rx_message_, callback->first);
+						dispatch(*callback);
 					} catch (std::runtime_error& e)
 					{
 						throw std::runtime_error(e.what());
@@ -251,7 +234,7 @@ namespace io_comm_rx {
 				{
 					try
 					{
-						callback->second->handle(rx_message_, callback->first);
+						dispatch(*callback);
 					} catch (std::runtime_error& e)
 					{
 						throw std::runtime_error(e.what());
@@ -267,7 +250,7 @@ namespace io_comm_rx {
             if (settings_->publish_imu)
             {
                 CallbackMap::key_type key = "Imu";
-                std::string ID_temp = rx_message_.messageID();
+                std::string ID_temp = message_id_;
                 if (ID_temp == do_imu_)
                 // The last incoming block INSNavGeod triggers the publishing of PoseWithCovarianceStamped.
                 {
@@ -276,7 +259,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -293,7 +276,7 @@ namespace io_comm_rx {
             if (settings_->publish_localization || settings_->publish_tf)
             {
                 CallbackMap::key_type key = "Localization";
-                std::string ID_temp = rx_message_.messageID();
+                std::string ID_temp = message_id_;
                 if (ID_temp == do_inslocalization_)
                 // The last incoming block INSNavGeod triggers the publishing of PoseWithCovarianceStamped.
                 {
@@ -302,7 +285,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -319,7 +302,7 @@ namespace io_comm_rx {
             if (settings_->publish_gpst)
             {
                 CallbackMap::key_type key1 = "GPST";
-                std::string ID_temp = rx_message_.messageID();
+                std::string ID_temp = message_id_;
                 // If no new PVTGeodetic block is coming in, there is no need to publish
                 // TimeReferenceMsg (with GPST) anew.
                 if (ID_temp == "4007")
@@ -329,7 +312,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -343,7 +326,7 @@ namespace io_comm_rx {
             if (settings_->publish_gpst)
             {
                 CallbackMap::key_type key1 = "GPST";
-                std::string ID_temp = rx_message_.messageID();
+                std::string ID_temp = message_id_;
                 // If no new INSNavGeod block is coming in, there is no need to publish
                 // TimeReferenceMsg (with GPST) anew.
                 if (ID_temp == "4226")
@@ -353,7 +336,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -367,8 +350,8 @@ namespace io_comm_rx {
         {
             if (settings_->publish_gpsfix)
             {
-                std::string ID_temp = rx_message_.messageID();
-                CallbackMap::key_type key1 = rx_message_.messageID();
+                std::string ID_temp = message_id_;
+                CallbackMap::key_type key1 = message_id_;
                 if (ID_temp == "4013" || ID_temp == "4001")
                 // Even though we are not interested in publishing ChannelStatus (4013)
                 // and DOP (4001) ROS messages, we have to save some contents of these 
@@ -379,7 +362,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -396,7 +379,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -411,8 +394,8 @@ namespace io_comm_rx {
         {
             if (settings_->publish_gpsfix)
             {
-                std::string ID_temp = rx_message_.messageID();
-                CallbackMap::key_type key1 = rx_message_.messageID();
+                std::string ID_temp = message_id_;
+                CallbackMap::key_type key1 = message_id_;
                 if (ID_temp == "4013" || ID_temp == "4001")
                 // Even though we are not interested in publishing ChannelStatus (4013)
                 // and DOP (4001) ROS messages, we have to save some contents of these 
@@ -423,7 +406,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -441,7 +424,7 @@ namespace io_comm_rx {
                     {
                         try
                         {
-                            callback->second->handle(rx_message_, callback->first);
+                            dispatch(*callback);
                         } catch (std::runtime_error& e)
                         {
                             throw std::runtime_error(e.what());
@@ -453,129 +436,195 @@ namespace io_comm_rx {
         }
     }
 
-    void CallbackHandlers::readCallback(Timestamp recvTimestamp, const uint8_t* data, std::size_t& size)
+    void CallbackHandlers::readCallback(Timestamp recvTimestamp, const uint8_t* data, std::size_t& size,
+                                        const ReceiveTimeline* timeline)
     {
-        rx_message_.newData(recvTimestamp, data, size);
+        rx_message_.newData(recvTimestamp, data, size, timeline);
+        if (settings_->publish_message_counters)
+            publishMessageCounters();
+        // Stages are only known when streaming from the Rx
+        if (settings_->publish_latency_diagnostics && timeline && !monitor_latency_)
+            node_->setPublishCallback(
+                boost::bind(&CallbackHandlers::recordPublication, this, _1, _2));
+        monitor_latency_ = settings_->publish_latency_diagnostics && timeline;
         // Read !all! (there might be many) messages in the buffer
         while (rx_message_.search() != rx_message_.getEndBuffer() &&
                rx_message_.found())
         {
+            Timestamp found_time = 0;
+            if (monitor_latency_)
+                found_time = node_->getTime();
+            // Counted once handled, since incomplete messages are handled anew.
+            // The counters are looked up once the message is complete.
+            std::size_t frame_size = 0;
+            MessageCounters::Counters* counters = nullptr;
+            // Blocks in raw_sbf_ before this message, see handle() below
+            std::size_t raw_sbf_blocks = raw_sbf_.block_ids.size();
+            // A message starting at the very end of the buffer, whose type is not
+            // known yet, is completed by the next chunk
+            if (rx_message_.getCount() < 2)
+            {
+                publishRawSBF(recvTimestamp);
+                throw(static_cast<std::size_t>(rx_message_.getPosBuffer() - data));
+            }
             // Print the found message (if NMEA) or just show messageID (if SBF)..
             if (rx_message_.isSBF())
             {
                 std::size_t sbf_block_length;
-                std::string ID_temp = rx_message_.messageID();
                 sbf_block_length =
                     static_cast<std::size_t>(rx_message_.getBlockLength());
-                node_->log(LogLevel::DEBUG, "ROSaic reading SBF block " + ID_temp + " made up of " + 
-                                            std::to_string(sbf_block_length) + " bytes...");
-                // If full message did not yet arrive, throw an error message.
-                if (sbf_block_length > rx_message_.getCount())
+                // If full message did not yet arrive, throw an error message. The
+                // length is only known once the header up to it has arrived.
+                if ((rx_message_.getCount() < SBF_LENGTH_FIELD_END) ||
+                    (sbf_block_length > rx_message_.getCount()))
                 {
-                    node_->log(LogLevel::DEBUG, 
+                    ROSAIC_DEBUG(node_, 
                         "Not a valid SBF block, parts of the SBF block are yet to be received. Ignore..");
+                    publishRawSBF(recvTimestamp);
                     throw(
                         static_cast<std::size_t>(rx_message_.getPosBuffer() - data));
                 }
+                // The block number rather than messageID(), which would build a
+                // string for every block
+                uint16_t block_id =
+                    parsing_utilities::getId(rx_message_.getPosBuffer());
+                ROSAIC_DEBUG(node_, "ROSaic reading SBF block " +
+                                        std::to_string(block_id) + " made up of " +
+                                        std::to_string(sbf_block_length) +
+                                        " bytes...");
+                counters = &rx_message_.messageCounters();
+                // Waiting for more data does not help a complete block that fails
+                // the CRC check, e.g. one spliced together after a lost UDP datagram,
+                // hence search for the next one
+                if (!rx_message_.checkCrc())
+                {
+                    ROSAIC_DEBUG(node_, "CRC check of SBF block " +
+                                            std::to_string(block_id) +
+                                            " failed, searching for the next message..");
+                    counters->crcFailure();
+                    continue;
+                }
+                // Passed through as soon as it is known to be intact, whether or not
+                // its ROS messages are published
+                if (settings_->publish_raw_sbf)
+                    appendRawSBF(rx_message_.getPosBuffer());
+                frame_size = sbf_block_length;
+                rx_message_.updateTimeReferences();
                 if (settings_->septentrio_receiver_type == "gnss")
                 {
                     if (settings_->publish_gpsfix == true &&
-                    (ID_temp == "4013" || ID_temp == "4027" || ID_temp == "4001" ||
-                     ID_temp == "4007" || ID_temp == "5906" || ID_temp == "5908" ||
-                     ID_temp == "5938" || ID_temp == "5939"))
+                    (block_id == 4013 || block_id == 4027 || block_id == 4001 ||
+                     block_id == 4007 || block_id == 5906 || block_id == 5908 ||
+                     block_id == 5938 || block_id == 5939))
                     {
-                        if (rx_message_.gnss_gpsfix_complete(gpsfix_map[ID_temp]))
+                        if (rx_message_.gnss_gpsfix_complete(gpsfix_map[block_id]))
                         {
-                            do_gpsfix_ = ID_temp;
+                            do_gpsfix_ = std::to_string(block_id);
                         }
                     }
                 }
                 if (settings_->septentrio_receiver_type == "ins")
                 {
                     if (settings_->publish_gpsfix == true &&
-                    (ID_temp == "4013" || ID_temp == "4027" || ID_temp == "4001" || ID_temp == "4226"))
+                    (block_id == 4013 || block_id == 4027 || block_id == 4001 || block_id == 4226))
                     {
-                        if (rx_message_.ins_gpsfix_complete(gpsfix_map[ID_temp]))
+                        if (rx_message_.ins_gpsfix_complete(gpsfix_map[block_id]))
                         {
-                            do_insgpsfix_ = ID_temp;
+                            do_insgpsfix_ = std::to_string(block_id);
                         }
                     }
                 }
                 if (settings_->septentrio_receiver_type == "gnss")
                 {
                     if (settings_->publish_navsatfix == true &&
-                    (ID_temp == "4007" || ID_temp == "5906"))
+                    (block_id == 4007 || block_id == 5906))
                     {
-                        if (rx_message_.gnss_navsatfix_complete(navsatfix_map[ID_temp]))
+                        if (rx_message_.gnss_navsatfix_complete(navsatfix_map[block_id]))
                         {
-                            do_navsatfix_ = ID_temp;
+                            do_navsatfix_ = std::to_string(block_id);
                         }
                     }
                 }
                 if (settings_->septentrio_receiver_type == "ins")
                 {
                     if (settings_->publish_navsatfix == true &&
-                    (ID_temp == "4226"))
+                    (block_id == 4226))
                     {
-                        if (rx_message_.ins_navsatfix_complete(navsatfix_map[ID_temp]))
+                        if (rx_message_.ins_navsatfix_complete(navsatfix_map[block_id]))
                         {
-                            do_insnavsatfix_ = ID_temp;
+                            do_insnavsatfix_ = std::to_string(block_id);
                         }
                     }
                 }
                 if (settings_->septentrio_receiver_type == "gnss")
                 {
                     if (settings_->publish_pose == true &&
-                    (ID_temp == "4007" || ID_temp == "5906" || ID_temp == "5938" ||
-                     ID_temp == "5939"))
+                    (block_id == 4007 || block_id == 5906 || block_id == 5938 ||
+                     block_id == 5939))
                     {
-                        if (rx_message_.gnss_pose_complete(pose_map[ID_temp]))
+                        if (rx_message_.gnss_pose_complete(pose_map[block_id]))
                         {
-                            do_pose_ = ID_temp;
+                            do_pose_ = std::to_string(block_id);
                         }
                     }
                 }
                 if (settings_->septentrio_receiver_type == "ins")
                 {
                     if (settings_->publish_pose == true &&
-                    (ID_temp == "4226"))
+                    (block_id == 4226))
                     {
-                        if (rx_message_.ins_pose_complete(pose_map[ID_temp]))
+                        if (rx_message_.ins_pose_complete(pose_map[block_id]))
                         {
-                            do_inspose_ = ID_temp;
+                            do_inspose_ = std::to_string(block_id);
                         }
                     }
                 }
 				if (settings_->publish_diagnostics == true &&
-				(ID_temp == "4014" || ID_temp == "4082"))
+				(block_id == 4014 || block_id == 4082))
 				{
-					if (rx_message_.diagnostics_complete(diagnosticarray_map[ID_temp]))
+					if (rx_message_.diagnostics_complete(diagnosticarray_map[block_id]))
 					{
-						do_diagnostics_ = ID_temp;
+						do_diagnostics_ = std::to_string(block_id);
 					}
 				}
                 if ((settings_->publish_localization || settings_->publish_tf) &&
-                (ID_temp == "4226"))
+                (block_id == 4226))
                 {
-                    if (rx_message_.ins_localization_complete(localization_map[ID_temp]))
+                    if (rx_message_.ins_localization_complete(localization_map[block_id]))
                     {
-                        do_inslocalization_ = ID_temp;
+                        do_inslocalization_ = std::to_string(block_id);
                     }
                 }
             }
             if (rx_message_.isNMEA())
             {
-                boost::char_separator<char> sep("\r"); // Carriage Return (CR)
-                typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
                 std::size_t nmea_size = rx_message_.messageSize();
-                // Syntax: new_string_name (const char* s, size_t n); size_t is
-                // either 2 or 8 bytes, depending on your system
-                std::string block_in_string(
-                    reinterpret_cast<const char*>(rx_message_.getPosBuffer()),
-                    nmea_size);
-                tokenizer tokens(block_in_string, sep);
-                node_->log(LogLevel::DEBUG, "The NMEA message contains " + std::to_string(nmea_size) + 
-                                            " bytes and is ready to be parsed. It reads: " + *tokens.begin());
+                // A sentence cut at the end of the chunk is completed by the next
+                // one when streaming from the Rx
+                if (timeline && nmea_size == rx_message_.getCount() &&
+                    nmea_size < NMEA_MAX_LENGTH)
+                {
+                    publishRawSBF(recvTimestamp);
+                    throw(
+                        static_cast<std::size_t>(rx_message_.getPosBuffer() - data));
+                }
+                counters = &rx_message_.messageCounters();
+                if (!parsing_utilities::checkNMEAChecksum(rx_message_.getPosBuffer(),
+                                                          nmea_size))
+                {
+                    ROSAIC_DEBUG(node_, "Checksum of NMEA sentence " +
+                                            rx_message_.messageID() +
+                                            " invalid, searching for the next message..");
+                    counters->checksumFailure();
+                    continue;
+                }
+                frame_size = nmea_size;
+                // The sentence ends before the first CR, see messageSize()
+                ROSAIC_DEBUG(node_, "The NMEA message contains " + std::to_string(nmea_size) + 
+                                            " bytes and is ready to be parsed. It reads: " +
+                                            std::string(reinterpret_cast<const char*>(
+                                                            rx_message_.getPosBuffer()),
+                                                        nmea_size));
             }
             if (rx_message_.isResponse()) // If the response is not sent at once, only
                                          // first part is ROS_DEBUG-printed
@@ -584,13 +633,13 @@ namespace io_comm_rx {
                 std::string block_in_string(
                     reinterpret_cast<const char*>(rx_message_.getPosBuffer()),
                     response_size);
-                node_->log(LogLevel::DEBUG, "The Rx's response contains " + std::to_string(response_size) +
+                ROSAIC_DEBUG(node_, "The Rx's response contains " + std::to_string(response_size) +
                                             " bytes and reads:\n " + block_in_string);
                 {
-                    boost::mutex::scoped_lock lock(g_response_mutex);
-                    g_response_received = true;
+                    boost::mutex::scoped_lock lock(response_mutex_);
+                    response_received_ = true;
                     lock.unlock();
-                    g_response_condition.notify_one();
+                    response_condition_.notify_one();
                 }
                 if (rx_message_.isErrorMessage())
                 {
@@ -603,30 +652,185 @@ namespace io_comm_rx {
             {
                 std::string cd(
                     reinterpret_cast<const char*>(rx_message_.getPosBuffer()), 4);
-                g_rx_tcp_port = cd;
-                if (g_cd_count == 0)
+                rx_tcp_port_ = cd;
+                uint32_t cd_count = rx_message_.countConnectionDescriptor();
+                if (cd_count == 1)
                 {
                     node_->log(LogLevel::INFO, "The connection descriptor for the TCP connection is " + cd);
                 }
-                if (g_cd_count < 3)
-                    ++g_cd_count;
-                if (g_cd_count == 2)
+                if (cd_count == 2)
                 {
-                    boost::mutex::scoped_lock lock(g_cd_mutex);
-                    g_cd_received = true;
+                    boost::mutex::scoped_lock lock(cd_mutex_);
+                    cd_received_ = true;
                     lock.unlock();
-                    g_cd_condition.notify_one();
+                    cd_condition_.notify_one();
                 }
                 continue;
             }
+            if (monitor_latency_)
+                message_recv_time_ = rx_message_.recvTime();
             try
             {
                 handle();
             } catch (std::runtime_error& e)
             {
-                node_->log(LogLevel::DEBUG, "Incomplete message: " + std::string(e.what()));
+                ROSAIC_DEBUG(node_, "Incomplete message: " + std::string(e.what()));
+                // The block is read anew with the next chunk, and appended again
+                dropRawSBF(raw_sbf_blocks);
+                publishRawSBF(recvTimestamp);
                 throw(static_cast<std::size_t>(rx_message_.getPosBuffer() - data));
             }
+            if (counters)
+                counters->frame(frame_size);
+            // Receive times are only known when streaming from the Rx
+            if (timeline)
+                recordLatency();
+            if (monitor_latency_)
+                recordStages(found_time);
+        }
+        publishRawSBF(recvTimestamp);
+    }
+
+    void CallbackHandlers::dispatch(const CallbackMap::value_type& callback)
+    {
+        ROSAIC_TRACE_SCOPE((callback.first == message_id_) ? "decode" : "assembly",
+                           callback.first);
+        if (!monitor_latency_)
+        {
+            callback.second->handle(rx_message_, callback.first);
+            return;
         }
+        Timestamp publishing_time = latency_monitor_.publishingTime();
+        Timestamp start = node_->getTime();
+        callback.second->handle(rx_message_, callback.first);
+        // Publishing is a stage of its own
+        Timestamp end = node_->getTime() -
+                        (latency_monitor_.publishingTime() - publishing_time);
+        LatencyMonitor::Stage stage = (callback.first == message_id_)
+                                          ? LatencyMonitor::DECODE
+                                          : LatencyMonitor::ASSEMBLY;
+        latency_monitor_.add(stage, callback.first, start, end);
+    }
+
+    void CallbackHandlers::recordStages(Timestamp found_time)
+    {
+        const std::string& id = message_id_;
+        Timestamp handoff_time = rx_message_.handoffTime();
+        Timestamp pickup_time = rx_message_.pickupTime();
+        latency_monitor_.add(LatencyMonitor::RECEIVE, id, message_recv_time_,
+                             handoff_time);
+        latency_monitor_.add(LatencyMonitor::HANDOFF, id, handoff_time, pickup_time);
+        latency_monitor_.add(LatencyMonitor::DETECTION, id, pickup_time, found_time);
+
+        Timestamp now = node_->getTime();
+        if (latency_diagnostics_time_ == 0)
+            latency_diagnostics_time_ = now;
+        if (now - latency_diagnostics_time_ <
+            static_cast<Timestamp>(settings_->latency_diagnostics_period) * 1000000000)
+            return;
+        DiagnosticArrayMsg msg = latency_monitor_.report();
+        msg.header.stamp = timestampToRos(now);
+        msg.header.frame_id = settings_->frame_id;
+        // The report itself is not measured
+        monitor_latency_ = false;
+        node_->publishMessage<DiagnosticArrayMsg>("/diagnostics", msg);
+        monitor_latency_ = true;
+        latency_diagnostics_time_ = now;
+    }
+
+    void CallbackHandlers::recordPublication(const std::string& topic,
+                                             Timestamp start)
+    {
+        if (!monitor_latency_)
+            return;
+        Timestamp end = node_->getTime();
+        latency_monitor_.add(LatencyMonitor::PUBLISH, topic, start, end);
+        latency_monitor_.add(LatencyMonitor::END_TO_END, topic, message_recv_time_,
+                             end);
+    }
+
+    void CallbackHandlers::publishMessageCounters()
+    {
+        Timestamp now = node_->getTime();
+        if (message_counters_time_ == 0)
+            message_counters_time_ = now;
+        if (now - message_counters_time_ <
+            static_cast<Timestamp>(settings_->message_counters_period) * 1000000000)
+            return;
+        DiagnosticArrayMsg msg;
+        msg.header.stamp = timestampToRos(now);
+        msg.header.frame_id = settings_->frame_id;
+        msg.status.push_back(rx_message_.counters().diagnostics());
+        bool monitor_latency = monitor_latency_;
+        monitor_latency_ = false;
+        node_->publishMessage<DiagnosticArrayMsg>("/diagnostics", msg);
+        monitor_latency_ = monitor_latency;
+        message_counters_time_ = now;
+    }
+
+    void CallbackHandlers::resetConnectionDescriptor()
+    {
+        rx_message_.resetConnectionDescriptor();
+        boost::mutex::scoped_lock lock(cd_mutex_);
+        cd_received_ = false;
+    }
+
+    void CallbackHandlers::setRinexWriter(RinexWriter* rinex_writer)
+    {
+        rx_message_.setRinexWriter(rinex_writer);
+    }
+
+    void CallbackHandlers::appendRawSBF(const uint8_t* block)
+    {
+        uint16_t id = parsing_utilities::getId(block);
+        if (!settings_->raw_sbf_block_ids.empty() &&
+            (std::find(settings_->raw_sbf_block_ids.begin(),
+                       settings_->raw_sbf_block_ids.end(),
+                       static_cast<int32_t>(id)) ==
+             settings_->raw_sbf_block_ids.end()))
+            return;
+        uint16_t length = parsing_utilities::getLength(block);
+        raw_sbf_.block_ids.push_back(id);
+        raw_sbf_.offsets.push_back(static_cast<uint32_t>(raw_sbf_.data.size()));
+        raw_sbf_.data.insert(raw_sbf_.data.end(), block, block + length);
+    }
+
+    void CallbackHandlers::dropRawSBF(std::size_t blocks)
+    {
+        if (raw_sbf_.block_ids.size() <= blocks)
+            return;
+        raw_sbf_.data.resize(raw_sbf_.offsets[blocks]);
+        raw_sbf_.block_ids.resize(blocks);
+        raw_sbf_.offsets.resize(blocks);
+    }
+
+    void CallbackHandlers::recordLatency()
+    {
+        Timestamp now = node_->getTime();
+        Timestamp recv_time = rx_message_.recvTime();
+        latency_.add((now > recv_time) ? now - recv_time : 0);
+        if (latency_report_time_ == 0)
+            latency_report_time_ = now;
+        if (now - latency_report_time_ < LATENCY_REPORT_PERIOD)
+            return;
+        node_->log(settings_->low_latency ? LogLevel::INFO : LogLevel::DEBUG,
+                   "Byte-to-publish latency of the last " +
+                       std::to_string(latency_.count()) +
+                       " messages: " + latency_.summary());
+        latency_.reset();
+        latency_report_time_ = now;
+    }
+
+    void CallbackHandlers::publishRawSBF(Timestamp recvTimestamp)
+    {
+        if (raw_sbf_.block_ids.empty())
+            return;
+        raw_sbf_.header.stamp = timestampToRos(recvTimestamp);
+        raw_sbf_.header.frame_id = settings_->frame_id;
+        node_->publishMessage<RawSBFMsg>("/raw_sbf", raw_sbf_);
+        // Keeps the capacity for the next buffer
+        raw_sbf_.block_ids.clear();
+        raw_sbf_.offsets.clear();
+        raw_sbf_.data.clear();
     }
 } // namespace io_comm_rx
\ No newline at end of file
@@ -0,0 +1,153 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/clock_estimator.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * @file clock_estimator.cpp
+ * @date 19/10/26
+ * @brief Estimates the offset of the host clock from GNSS time via minimum delays
+ */
+
+namespace io_comm_rx {
+
+    const Timestamp ClockEstimator::BUCKET_DURATION;
+    constexpr double ClockEstimator::STEP_THRESHOLD;
+    constexpr double ClockEstimator::MIN_REJECTION_RESIDUAL;
+    constexpr double ClockEstimator::LATENCY_WEIGHT;
+
+    ClockEstimator::ClockEstimator(Timestamp window) : window_(window) {}
+
+    bool ClockEstimator::update(Timestamp gnss_time, Timestamp host_time)
+    {
+        int64_t delay =
+            static_cast<int64_t>(host_time) - static_cast<int64_t>(gnss_time);
+        if (fitted_ > 0)
+        {
+            double excess = delay - predict(gnss_time);
+            if (std::abs(excess) > STEP_THRESHOLD)
+            {
+                // Either clock was stepped, e.g. the host clock by NTP
+                buckets_.clear();
+                fitted_ = 0;
+                latency_ = 0.0;
+                latency_sq_ = 0.0;
+                ++resets_;
+            } else
+            {
+                latency_ += LATENCY_WEIGHT * (excess - latency_);
+                latency_sq_ += LATENCY_WEIGHT * (excess * excess - latency_sq_);
+            }
+        }
+
+        if (!buckets_.empty() && (gnss_time / BUCKET_DURATION ==
+                                  buckets_.back().gnss_time / BUCKET_DURATION))
+        {
+            if (delay < buckets_.back().delay)
+                buckets_.back() = {gnss_time, delay};
+            return false;
+        }
+        buckets_.push_back({gnss_time, delay});
+        while (buckets_.front().gnss_time + window_ < gnss_time)
+            buckets_.pop_front();
+        if (buckets_.size() < 2)
+            return false;
+        fit();
+        return true;
+    }
+
+    void ClockEstimator::fit()
+    {
+        // The last bucket has just been started, hence it is not used
+        std::vector<Bucket> minima(buckets_.begin(), buckets_.end() - 1);
+        reference_ = minima.back().gnss_time;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            double n = minima.size();
+            double mean_x = 0.0, mean_y = 0.0;
+            for (const auto& m : minima)
+            {
+                mean_x += static_cast<int64_t>(m.gnss_time - reference_) / n;
+                mean_y += m.delay / n;
+            }
+            double sxx = 0.0, sxy = 0.0;
+            for (const auto& m : minima)
+            {
+                double dx = static_cast<int64_t>(m.gnss_time - reference_) - mean_x;
+                sxx += dx * dx;
+                sxy += dx * (m.delay - mean_y);
+            }
+            drift_ = (sxx > 0.0) ? sxy / sxx : 0.0;
+            offset_ = mean_y - drift_ * mean_x;
+            fitted_ = minima.size();
+            if (pass == 1 || minima.size() < 3)
+                break;
+
+            // Reject minima far above the line, the threshold being three times
+            // the median absolute residual
+            std::vector<double> residuals;
+            for (const auto& m : minima)
+                residuals.push_back(std::abs(m.delay - predict(m.gnss_time)));
+            std::nth_element(residuals.begin(),
+                             residuals.begin() + residuals.size() / 2,
+                             residuals.end());
+            double threshold = std::max(MIN_REJECTION_RESIDUAL,
+                                        3.0 * residuals[residuals.size() / 2]);
+            std::vector<Bucket> kept;
+            for (const auto& m : minima)
+                if (m.delay - predict(m.gnss_time) <= threshold)
+                    kept.push_back(m);
+            if (kept.size() == minima.size() || kept.size() < 2)
+                break;
+            minima.swap(kept);
+        }
+    }
+
+    double ClockEstimator::predict(Timestamp gnss_time) const
+    {
+        return offset_ +
+               drift_ * static_cast<int64_t>(gnss_time - reference_);
+    }
+
+    Timestamp ClockEstimator::toHost(Timestamp gnss_time) const
+    {
+        return static_cast<Timestamp>(static_cast<int64_t>(gnss_time) +
+                                      std::llround(predict(gnss_time)));
+    }
+
+    double ClockEstimator::jitter() const
+    {
+        return std::sqrt(std::max(0.0, latency_sq_ - latency_ * latency_)) * 1.0e-9;
+    }
+} // namespace io_comm_rx
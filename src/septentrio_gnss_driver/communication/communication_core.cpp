@@ -28,13 +28,29 @@
 //
 // *****************************************************************************
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
 #include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/serial.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <termios.h>
 
 // Boost includes
 #include <boost/regex.hpp>
 
 #include <septentrio_gnss_driver/communication/communication_core.hpp>
+#include <septentrio_gnss_driver/communication/compressed_file_reader.hpp>
 #include <septentrio_gnss_driver/communication/pcap_reader.hpp>
+#include <septentrio_gnss_driver/communication/sbf_file_decoder.hpp>
 
 #ifndef ANGLE_MAX
 #define ANGLE_MAX 180
@@ -98,42 +114,59 @@
  * @brief Highest-Level view on communication services
  */
 
-//! Mutex to control changes of global variable "g_response_received"
-boost::mutex g_response_mutex;
-//! Determines whether a command reply was received from the Rx
-bool g_response_received;
-//! Condition variable complementing "g_response_mutex"
-boost::condition_variable g_response_condition;
-//! Mutex to control changes of global variable "g_cd_received"
-boost::mutex g_cd_mutex;
-//! Determines whether the connection descriptor was received from the Rx
-bool g_cd_received;
-//! Condition variable complementing "g_cd_mutex"
-boost::condition_variable g_cd_condition;
-//! Whether or not we still want to read the connection descriptor, which we only
-//! want in the very beginning to know whether it is IP10, IP11 etc.
-bool g_read_cd;
-//! Rx TCP port, e.g. IP10 or IP11, to which ROSaic is connected to
-std::string g_rx_tcp_port;
-//! Since after SSSSSSSSSSS we need to wait for second connection descriptor, we have
-//! to count the connection descriptors
-uint32_t g_cd_count;
-
-io_comm_rx::Comm_IO::Comm_IO(ROSaicNodeBase* node, Settings* settings) : 
+io_comm_rx::Comm_IO::Comm_IO(
+    ROSaicNodeBase* node, Settings* settings,
+    boost::shared_ptr<boost::asio::io_service> shared_io_service) :
     node_(node),
     handlers_(node, settings),
     settings_(settings),
+    shared_io_service_(shared_io_service),
     stopping_(false)
 {
-    g_response_received = false;
-    g_cd_received = false;
-    g_read_cd = true;
-    g_cd_count = 0;
 }
 
+boost::shared_ptr<boost::asio::io_service> io_comm_rx::Comm_IO::ioService()
+{
+    if (shared_io_service_)
+        return shared_io_service_;
+    return boost::shared_ptr<boost::asio::io_service>(new boost::asio::io_service);
+}
+
+std::string io_comm_rx::Comm_IO::prometheusMetrics()
+{
+    std::string labels;
+    if (!node_->receiverName().empty())
+        labels = "receiver=\"" + node_->receiverName() + "\"";
+    return handlers_.messageCounters().prometheus(labels);
+}
+
+#ifdef ROSAIC_TRACING
+bool io_comm_rx::Comm_IO::dumpTrace(std::string& message)
+{
+    std::time_t now = std::time(nullptr);
+    std::tm utc;
+    gmtime_r(&now, &utc);
+    char time_string[16];
+    std::strftime(time_string, sizeof(time_string), "%Y%m%d_%H%M%S", &utc);
+    bool success =
+        trace::dump(settings_->trace_path + "_" + time_string + ".json", message);
+    node_->log(success ? LogLevel::INFO : LogLevel::ERROR,
+               success ? "Dumped the trace to " + message : message);
+    return success;
+}
+#endif
+
 void io_comm_rx::Comm_IO::initializeIO()
 {
     node_->log(LogLevel::DEBUG, "Called initializeIO() method");
+    if (settings_->prometheus_port != 0)
+        exporter_.reset(new PrometheusExporter(
+            node_, settings_->prometheus_address,
+            static_cast<uint16_t>(settings_->prometheus_port),
+            boost::bind(&Comm_IO::prometheusMetrics, this)));
+#ifdef ROSAIC_TRACING
+    node_->advertiseTrigger("dump_trace", boost::bind(&Comm_IO::dumpTrace, this, _1));
+#endif
     boost::smatch match;
     // In fact: smatch is a typedef of match_results<string::const_iterator>
     if (boost::regex_match(settings_->device, match, boost::regex("(tcp)://(.+):(\\d+)")))
@@ -150,16 +183,48 @@ void io_comm_rx::Comm_IO::initializeIO()
         tcp_host_ = match[2];
         tcp_port_ = match[3];
 
-        serial_ = false;
+        transport_ = TRANSPORT_TCP;
         settings_->read_from_sbf_log = false;
         settings_->read_from_pcap = false;
+        settings_->receive_only = false;
         connectionThread_.reset(new  boost::thread (boost::bind(&Comm_IO::connect, this)));
     } else if (boost::regex_match(settings_->device, match,
-                                  boost::regex("(file_name):(/|(?:/[\\w-]+)+.sbf)")))
+                                  boost::regex("(udp)://(.+):(\\d+)")))
+    {
+        // host is the local address to listen on or the multicast group to join
+        udp_host_ = match[2];
+        udp_port_ = match[3];
+
+        transport_ = TRANSPORT_UDP;
+        settings_->read_from_sbf_log = false;
+        settings_->read_from_pcap = false;
+        settings_->receive_only = true;
+        node_->log(LogLevel::INFO,
+                   "The Rx cannot be configured via UDP, its output has to be set up "
+                   "beforehand, e.g. via its web interface.");
+        connectionThread_.reset(new  boost::thread (boost::bind(&Comm_IO::connect, this)));
+    } else if (boost::regex_match(settings_->device, match,
+                                  boost::regex("(unix|fifo):(/.+)")))
+    {
+        // Stream relayed by a local multiplexer
+        local_path_ = match[2];
+        if (match[1] == "unix")
+            transport_ = TRANSPORT_UNIX;
+        else
+            transport_ = TRANSPORT_FIFO;
+        settings_->read_from_sbf_log = false;
+        settings_->read_from_pcap = false;
+        settings_->receive_only = true;
+        node_->log(LogLevel::INFO,
+                   "The Rx is not configured via " + std::string(match[1]) +
+                       ":, its output has to be set up beforehand.");
+        connectionThread_.reset(new  boost::thread (boost::bind(&Comm_IO::connect, this)));
+    } else if (boost::regex_match(settings_->device, match,
+                                  boost::regex("(file_name):(/|(?:/[\\w-]+)+.sbf(?:\\.gz|\\.zst)?)")))
     {
-        serial_ = false;
         settings_->read_from_sbf_log = true;
         settings_->read_from_pcap = false;
+        settings_->receive_only = false;
         settings_->use_gnss_time = true;
         connectionThread_.reset(new  boost::thread (
             boost::bind(&Comm_IO::prepareSBFFileReading, this, match[2])));
@@ -168,18 +233,19 @@ void io_comm_rx::Comm_IO::initializeIO()
                    settings_->device, match,
                    boost::regex("(file_name):(/|(?:/[\\w-]+)+.pcap)")))
     {
-        serial_ = false;
         settings_->read_from_sbf_log = false;
         settings_->read_from_pcap = true;
+        settings_->receive_only = false;
         settings_->use_gnss_time = true;
         connectionThread_.reset(new  boost::thread (
             boost::bind(&Comm_IO::preparePCAPFileReading, this, match[2])));
 
     } else if (boost::regex_match(settings_->device, match, boost::regex("(serial):(.+)")))
     {
-        serial_ = true;
+        transport_ = TRANSPORT_SERIAL;
         settings_->read_from_sbf_log = false;
         settings_->read_from_pcap = false;
+        settings_->receive_only = false;
         std::string proto(match[2]);
         std::stringstream ss;
         ss << "Searching for serial port" << proto;
@@ -189,7 +255,7 @@ void io_comm_rx::Comm_IO::initializeIO()
     } else
     {
         std::stringstream ss;
-        ss << "Device is unsupported. Perhaps you meant 'tcp://host:port' or 'file_name:xxx.sbf' or 'serial:/path/to/device'?";
+        ss << "Device is unsupported. Perhaps you meant 'tcp://host:port' or 'udp://host:port' or 'unix:/path' or 'fifo:/path' or 'file_name:xxx.sbf' (optionally .sbf.gz or .sbf.zst) or 'serial:/path/to/device'?";
         node_->log(LogLevel::ERROR, ss.str());
     }
     node_->log(LogLevel::DEBUG, "Leaving initializeIO() method");
@@ -202,7 +268,10 @@ void io_comm_rx::Comm_IO::prepareSBFFileReading(std::string file_name)
         std::stringstream ss;
         ss << "Setting up everything needed to read from" << file_name;
         node_->log(LogLevel::DEBUG, ss.str());
-        initializeSBFFileReading(file_name);
+        if (CompressedFileReader::isCompressed(file_name))
+            initializeCompressedSBFFileReading(file_name);
+        else
+            initializeSBFFileReading(file_name);
     } catch (std::runtime_error& e)
     {
         std::stringstream ss;
@@ -232,18 +301,133 @@ void io_comm_rx::Comm_IO::preparePCAPFileReading(std::string file_name)
 void io_comm_rx::Comm_IO::connect()
 {
     node_->log(LogLevel::DEBUG, "Called connect() method");
-    node_->log(LogLevel::DEBUG, 
-        "Started timer for calling reconnect() method until connection succeeds");
-
-    boost::asio::io_service io;
-    boost::posix_time::millisec wait_ms(static_cast<uint32_t>(settings_->reconnect_delay_s * 1000));
-    while (!connected_ && !stopping_)
+    uint32_t attempt = 0;
+    while (!stopping_)
     {
-        boost::asio::deadline_timer t(io, wait_ms);
         reconnect();
-        t.wait();
+        if (!connected_)
+        {
+            double delay = backoffDelay(attempt++);
+            node_->log(LogLevel::INFO, "Connecting again in " +
+                                           std::to_string(delay) + " s.");
+            boost::mutex::scoped_lock lock(connection_mutex_);
+            connection_condition_.wait_for(
+                lock,
+                boost::chrono::milliseconds(static_cast<int64_t>(delay * 1000)),
+                [this]() { return stopping_.load(); });
+            continue;
+        }
+        attempt = 0;
+        boost::shared_ptr<Manager> manager = currentManager();
+        if (outage_start_ != 0)
+        {
+            reconnect_time_ = monotonicTime();
+            // The output of the Rx is bound to the connection, at least via TCP
+            if (configure_rx_)
+                configureRx();
+        }
+
+        superviseConnection(manager);
+        if (stopping_)
+            break;
+
+        // Only the transport is rebuilt, the callback handlers are kept
+        Timestamp first_receive_time = manager->firstReceiveTime();
+        Timestamp last_receive_time = manager->lastReceiveTime();
+        if (last_receive_time > first_receive_time)
+            outage_byte_rate_ = manager->bytesReceived() * 1.0e9 /
+                                (last_receive_time - first_receive_time);
+        // A connection lost again before data arrived continues the same outage
+        if (outage_start_ == 0)
+            outage_start_ =
+                (last_receive_time != 0) ? last_receive_time : monotonicTime();
+        node_->log(LogLevel::WARN,
+                   "Lost the connection to the Rx after receiving " +
+                       std::to_string(manager->bytesReceived()) +
+                       " bytes, reconnecting.");
+        {
+            boost::mutex::scoped_lock lock(connection_mutex_);
+            connected_ = false;
+        }
+        {
+            boost::mutex::scoped_lock lock(manager_mutex_);
+            manager_.reset();
+        }
+        // Joins the threads of the lost connection
+        manager.reset();
+        link_lost_ = false;
+    }
+    node_->log(LogLevel::DEBUG, "Leaving connect() method");
+}
+
+void io_comm_rx::Comm_IO::superviseConnection(const boost::shared_ptr<Manager>& manager)
+{
+    Timestamp connect_time = monotonicTime();
+    bool recovering = (outage_start_ != 0);
+    while (!stopping_ && !link_lost_ && !manager->linkLost())
+    {
+        {
+            boost::mutex::scoped_lock lock(connection_mutex_);
+            connection_condition_.wait_for(lock, boost::chrono::milliseconds(100));
+        }
+        Timestamp first_receive_time = manager->firstReceiveTime();
+        if (recovering && first_receive_time != 0)
+        {
+            recovering = false;
+            double outage = (first_receive_time - outage_start_) / 1.0e9;
+            uint64_t bytes_lost = static_cast<uint64_t>(outage * outage_byte_rate_);
+            ++outages_;
+            outage_duration_total_ += outage;
+            bytes_lost_total_ += bytes_lost;
+            node_->log(LogLevel::WARN,
+                       "Recovered the connection to the Rx after an outage of " +
+                           std::to_string(outage) + " s, about " +
+                           std::to_string(bytes_lost) + " bytes lost, first byte " +
+                           std::to_string((first_receive_time - reconnect_time_) /
+                                          1000000) +
+                           " ms after reconnecting. " + std::to_string(outages_) +
+                           " outages of " + std::to_string(outage_duration_total_) +
+                           " s and about " + std::to_string(bytes_lost_total_) +
+                           " bytes lost so far.");
+            outage_start_ = 0;
+        }
+        if (settings_->reconnect_data_timeout_s > 0.0f)
+        {
+            Timestamp last_receive_time = manager->lastReceiveTime();
+            if (last_receive_time == 0)
+                last_receive_time = connect_time;
+            if (monotonicTime() - last_receive_time >
+                static_cast<Timestamp>(settings_->reconnect_data_timeout_s * 1.0e9))
+            {
+                node_->log(LogLevel::WARN,
+                           "Nothing received from the Rx for " +
+                               std::to_string(settings_->reconnect_data_timeout_s) +
+                               " s.");
+                link_lost_ = true;
+            }
+        }
     }
-    node_->log(LogLevel::DEBUG, "Successully connected. Leaving connect() method");
+}
+
+double io_comm_rx::Comm_IO::backoffDelay(uint32_t attempt)
+{
+    double delay = settings_->reconnect_delay_s *
+                   std::pow(2.0, static_cast<double>(std::min(attempt, 16u)));
+    delay = std::min(delay, static_cast<double>(settings_->reconnect_max_delay_s));
+    std::uniform_real_distribution<double> jitter(0.5 * delay, delay);
+    return jitter(random_);
+}
+
+void io_comm_rx::Comm_IO::linkLost()
+{
+    link_lost_ = true;
+    connection_condition_.notify_all();
+}
+
+boost::shared_ptr<io_comm_rx::Manager> io_comm_rx::Comm_IO::currentManager()
+{
+    boost::mutex::scoped_lock lock(manager_mutex_);
+    return manager_;
 }
 
 //! In serial mode (not USB, since the Rx port is then called USB1 or USB2), please
@@ -252,55 +436,62 @@ void io_comm_rx::Comm_IO::connect()
 void io_comm_rx::Comm_IO::reconnect()
 {
     node_->log(LogLevel::DEBUG, "Called reconnect() method");
-    if (serial_)
+    bool initialize_return = false;
+    std::string failure;
+    try
     {
-        bool initialize_serial_return = false;
-        try
+        switch (transport_)
         {
+        case TRANSPORT_SERIAL:
+        {
+            failure = "initializeSerial() failed for device " + settings_->device;
             node_->log(LogLevel::INFO, "Connecting serially to device" + settings_->device + 
                                        ", targeted baudrate: " + std::to_string(settings_->baudrate));
-            initialize_serial_return =
+            initialize_return =
                 initializeSerial(settings_->device, settings_->baudrate, settings_->hw_flow_control);
-        } catch (std::runtime_error& e)
+            break;
+        }
+        case TRANSPORT_UDP:
         {
-            {
-                std::stringstream ss;
-                ss << "initializeSerial() failed for device " << settings_->device
-                    << " due to: " << e.what();
-                node_->log(LogLevel::ERROR, ss.str());
-            }
+            failure = "initializeUDP() failed for host " + udp_host_ + " on port " + udp_port_;
+            node_->log(LogLevel::INFO, "Listening on udp://" + udp_host_ + ":" + udp_port_ +
+                                       "...");
+            initialize_return = initializeUDP(udp_host_, udp_port_);
+            break;
         }
-        if (initialize_serial_return)
+        case TRANSPORT_UNIX:
         {
-            boost::mutex::scoped_lock lock(connection_mutex_);
-            connected_ = true;
-            lock.unlock();
-            connection_condition_.notify_one();
+            failure = "initializeUnix() failed for socket " + local_path_;
+            node_->log(LogLevel::INFO, "Connecting to unix:" + local_path_ + "...");
+            initialize_return = initializeUnix(local_path_);
+            break;
         }
-    } else
-    {
-        bool initialize_tcp_return = false;
-        try
+        case TRANSPORT_FIFO:
+        {
+            failure = "initializeFifo() failed for named pipe " + local_path_;
+            node_->log(LogLevel::INFO, "Opening fifo:" + local_path_ + "...");
+            initialize_return = initializeFifo(local_path_);
+            break;
+        }
+        default:
         {
+            failure = "initializeTCP() failed for host " + tcp_host_ + " on port " + tcp_port_;
             node_->log(LogLevel::INFO, "Connecting to tcp://" + tcp_host_ + ":" + tcp_port_ +
                                        "...");
-            initialize_tcp_return = initializeTCP(tcp_host_, tcp_port_);
-        } catch (std::runtime_error& e)
-        {
-            {
-                std::stringstream ss;
-                ss << "initializeTCP() failed for host " << tcp_host_
-                    << " on port " << tcp_port_ << " due to: " << e.what();
-                node_->log(LogLevel::ERROR, ss.str());
-            }
+            initialize_return = initializeTCP(tcp_host_, tcp_port_);
+            break;
         }
-        if (initialize_tcp_return)
-        {
-            boost::mutex::scoped_lock lock(connection_mutex_);
-            connected_ = true;
-            lock.unlock();
-            connection_condition_.notify_one();
         }
+    } catch (std::runtime_error& e)
+    {
+        node_->log(LogLevel::ERROR, failure + " due to: " + e.what());
+    }
+    if (initialize_return)
+    {
+        boost::mutex::scoped_lock lock(connection_mutex_);
+        connected_ = true;
+        lock.unlock();
+        connection_condition_.notify_all();
     }
     node_->log(LogLevel::DEBUG, "Leaving reconnect() method");
 }
@@ -315,11 +506,18 @@ void io_comm_rx::Comm_IO::reconnect()
 void io_comm_rx::Comm_IO::configureRx()
 {
     node_->log(LogLevel::DEBUG, "Called configureRx() method");
+    configure_rx_ = true;
+    boost::mutex::scoped_lock lock_configure(configure_mutex_);
     {
         // wait for connection
         boost::mutex::scoped_lock lock(connection_mutex_);
-        connection_condition_.wait(lock, [this]() { return connected_; });
+        connection_condition_.wait(lock, [this]() { return connected_ || stopping_; });
     }       
+    // Configuring is given up if the connection is lost meanwhile, it is
+    // configured again once reconnected
+    boost::shared_ptr<Manager> manager = currentManager();
+    if (!manager)
+        return;
 
     
 
@@ -331,18 +529,24 @@ void io_comm_rx::Comm_IO::configureRx()
     std::string rx_port;
     if (proto == "tcp")
     {
-        // It is imperative to hold a lock on the mutex  "g_cd_mutex" while
-        // modifying the variable and "g_cd_received".
-        boost::mutex::scoped_lock lock_cd(g_cd_mutex);
+        // It is imperative to hold a lock on the mutex "cd_mutex_" while
+        // modifying the variable "cd_received_".
+        boost::mutex::scoped_lock lock_cd(handlers_.cd_mutex_);
         // Escape sequence (escape from correction mode), ensuring that we can send
         // our real commands afterwards...
         std::string cmd("\x0DSSSSSSSSSSSSSSSSSSS\x0D\x0D");
-        manager_.get()->send(cmd, cmd.size());
+        manager->send(cmd, cmd.size());
         // We wait for the connection descriptor before we send another command,
         // otherwise the latter would not be processed.
-        g_cd_condition.wait(lock_cd, []() { return g_cd_received; });
-        g_cd_received = false;
-        rx_port = g_rx_tcp_port;
+        while (!handlers_.cd_condition_.wait_for(
+            lock_cd, boost::chrono::milliseconds(100),
+            [this]() { return handlers_.cd_received_; }))
+        {
+            if (stopping_ || manager->linkLost() || currentManager() != manager)
+                return;
+        }
+        handlers_.cd_received_ = false;
+        rx_port = handlers_.rx_tcp_port_;
     } else
     {
         rx_port = settings_->rx_serial_port;
@@ -441,7 +645,8 @@ void io_comm_rx::Comm_IO::configureRx()
             blocks << " +AttCovEuler";
         }
         if (settings_->publish_measepoch ||
-            settings_->publish_gpsfix)
+            settings_->publish_gpsfix ||
+            !settings_->rinex_path.empty())
         {
             blocks << " +MeasEpoch";
         } 
@@ -902,11 +1107,18 @@ void io_comm_rx::Comm_IO::defineMessages()
             handlers_.insert<AttCovEulerMsg>("5939");
     }
     if (settings_->publish_measepoch ||
-        settings_->publish_gpsfix)
+        settings_->publish_gpsfix ||
+        !settings_->rinex_path.empty())
     {
         handlers_.callbackmap_ =
                 handlers_.insert<int32_t>("4027"); // MeasEpoch block
     } 
+    if (!settings_->rinex_path.empty() && !rinex_writer_)
+    {
+        rinex_writer_.reset(new RinexWriter(node_, settings_));
+        if (rinex_writer_->active())
+            handlers_.setRinexWriter(rinex_writer_.get());
+    }
 
 	// INS-related SBF blocks
     if (settings_->publish_insnavcart)
@@ -1040,15 +1252,33 @@ void io_comm_rx::Comm_IO::defineMessages()
     node_->log(LogLevel::DEBUG, "Leaving defineMessages() method");
 }
 
+void io_comm_rx::Comm_IO::waitForFileReading()
+{
+    // The connection thread reads the whole file, then returns
+    if ((settings_->read_from_sbf_log || settings_->read_from_pcap) &&
+        connectionThread_ && connectionThread_->joinable())
+        connectionThread_->join();
+}
+
 void io_comm_rx::Comm_IO::send(std::string cmd)
 {
-    // It is imperative to hold a lock on the mutex "g_response_mutex" while
-    // modifying the variable "g_response_received".
-    boost::mutex::scoped_lock lock(g_response_mutex);
+    // It is imperative to hold a lock on the mutex "response_mutex_" while
+    // modifying the variable "response_received_".
+    boost::mutex::scoped_lock lock(handlers_.response_mutex_);
+    boost::shared_ptr<Manager> manager = currentManager();
+    if (!manager)
+        return;
     // Determine byte size of cmd and hand over to send() method of manager_
-    manager_.get()->send(cmd, cmd.size());
-    g_response_condition.wait(lock, []() { return g_response_received; });
-    g_response_received = false;
+    manager->send(cmd, cmd.size());
+    // The response does not come if the connection is lost meanwhile
+    while (!handlers_.response_condition_.wait_for(
+        lock, boost::chrono::milliseconds(100),
+        [this]() { return handlers_.response_received_; }))
+    {
+        if (stopping_ || manager->linkLost() || currentManager() != manager)
+            return;
+    }
+    handlers_.response_received_ = false;
 }
 
 bool io_comm_rx::Comm_IO::initializeTCP(std::string host, std::string port)
@@ -1058,8 +1288,7 @@ bool io_comm_rx::Comm_IO::initializeTCP(std::string host, std::string port)
     port_ = port;
     // The io_context, of which io_service is a typedef of; it represents your
     // program's link to the operating system's I/O services.
-    boost::shared_ptr<boost::asio::io_service> io_service(
-        new boost::asio::io_service);
+    boost::shared_ptr<boost::asio::io_service> io_service = ioService();
     boost::asio::ip::tcp::resolver::iterator endpoint;
 
     try
@@ -1091,6 +1320,8 @@ bool io_comm_rx::Comm_IO::initializeTCP(std::string host, std::string port)
         // boost::asio::connect() function does this for us automatically.
         socket->connect(*endpoint);
         socket->set_option(boost::asio::ip::tcp::no_delay(true));
+        if (settings_->low_latency)
+            configureLowLatency(*socket);
     } catch (std::runtime_error& e)
     {
         throw std::runtime_error("Could not connect to " + endpoint->host_name() +
@@ -1107,63 +1338,278 @@ bool io_comm_rx::Comm_IO::initializeTCP(std::string host, std::string port)
             "You have called the InitializeTCP() method though an AsyncManager object is already available! Start all anew..");
         return false;
     }
-    setManager(boost::shared_ptr<Manager>(
-        new AsyncManager<boost::asio::ip::tcp::socket>(node_, socket, io_service)));
+    boost::shared_ptr<AsyncManager<boost::asio::ip::tcp::socket>> manager(
+        new AsyncManager<boost::asio::ip::tcp::socket>(
+            node_, socket, io_service, 131072, shared_io_service_ != nullptr));
+    manager->setQuickAck(settings_->low_latency);
+    setManager(manager);
     node_->log(LogLevel::DEBUG, "Leaving initializeTCP() method..");
     return true;
 }
 
+void io_comm_rx::Comm_IO::configureLowLatency(int fd)
+{
+    // Readable as soon as a byte arrived, without an inter-byte timer
+    termios tio;
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    serial_struct serial_info;
+    bool tuned = (ioctl(fd, TIOCGSERIAL, &serial_info) != -1);
+    if (tuned)
+    {
+        serial_info.flags |= ASYNC_LOW_LATENCY;
+        tuned = (ioctl(fd, TIOCSSERIAL, &serial_info) != -1);
+    }
+    if (!tuned)
+    {
+        node_->log(LogLevel::WARN,
+                   "Could not set the serial port to low latency (ASYNC_LOW_LATENCY): " +
+                       std::string(std::strerror(errno)));
+        return;
+    }
+    node_->log(LogLevel::INFO, "Serial port tuned for low latency.");
+}
+
+void io_comm_rx::Comm_IO::configureLowLatency(boost::asio::ip::tcp::socket& socket)
+{
+    boost::system::error_code error;
+    socket.set_option(boost::asio::socket_base::receive_buffer_size(
+                          LOW_LATENCY_RECEIVE_BUFFER_SIZE_),
+                      error);
+    if (!error)
+        socket.set_option(boost::asio::socket_base::receive_low_watermark(1), error);
+    if (error)
+        node_->log(LogLevel::WARN,
+                   "Could not tune the TCP socket for low latency: " + error.message());
+    if (settings_->low_latency_busy_poll_us > 0)
+    {
+        int busy_poll = static_cast<int>(settings_->low_latency_busy_poll_us);
+        // Increasing it beyond net.core.busy_read requires CAP_NET_ADMIN
+        if (setsockopt(socket.native_handle(), SOL_SOCKET, SO_BUSY_POLL, &busy_poll,
+                       sizeof(busy_poll)) == -1)
+            node_->log(LogLevel::WARN, "Could not set SO_BUSY_POLL: " +
+                                           std::string(std::strerror(errno)));
+    }
+    node_->log(LogLevel::INFO, "TCP connection tuned for low latency.");
+}
+
+bool io_comm_rx::Comm_IO::initializeUDP(std::string host, std::string port)
+{
+    node_->log(LogLevel::DEBUG, "Calling initializeUDP() method..");
+    boost::shared_ptr<boost::asio::io_service> io_service = ioService();
+    boost::asio::ip::udp::endpoint endpoint;
+
+    try
+    {
+        boost::asio::ip::udp::resolver resolver(*io_service);
+        endpoint = *resolver.resolve(boost::asio::ip::udp::resolver::query(
+            host, port, boost::asio::ip::udp::resolver::query::numeric_service));
+    } catch (std::runtime_error& e)
+    {
+        throw std::runtime_error("Could not resolve " + host + " on port " + port +
+                                 ": " + e.what());
+        return false;
+    }
+
+    boost::shared_ptr<boost::asio::ip::udp::socket> socket(
+        new boost::asio::ip::udp::socket(*io_service));
+
+    try
+    {
+        socket->open(endpoint.protocol());
+        socket->set_option(boost::asio::ip::udp::socket::reuse_address(true));
+        if (endpoint.address().is_multicast())
+        {
+            // Listen on all interfaces and join the group, such that other
+            // processes on this host may join it, too
+            boost::asio::ip::udp::endpoint any(endpoint.protocol(), endpoint.port());
+            socket->bind(any);
+            socket->set_option(
+                boost::asio::ip::multicast::join_group(endpoint.address()));
+        } else
+        {
+            socket->bind(endpoint);
+        }
+        // A large socket buffer absorbs bursts while the I/O thread is busy, the
+        // kernel caps it at net.core.rmem_max
+        boost::system::error_code error;
+        socket->set_option(
+            boost::asio::socket_base::receive_buffer_size(UDP_RECEIVE_BUFFER_SIZE_),
+            error);
+    } catch (std::runtime_error& e)
+    {
+        throw std::runtime_error("Could not listen on " + host + ":" + port + ": " +
+                                 e.what());
+        return false;
+    }
+
+    node_->log(LogLevel::INFO, "Listening on " + endpoint.address().to_string() + 
+                               ":" + std::to_string(endpoint.port()) + ".");
+
+    if (manager_)
+    {
+        node_->log(LogLevel::ERROR, 
+            "You have called the InitializeUDP() method though an AsyncManager object is already available! Start all anew..");
+        return false;
+    }
+    setManager(boost::shared_ptr<Manager>(
+        new AsyncManager<boost::asio::ip::udp::socket>(
+            node_, socket, io_service, 131072, shared_io_service_ != nullptr)));
+    udp_statistics_.reset(new UdpStatistics(node_));
+    manager_->addRawCallback(
+        boost::bind(&UdpStatistics::datagram, udp_statistics_.get(), _1, _2, _3));
+    node_->log(LogLevel::DEBUG, "Leaving initializeUDP() method..");
+    return true;
+}
+
+bool io_comm_rx::Comm_IO::initializeUnix(std::string path)
+{
+    node_->log(LogLevel::DEBUG, "Calling initializeUnix() method..");
+    boost::shared_ptr<boost::asio::io_service> io_service = ioService();
+    boost::shared_ptr<boost::asio::local::stream_protocol::socket> socket(
+        new boost::asio::local::stream_protocol::socket(*io_service));
+
+    try
+    {
+        socket->connect(boost::asio::local::stream_protocol::endpoint(path));
+    } catch (std::runtime_error& e)
+    {
+        throw std::runtime_error("Could not connect to " + path + ": " + e.what());
+        return false;
+    }
+
+    node_->log(LogLevel::INFO, "Connected to " + path + ".");
+
+    if (manager_)
+    {
+        node_->log(LogLevel::ERROR, 
+            "You have called the InitializeUnix() method though an AsyncManager object is already available! Start all anew..");
+        return false;
+    }
+    setManager(boost::shared_ptr<Manager>(
+        new AsyncManager<boost::asio::local::stream_protocol::socket>(
+            node_, socket, io_service, 131072, shared_io_service_ != nullptr)));
+    node_->log(LogLevel::DEBUG, "Leaving initializeUnix() method..");
+    return true;
+}
+
+bool io_comm_rx::Comm_IO::initializeFifo(std::string path)
+{
+    node_->log(LogLevel::DEBUG, "Calling initializeFifo() method..");
+    // Opening for writing, too, neither blocks until the multiplexer opens the pipe
+    // nor signals the end of the stream whenever it closes the pipe, such that it
+    // can reopen it at any time. Linux defines this for FIFOs, unlike POSIX.
+    int fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open " + path + ": " +
+                                 std::strerror(errno));
+        return false;
+    }
+    struct stat status;
+    if ((fstat(fd, &status) != 0) || !S_ISFIFO(status.st_mode))
+    {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a named pipe");
+        return false;
+    }
+
+    boost::shared_ptr<boost::asio::io_service> io_service = ioService();
+    boost::shared_ptr<boost::asio::posix::stream_descriptor> descriptor(
+        new boost::asio::posix::stream_descriptor(*io_service, fd));
+
+    node_->log(LogLevel::INFO, "Opened " + path + ".");
+
+    if (manager_)
+    {
+        node_->log(LogLevel::ERROR, 
+            "You have called the InitializeFifo() method though an AsyncManager object is already available! Start all anew..");
+        return false;
+    }
+    setManager(boost::shared_ptr<Manager>(
+        new AsyncManager<boost::asio::posix::stream_descriptor>(
+            node_, descriptor, io_service, 131072, shared_io_service_ != nullptr)));
+    node_->log(LogLevel::DEBUG, "Leaving initializeFifo() method..");
+    return true;
+}
+
 void io_comm_rx::Comm_IO::initializeSBFFileReading(std::string file_name)
 {
     node_->log(LogLevel::DEBUG, "Calling initializeSBFFileReading() method..");
-    std::size_t buffer_size = 131072;
-    uint8_t* to_be_parsed;
-    to_be_parsed = new uint8_t[buffer_size];
+    if (settings_->decode_threads > 1)
+    {
+        SBFFileDecoder decoder(node_, &handlers_, settings_->decode_threads);
+        decoder.decode(file_name, stopping_);
+        node_->log(LogLevel::DEBUG, "Leaving initializeSBFFileReading() method..");
+        return;
+    }
     std::ifstream bin_file(file_name, std::ios::binary);
     std::vector<uint8_t> vec_buf;
     if (bin_file.good())
     {
         /* Reads binary data using streambuffer iterators.
         Copies all SBF file content into bin_data. */
-        std::vector<uint8_t> v_buf((std::istreambuf_iterator<char>(bin_file)),
-                                   (std::istreambuf_iterator<char>()));
-        vec_buf = v_buf;
+        vec_buf.assign(std::istreambuf_iterator<char>(bin_file),
+                       std::istreambuf_iterator<char>());
         bin_file.close();
     } else
     {
         throw std::runtime_error("I could not find your file. Or it is corrupted.");
     }
-    // The spec now guarantees that vectors store their elements contiguously.
-    to_be_parsed = vec_buf.data();
     std::stringstream ss;
     ss << "Opened and copied over from " << file_name;
     node_->log(LogLevel::DEBUG, ss.str());
 
-    while (!stopping_) // Loop will stop if we are done reading the SBF file
+    parseFileContent(vec_buf);
+    node_->log(LogLevel::DEBUG, "Leaving initializeSBFFileReading() method..");
+}
+
+void io_comm_rx::Comm_IO::initializeCompressedSBFFileReading(std::string file_name)
+{
+    node_->log(LogLevel::DEBUG, "Calling initializeCompressedSBFFileReading() method..");
+    if (settings_->decode_threads > 1)
     {
-        try
-        {
-            node_->log(LogLevel::DEBUG, 
-                "Calling read_callback_() method, with number of bytes to be parsed being " +
-                buffer_size);
-            handlers_.readCallback(node_->getTime(), to_be_parsed, buffer_size);
-        } catch (std::size_t& parsing_failed_here)
+        node_->log(LogLevel::WARN, "Parallel decoding needs an uncompressed SBF file, " 
+                                   "decoding " + file_name + " with one thread.");
+        settings_->decode_threads = 1;
+    }
+    CompressedFileReader reader(node_, file_name);
+    // An SBF block is at most 65535 bytes long, if more bytes are left over after
+    // a failure, it was not caused by a block being cut at the end of a chunk
+    const std::size_t max_block_length = 65535;
+    std::vector<uint8_t> chunk;
+    // Decompressed data, starting with the incomplete message of the last chunk
+    std::vector<uint8_t> vec_buf;
+    while (!stopping_ && reader.read(chunk))
+    {
+        vec_buf.insert(vec_buf.end(), chunk.begin(), chunk.end());
+        std::size_t offset = 0;
+        while (offset < vec_buf.size() && !stopping_)
         {
-            if (to_be_parsed - vec_buf.data() >= vec_buf.size() * sizeof(uint8_t))
+            std::size_t buffer_size = vec_buf.size() - offset;
+            try
             {
-                break;
+                handlers_.readCallback(node_->getTime(), vec_buf.data() + offset,
+                                       buffer_size);
+                offset = vec_buf.size();
+            } catch (std::size_t& parsing_failed_here)
+            {
+                offset += parsing_failed_here;
+                if (vec_buf.size() - offset <= max_block_length)
+                    break;
+                ++offset;
             }
-            to_be_parsed = to_be_parsed + parsing_failed_here;
-            node_->log(LogLevel::DEBUG, "Parsing_failed_here is " + parsing_failed_here);
-            continue;
-        }
-        if (to_be_parsed - vec_buf.data() >= vec_buf.size() * sizeof(uint8_t))
-        {
-            break;
         }
-        to_be_parsed = to_be_parsed + buffer_size;
+        vec_buf.erase(vec_buf.begin(), vec_buf.begin() + offset);
     }
-    node_->log(LogLevel::DEBUG, "Leaving initializeSBFFileReading() method..");
+    // No chunk follows to complete the messages kept back, hence the messages
+    // behind one that fails are searched for as in an uncompressed file
+    parseFileContent(vec_buf);
+    node_->log(LogLevel::DEBUG, "Leaving initializeCompressedSBFFileReading() method..");
 }
 
 void io_comm_rx::Comm_IO::initializePCAPFileReading(std::string file_name)
@@ -1171,6 +1617,7 @@ void io_comm_rx::Comm_IO::initializePCAPFileReading(std::string file_name)
     node_->log(LogLevel::DEBUG, "Calling initializePCAPFileReading() method..");
     pcapReader::buffer_t vec_buf;
     pcapReader::PcapDevice device(node_, vec_buf);
+    device.setPause(settings_->file_reading_realtime);
 
     if (!device.connect(file_name.c_str()))
     {
@@ -1183,38 +1630,33 @@ void io_comm_rx::Comm_IO::initializePCAPFileReading(std::string file_name)
         ;
     device.disconnect();
 
-    std::size_t buffer_size = pcapReader::PcapDevice::BUFFSIZE;
-    uint8_t* to_be_parsed = new uint8_t[buffer_size];
-    to_be_parsed = vec_buf.data();
+    parseFileContent(vec_buf);
+    node_->log(LogLevel::DEBUG, "Leaving initializePCAPFileReading() method..");
+}
 
-    while (!stopping_) // Loop will stop if we are done reading the SBF file
+void io_comm_rx::Comm_IO::parseFileContent(const std::vector<uint8_t>& content)
+{
+    std::size_t offset = 0;
+    while (!stopping_ && offset < content.size())
     {
+        // Only the bytes left in the file, messages reaching beyond are incomplete
+        std::size_t buffer_size = content.size() - offset;
         try
         {
-            node_->log(LogLevel::DEBUG, 
+            ROSAIC_DEBUG(node_,
                 "Calling read_callback_() method, with number of bytes to be parsed being " +
-                buffer_size);
-            handlers_.readCallback(node_->getTime(), to_be_parsed, buffer_size);
+                std::to_string(buffer_size));
+            handlers_.readCallback(node_->getTime(), content.data() + offset,
+                                   buffer_size);
+            break;
         } catch (std::size_t& parsing_failed_here)
         {
-            if (to_be_parsed - vec_buf.data() >= vec_buf.size() * sizeof(uint8_t))
-            {
-                break;
-            }
-            if (!parsing_failed_here)
-                parsing_failed_here = 1;
-
-            to_be_parsed = to_be_parsed + parsing_failed_here;
-            node_->log(LogLevel::DEBUG, "Parsing_failed_here is " + parsing_failed_here);
-            continue;
-        }
-        if (to_be_parsed - vec_buf.data() >= vec_buf.size() * sizeof(uint8_t))
-        {
-            break;
+            // No more bytes will complete the message, hence search for the next
+            // one behind its first byte
+            offset += parsing_failed_here + 1;
+            ROSAIC_DEBUG(node_, "Parsing_failed_here is " + std::to_string(parsing_failed_here));
         }
-        to_be_parsed = to_be_parsed + buffer_size;
     }
-    node_->log(LogLevel::DEBUG, "Leaving initializePCAPFileReading() method..");
 }
 
 bool io_comm_rx::Comm_IO::initializeSerial(std::string port, uint32_t baudrate,
@@ -1225,8 +1667,7 @@ bool io_comm_rx::Comm_IO::initializeSerial(std::string port, uint32_t baudrate,
     baudrate_ = baudrate;
     // The io_context, of which io_service is a typedef of; it represents your
     // program's link to the operating system's I/O services.
-    boost::shared_ptr<boost::asio::io_service> io_service(
-        new boost::asio::io_service);
+    boost::shared_ptr<boost::asio::io_service> io_service = ioService();
     // To perform I/O operations the program needs an I/O object, here "serial".
     boost::shared_ptr<boost::asio::serial_port> serial(
         new boost::asio::serial_port(*io_service));
@@ -1277,6 +1718,58 @@ bool io_comm_rx::Comm_IO::initializeSerial(std::string port, uint32_t baudrate,
         // *termios_p);
         tcsetattr(fd, TCSANOW, &tio);
     }
+    if (settings_->low_latency)
+        configureLowLatency(serial->native_handle());
+
+    // The baudrate of the Rx is detected and switched to the desired one before a
+    // manager reads from the port
+    if (settings_->autobaud)
+    {
+        Timestamp open_time = monotonicTime();
+        uint32_t detected = detectBaudrate(*serial);
+        if (detected == 0)
+        {
+            node_->log(LogLevel::WARN,
+                       "The Rx did not answer at any baudrate, using " +
+                           std::to_string(baudrate_) + " baud.");
+            serial->set_option(boost::asio::serial_port_base::baud_rate(baudrate_));
+        } else
+        {
+            node_->log(LogLevel::INFO,
+                       "The Rx answered at " + std::to_string(detected) + " baud " +
+                           std::to_string((monotonicTime() - open_time) / 1000000) +
+                           " ms after opening the port.");
+            if (detected != baudrate_)
+            {
+                if (switchBaudrate(*serial))
+                {
+                    node_->log(LogLevel::INFO,
+                               "Switched the Rx from " + std::to_string(detected) +
+                                   " to " + std::to_string(baudrate_) +
+                                   " baud, it answered " +
+                                   std::to_string((monotonicTime() - open_time) /
+                                                  1000000) +
+                                   " ms after opening the port.");
+                } else
+                {
+                    // The Rx may not support the baudrate at this port, it is
+                    // looked for again
+                    node_->log(LogLevel::WARN,
+                               "The Rx did not answer at " +
+                                   std::to_string(baudrate_) +
+                                   " baud after switching to it.");
+                    detected = detectBaudrate(*serial);
+                    if (detected != 0)
+                        baudrate_ = detected;
+                    serial->set_option(
+                        boost::asio::serial_port_base::baud_rate(baudrate_));
+                }
+            }
+        }
+    } else
+    {
+        serial->set_option(boost::asio::serial_port_base::baud_rate(baudrate_));
+    }
 
     // Set the I/O manager
     if (manager_)
@@ -1287,106 +1780,195 @@ bool io_comm_rx::Comm_IO::initializeSerial(std::string port, uint32_t baudrate,
     }
     node_->log(LogLevel::DEBUG, "Creating new Async-Manager object..");
     setManager(boost::shared_ptr<Manager>(
-        new AsyncManager<boost::asio::serial_port>(node_, serial, io_service)));
+        new AsyncManager<boost::asio::serial_port>(
+            node_, serial, io_service, 131072, shared_io_service_ != nullptr)));
 
-    // Setting the baudrate, incrementally..
-    node_->log(LogLevel::DEBUG, "Gradually increasing the baudrate to the desired value...");
-    boost::asio::serial_port_base::baud_rate current_baudrate;
-    node_->log(LogLevel::DEBUG, "Initiated current_baudrate object...");
-    try
-    {
-        serial->get_option(
-            current_baudrate); // Note that this sets current_baudrate.value() often
-                               // to 115200, since by default, all Rx COM ports,
-        // at least for mosaic Rxs, are set to a baudrate of 115200 baud, using 8
-        // data-bits, no parity and 1 stop-bit.
-    } catch (boost::system::system_error& e)
-    {
+    node_->log(LogLevel::INFO, "Set ASIO baudrate to " + std::to_string(baudrate_)  + 
+                               ", leaving InitializeSerial() method");
+    return true;
+}
 
-        node_->log(LogLevel::ERROR, "get_option failed due to " +std::string( e.what()));
-        node_->log(LogLevel::INFO, "Additional info about error is " +
-                 boost::diagnostic_information(e));
-        /*
-        boost::system::error_code e_loop;
-        do // Caution: Might cause infinite loop..
+uint32_t io_comm_rx::Comm_IO::detectBaudrate(boost::asio::serial_port& serial)
+{
+    // Most likely first, i.e. the factory default and the usual rates of the COM
+    // ports, then the others from fast to slow
+    std::vector<uint32_t> candidates = {baudrate_, detected_baudrate_, 115200,
+                                        921600,    460800,             230400};
+    for (std::size_t i = sizeof(BAUDRATES) / sizeof(BAUDRATES[0]); i > 0; --i)
+        candidates.push_back(BAUDRATES[i - 1]);
+    std::vector<uint32_t> probed;
+    for (uint32_t candidate : candidates)
+    {
+        if (stopping_)
+            return 0;
+        if (candidate == 0 ||
+            std::find(probed.begin(), probed.end(), candidate) != probed.end())
+            continue;
+        probed.push_back(candidate);
+        if (probeBaudrate(serial, candidate))
         {
-            serial->get_option(current_baudrate, e_loop);
-        } while(e_loop);
-        */
-        return false;
+            detected_baudrate_ = candidate;
+            return candidate;
+        }
     }
-    // Gradually increase the baudrate to the desired value
-    // The desired baudrate can be lower or larger than the
-    // current baudrate; the for loop takes care of both scenarios.
-    node_->log(LogLevel::DEBUG, "Current baudrate is " + std::to_string(current_baudrate.value()));
-    for (uint8_t i = 0; i < sizeof(BAUDRATES) / sizeof(BAUDRATES[0]); i++)
+    return 0;
+}
+
+bool io_comm_rx::Comm_IO::probeBaudrate(boost::asio::serial_port& serial,
+                                        uint32_t baudrate)
+{
+    boost::system::error_code error;
+    serial.set_option(boost::asio::serial_port_base::baud_rate(baudrate), error);
+    if (error)
     {
-        if (current_baudrate.value() == baudrate_)
-        {
-            break; // Break if the desired baudrate has been reached.
-        }
-        if (current_baudrate.value() >= BAUDRATES[i] && baudrate_ > BAUDRATES[i])
-        {
+        node_->log(LogLevel::DEBUG, "Cannot set " + std::to_string(baudrate) +
+                                        " baud: " + error.message());
+        return false;
+    }
+    int fd = serial.native_handle();
+    // Whatever was received at the previous baudrate is garbage
+    tcflush(fd, TCIOFLUSH);
+    // The escape sequence of configureRx(), answered with the prompt in any mode
+    std::string probe("\x0DSSSSSSSSSSSSSSSSSSS\x0D");
+    boost::asio::write(serial, boost::asio::buffer(probe), error);
+    if (error)
+        return false;
+    // 10 bits per byte for the probe and the answer
+    int window_ms = AUTOBAUD_WINDOW_MS_ +
+                    static_cast<int>((probe.size() + 64) * 10000 / baudrate);
+    Timestamp deadline = monotonicTime() + static_cast<Timestamp>(window_ms) * 1000000;
+    std::string received;
+    char buffer[1024];
+    for (Timestamp now = monotonicTime(); now < deadline; now = monotonicTime())
+    {
+        pollfd readable = {fd, POLLIN, 0};
+        int ready = ::poll(&readable, 1,
+                           static_cast<int>((deadline - now + 999999) / 1000000));
+        if (ready < 0 && errno == EINTR)
             continue;
-        }
-        // Increment until Baudrate[i] matches current_baudrate.
-        try
-        {
-            serial->set_option(
-                boost::asio::serial_port_base::baud_rate(BAUDRATES[i]));
-        } catch (boost::system::system_error& e)
+        if (ready <= 0)
+            break;
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (n <= 0)
+            break;
+        received.append(buffer, n);
+        if (containsRxOutput(received))
         {
-
-            node_->log(LogLevel::ERROR, "set_option failed due to " + std::string(e.what()));
-            node_->log(LogLevel::INFO, "Additional info about error is " +
-                     boost::diagnostic_information(e));
-            return false;
+            node_->log(LogLevel::DEBUG,
+                       "The Rx answers at " + std::to_string(baudrate) + " baud.");
+            return true;
         }
-        usleep(SET_BAUDRATE_SLEEP_);
-        // boost::this_thread::sleep(boost::posix_time::milliseconds(SET_BAUDRATE_SLEEP_*1000));
-        // Boost's sleep would yield an error message with exit code -7 the second
-        // time it is called, hence we use sleep() or usleep().
-        try
-        {
-            serial->get_option(current_baudrate);
-        } catch (boost::system::system_error& e)
-        {
+        // An SBF block is at most 65535 bytes
+        if (received.size() > 131072)
+            received.erase(0, received.size() - 65536);
+    }
+    node_->log(LogLevel::DEBUG, "No valid output of the Rx at " +
+                                    std::to_string(baudrate) + " baud.");
+    return false;
+}
 
-            node_->log(LogLevel::ERROR, "get_option failed due to " + std::string(e.what()));
-            node_->log(LogLevel::INFO, "Additional info about error is " +
-                     boost::diagnostic_information(e));
-            /*
-            boost::system::error_code e_loop;
-            do // Caution: Might cause infinite loop..
-            {
-                serial->get_option(current_baudrate, e_loop);
-            } while(e_loop);
-            */
-            return false;
+bool io_comm_rx::Comm_IO::switchBaudrate(boost::asio::serial_port& serial)
+{
+    std::string cmd = "setCOMSettings, " + settings_->rx_serial_port + ", baud" +
+                      std::to_string(baudrate_) + " \x0D";
+    boost::system::error_code error;
+    boost::asio::write(serial, boost::asio::buffer(cmd), error);
+    if (error)
+        return false;
+    // The Rx answers at the baudrate it had, then switches
+    tcdrain(serial.native_handle());
+    usleep(AUTOBAUD_WINDOW_MS_ * 1000);
+    if (!probeBaudrate(serial, baudrate_))
+        return false;
+    detected_baudrate_ = baudrate_;
+    return true;
+}
+
+bool io_comm_rx::Comm_IO::containsRxOutput(const std::string& data)
+{
+    // Prompt of the connection, e.g. "COM1>" or "USB2>"
+    static const boost::regex prompt("[A-Z]{2,4}[0-9]{1,2}>");
+    if (boost::regex_search(data, prompt))
+        return true;
+    for (std::size_t pos = data.find('$'); pos != std::string::npos;
+         pos = data.find('$', pos + 1))
+    {
+        const uint8_t* message = reinterpret_cast<const uint8_t*>(data.data()) + pos;
+        std::size_t available = data.size() - pos;
+        if (available >= 8 && message[1] == '@')
+        {
+            uint16_t length = parsing_utilities::getLength(message);
+            if (length >= 8 && length % 4 == 0 && length <= available &&
+                isValid(message))
+                return true;
+            continue;
         }
-        node_->log(LogLevel::DEBUG, "Set ASIO baudrate to " + std::to_string(current_baudrate.value()));
+        // NMEA sentence "$...*hh" of printable characters
+        uint8_t checksum = 0;
+        std::size_t i = 1;
+        for (; i < available && message[i] != '*' && message[i] >= 0x20 &&
+               message[i] < 0x7f;
+             ++i)
+            checksum ^= message[i];
+        if (i < 6 || i + 2 >= available || message[i] != '*')
+            continue;
+        if (std::isxdigit(message[i + 1]) && std::isxdigit(message[i + 2]) &&
+            std::stoi(data.substr(pos + i + 1, 2), nullptr, 16) == checksum)
+            return true;
     }
-    node_->log(LogLevel::INFO, "Set ASIO baudrate to " + std::to_string(current_baudrate.value())  + 
-                               ", leaving InitializeSerial() method");
-    return true;
+    return false;
 }
 
 void io_comm_rx::Comm_IO::setManager(const boost::shared_ptr<Manager>& manager)
 {
     node_->log(LogLevel::DEBUG, "Called setManager() method");
+    boost::mutex::scoped_lock lock(manager_mutex_);
     if (manager_)
         return;
     manager_ = manager;
+    // The previous manager and its parsing thread are gone by now
+    handlers_.resetConnectionDescriptor();
     manager_->setCallback(
-        boost::bind(&CallbackHandlers::readCallback, &handlers_, _1, _2, _3));
+        boost::bind(&CallbackHandlers::readCallback, &handlers_, _1, _2, _3, _4));
+    manager_->setDisconnectCallback(boost::bind(&Comm_IO::linkLost, this));
+    manager_->configureThreads(settings_->realtime_io, settings_->realtime_parsing);
+    if (!settings_->raw_recording_path.empty())
+    {
+        if (!recorder_)
+            recorder_.reset(new RawRecorder(
+                node_, settings_->raw_recording_path,
+                static_cast<uint64_t>(settings_->raw_recording_max_file_size_mb) *
+                    1024 * 1024,
+                settings_->raw_recording_rotation_period_s,
+                settings_->raw_recording_compress,
+                static_cast<std::size_t>(settings_->raw_recording_buffer_size_mb) *
+                    1024 * 1024));
+        manager_->addRawCallback(
+            boost::bind(&RawRecorder::write, recorder_.get(), _1, _2, _3));
+    }
+    if (settings_->black_box_size_mb > 0)
+    {
+        if (!black_box_)
+        {
+            black_box_.reset(new BlackBox(
+                node_,
+                static_cast<std::size_t>(settings_->black_box_size_mb) * 1024 * 1024,
+                settings_->black_box_path));
+            node_->advertiseTrigger(
+                "dump_black_box", boost::bind(&BlackBox::dump, black_box_.get(), _1));
+        }
+        manager_->addRawCallback(
+            boost::bind(&BlackBox::write, black_box_.get(), _1, _2, _3));
+    }
     node_->log(LogLevel::DEBUG, "Leaving setManager() method");
 }
 
 void io_comm_rx::Comm_IO::resetSerial(std::string port)
 {
     serial_port_ = port;
-    boost::shared_ptr<boost::asio::io_service> io_service(
-        new boost::asio::io_service);
+    boost::shared_ptr<boost::asio::io_service> io_service = ioService();
     boost::shared_ptr<boost::asio::serial_port> serial(
         new boost::asio::serial_port(*io_service));
 
@@ -1406,7 +1988,8 @@ void io_comm_rx::Comm_IO::resetSerial(std::string port)
     if (manager_)
         return;
     setManager(boost::shared_ptr<Manager>(
-        new AsyncManager<boost::asio::serial_port>(node_, serial, io_service)));
+        new AsyncManager<boost::asio::serial_port>(
+            node_, serial, io_service, 131072, shared_io_service_ != nullptr)));
 
     // Set the baudrate
     serial->set_option(boost::asio::serial_port_base::baud_rate(baudrate_));
@@ -0,0 +1,215 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/compressed_file_reader.hpp>
+
+// Boost includes
+#include <boost/algorithm/string/predicate.hpp>
+
+/**
+ * @file compressed_file_reader.cpp
+ * @date 19/10/26
+ * @brief Defines a class for streaming decompression of SBF logs
+ */
+
+namespace io_comm_rx {
+
+    CompressedFileReader::CompressedFileReader(ROSaicNodeBase* node,
+                                               const std::string& file_name) :
+        node_(node),
+        file_name_(file_name)
+    {
+        if (boost::algorithm::ends_with(file_name, ".gz"))
+        {
+            codec_ = GZIP;
+            gz_file_ = gzopen(file_name.c_str(), "rb");
+            if (!gz_file_)
+                throw std::runtime_error("I could not find your file. Or it is corrupted.");
+            // Larger internal buffer than the default 8 KiB for fewer reads
+            gzbuffer(gz_file_, 256 * 1024);
+        } else if (boost::algorithm::ends_with(file_name, ".zst"))
+        {
+#ifdef HAVE_ZSTD
+            codec_ = ZSTD;
+            zstd_file_ = fopen(file_name.c_str(), "rb");
+            if (!zstd_file_)
+                throw std::runtime_error("I could not find your file. Or it is corrupted.");
+            zstd_context_ = ZSTD_createDCtx();
+            zstd_input_.resize(ZSTD_DStreamInSize());
+            zstd_input_buffer_ = ZSTD_inBuffer{zstd_input_.data(), 0, 0};
+#else
+            throw std::runtime_error(
+                "This driver was built without zstd support, please install libzstd and rebuild.");
+#endif
+        } else
+        {
+            throw std::runtime_error("Unknown compression format of " + file_name);
+        }
+        decompression_thread_ =
+            boost::thread(boost::bind(&CompressedFileReader::decompress, this));
+    }
+
+    CompressedFileReader::~CompressedFileReader()
+    {
+        {
+            boost::mutex::scoped_lock lock(queue_mutex_);
+            stopping_ = true;
+        }
+        chunk_free_condition_.notify_all();
+        decompression_thread_.join();
+        if (gz_file_)
+            gzclose(gz_file_);
+#ifdef HAVE_ZSTD
+        if (zstd_context_)
+            ZSTD_freeDCtx(zstd_context_);
+        if (zstd_file_)
+            fclose(zstd_file_);
+#endif
+    }
+
+    bool CompressedFileReader::isCompressed(const std::string& file_name)
+    {
+        return boost::algorithm::ends_with(file_name, ".gz") ||
+               boost::algorithm::ends_with(file_name, ".zst");
+    }
+
+    bool CompressedFileReader::read(std::vector<uint8_t>& chunk)
+    {
+        boost::mutex::scoped_lock lock(queue_mutex_);
+        while (queue_.empty() && !done_)
+            chunk_ready_condition_.wait(lock);
+        if (queue_.empty())
+            return false;
+        if (chunk.capacity() > 0)
+            free_chunks_.push_back(std::move(chunk));
+        chunk = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        chunk_free_condition_.notify_one();
+        return true;
+    }
+
+    void CompressedFileReader::decompress()
+    {
+        std::size_t total = 0;
+        while (true)
+        {
+            std::vector<uint8_t> chunk;
+            {
+                boost::mutex::scoped_lock lock(queue_mutex_);
+                while (queue_.size() >= QUEUE_LENGTH && !stopping_)
+                    chunk_free_condition_.wait(lock);
+                if (stopping_)
+                    break;
+                if (!free_chunks_.empty())
+                {
+                    chunk = std::move(free_chunks_.back());
+                    free_chunks_.pop_back();
+                }
+            }
+            chunk.resize(CHUNK_SIZE);
+            std::size_t size = 0;
+            try
+            {
+                size = decompressChunk(chunk.data(), chunk.size());
+            } catch (std::runtime_error& e)
+            {
+                node_->log(LogLevel::ERROR, "Decompression of " + file_name_ +
+                                                " failed after " +
+                                                std::to_string(total) +
+                                                " bytes: " + e.what());
+            }
+            if (size == 0)
+                break;
+            total += size;
+            chunk.resize(size);
+            {
+                boost::mutex::scoped_lock lock(queue_mutex_);
+                queue_.push_back(std::move(chunk));
+            }
+            chunk_ready_condition_.notify_one();
+        }
+        ROSAIC_DEBUG(node_, "Decompressed " + std::to_string(total) +
+                                        " bytes from " + file_name_);
+        {
+            boost::mutex::scoped_lock lock(queue_mutex_);
+            done_ = true;
+        }
+        chunk_ready_condition_.notify_all();
+    }
+
+    std::size_t CompressedFileReader::decompressChunk(uint8_t* out,
+                                                      std::size_t capacity)
+    {
+        if (codec_ == GZIP)
+        {
+            // gzread() transparently continues with concatenated gzip members
+            int size = gzread(gz_file_, out, static_cast<unsigned int>(capacity));
+            if (size < 0)
+            {
+                int errnum;
+                throw std::runtime_error(gzerror(gz_file_, &errnum));
+            }
+            return static_cast<std::size_t>(size);
+        }
+#ifdef HAVE_ZSTD
+        ZSTD_outBuffer output{out, capacity, 0};
+        while (output.pos < output.size)
+        {
+            if (zstd_input_buffer_.pos == zstd_input_buffer_.size)
+            {
+                zstd_input_buffer_.size =
+                    fread(zstd_input_.data(), 1, zstd_input_.size(), zstd_file_);
+                zstd_input_buffer_.pos = 0;
+                if (zstd_input_buffer_.size == 0)
+                {
+                    // Unlike gzread(), zstd does not report a file cut within a
+                    // frame, e.g. one still being written by the logger
+                    if (zstd_frame_open_)
+                        node_->log(LogLevel::WARN,
+                                   "The last zstd frame of " + file_name_ +
+                                       " is incomplete, the file is truncated.");
+                    zstd_frame_open_ = false;
+                    break;
+                }
+            }
+            std::size_t ret =
+                ZSTD_decompressStream(zstd_context_, &output, &zstd_input_buffer_);
+            if (ZSTD_isError(ret))
+                throw std::runtime_error(ZSTD_getErrorName(ret));
+            // 0 once a frame is completely decoded and flushed
+            zstd_frame_open_ = (ret != 0);
+        }
+        return output.pos;
+#else
+        return 0;
+#endif
+    }
+} // namespace io_comm_rx
@@ -0,0 +1,107 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/latency_monitor.hpp>
+
+/**
+ * @file latency_monitor.cpp
+ * @date 19/10/26
+ * @brief Implements the latencies of the stages a message passes from the socket
+ * to its publication
+ */
+
+namespace io_comm_rx {
+
+    void LatencyMonitor::add(Stage stage, const std::string& key, Timestamp start,
+                             Timestamp end)
+    {
+        if (start == 0)
+            return;
+        // Clocks of different threads may disagree by a few ns
+        Timestamp latency = (end > start) ? end - start : 0;
+        statistics_[stage][key].add(latency);
+        if (stage == PUBLISH)
+            publishing_time_ += latency;
+    }
+
+    DiagnosticArrayMsg LatencyMonitor::report()
+    {
+        DiagnosticArrayMsg msg;
+        for (std::size_t stage = 0; stage < STAGES; ++stage)
+        {
+            DiagnosticStatusMsg status;
+            status.level = DiagnosticStatusMsg::OK;
+            status.name = std::string("latency: ") + name(static_cast<Stage>(stage));
+            status.message = "p50, p99, p99.9 and max in us, number of samples";
+            for (auto& entry : statistics_[stage])
+            {
+                LatencyStatistics& statistics = entry.second;
+                if (statistics.count() == 0)
+                    continue;
+                DiagnosticKeyValueMsg value;
+                value.key = entry.first;
+                value.value = std::to_string(statistics.percentile(0.5) / 1000) + ", " +
+                              std::to_string(statistics.percentile(0.99) / 1000) +
+                              ", " +
+                              std::to_string(statistics.percentile(0.999) / 1000) +
+                              ", " + std::to_string(statistics.max() / 1000) + ", " +
+                              std::to_string(statistics.count());
+                status.values.push_back(value);
+                statistics.reset();
+            }
+            if (!status.values.empty())
+                msg.status.push_back(status);
+        }
+        return msg;
+    }
+
+    const char* LatencyMonitor::name(Stage stage)
+    {
+        switch (stage)
+        {
+        case RECEIVE:
+            return "receive";
+        case HANDOFF:
+            return "handoff";
+        case DETECTION:
+            return "frame detection";
+        case DECODE:
+            return "decode";
+        case ASSEMBLY:
+            return "composite assembly";
+        case PUBLISH:
+            return "publish";
+        case END_TO_END:
+            return "end-to-end";
+        default:
+            return "";
+        }
+    }
+} // namespace io_comm_rx
@@ -0,0 +1,96 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/latency_statistics.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file latency_statistics.cpp
+ * @date 19/10/26
+ * @brief Implements the statistics of latencies reported periodically
+ */
+
+namespace io_comm_rx {
+
+    void LatencyStatistics::add(Timestamp latency)
+    {
+        std::size_t bucket = 0;
+        if (latency >= 1000)
+            bucket = std::min(
+                BUCKETS - 1,
+                1 + static_cast<std::size_t>(4.0 * std::log2(latency / 1000.0)));
+        ++histogram_[bucket];
+        sum_ += latency;
+        max_ = std::max(max_, latency);
+        ++count_;
+    }
+
+    Timestamp LatencyStatistics::mean() const
+    {
+        if (count_ == 0)
+            return 0;
+        return static_cast<Timestamp>(sum_ / count_);
+    }
+
+    Timestamp LatencyStatistics::percentile(double fraction) const
+    {
+        uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * count_));
+        uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket)
+        {
+            seen += histogram_[bucket];
+            if (seen >= rank && seen > 0)
+            {
+                // Upper bound of the bucket
+                Timestamp bound =
+                    static_cast<Timestamp>(1000.0 * std::exp2(bucket / 4.0));
+                return std::min(bound, max_);
+            }
+        }
+        return max_;
+    }
+
+    std::string LatencyStatistics::summary() const
+    {
+        return "mean " + std::to_string(mean() / 1000) + " us, p99 " +
+               std::to_string(percentile(0.99) / 1000) + " us, max " +
+               std::to_string(max_ / 1000) + " us";
+    }
+
+    void LatencyStatistics::reset()
+    {
+        histogram_.fill(0);
+        sum_ = 0.0;
+        max_ = 0;
+        count_ = 0;
+    }
+} // namespace io_comm_rx
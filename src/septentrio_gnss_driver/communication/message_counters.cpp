@@ -0,0 +1,196 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/message_counters.hpp>
+// C++ library includes
+#include <cctype>
+#include <cstring>
+#include <sstream>
+
+/**
+ * @file message_counters.cpp
+ * @date 19/10/26
+ * @brief Implements the counters of the messages received and of the failures
+ * to read them
+ */
+
+namespace io_comm_rx {
+
+    const char* const MessageCounters::OTHER_SBF = "other SBF";
+    const char* const MessageCounters::OTHER_NMEA = "other NMEA";
+
+    MessageCounters::MessageCounters()
+    {
+        addKey(OTHER_SBF);
+        addKey(OTHER_NMEA);
+        sbf_.assign(SBF_ID_MASK + 1, counters_[OTHER_SBF].get());
+        other_nmea_ = counters_[OTHER_NMEA].get();
+    }
+
+    void MessageCounters::addKey(const std::string& key)
+    {
+        if (counters_.find(key) != counters_.end())
+            return;
+        Counters* counters = new Counters();
+        counters_[key].reset(counters);
+        if (!key.empty() && key[0] == '$')
+            nmea_.emplace_back(key, counters);
+        else if (!key.empty() && std::isdigit(static_cast<unsigned char>(key[0])))
+            sbf_[std::stoul(key) & SBF_ID_MASK] = counters;
+    }
+
+    MessageCounters::Counters& MessageCounters::nmea(const uint8_t* sentence,
+                                                     std::size_t size)
+    {
+        // The sentence is identified by its first field, e.g. "$GPGGA"
+        const void* comma = std::memchr(sentence, ',', size);
+        std::size_t length =
+            comma ? static_cast<const uint8_t*>(comma) - sentence : size;
+        for (const auto& entry : nmea_)
+        {
+            if ((entry.first.size() == length) &&
+                (std::memcmp(entry.first.data(), sentence, length) == 0))
+                return *entry.second;
+        }
+        return *other_nmea_;
+    }
+
+    void MessageCounters::skipped(std::size_t bytes)
+    {
+        resyncs_.fetch_add(1, std::memory_order_relaxed);
+        skipped_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    DiagnosticStatusMsg MessageCounters::diagnostics()
+    {
+        DiagnosticStatusMsg status;
+        uint64_t failures = this->failures();
+        status.name = "message counters";
+        if (failures > reported_failures_)
+        {
+            status.level = DiagnosticStatusMsg::WARN;
+            status.message = std::to_string(failures - reported_failures_) +
+                             " messages could not be read since the last report";
+        } else
+        {
+            status.level = DiagnosticStatusMsg::OK;
+            status.message = "All messages read since the last report";
+        }
+        reported_failures_ = failures;
+        for (const auto& entry : counters_)
+        {
+            const Counters& counters = *entry.second;
+            uint64_t frames = counters.frames.load(std::memory_order_relaxed);
+            uint64_t crc_failures =
+                counters.crc_failures.load(std::memory_order_relaxed);
+            uint64_t parse_failures =
+                counters.parse_failures.load(std::memory_order_relaxed);
+            uint64_t checksum_failures =
+                counters.checksum_failures.load(std::memory_order_relaxed);
+            if (frames + crc_failures + parse_failures + checksum_failures == 0)
+                continue;
+            DiagnosticKeyValueMsg value;
+            value.key = entry.first;
+            value.value =
+                "frames " + std::to_string(frames) + ", bytes " +
+                std::to_string(counters.bytes.load(std::memory_order_relaxed)) +
+                ", CRC failures " + std::to_string(crc_failures) +
+                ", parse failures " + std::to_string(parse_failures) +
+                ", NMEA checksum failures " + std::to_string(checksum_failures);
+            status.values.push_back(value);
+        }
+        DiagnosticKeyValueMsg value;
+        value.key = "resync";
+        value.value =
+            "resyncs " + std::to_string(resyncs_.load(std::memory_order_relaxed)) +
+            ", bytes skipped " +
+            std::to_string(skipped_bytes_.load(std::memory_order_relaxed));
+        status.values.push_back(value);
+        return status;
+    }
+
+    std::string MessageCounters::prometheus(const std::string& labels) const
+    {
+        typedef std::atomic<uint64_t> Counters::*Member;
+        static const struct
+        {
+            const char* name;
+            const char* help;
+            Member member;
+        } metrics[] = {
+            {"septentrio_gnss_frames_total", "Frames read per message type",
+             &Counters::frames},
+            {"septentrio_gnss_bytes_total", "Bytes of the frames read per message type",
+             &Counters::bytes},
+            {"septentrio_gnss_crc_failures_total",
+             "SBF blocks with invalid CRC per block ID", &Counters::crc_failures},
+            {"septentrio_gnss_parse_failures_total",
+             "Messages that could not be parsed per message type",
+             &Counters::parse_failures},
+            {"septentrio_gnss_nmea_checksum_failures_total",
+             "NMEA sentences with invalid checksum per sentence",
+             &Counters::checksum_failures}};
+        std::string prefix = labels.empty() ? "{" : "{" + labels + ",";
+        std::ostringstream out;
+        for (const auto& metric : metrics)
+        {
+            out << "# HELP " << metric.name << " " << metric.help << "\n"
+                << "# TYPE " << metric.name << " counter\n";
+            for (const auto& entry : counters_)
+                out << metric.name << prefix << "message=\"" << entry.first
+                    << "\"} "
+                    << ((*entry.second).*(metric.member))
+                           .load(std::memory_order_relaxed)
+                    << "\n";
+        }
+        std::string suffix = labels.empty() ? "" : "{" + labels + "}";
+        out << "# HELP septentrio_gnss_resyncs_total Times bytes were skipped to "
+               "find the next message\n"
+            << "# TYPE septentrio_gnss_resyncs_total counter\n"
+            << "septentrio_gnss_resyncs_total" << suffix << " "
+            << resyncs_.load(std::memory_order_relaxed) << "\n"
+            << "# HELP septentrio_gnss_skipped_bytes_total Bytes skipped to find "
+               "the next message\n"
+            << "# TYPE septentrio_gnss_skipped_bytes_total counter\n"
+            << "septentrio_gnss_skipped_bytes_total" << suffix << " "
+            << skipped_bytes_.load(std::memory_order_relaxed) << "\n";
+        return out.str();
+    }
+
+    uint64_t MessageCounters::failures() const
+    {
+        uint64_t failures = 0;
+        for (const auto& entry : counters_)
+            failures += entry.second->crc_failures.load(std::memory_order_relaxed) +
+                        entry.second->parse_failures.load(std::memory_order_relaxed) +
+                        entry.second->checksum_failures.load(std::memory_order_relaxed);
+        return failures;
+    }
+} // namespace io_comm_rx
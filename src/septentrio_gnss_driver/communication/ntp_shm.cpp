@@ -0,0 +1,123 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/ntp_shm.hpp>
+// C++ library includes
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+/**
+ * @file ntp_shm.cpp
+ * @date 19/10/26
+ * @brief Writes time samples to the shared memory reference clock of ntpd and
+ * chrony
+ */
+
+namespace io_comm_rx {
+
+    NtpShm::NtpShm(ROSaicNodeBase* node, uint32_t unit) : node_(node)
+    {
+        int id = shmget(static_cast<key_t>(KEY_BASE + unit), sizeof(ShmTime),
+                        IPC_CREAT | ((unit <= 1) ? 0600 : 0666));
+        if (id == -1)
+        {
+            node_->log(LogLevel::ERROR, "Could not get NTP shared memory unit " +
+                                            std::to_string(unit) + ": " +
+                                            std::strerror(errno));
+            return;
+        }
+        void* shm = shmat(id, nullptr, 0);
+        if (shm == reinterpret_cast<void*>(-1))
+        {
+            node_->log(LogLevel::ERROR, "Could not attach NTP shared memory unit " +
+                                            std::to_string(unit) + ": " +
+                                            std::strerror(errno));
+            return;
+        }
+        shm_ = static_cast<ShmTime*>(shm);
+        shm_->mode = 1;
+        shm_->valid = 0;
+        shm_->precision = PRECISION;
+        shm_->nsamples = 3;
+        node_->log(LogLevel::INFO, "Writing time samples to NTP shared memory unit " +
+                                       std::to_string(unit));
+    }
+
+    NtpShm::~NtpShm()
+    {
+        if (shm_)
+            shmdt(shm_);
+    }
+
+    void NtpShm::write(Timestamp clock_time, Timestamp receive_time)
+    {
+        if (!shm_)
+            return;
+        // In mode 1, the reader discards the sample if count changed while
+        // reading, the barriers keep the fields within the two increments
+        shm_->valid = 0;
+        ++shm_->count;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        shm_->clockTimeStampSec = static_cast<time_t>(clock_time / 1000000000);
+        shm_->clockTimeStampNSec = static_cast<unsigned>(clock_time % 1000000000);
+        shm_->clockTimeStampUSec = static_cast<int>(shm_->clockTimeStampNSec / 1000);
+        shm_->receiveTimeStampSec = static_cast<time_t>(receive_time / 1000000000);
+        shm_->receiveTimeStampNSec = static_cast<unsigned>(receive_time % 1000000000);
+        shm_->receiveTimeStampUSec =
+            static_cast<int>(shm_->receiveTimeStampNSec / 1000);
+        shm_->leap = 0;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ++shm_->count;
+        shm_->valid = 1;
+    }
+
+    bool NtpShm::read(Timestamp& clock_time, Timestamp& receive_time)
+    {
+        if (!shm_ || !shm_->valid)
+            return false;
+        int count = shm_->count;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Timestamp clock_sec = static_cast<Timestamp>(shm_->clockTimeStampSec);
+        Timestamp clock_nsec = shm_->clockTimeStampNSec;
+        Timestamp receive_sec = static_cast<Timestamp>(shm_->receiveTimeStampSec);
+        Timestamp receive_nsec = shm_->receiveTimeStampNSec;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // A writer got in between
+        if (count != shm_->count || !shm_->valid)
+            return false;
+        shm_->valid = 0;
+        clock_time = clock_sec * 1000000000 + clock_nsec;
+        receive_time = receive_sec * 1000000000 + receive_nsec;
+        return true;
+    }
+} // namespace io_comm_rx
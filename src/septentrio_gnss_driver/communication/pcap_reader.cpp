@@ -155,7 +155,8 @@ namespace pcapReader {
                 return READ_ERROR;
             }
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (m_pause)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
             return READ_SUCCESS;
         } else if (result == -2)
@@ -0,0 +1,142 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/prometheus_exporter.hpp>
+// Boost includes
+#include <boost/bind.hpp>
+
+/**
+ * @file prometheus_exporter.cpp
+ * @date 19/10/26
+ * @brief Implements a minimal HTTP server exposing metrics to Prometheus
+ */
+
+namespace io_comm_rx {
+
+    PrometheusExporter::PrometheusExporter(
+        ROSaicNodeBase* node, const std::string& address, uint16_t port,
+        const boost::function<std::string()>& metrics) :
+        node_(node),
+        metrics_(metrics), acceptor_(io_service_)
+    {
+        try
+        {
+            boost::asio::ip::tcp::endpoint endpoint(
+                boost::asio::ip::address::from_string(address), port);
+            acceptor_.open(endpoint.protocol());
+            acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            acceptor_.bind(endpoint);
+            acceptor_.listen();
+        } catch (boost::system::system_error& e)
+        {
+            node_->log(LogLevel::ERROR, "Could not export the metrics on " + address +
+                                            ":" + std::to_string(port) + ": " +
+                                            e.what());
+            return;
+        }
+        accept();
+        thread_ = boost::thread(
+            boost::bind(&boost::asio::io_service::run, &io_service_));
+        node_->log(LogLevel::INFO, "Exporting the metrics on http://" + address +
+                                       ":" + std::to_string(port) + "/metrics");
+    }
+
+    PrometheusExporter::~PrometheusExporter()
+    {
+        io_service_.stop();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    void PrometheusExporter::accept()
+    {
+        std::shared_ptr<Session> session(new Session(io_service_));
+        acceptor_.async_accept(session->socket,
+                               boost::bind(&PrometheusExporter::handleAccept, this,
+                                           session,
+                                           boost::asio::placeholders::error));
+    }
+
+    void PrometheusExporter::handleAccept(const std::shared_ptr<Session>& session,
+                                          const boost::system::error_code& error)
+    {
+        accept();
+        if (error)
+            return;
+        session->timer.expires_from_now(
+            boost::posix_time::seconds(REQUEST_TIMEOUT_S));
+        session->timer.async_wait([session](const boost::system::error_code& error) {
+            if (error != boost::asio::error::operation_aborted)
+            {
+                boost::system::error_code ignored;
+                session->socket.close(ignored);
+            }
+        });
+        boost::asio::async_read_until(
+            session->socket, session->request, "\r\n\r\n",
+            boost::bind(&PrometheusExporter::handleRequest, this, session,
+                        boost::asio::placeholders::error));
+    }
+
+    void PrometheusExporter::handleRequest(const std::shared_ptr<Session>& session,
+                                           const boost::system::error_code& error)
+    {
+        session->timer.cancel();
+        if (error)
+            return;
+        std::istream request(&session->request);
+        std::string method, target;
+        request >> method >> target;
+        if (method != "GET")
+            session->response = "HTTP/1.1 405 Method Not Allowed\r\n"
+                                "Allow: GET\r\nContent-Length: 0\r\n"
+                                "Connection: close\r\n\r\n";
+        else if (target != "/metrics")
+            session->response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n"
+                                "Connection: close\r\n\r\n";
+        else
+        {
+            std::string body = metrics_();
+            session->response = "HTTP/1.1 200 OK\r\n"
+                                "Content-Type: text/plain; version=0.0.4\r\n"
+                                "Content-Length: " +
+                                std::to_string(body.size()) +
+                                "\r\nConnection: close\r\n\r\n" + body;
+        }
+        boost::asio::async_write(
+            session->socket, boost::asio::buffer(session->response),
+            [session](const boost::system::error_code&, std::size_t) {
+                boost::system::error_code ignored;
+                session->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both,
+                                         ignored);
+                session->socket.close(ignored);
+            });
+    }
+} // namespace io_comm_rx
@@ -0,0 +1,265 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/raw_recorder.hpp>
+
+// C++ library includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @file raw_recorder.cpp
+ * @date 19/10/26
+ * @brief Defines a class recording the raw byte stream of the Rx to disk
+ */
+
+namespace io_comm_rx {
+
+    RawRecorder::RawRecorder(ROSaicNodeBase* node, const std::string& path_prefix,
+                             uint64_t max_file_size, uint32_t rotation_period_s,
+                             bool compress, std::size_t buffer_size) :
+        node_(node),
+        path_prefix_(path_prefix), max_file_size_(max_file_size),
+        rotation_period_s_(rotation_period_s), compress_(compress)
+    {
+        std::size_t ring_size = WRITE_SIZE;
+        while (ring_size < buffer_size)
+            ring_size <<= 1;
+        ring_.resize(ring_size);
+        ring_mask_ = ring_size - 1;
+        staging_.resize(WRITE_SIZE);
+
+        openFile();
+        writer_thread_ = boost::thread(boost::bind(&RawRecorder::run, this));
+    }
+
+    RawRecorder::~RawRecorder()
+    {
+        stopping_ = true;
+        writer_thread_.join();
+    }
+
+    void RawRecorder::write(Timestamp /* recvTime */, const uint8_t* data,
+                            std::size_t size)
+    {
+        uint64_t head = ring_head_.load(std::memory_order_relaxed);
+        uint64_t tail = ring_tail_.load(std::memory_order_acquire);
+        if (size > ring_.size() - (head - tail))
+        {
+            // Dropping the whole chunk keeps the bytes that do get recorded
+            // contiguous with respect to the chunks read
+            dropped_bytes_.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+        std::size_t pos = head & ring_mask_;
+        std::size_t first = std::min(size, ring_.size() - pos);
+        std::memcpy(&ring_[pos], data, first);
+        std::memcpy(&ring_[0], data + first, size - first);
+        ring_head_.store(head + size, std::memory_order_release);
+    }
+
+    std::size_t RawRecorder::drainRing()
+    {
+        uint64_t tail = ring_tail_.load(std::memory_order_relaxed);
+        uint64_t head = ring_head_.load(std::memory_order_acquire);
+        std::size_t size = std::min(static_cast<std::size_t>(head - tail),
+                                    WRITE_SIZE - staged_);
+        std::size_t pos = tail & ring_mask_;
+        std::size_t first = std::min(size, ring_.size() - pos);
+        std::memcpy(&staging_[staged_], &ring_[pos], first);
+        std::memcpy(&staging_[staged_ + first], &ring_[0], size - first);
+        staged_ += size;
+        ring_tail_.store(tail + size, std::memory_order_release);
+        return size;
+    }
+
+    void RawRecorder::run()
+    {
+        auto last_flush = boost::chrono::steady_clock::now();
+        auto last_report = last_flush;
+        while (true)
+        {
+            bool stopping = stopping_.load();
+            std::size_t drained = drainRing();
+            auto now = boost::chrono::steady_clock::now();
+            // Regular writes are WRITE_SIZE bytes, smaller ones only happen once a
+            // second at low data rates, so that little is lost on a crash
+            if ((staged_ == WRITE_SIZE) ||
+                ((staged_ > 0) &&
+                 (stopping || (now - last_flush >= boost::chrono::seconds(1)))))
+            {
+                flushStaging();
+                last_flush = now;
+            }
+            if ((rotation_period_s_ > 0) &&
+                (now - file_start_ >= boost::chrono::seconds(rotation_period_s_)))
+            {
+                flushStaging();
+                closeFile();
+                openFile();
+            }
+            uint64_t dropped_bytes = dropped_bytes_.load(std::memory_order_relaxed);
+            if ((dropped_bytes != reported_dropped_bytes_) &&
+                (stopping || (now - last_report >= boost::chrono::seconds(1))))
+            {
+                node_->log(LogLevel::WARN,
+                           "Raw recording dropped " +
+                               std::to_string(dropped_bytes - reported_dropped_bytes_) +
+                               " bytes (" + std::to_string(dropped_bytes) +
+                               " in total).");
+                reported_dropped_bytes_ = dropped_bytes;
+                last_report = now;
+            }
+            if (stopping && (drained == 0) && (staged_ == 0))
+                break;
+            if (drained == 0)
+                boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+        }
+        closeFile();
+    }
+
+    void RawRecorder::flushStaging()
+    {
+        if (staged_ == 0)
+            return;
+        // Without a file the bytes are dropped, opening is retried on rotation only
+        bool success = false;
+        if (gz_file_)
+        {
+            success = (gzwrite(gz_file_, staging_.data(),
+                               static_cast<unsigned>(staged_)) ==
+                       static_cast<int>(staged_));
+        } else if (fd_ >= 0)
+        {
+            std::size_t written = 0;
+            while (written < staged_)
+            {
+                ssize_t result = ::write(fd_, &staging_[written], staged_ - written);
+                if (result < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    break;
+                }
+                written += static_cast<std::size_t>(result);
+            }
+            success = (written == staged_);
+        }
+        if (success)
+        {
+            file_size_ += staged_;
+        } else
+        {
+            if ((fd_ >= 0) || gz_file_)
+            {
+                node_->log(LogLevel::ERROR, "Could not write to " + file_name_ + ": " +
+                                                std::strerror(errno));
+                closeFile();
+            }
+            dropped_bytes_.fetch_add(staged_, std::memory_order_relaxed);
+        }
+        staged_ = 0;
+        if ((max_file_size_ > 0) && (file_size_ >= max_file_size_))
+        {
+            closeFile();
+            openFile();
+        }
+    }
+
+    void RawRecorder::openFile()
+    {
+        std::time_t now = std::time(nullptr);
+        std::tm utc;
+        gmtime_r(&now, &utc);
+        char time_string[16];
+        std::strftime(time_string, sizeof(time_string), "%Y%m%d_%H%M%S", &utc);
+        file_name_ = path_prefix_ + "_" + time_string + "_" +
+                     std::to_string(file_count_++) + (compress_ ? ".sbf.gz" : ".sbf");
+        file_size_ = 0;
+        file_start_ = boost::chrono::steady_clock::now();
+
+        fd_ = ::open(file_name_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                     0644);
+        if (fd_ < 0)
+        {
+            int error = errno;
+            ++open_failures_;
+            if ((last_open_error_ == boost::chrono::steady_clock::time_point()) ||
+                (file_start_ - last_open_error_ >= boost::chrono::minutes(1)))
+            {
+                node_->log(LogLevel::ERROR,
+                           "Could not open " + file_name_ + " for raw recording: " +
+                               std::strerror(error) + " (" +
+                               std::to_string(open_failures_) +
+                               " failure(s) since the last report), retrying at "
+                               "the next rotation.");
+                open_failures_ = 0;
+                last_open_error_ = file_start_;
+            }
+            return;
+        }
+        if (compress_)
+        {
+            // Fastest compression level, the writer thread has to keep up with the
+            // Rx
+            gz_file_ = gzdopen(fd_, "wb1");
+            if (!gz_file_)
+            {
+                ::close(fd_);
+                fd_ = -1;
+                node_->log(LogLevel::ERROR,
+                           "Could not open " + file_name_ + " for compression.");
+                return;
+            }
+            fd_ = -1;
+            gzbuffer(gz_file_, WRITE_SIZE);
+        }
+        node_->log(LogLevel::INFO, "Recording raw Rx data to " + file_name_);
+    }
+
+    void RawRecorder::closeFile()
+    {
+        if (gz_file_)
+        {
+            gzclose(gz_file_);
+            gz_file_ = nullptr;
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+} // namespace io_comm_rx
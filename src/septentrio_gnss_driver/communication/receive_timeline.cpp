@@ -0,0 +1,117 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/receive_timeline.hpp>
+
+/**
+ * @file receive_timeline.cpp
+ * @date 19/10/26
+ * @brief Interpolates the receive times of the bytes of a buffer that is parsed
+ */
+
+namespace io_comm_rx {
+
+    void ReceiveTimeline::append(std::size_t size, Timestamp end_time,
+                                 double byte_period, Timestamp handoff_time,
+                                 Timestamp pickup_time)
+    {
+        if (size == 0)
+            return;
+        // The first byte cannot have arrived earlier than the link allows, nor
+        // before the last byte of the previous chunk
+        Timestamp span = static_cast<Timestamp>(byte_period * (size - 1));
+        Timestamp start_time = (end_time > span) ? end_time - span : 0;
+        if (start_time < last_time_)
+            start_time = (last_time_ < end_time) ? last_time_ : end_time;
+        std::size_t begin = chunks_.empty() ? 0 : chunks_.back().end;
+        chunks_.push_back(
+            {begin + size, start_time, end_time, handoff_time, pickup_time});
+        last_time_ = end_time;
+    }
+
+    Timestamp ReceiveTimeline::at(std::size_t offset) const
+    {
+        if (chunks_.empty())
+            return 0;
+        std::size_t begin = 0;
+        for (const auto& chunk : chunks_)
+        {
+            if (offset < chunk.end)
+            {
+                std::size_t last = chunk.end - 1;
+                if (last == begin)
+                    return chunk.end_time;
+                return chunk.start_time +
+                       (chunk.end_time - chunk.start_time) * (offset - begin) /
+                           (last - begin);
+            }
+            begin = chunk.end;
+        }
+        return chunks_.back().end_time;
+    }
+
+    Timestamp ReceiveTimeline::handoffTime(std::size_t offset) const
+    {
+        const Chunk* c = chunk(offset);
+        return c ? c->handoff_time : 0;
+    }
+
+    Timestamp ReceiveTimeline::pickupTime(std::size_t offset) const
+    {
+        const Chunk* c = chunk(offset);
+        return c ? c->pickup_time : 0;
+    }
+
+    const ReceiveTimeline::Chunk* ReceiveTimeline::chunk(std::size_t offset) const
+    {
+        if (chunks_.empty())
+            return nullptr;
+        for (const auto& c : chunks_)
+        {
+            if (offset < c.end)
+                return &c;
+        }
+        return &chunks_.back();
+    }
+
+    void ReceiveTimeline::consume(std::size_t size)
+    {
+        Timestamp first_time = at(size);
+        while (!chunks_.empty() && chunks_.front().end <= size)
+            chunks_.pop_front();
+        if (chunks_.empty())
+            return;
+        // Part of the first chunk remains, its start time is the one of its
+        // first remaining byte
+        chunks_.front().start_time = first_time;
+        for (auto& chunk : chunks_)
+            chunk.end -= size;
+    }
+} // namespace io_comm_rx
@@ -0,0 +1,761 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/rinex_writer.hpp>
+
+// C++ library includes
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <set>
+#include <sstream>
+// ROSaic includes
+#include <septentrio_gnss_driver/communication/rx_message.hpp>
+#include <septentrio_gnss_driver/packed_structs/sbf_structs.hpp>
+
+/**
+ * @file rinex_writer.cpp
+ * @date 19/10/26
+ * @brief Defines a class writing RINEX 3 observation files from MeasEpoch blocks
+ */
+
+namespace io_comm_rx {
+
+    namespace {
+        //! Speed of light in m/s
+        const double SPEED_OF_LIGHT = 299792458.0;
+        //! Unix time of the start of GPS time, 6 January 1980
+        const std::time_t GPS_EPOCH_UNIX = 315964800;
+        const uint64_t MS_PER_WEEK = 604800000;
+        const uint64_t MS_PER_HOUR = 3600000;
+        //! Satellite systems in the order of the header
+        const char SYSTEMS[] = "GRECJIS";
+        //! Frequency numbers of the GLONASS slots 1 to 24, antipodal slots share
+        //! one
+        const int GLONASS_K[] = {1,  -4, 5,  6, 1,  -4, 5,  6,  -2, -7, 0, -1,
+                                 -2, -7, 0, -1, 4,  -3, 3,  2,  4,  -3, 3, 2};
+        //! Column of the labels of the header lines
+        const std::size_t LABEL_COLUMN = 60;
+        //! Directories and station names of the active writers of the process
+        std::set<std::string> used_stations;
+        boost::mutex used_stations_mutex;
+
+        //! Signal of the SBF reference guide and its RINEX observation code
+        struct SignalInfo
+        {
+            uint8_t number;
+            char system;
+            const char* code;
+            //! Carrier frequency in Hz, of GLONASS frequency number 0 for FDMA
+            double frequency;
+            //! Spacing of the GLONASS FDMA frequencies in Hz, 0 otherwise
+            double glonass_spacing;
+        };
+
+        //! Signals with a RINEX 3.04 observation code, in the order of the
+        //! observation types of each system. QZSS L6 and L-band are not converted.
+        const SignalInfo SIGNALS[] = {
+            {0, 'G', "1C", 1575.42e6, 0.0},     {1, 'G', "1W", 1575.42e6, 0.0},
+            {2, 'G', "2W", 1227.60e6, 0.0},     {3, 'G', "2L", 1227.60e6, 0.0},
+            {4, 'G', "5Q", 1176.45e6, 0.0},     {5, 'G', "1L", 1575.42e6, 0.0},
+            {8, 'R', "1C", 1602.0e6, 562.5e3},  {9, 'R', "1P", 1602.0e6, 562.5e3},
+            {10, 'R', "2P", 1246.0e6, 437.5e3}, {11, 'R', "2C", 1246.0e6, 437.5e3},
+            {12, 'R', "3Q", 1202.025e6, 0.0},   {17, 'E', "1C", 1575.42e6, 0.0},
+            {19, 'E', "6C", 1278.75e6, 0.0},    {20, 'E', "5Q", 1176.45e6, 0.0},
+            {21, 'E', "7Q", 1207.14e6, 0.0},    {22, 'E', "8Q", 1191.795e6, 0.0},
+            {13, 'C', "1P", 1575.42e6, 0.0},    {14, 'C', "5P", 1176.45e6, 0.0},
+            {28, 'C', "2I", 1561.098e6, 0.0},   {29, 'C', "7I", 1207.14e6, 0.0},
+            {30, 'C', "6I", 1268.52e6, 0.0},    {34, 'C', "7D", 1207.14e6, 0.0},
+            {6, 'J', "1C", 1575.42e6, 0.0},     {7, 'J', "2L", 1227.60e6, 0.0},
+            {26, 'J', "5Q", 1176.45e6, 0.0},    {32, 'J', "1L", 1575.42e6, 0.0},
+            {33, 'J', "1Z", 1575.42e6, 0.0},    {15, 'I', "5A", 1176.45e6, 0.0},
+            {24, 'S', "1C", 1575.42e6, 0.0},    {25, 'S', "5I", 1176.45e6, 0.0}};
+
+        const SignalInfo* signalInfo(uint8_t number)
+        {
+            for (const auto& info : SIGNALS)
+            {
+                if (info.number == number)
+                    return &info;
+            }
+            return nullptr;
+        }
+
+        //! Signals of a system, in the order of its observation types
+        std::vector<const SignalInfo*> systemSignals(char system)
+        {
+            std::vector<const SignalInfo*> signals;
+            for (const auto& info : SIGNALS)
+            {
+                if (info.system == system)
+                    signals.push_back(&info);
+            }
+            return signals;
+        }
+
+        //! Position of a signal among those of its system
+        std::size_t signalIndex(const SignalInfo& signal)
+        {
+            std::size_t index = 0;
+            for (const auto& info : SIGNALS)
+            {
+                if (&info == &signal)
+                    break;
+                if (info.system == signal.system)
+                    ++index;
+            }
+            return index;
+        }
+
+        //! Signal number of the Type field, extended by ObsInfo if it is 31
+        uint8_t signalNumber(uint8_t type, uint8_t obs_info)
+        {
+            uint8_t number = type & 0x1F;
+            if (number == 31)
+                number = (obs_info >> 3) + 32;
+            return number;
+        }
+
+        //! C/N0 in dB-Hz, offset by 10 dB-Hz unless GPS L1P or L2P
+        double cn0(uint8_t value, uint8_t signal)
+        {
+            return value * 0.25 + (((signal == 1) || (signal == 2)) ? 0.0 : 10.0);
+        }
+
+        /**
+         * @brief Converts an SVID of the SBF reference guide into a RINEX
+         * satellite number, e.g. "G01"
+         * @return False if the satellite has no RINEX number, e.g. L-band
+         */
+        bool satelliteId(uint8_t svid, std::string& sat)
+        {
+            char system;
+            int prn;
+            if ((svid >= 1) && (svid <= 37))
+            {
+                system = 'G';
+                prn = svid;
+            } else if ((svid >= 38) && (svid <= 61))
+            {
+                system = 'R';
+                prn = svid - 37;
+            } else if ((svid >= 63) && (svid <= 68))
+            {
+                system = 'R';
+                prn = svid - 38;
+            } else if ((svid >= 71) && (svid <= 106))
+            {
+                system = 'E';
+                prn = svid - 70;
+            } else if ((svid >= 120) && (svid <= 140))
+            {
+                system = 'S';
+                prn = svid - 100;
+            } else if ((svid >= 141) && (svid <= 180))
+            {
+                system = 'C';
+                prn = svid - 140;
+            } else if ((svid >= 181) && (svid <= 187))
+            {
+                system = 'J';
+                prn = svid - 180;
+            } else if ((svid >= 191) && (svid <= 197))
+            {
+                system = 'I';
+                prn = svid - 190;
+            } else if ((svid >= 198) && (svid <= 215))
+            {
+                system = 'S';
+                prn = svid - 157;
+            } else if ((svid >= 216) && (svid <= 222))
+            {
+                system = 'I';
+                prn = svid - 208;
+            } else if ((svid >= 223) && (svid <= 245))
+            {
+                system = 'C';
+                prn = svid - 182;
+            } else
+                return false;
+            char id[4];
+            std::snprintf(id, sizeof(id), "%c%02d", system, prn);
+            sat = id;
+            return true;
+        }
+
+        //! Calendar time of GPS time in ms, in the GPS time scale
+        std::tm calendarTime(uint64_t time_ms)
+        {
+            std::time_t time =
+                GPS_EPOCH_UNIX + static_cast<std::time_t>(time_ms / 1000);
+            std::tm calendar;
+            gmtime_r(&time, &calendar);
+            return calendar;
+        }
+
+        //! Data frequency field of the RINEX 3 file names
+        std::string dataFrequency(uint32_t period_ms)
+        {
+            char frequency[8] = "00U";
+            if ((period_ms > 0) && (period_ms < 10))
+                std::snprintf(frequency, sizeof(frequency), "%02uC",
+                              1000 / period_ms / 100);
+            else if ((period_ms > 0) && (period_ms < 1000))
+                std::snprintf(frequency, sizeof(frequency), "%02uZ",
+                              1000 / period_ms);
+            else if ((period_ms >= 1000) && (period_ms < 100000))
+                std::snprintf(frequency, sizeof(frequency), "%02uS",
+                              period_ms / 1000);
+            else if ((period_ms >= 100000) && (period_ms < 6000000))
+                std::snprintf(frequency, sizeof(frequency), "%02uM",
+                              period_ms / 60000);
+            return frequency;
+        }
+
+        //! Header line of 60 characters content and 20 characters label
+        std::string headerLine(const std::string& content, const char* label)
+        {
+            char line[84];
+            std::snprintf(line, sizeof(line), "%-60.60s%-20.20s\n", content.c_str(),
+                          label);
+            return line;
+        }
+
+        //! Label of a header line, without trailing blanks
+        std::string headerLabel(const std::string& line)
+        {
+            if (line.size() <= LABEL_COLUMN)
+                return std::string();
+            std::string label = line.substr(LABEL_COLUMN);
+            label.erase(label.find_last_not_of(" \r\n") + 1);
+            return label;
+        }
+
+        /**
+         * @brief Reads the header lines that may not differ between runs with the
+         * same settings, i.e. not the date of the run and the first epoch, nor the
+         * GLONASS slots seen
+         * @param[in] in Header, followed by anything
+         * @param[out] lines The header lines
+         * @return False if the header does not end
+         */
+        bool fixedHeaderLines(std::istream& in, std::vector<std::string>& lines)
+        {
+            std::string line;
+            while (std::getline(in, line))
+            {
+                std::string label = headerLabel(line);
+                if (label == "END OF HEADER")
+                    return true;
+                if ((label != "PGM / RUN BY / DATE") &&
+                    (label != "TIME OF FIRST OBS") &&
+                    (label != "GLONASS SLOT / FRQ #"))
+                    lines.push_back(line.substr(0, LABEL_COLUMN) + label);
+            }
+            return false;
+        }
+    } // namespace
+
+    RinexWriter::RinexWriter(ROSaicNodeBase* node, const Settings* settings) :
+        node_(node),
+        directory_(settings->rinex_path), marker_name_(settings->rinex_marker_name),
+        ant_serial_nr_(settings->ant_serial_nr), ant_type_(settings->ant_type),
+        delta_h_(settings->delta_u), delta_e_(settings->delta_e),
+        delta_n_(settings->delta_n)
+    {
+        // Nine-character station name: marker, monument and receiver number and
+        // an unknown country code, e.g. "SEPT00XXX"
+        std::string station = marker_name_;
+        station.erase(std::remove_if(station.begin(), station.end(),
+                                     [](char c) {
+                                         return !std::isalnum(
+                                             static_cast<unsigned char>(c));
+                                     }),
+                      station.end());
+        std::transform(station.begin(), station.end(), station.begin(),
+                       [](char c) {
+                           return static_cast<char>(
+                               std::toupper(static_cast<unsigned char>(c)));
+                       });
+        if (station.size() >= 9)
+            station_ = station.substr(0, 9);
+        else
+            station_ = (station.substr(0, 4) + "0000").substr(0, 4) + "00XXX";
+        {
+            boost::mutex::scoped_lock lock(used_stations_mutex);
+            active_ = used_stations.insert(directory_ + "/" + station_).second;
+        }
+        if (!active_)
+        {
+            node_->log(LogLevel::ERROR,
+                       "RINEX files of station " + station_ + " in " + directory_ +
+                           " are already written for another Rx, set a distinct "
+                           "rinex/marker_name per Rx. No RINEX files are written.");
+            return;
+        }
+
+        // The Rx outputs MeasEpoch at the PVT polling period, unless its output is
+        // configured by others
+        if (settings->receive_only || settings->read_from_sbf_log ||
+            settings->read_from_pcap)
+            frequency_ = dataFrequency(0);
+        else
+            frequency_ = dataFrequency(settings->polling_period_pvt);
+
+        ring_.resize(RING_SIZE);
+        ring_mask_ = RING_SIZE - 1;
+        writer_thread_ = boost::thread(boost::bind(&RinexWriter::run, this));
+    }
+
+    RinexWriter::~RinexWriter()
+    {
+        if (!active_)
+            return;
+        stopping_ = true;
+        writer_thread_.join();
+        boost::mutex::scoped_lock lock(used_stations_mutex);
+        used_stations.erase(directory_ + "/" + station_);
+    }
+
+    void RinexWriter::write(const uint8_t* block)
+    {
+        std::size_t size = parsing_utilities::getLength(block);
+        uint64_t head = ring_head_.load(std::memory_order_relaxed);
+        uint64_t tail = ring_tail_.load(std::memory_order_acquire);
+        if (size > ring_.size() - (head - tail))
+        {
+            dropped_blocks_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::size_t pos = head & ring_mask_;
+        std::size_t first = std::min(size, ring_.size() - pos);
+        std::memcpy(&ring_[pos], block, first);
+        std::memcpy(&ring_[0], block + first, size - first);
+        ring_head_.store(head + size, std::memory_order_release);
+    }
+
+    bool RinexWriter::readBlock()
+    {
+        uint64_t tail = ring_tail_.load(std::memory_order_relaxed);
+        uint64_t head = ring_head_.load(std::memory_order_acquire);
+        // Blocks are queued as a whole, so a complete header means a complete
+        // block
+        if (head - tail < 8)
+            return false;
+        auto copy = [this, tail](uint8_t* destination, std::size_t size) {
+            std::size_t pos = tail & ring_mask_;
+            std::size_t first = std::min(size, ring_.size() - pos);
+            std::memcpy(destination, &ring_[pos], first);
+            std::memcpy(destination + first, &ring_[0], size - first);
+        };
+        uint8_t header[8];
+        copy(header, sizeof(header));
+        block_.resize(parsing_utilities::getLength(header));
+        copy(block_.data(), block_.size());
+        ring_tail_.store(tail + block_.size(), std::memory_order_release);
+        return true;
+    }
+
+    void RinexWriter::run()
+    {
+        auto last_report = boost::chrono::steady_clock::now();
+        while (true)
+        {
+            bool stopping = stopping_.load();
+            bool converted = false;
+            while (readBlock())
+            {
+                convertBlock();
+                converted = true;
+            }
+            // Epochs come at most at the PVT rate, each is on disk before the
+            // writer thread sleeps
+            if (converted && file_)
+                std::fflush(file_);
+            auto now = boost::chrono::steady_clock::now();
+            uint64_t dropped_blocks =
+                dropped_blocks_.load(std::memory_order_relaxed);
+            if ((dropped_blocks != reported_dropped_blocks_) &&
+                (stopping || (now - last_report >= boost::chrono::seconds(1))))
+            {
+                node_->log(LogLevel::WARN,
+                           "RINEX writing fell behind, " +
+                               std::to_string(dropped_blocks -
+                                              reported_dropped_blocks_) +
+                               " MeasEpoch blocks dropped (" +
+                               std::to_string(dropped_blocks) + " in total).");
+                reported_dropped_blocks_ = dropped_blocks;
+                last_report = now;
+            }
+            if (stopping)
+                break;
+            if (!converted)
+                boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+        }
+        closeFile();
+    }
+
+    void RinexWriter::convertBlock()
+    {
+        if (!MeasEpochParser(node_, block_.begin(), block_.end(), msg_))
+            return;
+        if ((msg_.block_header.tow == UINT32_MAX) ||
+            (msg_.block_header.wnc == UINT16_MAX))
+            return;
+        uint64_t time_ms =
+            msg_.block_header.wnc * MS_PER_WEEK + msg_.block_header.tow;
+
+        epoch_.clear();
+        for (const auto& type1 : msg_.type1)
+        {
+            uint8_t signal1 = signalNumber(type1.type, type1.obs_info);
+            const SignalInfo* info1 = signalInfo(signal1);
+            std::string sat;
+            if (!info1 || !satelliteId(type1.sv_id, sat) ||
+                (sat[0] != info1->system))
+                continue;
+            // ObsInfo holds the GLONASS frequency number offset by 8
+            int glonass_k = 0;
+            if (sat[0] == 'R')
+            {
+                glonass_k = (type1.obs_info >> 3) - 8;
+                glonass_k_[std::stoi(sat.substr(1))] = glonass_k;
+            }
+            double frequency1 =
+                info1->frequency + glonass_k * info1->glonass_spacing;
+
+            // Do-not-use values are checked before the conversion
+            Measurement m1;
+            uint8_t code_msb = type1.misc & 0x0F;
+            m1.code_valid = (code_msb != 0) || (type1.code_lsb != 0);
+            m1.code = (code_msb * 4294967296.0 + type1.code_lsb) * 0.001;
+            m1.phase_valid =
+                m1.code_valid &&
+                !((type1.carrier_msb == -128) && (type1.carrier_lsb == 0));
+            m1.phase = m1.code * frequency1 / SPEED_OF_LIGHT +
+                       (type1.carrier_msb * 65536.0 + type1.carrier_lsb) * 0.001;
+            m1.doppler_valid = (type1.doppler != INT32_MIN);
+            m1.doppler = type1.doppler * 0.0001;
+            m1.cn0_valid = (type1.cn0 != 255);
+            m1.cn0 = cn0(type1.cn0, signal1);
+            m1.lock_time = type1.lock_time;
+            m1.half_cycle = (type1.obs_info & 0x04) != 0;
+            setSignal(sat, signal1, m1, time_ms);
+
+            // Type-2 sub-blocks are offsets from their Type-1 sub-block
+            for (const auto& type2 : type1.type2)
+            {
+                uint8_t signal2 = signalNumber(type2.type, type2.obs_info);
+                const SignalInfo* info2 = signalInfo(signal2);
+                if (!info2 || (info2->system != info1->system))
+                    continue;
+                double frequency2 =
+                    info2->frequency + glonass_k * info2->glonass_spacing;
+                // Two's complement 3-bit and 5-bit fields
+                int code_offset_msb = ((type2.offsets_msb & 0x07) ^ 0x04) - 0x04;
+                int doppler_offset_msb =
+                    (((type2.offsets_msb >> 3) & 0x1F) ^ 0x10) - 0x10;
+
+                Measurement m2;
+                m2.code_valid = m1.code_valid && !((code_offset_msb == -4) &&
+                                                   (type2.code_offset_lsb == 0));
+                m2.code =
+                    m1.code +
+                    (code_offset_msb * 65536.0 + type2.code_offset_lsb) * 0.001;
+                m2.phase_valid =
+                    m2.code_valid &&
+                    !((type2.carrier_msb == -128) && (type2.carrier_lsb == 0));
+                m2.phase = m2.code * frequency2 / SPEED_OF_LIGHT +
+                           (type2.carrier_msb * 65536.0 + type2.carrier_lsb) * 0.001;
+                m2.doppler_valid =
+                    m1.doppler_valid && !((doppler_offset_msb == -16) &&
+                                          (type2.doppler_offset_lsb == 0));
+                m2.doppler =
+                    m1.doppler * frequency2 / frequency1 +
+                    (doppler_offset_msb * 65536.0 + type2.doppler_offset_lsb) *
+                        0.0001;
+                m2.cn0_valid = (type2.cn0 != 255);
+                m2.cn0 = cn0(type2.cn0, signal2);
+                m2.lock_time = type2.lock_time;
+                m2.half_cycle = (type2.obs_info & 0x04) != 0;
+                setSignal(sat, signal2, m2, time_ms);
+            }
+        }
+
+        uint64_t hour_ms = time_ms - time_ms % MS_PER_HOUR;
+        if (hour_ms != file_hour_ms_)
+        {
+            closeFile();
+            openFile(hour_ms);
+        }
+        if (!file_)
+            return;
+        if (!header_written_)
+            writeHeader(time_ms);
+        if (!file_)
+            return;
+
+        std::tm calendar = calendarTime(time_ms);
+        char line[96];
+        std::snprintf(line, sizeof(line), "> %04d %02d %02d %02d %02d%11.7f  0%3u\n",
+                      calendar.tm_year + 1900, calendar.tm_mon + 1, calendar.tm_mday,
+                      calendar.tm_hour, calendar.tm_min,
+                      calendar.tm_sec + (time_ms % 1000) * 0.001,
+                      static_cast<unsigned>(epoch_.size()));
+        text_ = line;
+        for (const auto& satellite : epoch_)
+        {
+            text_ += satellite.first;
+            for (const auto& observation : satellite.second)
+            {
+                // F14.3 followed by the loss of lock and signal strength indicators
+                if (observation.valid && (observation.value > -1e9) &&
+                    (observation.value < 1e10))
+                {
+                    std::snprintf(line, sizeof(line), "%14.3f%c%c",
+                                  observation.value,
+                                  observation.lli ? '0' + observation.lli : ' ',
+                                  observation.ssi ? '0' + observation.ssi : ' ');
+                    text_ += line;
+                } else
+                    text_.append(16, ' ');
+            }
+            text_.erase(text_.find_last_not_of(' ') + 1);
+            text_ += '\n';
+        }
+        if (std::fwrite(text_.data(), 1, text_.size(), file_) != text_.size())
+        {
+            node_->log(LogLevel::ERROR, "Could not write to " + file_name_ + ": " +
+                                            std::strerror(errno));
+            closeFile();
+        }
+    }
+
+    void RinexWriter::setSignal(const std::string& sat, uint8_t signal,
+                                const Measurement& measurement, uint64_t time_ms)
+    {
+        const SignalInfo* info = signalInfo(signal);
+        std::vector<Observation>& observations = epoch_[sat];
+        if (observations.empty())
+            observations.resize(4 * systemSignals(sat[0]).size());
+        std::size_t index = 4 * signalIndex(*info);
+
+        // Lost lock if the lock time dropped or began after the last epoch of the
+        // signal, the lock time being rounded down to seconds
+        bool lost_lock = true;
+        auto lock = locks_.find(std::make_pair(sat, signal));
+        if (lock != locks_.end())
+        {
+            lost_lock = (measurement.lock_time < lock->second.lock_time) ||
+                        ((measurement.lock_time + 1) * 1000ull <=
+                         time_ms - lock->second.time_ms);
+            lock->second = Lock{measurement.lock_time, time_ms};
+        } else
+            locks_.emplace(std::make_pair(sat, signal),
+                           Lock{measurement.lock_time, time_ms});
+
+        observations[index].value = measurement.code;
+        observations[index].valid = measurement.code_valid;
+        observations[index + 1].value = measurement.phase;
+        observations[index + 1].valid = measurement.phase_valid;
+        observations[index + 1].lli =
+            (lost_lock ? 1 : 0) | (measurement.half_cycle ? 2 : 0);
+        if (measurement.cn0_valid)
+            observations[index + 1].ssi = static_cast<uint8_t>(
+                std::min(std::max(static_cast<int>(measurement.cn0 / 6.0), 1), 9));
+        observations[index + 2].value = measurement.doppler;
+        observations[index + 2].valid = measurement.doppler_valid;
+        observations[index + 3].value = measurement.cn0;
+        observations[index + 3].valid = measurement.cn0_valid;
+    }
+
+    void RinexWriter::openFile(uint64_t hour_ms)
+    {
+        file_hour_ms_ = hour_ms;
+        std::tm calendar = calendarTime(hour_ms);
+        char start[32];
+        std::snprintf(start, sizeof(start), "%04d%03d%02d00",
+                      calendar.tm_year + 1900, calendar.tm_yday + 1,
+                      calendar.tm_hour);
+        file_name_ = directory_ + "/" + station_ + "_R_" + start + "_01H_" +
+                     frequency_ + "_MO.rnx";
+        // A restart within the hour appends to the file of that hour, unless it
+        // was written with other settings
+        header_written_ = false;
+        std::ifstream existing(file_name_);
+        if (existing.good() && (existing.peek() != EOF))
+        {
+            std::vector<std::string> existing_lines;
+            std::vector<std::string> lines;
+            std::istringstream text(headerText(hour_ms));
+            fixedHeaderLines(text, lines);
+            header_written_ = fixedHeaderLines(existing, existing_lines) &&
+                              (existing_lines == lines);
+            existing.close();
+            if (!header_written_)
+            {
+                int n = 1;
+                while (std::ifstream(file_name_ + "." + std::to_string(n)).good())
+                    ++n;
+                std::string old_name = file_name_ + "." + std::to_string(n);
+                if (std::rename(file_name_.c_str(), old_name.c_str()) != 0)
+                {
+                    node_->log(LogLevel::ERROR, "Could not move " + file_name_ +
+                                                    " aside: " +
+                                                    std::strerror(errno));
+                    return;
+                }
+                node_->log(LogLevel::WARN,
+                           "The header of " + file_name_ +
+                               " does not match the settings, moved it to " +
+                               old_name + " to start it anew.");
+            }
+        }
+        file_ = std::fopen(file_name_.c_str(), "a");
+        if (!file_)
+        {
+            node_->log(LogLevel::ERROR, "Could not open " + file_name_ +
+                                            " for RINEX writing: " +
+                                            std::strerror(errno));
+            return;
+        }
+        node_->log(LogLevel::INFO, "Writing RINEX observations to " + file_name_);
+    }
+
+    std::string RinexWriter::headerText(uint64_t time_ms)
+    {
+        char content[64];
+        std::string header;
+        std::snprintf(content, sizeof(content), "%9.2f%11s%-20s%-20s", 3.04, "",
+                      "OBSERVATION DATA", "M");
+        header += headerLine(content, "RINEX VERSION / TYPE");
+        std::time_t now = std::time(nullptr);
+        std::tm utc;
+        gmtime_r(&now, &utc);
+        char date[24];
+        std::strftime(date, sizeof(date), "%Y%m%d %H%M%S UTC", &utc);
+        std::snprintf(content, sizeof(content), "%-20s%-20s%-20s", "ROSaic", "",
+                      date);
+        header += headerLine(content, "PGM / RUN BY / DATE");
+        header += headerLine(marker_name_, "MARKER NAME");
+        header += headerLine("", "OBSERVER / AGENCY");
+        std::snprintf(content, sizeof(content), "%-20s%-20s%-20s", "", "SEPTENTRIO",
+                      "");
+        header += headerLine(content, "REC # / TYPE / VERS");
+        std::snprintf(content, sizeof(content), "%-20.20s%-20.20s",
+                      ant_serial_nr_.c_str(), ant_type_.c_str());
+        header += headerLine(content, "ANT # / TYPE");
+        // Unknown, the Rx may be moving
+        std::snprintf(content, sizeof(content), "%14.4f%14.4f%14.4f", 0.0, 0.0, 0.0);
+        header += headerLine(content, "APPROX POSITION XYZ");
+        std::snprintf(content, sizeof(content), "%14.4f%14.4f%14.4f", delta_h_,
+                      delta_e_, delta_n_);
+        header += headerLine(content, "ANTENNA: DELTA H/E/N");
+        for (const char* system = SYSTEMS; *system; ++system)
+        {
+            std::vector<const SignalInfo*> signals = systemSignals(*system);
+            std::snprintf(content, sizeof(content), "%c  %3u", *system,
+                          static_cast<unsigned>(4 * signals.size()));
+            std::string line = content;
+            for (const auto* signal : signals)
+            {
+                for (char type : {'C', 'L', 'D', 'S'})
+                {
+                    // 13 observation types per line
+                    if (line.size() == 58)
+                    {
+                        header += headerLine(line, "SYS / # / OBS TYPES");
+                        line = "      ";
+                    }
+                    line += std::string(" ") + type + signal->code;
+                }
+            }
+            header += headerLine(line, "SYS / # / OBS TYPES");
+        }
+        header += headerLine("DBHZ", "SIGNAL STRENGTH UNIT");
+        std::tm first = calendarTime(time_ms);
+        std::snprintf(content, sizeof(content), "%6d%6d%6d%6d%6d%13.7f     GPS",
+                      first.tm_year + 1900, first.tm_mon + 1, first.tm_mday,
+                      first.tm_hour, first.tm_min,
+                      first.tm_sec + (time_ms % 1000) * 0.001);
+        header += headerLine(content, "TIME OF FIRST OBS");
+        // Phase shifts and GLONASS biases are unknown
+        for (const char* system = SYSTEMS; *system; ++system)
+            header += headerLine(std::string(1, *system), "SYS / PHASE SHIFT");
+        // All slots, since satellites rise after the header, the frequency numbers
+        // seen so far taking precedence
+        std::map<int, int> glonass_k = glonass_k_;
+        for (int slot = 1; slot <= 24; ++slot)
+            glonass_k.emplace(slot, GLONASS_K[slot - 1]);
+        std::snprintf(content, sizeof(content), "%3u ",
+                      static_cast<unsigned>(glonass_k.size()));
+        std::string line = content;
+        for (const auto& slot : glonass_k)
+        {
+            // 8 satellites per line
+            if (line.size() == 60)
+            {
+                header += headerLine(line, "GLONASS SLOT / FRQ #");
+                line = "    ";
+            }
+            std::snprintf(content, sizeof(content), "R%02d %2d ", slot.first,
+                          slot.second);
+            line += content;
+        }
+        header += headerLine(line, "GLONASS SLOT / FRQ #");
+        header += headerLine("", "GLONASS COD/PHS/BIS");
+        header += headerLine("", "END OF HEADER");
+        return header;
+    }
+
+    void RinexWriter::writeHeader(uint64_t time_ms)
+    {
+        std::string text = headerText(time_ms);
+        header_written_ = true;
+        if (std::fwrite(text.data(), 1, text.size(), file_) != text.size())
+        {
+            node_->log(LogLevel::ERROR, "Could not write to " + file_name_ + ": " +
+                                            std::strerror(errno));
+            closeFile();
+        }
+    }
+
+    void RinexWriter::closeFile()
+    {
+        if (file_)
+        {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+} // namespace io_comm_rx
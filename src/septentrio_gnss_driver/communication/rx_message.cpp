@@ -33,6 +33,7 @@
 #include <GeographicLib/UTMUPS.hpp>
 
 #include <septentrio_gnss_driver/communication/rx_message.hpp>
+#include <septentrio_gnss_driver/communication/rinex_writer.hpp>
 
 /**
  * The position_covariance array is populated in row-major order, where the basis of
@@ -331,7 +332,7 @@ io_comm_rx::RxMessage::ImuCallback()
 			Timestamp tsImu = timestampSBF(last_extsensmeas_.block_header.tow, last_extsensmeas_.block_header.wnc, true);
 			Timestamp tsIns = timestampSBF(last_insnavgeod_.block_header.tow, last_insnavgeod_.block_header.wnc, true);// Filling in the oreintation data
 			
-			static int64_t maxDt = (settings_->polling_period_pvt == 0) ? 10000000 : settings_->polling_period_pvt * 1000000;
+			const int64_t maxDt = (settings_->polling_period_pvt == 0) ? 10000000 : settings_->polling_period_pvt * 1000000;
 			if ((tsImu - tsIns) > maxDt)
 			{
 				valid_orientation = false;
@@ -688,7 +689,7 @@ NavSatFixMsg io_comm_rx::RxMessage::NavSatFixCallback()
         }
         default:
         {
-            node_->log(LogLevel::DEBUG, "PVTGeodetic's Mode field contains an invalid type of PVT solution.");
+            ROSAIC_DEBUG(node_, "PVTGeodetic's Mode field contains an invalid type of PVT solution.");
             break;
         }
         }
@@ -766,7 +767,7 @@ NavSatFixMsg io_comm_rx::RxMessage::NavSatFixCallback()
 		}
 		default:
 		{
-			node_->log(LogLevel::DEBUG, "INSNavGeod's Mode field contains an invalid type of PVT solution.");
+			ROSAIC_DEBUG(node_, "INSNavGeod's Mode field contains an invalid type of PVT solution.");
 			break;
 		}
 		}
@@ -1003,7 +1004,7 @@ GPSFixMsg io_comm_rx::RxMessage::GPSFixCallback()
         }
         default:
         {
-            node_->log(LogLevel::DEBUG, "PVTGeodetic's Mode field contains an invalid type of PVT solution.");
+            ROSAIC_DEBUG(node_, "PVTGeodetic's Mode field contains an invalid type of PVT solution.");
             break;
         }
         }
@@ -1135,7 +1136,7 @@ GPSFixMsg io_comm_rx::RxMessage::GPSFixCallback()
         case evSBAS:
         default:
         {
-            node_->log(LogLevel::DEBUG, "INSNavGeod's Mode field contains an invalid type of PVT solution.");
+            ROSAIC_DEBUG(node_, "INSNavGeod's Mode field contains an invalid type of PVT solution.");
             break;
         }
         }
@@ -1277,13 +1278,103 @@ Timestamp io_comm_rx::RxMessage::timestampSBF(uint32_t tow, uint16_t wnc, bool u
 		
         time_obj = nsOfGpsStart + tow * mSec2NSec + wnc * nsecPerWeek - settings_->leap_seconds * secToNSec;
 	}
+	else if (settings_->clock_estimate_correct_stamps && clock_estimator_.valid())
+	{
+		time_obj = clock_estimator_.toHost(timestampSBF(tow, wnc, true));
+	}
 	else
     {
-        time_obj = recvTimestamp_;
+        time_obj = recvTime();
     }
 	return time_obj;
 }
 
+void io_comm_rx::RxMessage::updateTimeReferences()
+{
+    bool estimate =
+        settings_->publish_clockestimate || settings_->clock_estimate_correct_stamps;
+    if (!estimate && settings_->ntp_shm_unit < 0)
+        return;
+    // Host times of blocks read from file are meaningless
+    if (settings_->read_from_sbf_log || settings_->read_from_pcap)
+        return;
+    uint32_t tow = parsing_utilities::getTow(data_);
+    uint16_t wnc = parsing_utilities::getWnc(data_);
+    if (!validValue(tow) || !validValue(wnc))
+        return;
+    Timestamp gnss_time = timestampSBF(tow, wnc, true);
+    Timestamp host_time = recvTime();
+    // The first block of an epoch is the one delayed the least by the output of
+    // the others. The Rx time jumping back, e.g. after a reset, is accepted.
+    if (settings_->ntp_shm_unit >= 0 &&
+        (gnss_time > last_ntp_sample_ ||
+         gnss_time + NTP_SHM_TIME_JUMP < last_ntp_sample_))
+    {
+        if (!ntp_shm_)
+            ntp_shm_.reset(new NtpShm(node_, settings_->ntp_shm_unit));
+        ntp_shm_->write(gnss_time, host_time);
+        last_ntp_sample_ = gnss_time;
+    }
+    if (!estimate)
+        return;
+    clock_estimator_.setWindow(
+        static_cast<Timestamp>(settings_->clock_estimate_window * 1.0e9));
+    if (!clock_estimator_.update(gnss_time, host_time) ||
+        !settings_->publish_clockestimate)
+        return;
+    ClockEstimateMsg msg;
+    msg.header.stamp = timestampToRos(host_time);
+    msg.header.frame_id = settings_->frame_id;
+    msg.offset = clock_estimator_.offset();
+    msg.drift = clock_estimator_.drift();
+    msg.latency = clock_estimator_.latency();
+    msg.jitter = clock_estimator_.jitter();
+    msg.samples = clock_estimator_.samples();
+    msg.resets = clock_estimator_.resets();
+    node_->publishMessage<ClockEstimateMsg>("/clockestimate", msg);
+}
+
+Timestamp io_comm_rx::RxMessage::recvTime()
+{
+    if (!timeline_ || timeline_->empty())
+        return recvTimestamp_;
+    return timeline_->at(lastByteOffset());
+}
+
+Timestamp io_comm_rx::RxMessage::handoffTime()
+{
+    if (!timeline_)
+        return 0;
+    return timeline_->handoffTime(lastByteOffset());
+}
+
+Timestamp io_comm_rx::RxMessage::pickupTime()
+{
+    if (!timeline_)
+        return 0;
+    return timeline_->pickupTime(lastByteOffset());
+}
+
+void io_comm_rx::RxMessage::countParseFailure()
+{
+    messageCounters().parseFailure();
+}
+
+io_comm_rx::MessageCounters::Counters& io_comm_rx::RxMessage::messageCounters()
+{
+    if (this->isNMEA())
+        return counters_.nmea(data_, this->messageSize());
+    return counters_.sbf(parsing_utilities::getId(data_));
+}
+
+std::size_t io_comm_rx::RxMessage::lastByteOffset()
+{
+    std::size_t size = this->isSBF() ? this->getBlockLength() : this->messageSize();
+    if (size == 0)
+        size = 1;
+    return static_cast<std::size_t>(data_ - buffer_) + size - 1;
+}
+
 bool io_comm_rx::RxMessage::found()
 {
     if (found_)
@@ -1291,7 +1382,7 @@ bool io_comm_rx::RxMessage::found()
 
     // Verify header bytes
     if (!this->isSBF() && !this->isNMEA() && !this->isResponse() &&
-        !(g_read_cd && this->isConnectionDescriptor()))
+        !(read_cd_ && this->isConnectionDescriptor()))
     {
         return false;
     }
@@ -1306,15 +1397,24 @@ const uint8_t* io_comm_rx::RxMessage::search()
     {
         next();
     }
+    std::size_t start_count = count_;
     // Search for message or a response header
     for (; count_ > 0; --count_, ++data_)
     {
         if (this->isSBF() || this->isNMEA() || this->isResponse() ||
-            (g_read_cd && this->isConnectionDescriptor()))
+            (read_cd_ && this->isConnectionDescriptor()))
+        {
+            break;
+        }
+        // All messages start with "$", except for the connection descriptor, the
+        // next byte is yet to be received
+        if ((count_ == 1) && (data_[0] == SBF_SYNC_BYTE_1))
         {
             break;
         }
     }
+    if (resync_ && count_ < start_count)
+        counters_.skipped(start_count - count_);
     found_ = true;
     return data_;
 }
@@ -1530,16 +1630,18 @@ void io_comm_rx::RxMessage::next()
     if (found())
     {
         if (this->isNMEA() || this->isResponse() ||
-            (g_read_cd && this->isConnectionDescriptor()))
+            (read_cd_ && this->isConnectionDescriptor()))
         {
-            if (g_read_cd && this->isConnectionDescriptor() && g_cd_count == 2)
+            if (read_cd_ && this->isConnectionDescriptor() && cd_count_ == 2)
             {
-                g_read_cd = false;
+                read_cd_ = false;
             }
             jump_size = static_cast<uint32_t>(1);
+            resync_ = false;
         }
         if (this->isSBF())
         {
+            resync_ = true;
             if (crc_check_)
             {
                 jump_size = static_cast<std::size_t>(this->getBlockLength());
@@ -1582,11 +1684,10 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
         return false;
     if (this->isSBF())
     {
-        // If the CRC check is unsuccessful, return false
-        crc_check_ = isValid(data_);
+        // If the CRC check of readCallback() was unsuccessful, return false
         if (!crc_check_)
         {
-            node_->log(LogLevel::DEBUG, "CRC Check returned False. Not a valid data block. Retrieving full SBF block.");
+            ROSAIC_DEBUG(node_, "CRC Check returned False. Not a valid data block. Retrieving full SBF block.");
             return false;
         }
     }
@@ -1601,6 +1702,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!PVTCartesianParser(node_, dvec.begin(), dvec.end(), msg))
 			{
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in PVTCartesian");
+				countParseFailure();
 				break;
 			}
 			msg.header.frame_id = settings_->frame_id;
@@ -1624,6 +1726,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!PVTGeodeticParser(node_, dvec.begin(), dvec.end(), last_pvtgeodetic_))
 			{
                 node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in PVTGeodetic");
+                countParseFailure();
 				break;
 			}
 			last_pvtgeodetic_.header.frame_id = settings_->frame_id;
@@ -1651,6 +1754,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!PosCovCartesianParser(node_, dvec.begin(), dvec.end(), msg))
 			{
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in PosCovCartesian");
+				countParseFailure();
 				break;
 			}
 			msg.header.frame_id = settings_->frame_id;
@@ -1676,6 +1780,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
                 poscovgeodetic_has_arrived_navsatfix_ = false;
                 poscovgeodetic_has_arrived_pose_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in PosCovGeodetic");
+				countParseFailure();
 				break;
 			}
 			last_poscovgeodetic_.header.frame_id = settings_->frame_id;
@@ -1704,6 +1809,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
                 atteuler_has_arrived_gpsfix_ = false;
 			    atteuler_has_arrived_pose_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in AttEuler");
+				countParseFailure();
 				break;
 			}
 			last_atteuler_.header.frame_id = settings_->frame_id;
@@ -1731,6 +1837,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
                 attcoveuler_has_arrived_gpsfix_ = false;
 			    attcoveuler_has_arrived_pose_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in AttCovEuler");
+				countParseFailure();
 				break;
 			}
 			last_attcoveuler_.header.frame_id = settings_->frame_id;
@@ -1758,6 +1865,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!INSNavCartParser(node_, dvec.begin(), dvec.end(), msg, settings_->use_ros_axis_orientation))
 			{
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in INSNavCart");
+				countParseFailure();
 				break;
 			}
 			msg.header.frame_id = settings_->frame_id;
@@ -1785,6 +1893,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
                 insnavgeod_has_arrived_pose_ = false;
                 insnavgeod_has_arrived_localization_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in INSNavGeod");
+				countParseFailure();
 				break;
 			}
 			last_insnavgeod_.header.frame_id = settings_->frame_id;
@@ -1814,6 +1923,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!IMUSetupParser(node_, dvec.begin(), dvec.end(), msg, settings_->use_ros_axis_orientation))
 			{                
                 node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in IMUSetup");
+                countParseFailure();
 				break;
 			}
 			msg.header.frame_id = settings_->vehicle_frame_id;
@@ -1838,6 +1948,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!VelSensorSetupParser(node_, dvec.begin(), dvec.end(), msg, settings_->use_ros_axis_orientation))
 			{                
                 node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in VelSensorSetup");
+                countParseFailure();
 				break;
 			}
 			msg.header.frame_id = settings_->vehicle_frame_id;
@@ -1863,6 +1974,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!INSNavCartParser(node_, dvec.begin(), dvec.end(), msg, settings_->use_ros_axis_orientation))
 			{
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in ExtEventINSNavCart");
+				countParseFailure();
 				break;
 			}
 			msg.header.frame_id = settings_->frame_id;
@@ -1887,6 +1999,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!INSNavGeodParser(node_, dvec.begin(), dvec.end(), msg, settings_->use_ros_axis_orientation))
 			{                
                 node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in ExtEventINSNavGeod");
+                countParseFailure();
 				break;
 			}
 			msg.header.frame_id = settings_->frame_id;
@@ -1910,6 +2023,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!ExtSensorMeasParser(node_, dvec.begin(), dvec.end(), last_extsensmeas_, settings_->use_ros_axis_orientation))
 			{                
                 node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in ExtSensorMeas");
+                countParseFailure();
 				break;
 			}
 			last_extsensmeas_.header.frame_id = settings_->imu_frame_id;
@@ -1933,7 +2047,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 					msg = ImuCallback();
 				} catch (std::runtime_error& e)
 				{
-					node_->log(LogLevel::DEBUG, "ImuMsg: " + std::string(e.what()));
+					ROSAIC_DEBUG(node_, "ImuMsg: " + std::string(e.what()));
 					break;
 				}
 				msg.header.frame_id = settings_->imu_frame_id;
@@ -1985,14 +2099,15 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			// Create NmeaSentence struct to pass to GpggaParser::parseASCII
 			NMEASentence gga_message(id, body);
 			GpggaMsg msg;
-            Timestamp time_obj = node_->getTime();
+            Timestamp time_obj = recvTime();
 			GpggaParser parser_obj;
 			try
 			{
 				msg = parser_obj.parseASCII(gga_message, settings_->frame_id, settings_->use_gnss_time, time_obj);
 			} catch (ParseException& e)
 			{
-				node_->log(LogLevel::DEBUG, "GpggaMsg: " + std::string(e.what()));
+				ROSAIC_DEBUG(node_, "GpggaMsg: " + std::string(e.what()));
+				countParseFailure();
                 break;
 			}
 			// Wait as long as necessary (only when reading from SBF/PCAP file)
@@ -2006,7 +2121,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 		}
 		case evGPRMC:
 		{
-			Timestamp time_obj = node_->getTime();
+			Timestamp time_obj = recvTime();
 			
             boost::char_separator<char> sep("\r");
 			typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
@@ -2033,7 +2148,8 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 				msg = parser_obj.parseASCII(rmc_message, settings_->frame_id, settings_->use_gnss_time, time_obj);
 			} catch (ParseException& e)
 			{
-				node_->log(LogLevel::DEBUG, "GprmcMsg: " + std::string(e.what()));
+				ROSAIC_DEBUG(node_, "GprmcMsg: " + std::string(e.what()));
+				countParseFailure();
                 break;
 			}
 			// Wait as long as necessary (only when reading from SBF/PCAP file)
@@ -2069,10 +2185,11 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			GpgsaParser parser_obj;
 			try
 			{
-				msg = parser_obj.parseASCII(gsa_message, settings_->frame_id, settings_->use_gnss_time, node_->getTime());
+				msg = parser_obj.parseASCII(gsa_message, settings_->frame_id, settings_->use_gnss_time, recvTime());
 			} catch (ParseException& e)
 			{
-				node_->log(LogLevel::DEBUG, "GpgsaMsg: " + std::string(e.what()));
+				ROSAIC_DEBUG(node_, "GpgsaMsg: " + std::string(e.what()));
+				countParseFailure();
                 break;
 			}
 			if (settings_->septentrio_receiver_type == "gnss")
@@ -2122,10 +2239,11 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			GpgsvParser parser_obj;
 			try
 			{
-				msg = parser_obj.parseASCII(gsv_message, settings_->frame_id, settings_->use_gnss_time, node_->getTime());
+				msg = parser_obj.parseASCII(gsv_message, settings_->frame_id, settings_->use_gnss_time, recvTime());
 			} catch (ParseException& e)
 			{
-				node_->log(LogLevel::DEBUG, "GpgsvMsg: " + std::string(e.what()));
+				ROSAIC_DEBUG(node_, "GpgsvMsg: " + std::string(e.what()));
+				countParseFailure();
                 break;
 			}
 			if (settings_->septentrio_receiver_type == "gnss")
@@ -2160,7 +2278,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 					msg = NavSatFixCallback();
 				} catch (std::runtime_error& e)
 				{
-					node_->log(LogLevel::DEBUG, "NavSatFixMsg: " + std::string(e.what()));
+					ROSAIC_DEBUG(node_, "NavSatFixMsg: " + std::string(e.what()));
                     break;
 				}
 				msg.header.frame_id = settings_->frame_id;
@@ -2190,7 +2308,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 					msg = NavSatFixCallback();
 				} catch (std::runtime_error& e)
 				{
-					node_->log(LogLevel::DEBUG, "NavSatFixMsg: " + std::string(e.what()));
+					ROSAIC_DEBUG(node_, "NavSatFixMsg: " + std::string(e.what()));
                     break;
 				}
 				msg.header.frame_id = settings_->frame_id;
@@ -2220,7 +2338,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 					msg = GPSFixCallback();
 				} catch (std::runtime_error& e)
 				{
-					node_->log(LogLevel::DEBUG, "GPSFixMsg: " + std::string(e.what()));
+					ROSAIC_DEBUG(node_, "GPSFixMsg: " + std::string(e.what()));
                     break;
 				}
 				msg.header.frame_id = settings_->frame_id;
@@ -2259,7 +2377,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 					msg = GPSFixCallback();
 				} catch (std::runtime_error& e)
 				{
-					node_->log(LogLevel::DEBUG, "GPSFixMsg: " + std::string(e.what()));
+					ROSAIC_DEBUG(node_, "GPSFixMsg: " + std::string(e.what()));
                     break;
 				}
 				msg.header.frame_id = settings_->frame_id;
@@ -2294,7 +2412,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 					msg = PoseWithCovarianceStampedCallback();
 				} catch (std::runtime_error& e)
 				{
-					node_->log(LogLevel::DEBUG, "PoseWithCovarianceStampedMsg: " + std::string(e.what()));
+					ROSAIC_DEBUG(node_, "PoseWithCovarianceStampedMsg: " + std::string(e.what()));
                     break;
 				}
 				msg.header.frame_id = settings_->frame_id;
@@ -2326,7 +2444,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 					msg = PoseWithCovarianceStampedCallback();
 				} catch (std::runtime_error& e)
 				{
-					node_->log(LogLevel::DEBUG, "PoseWithCovarianceStampedMsg: " + std::string(e.what()));
+					ROSAIC_DEBUG(node_, "PoseWithCovarianceStampedMsg: " + std::string(e.what()));
                     break;
 				}
 				msg.header.frame_id = settings_->frame_id;
@@ -2352,6 +2470,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!ChannelStatusParser(node_, dvec.begin(), dvec.end(), last_channelstatus_))
 			{
                 node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in ChannelStatus");
+                countParseFailure();
 				break;
 			}
             channelstatus_has_arrived_gpsfix_ = true;
@@ -2359,10 +2478,17 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 		}
 		case evMeasEpoch:
 		{
+			// Only copied here, the RINEX writer decodes the block in its own
+			// thread
+			if (rinex_writer_)
+				rinex_writer_->write(data_);
+			if (!settings_->publish_measepoch && !settings_->publish_gpsfix)
+				break;
 			std::vector<uint8_t> dvec(data_, data_ + parsing_utilities::getLength(data_));
 			if (!MeasEpochParser(node_, dvec.begin(), dvec.end(), last_measepoch_))
 			{
                 node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in MeasEpoch");
+                countParseFailure();
 				break;
 			}
 			last_measepoch_.header.frame_id = settings_->frame_id;
@@ -2383,6 +2509,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			{
 			    dop_has_arrived_gpsfix_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in DOP");
+				countParseFailure();
 				break;
 			}
 			dop_has_arrived_gpsfix_ = true;
@@ -2395,6 +2522,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			{
 			    velcovgeodetic_has_arrived_gpsfix_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in VelCovGeodetic");
+				countParseFailure();
 				break;
 			}
 			last_velcovgeodetic_.header.frame_id = settings_->frame_id;
@@ -2421,7 +2549,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 				msg = DiagnosticArrayCallback();
 			} catch (std::runtime_error& e)
 			{
-				node_->log(LogLevel::DEBUG, "DiagnosticArrayMsg: " + std::string(e.what()));
+				ROSAIC_DEBUG(node_, "DiagnosticArrayMsg: " + std::string(e.what()));
                 break;
 			}
 			if (settings_->septentrio_receiver_type == "gnss")
@@ -2455,7 +2583,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
                 msg = LocalizationUtmCallback();
             } catch (std::runtime_error& e)
             {
-                node_->log(LogLevel::DEBUG, "LocalizationMsg: " + std::string(e.what()));
+                ROSAIC_DEBUG(node_, "LocalizationMsg: " + std::string(e.what()));
                 break;
             }
             uint32_t tow = parsing_utilities::getTow(data_);
@@ -2481,6 +2609,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			{                
 			    receiverstatus_has_arrived_diagnostics_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in ReceiverStatus");
+				countParseFailure();
 				break;
 			}
             receiverstatus_has_arrived_diagnostics_ = true;
@@ -2493,6 +2622,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			{
                 qualityind_has_arrived_diagnostics_ = false;
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in QualityInd");
+				countParseFailure();
 				break;
 			}
 			qualityind_has_arrived_diagnostics_ = true;
@@ -2504,6 +2634,7 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 			if (!ReceiverSetupParser(node_, dvec.begin(), dvec.end(), last_receiversetup_))
 			{
 				node_->log(LogLevel::ERROR, "septentrio_gnss_driver: parse error in ReceiverSetup");
+				countParseFailure();
 				break;
 			}
 			break;
@@ -2516,6 +2647,10 @@ bool io_comm_rx::RxMessage::read(std::string message_key, bool search)
 
 void io_comm_rx::RxMessage::wait(Timestamp time_obj)
 {
+	// Parallel decoding of SBF files is meant for throughput, not for playback
+	if (!settings_->file_reading_realtime ||
+		(settings_->read_from_sbf_log && (settings_->decode_threads > 1)))
+		return;
 	Timestamp unix_old = unix_time_;
 	unix_time_ = time_obj;
 	if ((unix_old != 0) &&
@@ -2525,10 +2660,8 @@ void io_comm_rx::RxMessage::wait(Timestamp time_obj)
         {
 	        auto sleep_nsec = unix_time_ - unix_old;
         
-            std::stringstream ss;
-            ss << "Waiting for " << sleep_nsec / 1000000
-            << " milliseconds...";
-            node_->log(LogLevel::DEBUG, ss.str());       
+            ROSAIC_DEBUG(node_, "Waiting for " + std::to_string(sleep_nsec / 1000000) +
+                                    " milliseconds...");
         
 		    std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_nsec));
         }
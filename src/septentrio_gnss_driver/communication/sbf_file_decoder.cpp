@@ -0,0 +1,290 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/sbf_file_decoder.hpp>
+
+// Boost includes
+#include <boost/bind.hpp>
+
+// C++ library includes
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+// POSIX includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file sbf_file_decoder.cpp
+ * @date 19/10/26
+ * @brief Defines a class for decoding large SBF files with several threads
+ */
+
+namespace io_comm_rx {
+
+    SBFFileDecoder::SBFFileDecoder(ROSaicNodeBase* node, CallbackHandlers* handlers,
+                                   uint32_t threads) :
+        node_(node),
+        handlers_(handlers), threads_(std::max(threads, static_cast<uint32_t>(1)))
+    {
+    }
+
+    SBFFileDecoder::~SBFFileDecoder()
+    {
+        if (data_)
+            munmap(const_cast<uint8_t*>(data_), size_);
+    }
+
+    void SBFFileDecoder::decode(const std::string& file_name,
+                                const std::atomic<bool>& stopping)
+    {
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("I could not find your file. Or it is corrupted.");
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+        {
+            close(fd);
+            throw std::runtime_error("I could not determine the size of your file, or it is empty.");
+        }
+        size_ = static_cast<std::size_t>(file_stat.st_size);
+        void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping stays valid after closing the file descriptor
+        close(fd);
+        if (map == MAP_FAILED)
+            throw std::runtime_error("Memory-mapping of the file failed: " +
+                                     std::string(strerror(errno)));
+        data_ = static_cast<const uint8_t*>(map);
+        // Every chunk is read once from front to back
+        madvise(map, size_, MADV_SEQUENTIAL);
+
+        chunks_.clear();
+        chunks_.resize((size_ + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        next_chunk_ = 0;
+        merged_chunk_ = 0;
+        abort_ = false;
+
+        {
+            std::stringstream ss;
+            ss << "Decoding " << file_name << " (" << size_ << " bytes, "
+               << chunks_.size() << " chunks) with " << threads_ << " threads";
+            node_->log(LogLevel::INFO, ss.str());
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        boost::thread_group workers;
+        for (uint32_t i = 0; i < threads_; ++i)
+            workers.create_thread(boost::bind(&SBFFileDecoder::work, this));
+
+        // Frames of previous chunks that may still be preceded by frames of
+        // upcoming chunks
+        std::vector<Frame> pending;
+        std::vector<Frame> merged;
+        std::size_t tail = 0;
+        std::size_t frames = 0;
+        std::size_t skipped = 0;
+        for (std::size_t i = 0; i < chunks_.size() && !stopping; ++i)
+        {
+            Chunk chunk;
+            {
+                boost::mutex::scoped_lock lock(chunk_mutex_);
+                while (!chunks_[i].ready && !stopping)
+                    chunk_ready_condition_.wait_for(lock,
+                                                    boost::chrono::milliseconds(100));
+                if (!chunks_[i].ready)
+                    break;
+                std::swap(chunk, chunks_[i]);
+                merged_chunk_ = i + 1;
+            }
+            chunk_free_condition_.notify_all();
+            // Bytes before the first frame only count as skipped if they do not
+            // belong to the last frame of the previous chunk
+            std::size_t begin = std::max(i * CHUNK_SIZE, tail);
+            skipped += chunk.skipped + (chunk.lead > begin ? chunk.lead - begin : 0);
+
+            // A false sync at the start of this chunk lies within the last frame
+            // of the previous one and is dropped
+            chunk.frames.erase(std::remove_if(chunk.frames.begin(),
+                                              chunk.frames.end(),
+                                              [tail](const Frame& frame) {
+                                                  return frame.offset < tail;
+                                              }),
+                               chunk.frames.end());
+            tail = std::max(tail, chunk.tail);
+            if (chunk.frames.empty())
+                continue;
+            frames += chunk.frames.size();
+
+            // Everything older than the oldest frame of this chunk is final
+            uint64_t watermark = chunk.frames.front().key;
+            merged.clear();
+            merged.reserve(pending.size() + chunk.frames.size());
+            std::merge(pending.begin(), pending.end(), chunk.frames.begin(),
+                       chunk.frames.end(), std::back_inserter(merged),
+                       [](const Frame& lhs, const Frame& rhs) {
+                           return lhs.key < rhs.key;
+                       });
+            auto final_end = std::lower_bound(
+                merged.begin(), merged.end(), watermark,
+                [](const Frame& frame, uint64_t key) { return frame.key < key; });
+            dispatch(merged.begin(), final_end);
+            pending.assign(final_end, merged.end());
+        }
+        if (!stopping)
+            dispatch(pending.begin(), pending.end());
+
+        {
+            boost::mutex::scoped_lock lock(chunk_mutex_);
+            abort_ = true;
+        }
+        chunk_free_condition_.notify_all();
+        workers.join_all();
+
+        munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+
+        double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        std::stringstream ss;
+        ss << "Decoded " << frames << " frames from " << file_name << " in "
+           << seconds << " s (" << (seconds > 0.0 ? size_ / seconds / 1.0e6 : 0.0)
+           << " MB/s), skipped " << skipped << " bytes while resynchronizing";
+        node_->log(LogLevel::INFO, ss.str());
+    }
+
+    void SBFFileDecoder::work()
+    {
+        const std::size_t ahead = CHUNKS_AHEAD_PER_THREAD * threads_;
+        while (true)
+        {
+            std::size_t i;
+            {
+                boost::mutex::scoped_lock lock(chunk_mutex_);
+                // Bounds the memory used for indices that are not yet merged
+                while (!abort_ && next_chunk_ < chunks_.size() &&
+                       next_chunk_ >= merged_chunk_ + ahead)
+                    chunk_free_condition_.wait(lock);
+                if (abort_ || next_chunk_ >= chunks_.size())
+                    return;
+                i = next_chunk_++;
+            }
+            Chunk chunk;
+            indexChunk(i * CHUNK_SIZE, std::min((i + 1) * CHUNK_SIZE, size_), chunk);
+            {
+                boost::mutex::scoped_lock lock(chunk_mutex_);
+                chunk.ready = true;
+                std::swap(chunks_[i], chunk);
+            }
+            chunk_ready_condition_.notify_all();
+        }
+    }
+
+    void SBFFileDecoder::indexChunk(std::size_t begin, std::size_t end,
+                                    Chunk& chunk) const
+    {
+        // WNc 65535 and TOW 4294967295 are SBF do-not-use values, such blocks
+        // inherit the key of the frame before them
+        static const uint64_t NO_KEY = UINT64_MAX;
+        uint64_t key = NO_KEY;
+        std::size_t pos = begin;
+        std::size_t length = 0;
+        chunk.lead = framing::findFrame(data_, size_, pos, end, length);
+        chunk.tail = chunk.lead;
+        pos = chunk.lead;
+        while ((pos = framing::findFrame(data_, size_, pos, end, length)) < end)
+        {
+            chunk.skipped += pos - chunk.tail;
+            if (data_[pos + 1] == SBF_SYNC_BYTE_2)
+            {
+                uint32_t tow = parsing_utilities::getTow(data_ + pos);
+                uint16_t wnc = parsing_utilities::getWnc(data_ + pos);
+                if (tow != UINT32_MAX && wnc != UINT16_MAX)
+                    key = (static_cast<uint64_t>(wnc) << 32) | tow;
+            }
+            chunk.frames.push_back(Frame{key, pos, length});
+            pos += length;
+            chunk.tail = pos;
+        }
+        if (chunk.tail < end)
+            chunk.skipped += end - chunk.tail;
+
+        // Frames before the first valid time stamp of the chunk get that one
+        auto first_key = std::find_if(
+            chunk.frames.begin(), chunk.frames.end(),
+            [](const Frame& frame) { return frame.key != NO_KEY; });
+        uint64_t leading_key = (first_key == chunk.frames.end()) ? 0 : first_key->key;
+        for (auto frame = chunk.frames.begin(); frame != first_key; ++frame)
+            frame->key = leading_key;
+
+        // Receivers output blocks in time order, so this is rarely needed
+        auto less = [](const Frame& lhs, const Frame& rhs) {
+            return lhs.key < rhs.key;
+        };
+        if (!std::is_sorted(chunk.frames.begin(), chunk.frames.end(), less))
+            std::stable_sort(chunk.frames.begin(), chunk.frames.end(), less);
+    }
+
+    void SBFFileDecoder::dispatch(std::vector<Frame>::const_iterator first,
+                                  std::vector<Frame>::const_iterator last)
+    {
+        Timestamp recvTimestamp = node_->getTime();
+        while (first != last)
+        {
+            // Frames that follow each other in the file are handed over at once
+            auto run_end = first + 1;
+            std::size_t end = first->offset + first->length;
+            while (run_end != last && run_end->offset == end)
+            {
+                end += run_end->length;
+                ++run_end;
+            }
+            std::size_t size = end - first->offset;
+            try
+            {
+                handlers_->readCallback(recvTimestamp, data_ + first->offset, size);
+                first = run_end;
+            } catch (std::size_t& parsing_failed_here)
+            {
+                // The frames are complete, so the failed one is skipped
+                std::size_t failed = first->offset + parsing_failed_here;
+                ROSAIC_DEBUG(node_, "Skipping frame at offset " +
+                                                std::to_string(failed) +
+                                                " that could not be handled");
+                while (first != run_end && first->offset <= failed)
+                    ++first;
+            }
+        }
+    }
+} // namespace io_comm_rx
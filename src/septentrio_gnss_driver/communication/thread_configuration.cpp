@@ -0,0 +1,168 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/thread_configuration.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <malloc.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @file thread_configuration.cpp
+ * @date 19/10/26
+ * @brief Implements the real-time configuration of the driver threads and of its
+ * memory
+ */
+
+namespace io_comm_rx {
+
+    void getThreadSettings(ROSaicNodeBase* node, const std::string& name,
+                           ThreadSettings& settings)
+    {
+        std::string prefix = "realtime/" + name + "/";
+        node->param(prefix + "policy", settings.policy, std::string("other"));
+        node->param(prefix + "priority", settings.priority, static_cast<int32_t>(0));
+        node->param(prefix + "cpus", settings.cpus, std::vector<int32_t>());
+        if (settings.policy != "other" && settings.policy != "fifo" &&
+            settings.policy != "rr")
+        {
+            node->log(LogLevel::ERROR, prefix + "policy must be other, fifo or rr, using other.");
+            settings.policy = "other";
+        }
+        if (settings.policy == "other")
+            return;
+        int policy = (settings.policy == "fifo") ? SCHED_FIFO : SCHED_RR;
+        int min_priority = sched_get_priority_min(policy);
+        int max_priority = sched_get_priority_max(policy);
+        if (settings.priority < min_priority || settings.priority > max_priority)
+        {
+            node->log(LogLevel::ERROR,
+                      prefix + "priority must be between " +
+                          std::to_string(min_priority) + " and " +
+                          std::to_string(max_priority) + ", clamping it.");
+            settings.priority = std::max(min_priority,
+                                         std::min(max_priority, settings.priority));
+        }
+    }
+
+    bool configureThread(ROSaicNodeBase* node, pthread_t thread,
+                         const std::string& name, const ThreadSettings& settings)
+    {
+        bool success = true;
+        std::string description = "Running the " + name + " thread";
+        if (settings.policy != "other")
+        {
+            sched_param param = {};
+            param.sched_priority = settings.priority;
+            int policy = (settings.policy == "fifo") ? SCHED_FIFO : SCHED_RR;
+            int error = pthread_setschedparam(thread, policy, &param);
+            if (error)
+            {
+                node->log(LogLevel::WARN,
+                          "Could not set the scheduling of the " + name +
+                              " thread to " + settings.policy + " priority " +
+                              std::to_string(settings.priority) + ": " +
+                              std::strerror(error) +
+                              " (needs CAP_SYS_NICE or an rtprio limit)");
+                success = false;
+            } else
+                description += " with " + settings.policy + " priority " +
+                               std::to_string(settings.priority);
+        }
+        if (!settings.cpus.empty())
+        {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            std::string cpu_list;
+            for (int32_t cpu : settings.cpus)
+            {
+                if (cpu < 0 || cpu >= CPU_SETSIZE)
+                    continue;
+                CPU_SET(cpu, &cpus);
+                cpu_list += (cpu_list.empty() ? "" : ",") + std::to_string(cpu);
+            }
+            int error = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+            if (error)
+            {
+                node->log(LogLevel::WARN, "Could not restrict the " + name +
+                                              " thread to CPUs " + cpu_list + ": " +
+                                              std::strerror(error));
+                success = false;
+            } else
+                description += " on CPUs " + cpu_list;
+        }
+        node->log(LogLevel::INFO, description + ".");
+        return success;
+    }
+
+    bool lockMemory(ROSaicNodeBase* node, std::size_t prefault_heap)
+    {
+        // Large allocations would be mapped anew each time, and freed heap would be
+        // trimmed, both of which faults again
+        mallopt(M_MMAP_MAX, 0);
+        mallopt(M_TRIM_THRESHOLD, -1);
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            node->log(LogLevel::WARN,
+                      "Could not lock memory: " + std::string(std::strerror(errno)) +
+                          " (needs CAP_IPC_LOCK or a memlock limit)");
+            return false;
+        }
+        if (prefault_heap > 0)
+        {
+            // Written through volatile, such that the writes are not optimized
+            // away along with the allocation
+            volatile char* heap = static_cast<char*>(malloc(prefault_heap));
+            if (heap)
+            {
+                std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+                for (std::size_t i = 0; i < prefault_heap; i += page_size)
+                    heap[i] = 0;
+                free(const_cast<char*>(heap));
+            }
+        }
+        node->log(LogLevel::INFO, "Locked memory, prefaulted " +
+                                      std::to_string(prefault_heap / 1024 / 1024) +
+                                      " MB of heap.");
+        return true;
+    }
+
+    Timestamp monotonicTime()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<Timestamp>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+} // namespace io_comm_rx
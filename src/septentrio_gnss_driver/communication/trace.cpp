@@ -0,0 +1,235 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <septentrio_gnss_driver/communication/trace.hpp>
+
+/**
+ * @file trace.cpp
+ * @date 19/10/26
+ * @brief Defines the tracepoints of the parsing pipeline
+ */
+
+#ifdef ROSAIC_TRACING
+
+#ifdef ROSAIC_TRACING_LTTNG
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include <septentrio_gnss_driver/communication/trace_tp.h>
+#endif
+
+// C++ library includes
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+// Linux includes
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace io_comm_rx {
+    namespace trace {
+
+        uint64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        Scope::Scope(const char* category, const char* name) : category_(category)
+        {
+            std::strncpy(name_, name, NAME_SIZE - 1);
+            name_[NAME_SIZE - 1] = '\0';
+            start_ = now();
+        }
+
+#ifdef ROSAIC_TRACING_LTTNG
+
+        void span(const char* category, const char* name, uint64_t start,
+                  uint64_t end)
+        {
+            tracepoint(septentrio_gnss_driver, span, category, name, start, end);
+        }
+
+        bool dump(const std::string& /*file_name*/, std::string& message)
+        {
+            message = "The spans are emitted via LTTng-UST, record them with "
+                      "lttng enable-event --userspace septentrio_gnss_driver:span";
+            return false;
+        }
+
+#else
+
+        namespace {
+            //! A span
+            struct Event
+            {
+                uint64_t start;
+                uint64_t end;
+                const char* category;
+                char name[NAME_SIZE];
+            };
+
+            //! Spans of one thread
+            struct ThreadRing
+            {
+                //! Only contended while dumping
+                std::mutex mutex;
+                std::vector<Event> events;
+                //! Number of spans recorded so far
+                uint64_t count = 0;
+                long tid = 0;
+                char thread_name[16] = {};
+            };
+
+            std::mutex rings_mutex;
+            //! Rings of all threads, kept after their threads ended
+            std::vector<std::shared_ptr<ThreadRing>> rings;
+
+            ThreadRing& threadRing()
+            {
+                thread_local std::shared_ptr<ThreadRing> ring;
+                if (!ring)
+                {
+                    ring = std::make_shared<ThreadRing>();
+                    ring->events.resize(EVENTS_PER_THREAD);
+                    ring->tid = syscall(SYS_gettid);
+                    pthread_getname_np(pthread_self(), ring->thread_name,
+                                       sizeof(ring->thread_name));
+                    std::lock_guard<std::mutex> lock(rings_mutex);
+                    rings.push_back(ring);
+                }
+                return *ring;
+            }
+
+            void writeString(std::ostream& out, const char* s)
+            {
+                out << '"';
+                for (; *s != '\0'; ++s)
+                {
+                    if (static_cast<unsigned char>(*s) < 0x20)
+                        continue;
+                    if ((*s == '"') || (*s == '\\'))
+                        out << '\\';
+                    out << *s;
+                }
+                out << '"';
+            }
+
+            //! Chrome traces are in microseconds, written with ns resolution
+            void writeMicroseconds(std::ostream& out, uint64_t ns)
+            {
+                out << ns / 1000 << '.' << std::setw(3) << std::setfill('0')
+                    << ns % 1000;
+            }
+        } // namespace
+
+        void span(const char* category, const char* name, uint64_t start,
+                  uint64_t end)
+        {
+            ThreadRing& ring = threadRing();
+            std::lock_guard<std::mutex> lock(ring.mutex);
+            Event& event = ring.events[ring.count % EVENTS_PER_THREAD];
+            event.start = start;
+            event.end = (end < start) ? start : end;
+            event.category = category;
+            std::strncpy(event.name, name, NAME_SIZE - 1);
+            event.name[NAME_SIZE - 1] = '\0';
+            ++ring.count;
+        }
+
+        bool dump(const std::string& file_name, std::string& message)
+        {
+            std::ofstream file(file_name);
+            if (!file.good())
+            {
+                message = "Could not open " + file_name + ".";
+                return false;
+            }
+            std::vector<std::shared_ptr<ThreadRing>> all;
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex);
+                all = rings;
+            }
+            long pid = getpid();
+            file << "{\"traceEvents\":[";
+            bool first = true;
+            for (const auto& ring : all)
+            {
+                std::vector<Event> events;
+                {
+                    std::lock_guard<std::mutex> lock(ring->mutex);
+                    uint64_t begin = (ring->count > EVENTS_PER_THREAD)
+                                         ? ring->count - EVENTS_PER_THREAD
+                                         : 0;
+                    events.reserve(ring->count - begin);
+                    for (uint64_t i = begin; i < ring->count; ++i)
+                        events.push_back(ring->events[i % EVENTS_PER_THREAD]);
+                }
+                if (!first)
+                    file << ",";
+                first = false;
+                file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                     << ",\"tid\":" << ring->tid << ",\"args\":{\"name\":";
+                writeString(file, ring->thread_name);
+                file << "}}";
+                for (const Event& event : events)
+                {
+                    file << ",\n{\"name\":";
+                    writeString(file, event.name);
+                    file << ",\"cat\":";
+                    writeString(file, event.category);
+                    file << ",\"ph\":\"X\",\"ts\":";
+                    writeMicroseconds(file, event.start);
+                    file << ",\"dur\":";
+                    writeMicroseconds(file, event.end - event.start);
+                    file << ",\"pid\":" << pid << ",\"tid\":" << ring->tid << "}";
+                }
+            }
+            file << "\n]}\n";
+            file.close();
+            if (!file.good())
+            {
+                message = "Could not write " + file_name + ".";
+                return false;
+            }
+            message = file_name;
+            return true;
+        }
+
+#endif // ROSAIC_TRACING_LTTNG
+
+    } // namespace trace
+} // namespace io_comm_rx
+
+#endif // ROSAIC_TRACING
@@ -0,0 +1,217 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/communication/udp_statistics.hpp>
+
+// C++ library includes
+#include <cstring>
+// ROSaic includes
+#include <septentrio_gnss_driver/crc/crc.h>
+#include <septentrio_gnss_driver/parsers/parsing_utilities.hpp>
+
+/**
+ * @file udp_statistics.cpp
+ * @date 19/10/26
+ * @brief Defines a class detecting lost and reordered datagrams of a UDP stream
+ */
+
+namespace {
+    //! Length of the SBF header up to and including the WNc field
+    const std::size_t SBF_TIME_END = 14;
+    //! TOW value meaning "do not use"
+    const uint32_t TOW_DO_NOT_USE = 4294967295u;
+    //! WNc value meaning "do not use"
+    const uint16_t WNC_DO_NOT_USE = 65535;
+    //! Milliseconds per GPS week
+    const uint64_t MS_PER_WEEK = 604800000ull;
+
+    //! Whether data points to the start of an SBF block ("$@"), or of an NMEA
+    //! message or command reply ("$" followed by a capital letter)
+    bool startsMessage(const uint8_t* data, std::size_t size)
+    {
+        return (size >= 2) && (data[0] == '$') &&
+               ((data[1] == '@') || ((data[1] >= 'A') && (data[1] <= 'Z')));
+    }
+} // namespace
+
+namespace io_comm_rx {
+
+    UdpStatistics::UdpStatistics(ROSaicNodeBase* node, uint32_t report_period_s) :
+        node_(node),
+        report_period_(static_cast<uint64_t>(report_period_s) * 1000000000ull)
+    {
+    }
+
+    void UdpStatistics::datagram(Timestamp recvTime, const uint8_t* data,
+                                 std::size_t size)
+    {
+        if (last_report_ == 0)
+            last_report_ = recvTime;
+        ++datagrams_;
+        bytes_ += size;
+        analyze(data, size);
+        if (recvTime - last_report_ >= report_period_)
+            report(recvTime);
+    }
+
+    void UdpStatistics::analyze(const uint8_t* data, std::size_t size)
+    {
+        std::size_t pos = 0;
+        if (continuation_)
+        {
+            if (startsMessage(data, size))
+            {
+                // The rest of the previous message was lost
+                ++gaps_;
+            } else if (pending_ > size)
+            {
+                // Datagram in the middle of a long message
+                pending_ -= size;
+                return;
+            } else
+            {
+                // If the length of the previous message is unknown, the search
+                // for the next message starts right away
+                pos = pending_;
+                if ((pending_ > 0) && (pos < size) &&
+                    !startsMessage(data + pos, size - pos))
+                {
+                    // The datagram continues a different message
+                    ++gaps_;
+                }
+            }
+        } else if (!startsMessage(data, size))
+        {
+            // The start of the message was lost
+            ++gaps_;
+        }
+        continuation_ = false;
+        pending_ = 0;
+
+        bool first_block = true;
+        while (pos < size)
+        {
+            const uint8_t* message = data + pos;
+            std::size_t left = size - pos;
+            if (!startsMessage(message, left))
+            {
+                if ((left == 1) && (message[0] == '$'))
+                {
+                    continuation_ = true;
+                    break;
+                }
+                const void* next = std::memchr(message + 1, '$', left - 1);
+                pos = next ? static_cast<const uint8_t*>(next) - data : size;
+                continue;
+            }
+            if (message[1] == '@')
+            {
+                if (left < SBF_LENGTH_FIELD_END)
+                {
+                    continuation_ = true;
+                    break;
+                }
+                uint16_t length = parsing_utilities::getLength(message);
+                if ((length < SBF_LENGTH_FIELD_END) || (length % 4 != 0))
+                {
+                    ++corrupt_;
+                    ++pos;
+                    continue;
+                }
+                if (length > left)
+                {
+                    continuation_ = true;
+                    pending_ = length - left;
+                    break;
+                }
+                if (!isValid(message))
+                {
+                    ++corrupt_;
+                    ++pos;
+                    continue;
+                }
+                if (length >= SBF_TIME_END)
+                {
+                    uint32_t tow = parsing_utilities::getTow(message);
+                    uint16_t wnc = parsing_utilities::getWnc(message);
+                    if ((tow != TOW_DO_NOT_USE) && (wnc != WNC_DO_NOT_USE))
+                    {
+                        uint64_t time = wnc * MS_PER_WEEK + tow;
+                        if (time < latest_time_)
+                        {
+                            if (first_block)
+                                ++reordered_;
+                        } else
+                            latest_time_ = time;
+                        first_block = false;
+                    }
+                }
+                pos += length;
+            } else
+            {
+                // NMEA message or command reply, terminated by <LF>
+                const void* lf = std::memchr(message, '\n', left);
+                if (!lf)
+                {
+                    continuation_ = true;
+                    break;
+                }
+                pos = static_cast<const uint8_t*>(lf) - data + 1;
+            }
+        }
+    }
+
+    void UdpStatistics::report(Timestamp recvTime)
+    {
+        total_datagrams_ += datagrams_;
+        total_gaps_ += gaps_;
+        total_reordered_ += reordered_;
+        std::string message =
+            "UDP stream: " + std::to_string(datagrams_) + " datagrams (" +
+            std::to_string(bytes_) + " bytes) within " +
+            std::to_string((recvTime - last_report_) / 1000000) + " ms, " +
+            std::to_string(gaps_) + " framing gaps due to lost or reordered datagrams, " +
+            std::to_string(reordered_) + " reordered datagrams, " +
+            std::to_string(corrupt_) + " corrupt SBF blocks. In total " +
+            std::to_string(total_datagrams_) + " datagrams, " +
+            std::to_string(total_gaps_) + " gaps, " +
+            std::to_string(total_reordered_) + " reordered.";
+        if ((gaps_ > 0) || (reordered_ > 0) || (corrupt_ > 0))
+            node_->log(LogLevel::WARN, message);
+        else
+            node_->log(LogLevel::DEBUG, message);
+        datagrams_ = 0;
+        bytes_ = 0;
+        gaps_ = 0;
+        reordered_ = 0;
+        corrupt_ = 0;
+        last_report_ = recvTime;
+    }
+} // namespace io_comm_rx
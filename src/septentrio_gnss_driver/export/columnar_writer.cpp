@@ -0,0 +1,329 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/export/columnar_writer.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cerrno>
+// Arrow includes
+#ifdef HAVE_ARROW
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#endif
+
+/**
+ * @file columnar_writer.cpp
+ * @date 19/10/26
+ * @brief Defines a writer of column-oriented files
+ */
+
+namespace sbf_export {
+
+    namespace {
+        //! First bytes of files in the native format
+        const char NATIVE_MAGIC[8] = {'S', 'B', 'F', 'C', 'O', 'L', '0', '1'};
+    } // namespace
+
+#ifdef HAVE_ARROW
+    struct ColumnarWriter::ArrowState
+    {
+        std::shared_ptr<arrow::Schema> schema;
+        std::shared_ptr<arrow::io::FileOutputStream> stream;
+        std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+    };
+
+    namespace {
+        std::shared_ptr<arrow::DataType> arrowType(ColumnType type)
+        {
+            switch (type)
+            {
+            case ColumnType::UInt8:
+                return arrow::uint8();
+            case ColumnType::Int8:
+                return arrow::int8();
+            case ColumnType::UInt16:
+                return arrow::uint16();
+            case ColumnType::UInt32:
+                return arrow::uint32();
+            case ColumnType::Int32:
+                return arrow::int32();
+            case ColumnType::Float32:
+                return arrow::float32();
+            default:
+                return arrow::float64();
+            }
+        }
+    } // namespace
+
+    bool arrowAvailable() { return true; }
+#else
+    struct ColumnarWriter::ArrowState
+    {
+    };
+
+    bool arrowAvailable() { return false; }
+#endif
+
+    std::size_t columnWidth(ColumnType type)
+    {
+        switch (type)
+        {
+        case ColumnType::UInt8:
+        case ColumnType::Int8:
+            return 1;
+        case ColumnType::UInt16:
+            return 2;
+        case ColumnType::UInt32:
+        case ColumnType::Int32:
+        case ColumnType::Float32:
+            return 4;
+        default:
+            return 8;
+        }
+    }
+
+    ColumnarWriter::ColumnarWriter(const std::string& file_name,
+                                   const std::vector<Column>& columns,
+                                   Format format, std::size_t batch_rows) :
+        file_name_(file_name),
+        columns_(columns), format_(format),
+        batch_rows_(std::max(batch_rows, static_cast<std::size_t>(1)))
+    {
+        for (const auto& column : columns_)
+            widths_.push_back(columnWidth(column.type));
+    }
+
+    ColumnarWriter::~ColumnarWriter()
+    {
+        std::string error;
+        close(error);
+    }
+
+    bool ColumnarWriter::open(std::string& error)
+    {
+        if (!writeHeader(error))
+            return false;
+        for (std::size_t i = 0; i < BATCHES_IN_FLIGHT; ++i)
+        {
+            std::unique_ptr<Batch> batch(new Batch);
+            for (std::size_t width : widths_)
+                batch->columns.emplace_back(batch_rows_ * width);
+            free_batches_.push_back(std::move(batch));
+        }
+        batch_ = std::move(free_batches_.front());
+        free_batches_.pop_front();
+        thread_ = std::thread(&ColumnarWriter::run, this);
+        return true;
+    }
+
+    void ColumnarWriter::submit()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        full_batches_.push_back(std::move(batch_));
+        full_condition_.notify_one();
+        free_condition_.wait(lock, [this]() { return !free_batches_.empty(); });
+        batch_ = std::move(free_batches_.front());
+        free_batches_.pop_front();
+        batch_->rows = 0;
+    }
+
+    void ColumnarWriter::run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            full_condition_.wait(
+                lock, [this]() { return closing_ || !full_batches_.empty(); });
+            if (full_batches_.empty())
+                break;
+            std::unique_ptr<Batch> batch = std::move(full_batches_.front());
+            full_batches_.pop_front();
+            bool failed = !error_.empty();
+            lock.unlock();
+            std::string error;
+            if (!failed)
+                writeBatch(*batch, error);
+            lock.lock();
+            if (error_.empty())
+                error_ = error;
+            free_batches_.push_back(std::move(batch));
+            free_condition_.notify_one();
+        }
+    }
+
+    bool ColumnarWriter::close(std::string& error)
+    {
+        if (thread_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (batch_->rows > 0)
+                    full_batches_.push_back(std::move(batch_));
+                closing_ = true;
+            }
+            full_condition_.notify_one();
+            thread_.join();
+        }
+
+        std::string finish_error;
+        if (!finish(finish_error) && error_.empty())
+            error_ = finish_error;
+        error = error_;
+        return error_.empty();
+    }
+
+    bool ColumnarWriter::writeHeader(std::string& error)
+    {
+        if (format_ == Format::Arrow)
+        {
+#ifdef HAVE_ARROW
+            std::vector<std::shared_ptr<arrow::Field>> fields;
+            for (const auto& column : columns_)
+                fields.push_back(
+                    arrow::field(column.name, arrowType(column.type), false));
+            arrow_.reset(new ArrowState);
+            arrow_->schema = arrow::schema(fields);
+            auto stream = arrow::io::FileOutputStream::Open(file_name_);
+            if (!stream.ok())
+            {
+                error = "Cannot create " + file_name_ + ": " +
+                        stream.status().ToString();
+                return false;
+            }
+            arrow_->stream = *stream;
+            auto writer = arrow::ipc::MakeFileWriter(arrow_->stream, arrow_->schema);
+            if (!writer.ok())
+            {
+                error = "Cannot write " + file_name_ + ": " +
+                        writer.status().ToString();
+                return false;
+            }
+            arrow_->writer = *writer;
+            return true;
+#else
+            error = "Built without Arrow, " + file_name_ + " cannot be written";
+            return false;
+#endif
+        }
+
+        file_ = std::fopen(file_name_.c_str(), "wb");
+        if (!file_)
+        {
+            error = "Cannot create " + file_name_ + ": " + std::strerror(errno);
+            return false;
+        }
+        std::string header(NATIVE_MAGIC, sizeof(NATIVE_MAGIC));
+        uint32_t count = static_cast<uint32_t>(columns_.size());
+        header.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& column : columns_)
+        {
+            header.push_back(static_cast<char>(column.type));
+            header.push_back(static_cast<char>(column.name.size()));
+            header.append(column.name);
+        }
+        if (std::fwrite(header.data(), 1, header.size(), file_) != header.size())
+        {
+            error = "Cannot write " + file_name_ + ": " + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    bool ColumnarWriter::writeBatch(const Batch& batch, std::string& error)
+    {
+        if (format_ == Format::Arrow)
+        {
+#ifdef HAVE_ARROW
+            // The batch outlives the write, so its columns are not copied
+            std::vector<std::shared_ptr<arrow::Array>> arrays;
+            for (std::size_t i = 0; i < columns_.size(); ++i)
+            {
+                std::vector<std::shared_ptr<arrow::Buffer>> buffers = {
+                    nullptr, std::make_shared<arrow::Buffer>(
+                                 batch.columns[i].data(),
+                                 static_cast<int64_t>(batch.rows * widths_[i]))};
+                arrays.push_back(arrow::MakeArray(arrow::ArrayData::Make(
+                    arrow_->schema->field(static_cast<int>(i))->type(),
+                    static_cast<int64_t>(batch.rows), buffers, 0)));
+            }
+            auto record_batch = arrow::RecordBatch::Make(
+                arrow_->schema, static_cast<int64_t>(batch.rows), arrays);
+            arrow::Status status = arrow_->writer->WriteRecordBatch(*record_batch);
+            if (!status.ok())
+            {
+                error = "Cannot write " + file_name_ + ": " + status.ToString();
+                return false;
+            }
+#endif
+            return true;
+        }
+
+        uint32_t rows = static_cast<uint32_t>(batch.rows);
+        bool written = std::fwrite(&rows, sizeof(rows), 1, file_) == 1;
+        for (std::size_t i = 0; written && i < columns_.size(); ++i)
+        {
+            std::size_t size = batch.rows * widths_[i];
+            written = std::fwrite(batch.columns[i].data(), 1, size, file_) == size;
+        }
+        if (!written)
+            error = "Cannot write " + file_name_ + ": " + std::strerror(errno);
+        return written;
+    }
+
+    bool ColumnarWriter::finish(std::string& error)
+    {
+#ifdef HAVE_ARROW
+        if (arrow_ && arrow_->writer)
+        {
+            arrow::Status status = arrow_->writer->Close();
+            if (status.ok())
+                status = arrow_->stream->Close();
+            arrow_.reset();
+            if (!status.ok())
+            {
+                error = "Cannot close " + file_name_ + ": " + status.ToString();
+                return false;
+            }
+        }
+#endif
+        if (file_)
+        {
+            bool closed = std::fclose(file_) == 0;
+            file_ = nullptr;
+            if (!closed)
+            {
+                error = "Cannot close " + file_name_ + ": " + std::strerror(errno);
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace sbf_export
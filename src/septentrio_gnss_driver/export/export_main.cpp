@@ -0,0 +1,168 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/export/sbf_exporter.hpp>
+// C++ library includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+/**
+ * @file export_main.cpp
+ * @date 19/10/26
+ * @brief Main function of the columnar export of SBF files
+ */
+
+namespace {
+    void usage(const char* name)
+    {
+        std::fprintf(
+            stderr,
+            "Usage: %s [options] FILE.sbf...\n"
+            "  --output PREFIX      Prefix of the tables, PREFIX_<block>.<ext>\n"
+            "                       (first file without its extension)\n"
+            "  --blocks LIST        Comma-separated block types (all)\n"
+            "  --format FORMAT      arrow or native (arrow if built with Arrow)\n"
+            "  --batch-rows N       Rows per row group (65536)\n"
+            "Block types:",
+            name);
+        for (const auto& block : sbf_export::SBFExporter::blockTypes())
+            std::fprintf(stderr, " %s", block.c_str());
+        std::fprintf(stderr, "\n");
+    }
+
+    std::vector<std::string> blockList(const std::string& value)
+    {
+        std::vector<std::string> types = sbf_export::SBFExporter::blockTypes();
+        std::vector<std::string> blocks;
+        std::size_t begin = 0;
+        while (begin <= value.size())
+        {
+            std::size_t end = std::min(value.find(',', begin), value.size());
+            std::string block = value.substr(begin, end - begin);
+            if (std::find(types.begin(), types.end(), block) == types.end())
+                throw std::invalid_argument("unknown block type " + block);
+            if (std::find(blocks.begin(), blocks.end(), block) == blocks.end())
+                blocks.push_back(block);
+            begin = end + 1;
+        }
+        return blocks;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    sbf_export::ExportSettings settings;
+    settings.blocks = sbf_export::SBFExporter::blockTypes();
+    settings.format = sbf_export::arrowAvailable() ? sbf_export::Format::Arrow
+                                                   : sbf_export::Format::Native;
+    std::vector<std::string> files;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string option = argv[i];
+            if (option == "--help" || option == "-h")
+            {
+                usage(argv[0]);
+                return 0;
+            }
+            if (option.compare(0, 2, "--") != 0)
+            {
+                files.push_back(option);
+                continue;
+            }
+            if (i + 1 >= argc)
+                throw std::invalid_argument("missing value of " + option);
+            std::string value = argv[++i];
+            if (option == "--output")
+                settings.output_prefix = value;
+            else if (option == "--blocks")
+                settings.blocks = blockList(value);
+            else if (option == "--format")
+            {
+                if (value == "arrow")
+                {
+                    if (!sbf_export::arrowAvailable())
+                        throw std::invalid_argument("built without Arrow");
+                    settings.format = sbf_export::Format::Arrow;
+                } else if (value == "native")
+                    settings.format = sbf_export::Format::Native;
+                else
+                    throw std::invalid_argument("unknown format " + value);
+            } else if (option == "--batch-rows")
+            {
+                settings.batch_rows = std::stoul(value);
+                if (settings.batch_rows == 0)
+                    throw std::invalid_argument("batch rows must be positive");
+            } else
+                throw std::invalid_argument("unknown option " + option);
+        }
+        if (files.empty())
+            throw std::invalid_argument("no SBF file given");
+    } catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        usage(argv[0]);
+        return 1;
+    }
+    if (settings.output_prefix.empty())
+    {
+        std::size_t slash = files.front().find_last_of('/');
+        std::size_t dot = files.front().find_last_of('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            settings.output_prefix = files.front();
+        else
+            settings.output_prefix = files.front().substr(0, dot);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    sbf_export::SBFExporter exporter(settings);
+    std::string error;
+    bool exported = exporter.open(error);
+    for (auto file = files.begin(); exported && file != files.end(); ++file)
+        exported = exporter.exportFile(*file, error);
+    std::string close_error;
+    if (!exporter.close(close_error) && exported)
+    {
+        exported = false;
+        error = close_error;
+    }
+    if (!exported)
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    exporter.printStatistics(
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count());
+    return 0;
+}
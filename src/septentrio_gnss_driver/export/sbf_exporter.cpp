@@ -0,0 +1,411 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/export/sbf_exporter.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+// POSIX includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// ROSaic includes
+#include <septentrio_gnss_driver/parsers/framing.hpp>
+
+/**
+ * @file sbf_exporter.cpp
+ * @date 19/10/26
+ * @brief Defines the export of decoded SBF blocks into column-oriented files
+ */
+
+namespace sbf_export {
+
+    namespace {
+        const ColumnType U8 = ColumnType::UInt8;
+        const ColumnType I8 = ColumnType::Int8;
+        const ColumnType U16 = ColumnType::UInt16;
+        const ColumnType U32 = ColumnType::UInt32;
+        const ColumnType I32 = ColumnType::Int32;
+        const ColumnType F32 = ColumnType::Float32;
+        const ColumnType F64 = ColumnType::Float64;
+
+        // The columns are set in this order by the export functions below
+        const std::vector<Column> PVTGEODETIC_COLUMNS = {
+            {"tow", U32},          {"wnc", U16},          {"mode", U8},
+            {"error", U8},         {"latitude", F64},     {"longitude", F64},
+            {"height", F64},       {"undulation", F32},   {"vn", F32},
+            {"ve", F32},           {"vu", F32},           {"cog", F32},
+            {"rx_clk_bias", F64},  {"rx_clk_drift", F32}, {"time_system", U8},
+            {"datum", U8},         {"nr_sv", U8},         {"wa_corr_info", U8},
+            {"reference_id", U16}, {"mean_corr_age", U16}, {"signal_info", U32},
+            {"alert_flag", U8},    {"nr_bases", U8},      {"ppp_info", U16},
+            {"latency", U16},      {"h_accuracy", U16},   {"v_accuracy", U16},
+            {"misc", U8}};
+
+        const std::vector<Column> INSNAVGEOD_COLUMNS = {
+            {"tow", U32},
+            {"wnc", U16},
+            {"gnss_mode", U8},
+            {"error", U8},
+            {"info", U16},
+            {"gnss_age", U16},
+            {"latitude", F64},
+            {"longitude", F64},
+            {"height", F64},
+            {"undulation", F32},
+            {"accuracy", U16},
+            {"latency", U16},
+            {"datum", U8},
+            {"sb_list", U16},
+            {"latitude_std_dev", F32},
+            {"longitude_std_dev", F32},
+            {"height_std_dev", F32},
+            {"latitude_longitude_cov", F32},
+            {"latitude_height_cov", F32},
+            {"longitude_height_cov", F32},
+            {"heading", F32},
+            {"pitch", F32},
+            {"roll", F32},
+            {"heading_std_dev", F32},
+            {"pitch_std_dev", F32},
+            {"roll_std_dev", F32},
+            {"heading_pitch_cov", F32},
+            {"heading_roll_cov", F32},
+            {"pitch_roll_cov", F32},
+            {"ve", F32},
+            {"vn", F32},
+            {"vu", F32},
+            {"ve_std_dev", F32},
+            {"vn_std_dev", F32},
+            {"vu_std_dev", F32},
+            {"ve_vn_cov", F32},
+            {"ve_vu_cov", F32},
+            {"vn_vu_cov", F32}};
+
+        const std::vector<Column> MEASEPOCH_COLUMNS = {
+            {"tow", U32},
+            {"wnc", U16},
+            {"common_flags", U8},
+            {"cum_clk_jumps", U8},
+            {"rx_channel", U8},
+            {"sv_id", U8},
+            //! 1 or 2, the sub-block type
+            {"sub_block", U8},
+            {"type", U8},
+            {"obs_info", U8},
+            {"cn0", U8},
+            {"lock_time", U16},
+            {"carrier_msb", I8},
+            {"carrier_lsb", U16},
+            // Type-1 only, 0 in Type-2 rows
+            {"misc", U8},
+            {"code_lsb", U32},
+            {"doppler", I32},
+            // Type-2 only, 0 in Type-1 rows
+            {"offsets_msb", U8},
+            {"code_offset_lsb", U16},
+            {"doppler_offset_lsb", U16}};
+
+        const std::vector<Column> CHANNELSTATUS_COLUMNS = {
+            {"tow", U32},           {"wnc", U16},          {"rx_channel", U8},
+            {"sv_id", U8},          {"freq_nr", U8},       {"az_rise_set", U16},
+            {"health_status", U16}, {"elev", I8},          {"antenna", U8},
+            {"tracking_status", U16}, {"pvt_status", U16}, {"pvt_info", U16}};
+
+        //! Sets the values of a row in the order of its columns and completes it
+        template <typename... T>
+        void addRow(ColumnarWriter& writer, T... values)
+        {
+            std::size_t column = 0;
+            // Braced initializers are evaluated from left to right
+            int expand[] = {(writer.set(column++, values), 0)...};
+            (void)expand;
+            writer.endRow();
+        }
+    } // namespace
+
+    SBFExporter::SBFExporter(const ExportSettings& settings) : settings_(settings)
+    {
+    }
+
+    std::vector<std::string> SBFExporter::blockTypes()
+    {
+        return {"PVTGeodetic", "INSNavGeod", "MeasEpoch", "ChannelStatus"};
+    }
+
+    bool SBFExporter::open(std::string& error)
+    {
+        std::string extension =
+            (settings_.format == Format::Arrow) ? ".arrow" : ".sbfc";
+        for (const auto& block : settings_.blocks)
+        {
+            std::unique_ptr<ColumnarWriter>* writer;
+            const std::vector<Column>* columns;
+            if (block == "PVTGeodetic")
+            {
+                writer = &pvtgeodetic_;
+                columns = &PVTGEODETIC_COLUMNS;
+            } else if (block == "INSNavGeod")
+            {
+                writer = &insnavgeod_;
+                columns = &INSNAVGEOD_COLUMNS;
+            } else if (block == "MeasEpoch")
+            {
+                writer = &measepoch_;
+                columns = &MEASEPOCH_COLUMNS;
+            } else if (block == "ChannelStatus")
+            {
+                writer = &channelstatus_;
+                columns = &CHANNELSTATUS_COLUMNS;
+            } else
+            {
+                error = "Unknown block type " + block;
+                return false;
+            }
+            writer->reset(new ColumnarWriter(
+                settings_.output_prefix + "_" + block + extension, *columns,
+                settings_.format, settings_.batch_rows));
+            if (!(*writer)->open(error))
+                return false;
+        }
+        return true;
+    }
+
+    bool SBFExporter::exportFile(const std::string& file_name, std::string& error)
+    {
+        int fd = ::open(file_name.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            error = "Cannot open " + file_name + ": " + std::strerror(errno);
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            error = "Cannot stat " + file_name + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+        if (size == 0)
+        {
+            ::close(fd);
+            return true;
+        }
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            error = "Cannot map " + file_name + ": " + std::strerror(errno);
+            return false;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        const uint8_t* data = static_cast<const uint8_t*>(mapped);
+
+        std::size_t pos = 0;
+        std::size_t tail = 0;
+        std::size_t length = 0;
+        while ((pos = framing::findFrame(data, size, pos, size, length)) < size)
+        {
+            skipped_ += pos - tail;
+            if (data[pos + 1] == SBF_SYNC_BYTE_2)
+            {
+                ++blocks_;
+                switch (parsing_utilities::getId(data + pos))
+                {
+                case 4007:
+                    if (pvtgeodetic_)
+                        exportPVTGeodetic(data + pos, length);
+                    break;
+                case 4226:
+                    if (insnavgeod_)
+                        exportINSNavGeod(data + pos, length);
+                    break;
+                case 4027:
+                    if (measepoch_)
+                        exportMeasEpoch(data + pos, length);
+                    break;
+                case 4013:
+                    if (channelstatus_)
+                        exportChannelStatus(data + pos, length);
+                    break;
+                default:
+                    break;
+                }
+            }
+            pos += length;
+            tail = pos;
+        }
+        skipped_ += size - tail;
+        bytes_ += size;
+        munmap(mapped, size);
+        return true;
+    }
+
+    bool SBFExporter::close(std::string& error)
+    {
+        bool closed = true;
+        for (auto* writer :
+             {&pvtgeodetic_, &insnavgeod_, &measepoch_, &channelstatus_})
+        {
+            std::string writer_error;
+            if (*writer && !(*writer)->close(writer_error) && closed)
+            {
+                error = writer_error;
+                closed = false;
+            }
+        }
+        return closed;
+    }
+
+    void SBFExporter::printStatistics(double seconds) const
+    {
+        std::fprintf(stderr,
+                     "Read %llu bytes in %.1f s (%.1f MB/s), %llu SBF blocks, "
+                     "%llu bytes skipped, %llu parse failures\n",
+                     static_cast<unsigned long long>(bytes_), seconds,
+                     seconds > 0.0 ? bytes_ / seconds / 1e6 : 0.0,
+                     static_cast<unsigned long long>(blocks_),
+                     static_cast<unsigned long long>(skipped_),
+                     static_cast<unsigned long long>(parse_failures_));
+        for (const auto* writer :
+             {&pvtgeodetic_, &insnavgeod_, &measepoch_, &channelstatus_})
+        {
+            if (*writer)
+                std::fprintf(stderr, "%s: %llu rows\n",
+                             (*writer)->fileName().c_str(),
+                             static_cast<unsigned long long>((*writer)->rows()));
+        }
+    }
+
+    bool SBFExporter::logEnabled(LogLevel logLevel)
+    {
+        return logLevel >= LogLevel::WARN;
+    }
+
+    void SBFExporter::log(LogLevel logLevel, const std::string& s)
+    {
+        if (logEnabled(logLevel))
+            std::fprintf(stderr, "%s\n", s.c_str());
+    }
+
+    void SBFExporter::exportPVTGeodetic(const uint8_t* block, std::size_t length)
+    {
+        PVTGeodeticMsg& msg = pvtgeodetic_msg_;
+        if (!PVTGeodeticParser(this, block, block + length, msg))
+        {
+            ++parse_failures_;
+            return;
+        }
+        addRow(*pvtgeodetic_, msg.block_header.tow, msg.block_header.wnc, msg.mode,
+            msg.error, msg.latitude, msg.longitude, msg.height, msg.undulation,
+            msg.vn, msg.ve, msg.vu, msg.cog, msg.rx_clk_bias, msg.rx_clk_drift,
+            msg.time_system, msg.datum, msg.nr_sv, msg.wa_corr_info,
+            msg.reference_id, msg.mean_corr_age, msg.signal_info, msg.alert_flag,
+            msg.nr_bases, msg.ppp_info, msg.latency, msg.h_accuracy,
+            msg.v_accuracy, msg.misc);
+    }
+
+    void SBFExporter::exportINSNavGeod(const uint8_t* block, std::size_t length)
+    {
+        INSNavGeodMsg& msg = insnavgeod_msg_;
+        if (!INSNavGeodParser(this, block, block + length, msg, false))
+        {
+            ++parse_failures_;
+            return;
+        }
+        addRow(*insnavgeod_, msg.block_header.tow, msg.block_header.wnc,
+            msg.gnss_mode, msg.error, msg.info, msg.gnss_age, msg.latitude,
+            msg.longitude, msg.height, msg.undulation, msg.accuracy, msg.latency,
+            msg.datum, msg.sb_list, msg.latitude_std_dev, msg.longitude_std_dev,
+            msg.height_std_dev, msg.latitude_longitude_cov,
+            msg.latitude_height_cov, msg.longitude_height_cov, msg.heading,
+            msg.pitch, msg.roll, msg.heading_std_dev, msg.pitch_std_dev,
+            msg.roll_std_dev, msg.heading_pitch_cov, msg.heading_roll_cov,
+            msg.pitch_roll_cov, msg.ve, msg.vn, msg.vu, msg.ve_std_dev,
+            msg.vn_std_dev, msg.vu_std_dev, msg.ve_vn_cov, msg.ve_vu_cov,
+            msg.vn_vu_cov);
+    }
+
+    void SBFExporter::exportMeasEpoch(const uint8_t* block, std::size_t length)
+    {
+        MeasEpochMsg& msg = measepoch_msg_;
+        if (!MeasEpochParser(this, block, block + length, msg))
+        {
+            ++parse_failures_;
+            return;
+        }
+        for (const auto& type1 : msg.type1)
+        {
+            addRow(*measepoch_, msg.block_header.tow, msg.block_header.wnc,
+                msg.common_flags, msg.cum_clk_jumps, type1.rx_channel,
+                type1.sv_id, static_cast<uint8_t>(1), type1.type, type1.obs_info,
+                type1.cn0, type1.lock_time, type1.carrier_msb, type1.carrier_lsb,
+                type1.misc, type1.code_lsb, type1.doppler, static_cast<uint8_t>(0),
+                static_cast<uint16_t>(0), static_cast<uint16_t>(0));
+            for (const auto& type2 : type1.type2)
+            {
+                addRow(*measepoch_, msg.block_header.tow, msg.block_header.wnc,
+                    msg.common_flags, msg.cum_clk_jumps, type1.rx_channel,
+                    type1.sv_id, static_cast<uint8_t>(2), type2.type,
+                    type2.obs_info, type2.cn0,
+                    static_cast<uint16_t>(type2.lock_time), type2.carrier_msb,
+                    type2.carrier_lsb, static_cast<uint8_t>(0),
+                    static_cast<uint32_t>(0), static_cast<int32_t>(0),
+                    type2.offsets_msb, type2.code_offset_lsb,
+                    type2.doppler_offset_lsb);
+            }
+        }
+    }
+
+    void SBFExporter::exportChannelStatus(const uint8_t* block, std::size_t length)
+    {
+        ChannelStatus& msg = channelstatus_msg_;
+        if (!ChannelStatusParser(this, block, block + length, msg))
+        {
+            ++parse_failures_;
+            return;
+        }
+        for (const auto& satInfo : msg.satInfo)
+        {
+            for (const auto& stateInfo : satInfo.stateInfo)
+            {
+                addRow(*channelstatus_, msg.block_header.tow, msg.block_header.wnc,
+                    satInfo.rx_channel, satInfo.sv_id, satInfo.freq_nr,
+                    satInfo.az_rise_set, satInfo.health_status, satInfo.elev,
+                    stateInfo.antenna, stateInfo.tracking_status,
+                    stateInfo.pvt_status, stateInfo.pvt_info);
+            }
+        }
+    }
+} // namespace sbf_export
@@ -39,10 +39,20 @@
 int main(int argc, char** argv)
 {
     ros::init(argc, argv, "septentrio_gnss");
-  	
-    rosaic_node::ROSaicNode
-        rx_node; // This launches everything we need, in theory :)
-    ros::spin();
+
+    std::vector<std::string> receivers;
+    ros::NodeHandle("~").getParam("receivers", receivers);
+    if (receivers.empty())
+    {
+        rosaic_node::ROSaicNode
+            rx_node; // This launches everything we need, in theory :)
+        ros::spin();
+    } else
+    {
+        // Several Rxs, each in a namespace of its own
+        rosaic_node::ROSaicMultiNode rx_nodes(receivers);
+        ros::spin();
+    }
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/node/replay.hpp>
+// C++ library includes
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @file replay.cpp
+ * @date 19/10/26
+ * @brief Replays an SBF or PCAP file through the whole decoding pipeline and
+ * compares the messages with golden ones
+ *
+ * The messages are handed over to a PublishSink instead of being published. The
+ * file is decoded twice: once counting the messages only, to measure the
+ * throughput, and once printing them, to be recorded or compared field by field.
+ */
+
+namespace {
+    /**
+     * @brief Compares the messages field by field, i.e. line by line
+     * @return Number of messages that differ
+     */
+    std::size_t compare(const std::vector<std::string>& golden,
+                        const std::vector<std::string>& actual)
+    {
+        const std::size_t MAX_REPORTED = 10;
+        std::size_t differences = 0;
+        for (std::size_t i = 0; i < std::min(golden.size(), actual.size()); ++i)
+        {
+            if (golden[i] == actual[i])
+                continue;
+            if (++differences > MAX_REPORTED)
+                continue;
+            std::istringstream expected_lines(golden[i]);
+            std::istringstream actual_lines(actual[i]);
+            std::string topic = golden[i].substr(0, golden[i].find('\n'));
+            std::string expected_line, actual_line;
+            while (true)
+            {
+                bool more_expected = !!std::getline(expected_lines, expected_line);
+                bool more_actual = !!std::getline(actual_lines, actual_line);
+                if (!more_expected && !more_actual)
+                    break;
+                if (!more_expected)
+                    expected_line = "<none>";
+                if (!more_actual)
+                    actual_line = "<none>";
+                if (expected_line != actual_line)
+                {
+                    ROS_ERROR_STREAM("Message " << i << " (" << topic
+                                                << ") differs, expected \""
+                                                << expected_line << "\", got \""
+                                                << actual_line << "\"");
+                    break;
+                }
+            }
+        }
+        if (golden.size() != actual.size())
+        {
+            ROS_ERROR_STREAM("Expected " << golden.size() << " messages, got "
+                                         << actual.size());
+            ++differences;
+        }
+        return differences;
+    }
+
+    void usage()
+    {
+        ROS_ERROR("Usage: septentrio_gnss_driver_replay [--record FILE] [--golden "
+                  "FILE] [--min-rate MESSAGES_PER_S], the node parameters, "
+                  "including device: file_name:/path/to/file.sbf or .pcap, being "
+                  "taken from the parameter server");
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "septentrio_gnss_replay");
+
+    std::string record_file;
+    std::string golden_file;
+    double min_rate = 0.0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 2;
+        }
+        if (option == "--record")
+            record_file = argv[++i];
+        else if (option == "--golden")
+            golden_file = argv[++i];
+        else if (option == "--min-rate")
+            min_rate = std::stod(argv[++i]);
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    ros::NodeHandle pnh("~");
+    std::string device;
+    pnh.getParam("device", device);
+    if (device.compare(0, 10, "file_name:") != 0)
+    {
+        ROS_ERROR_STREAM("The device " << device << " is not a file");
+        usage();
+        return 2;
+    }
+    // Decoded as fast as possible, also for the golden messages to not depend on
+    // the playback speed
+    pnh.setParam("file_reading/realtime", false);
+
+    int result = 0;
+    rosaic_replay::MessageRecorder counter(false);
+    rosaic_replay::replay(counter);
+    double rate = counter.rate();
+    ROS_INFO_STREAM("Decoded " << counter.count() << " messages in "
+                               << counter.seconds() << " s, " << rate
+                               << " messages/s");
+    if (rate < min_rate)
+    {
+        ROS_ERROR_STREAM("The throughput is below " << min_rate << " messages/s");
+        result = 1;
+    }
+
+    if (record_file.empty() && golden_file.empty())
+        return result;
+    rosaic_replay::MessageRecorder printer(true);
+    rosaic_replay::replay(printer);
+    if (!record_file.empty())
+    {
+        std::ofstream out(record_file, std::ios::binary);
+        out << printer.text();
+        if (!out)
+        {
+            ROS_ERROR_STREAM("Cannot write " << record_file);
+            return 2;
+        }
+        ROS_INFO_STREAM("Recorded " << printer.count() << " messages to "
+                                    << record_file);
+    }
+    if (!golden_file.empty())
+    {
+        std::ifstream in(golden_file, std::ios::binary);
+        if (!in)
+        {
+            ROS_ERROR_STREAM("Cannot read " << golden_file);
+            return 2;
+        }
+        std::stringstream golden;
+        golden << in.rdbuf();
+        std::size_t differences =
+            compare(rosaic_replay::splitMessages(golden.str()),
+                    rosaic_replay::splitMessages(printer.text()));
+        if (differences != 0)
+        {
+            ROS_ERROR_STREAM(differences << " messages differ from " << golden_file);
+            result = 1;
+        } else
+            ROS_INFO_STREAM("All " << printer.count() << " messages match "
+                                   << golden_file);
+    }
+    return result;
+}
@@ -40,8 +40,17 @@
  */
 
 rosaic_node::ROSaicNode::ROSaicNode() :
-    IO_(this, &settings_)
+    ROSaicNode(std::string(), boost::shared_ptr<boost::asio::io_service>())
 {
+}
+
+rosaic_node::ROSaicNode::ROSaicNode(
+    const std::string& receiver_name,
+    boost::shared_ptr<boost::asio::io_service> io_service, PublishSink* sink) :
+    ROSaicNodeBase(receiver_name),
+    IO_(this, &settings_, io_service)
+{
+    setPublishSink(sink);
     param("activate_debug_log", settings_.activate_debug_log, false);
     if (settings_.activate_debug_log)
     {
@@ -59,16 +68,25 @@ rosaic_node::ROSaicNode::ROSaicNode() :
     if (!getROSParams())
         return;
 
-    // Initializes Connection
-    IO_.initializeIO();
+    // Memory is locked before the I/O threads are started, such that their stacks
+    // are locked, too
+    if (settings_.realtime_lock_memory)
+        io_comm_rx::lockMemory(this, static_cast<std::size_t>(
+                                         settings_.realtime_prefault_heap_mb) *
+                                         1024 * 1024);
 
     // Subscribes to all requested Rx messages by adding entries to the C++ multimap
-    // storing the callback handlers and publishes ROS messages
+    // storing the callback handlers and publishes ROS messages. This comes first,
+    // such that no message of a file is missed.
     IO_.defineMessages();
 
+    // Initializes Connection
+    IO_.initializeIO();
+
     // Sends commands to the Rx regarding which SBF/NMEA messages it should output
     // and sets all its necessary corrections-related parameters
-    if (!settings_.read_from_sbf_log && !settings_.read_from_pcap)
+    if (!settings_.read_from_sbf_log && !settings_.read_from_pcap &&
+        !settings_.receive_only)
     {
         IO_.configureRx();
     }
@@ -76,6 +94,11 @@ rosaic_node::ROSaicNode::ROSaicNode() :
     this->log(LogLevel::DEBUG, "Leaving ROSaicNode() constructor..");
 }
 
+void rosaic_node::ROSaicNode::waitForFileReading()
+{
+    IO_.waitForFileReading();
+}
+
 bool rosaic_node::ROSaicNode::getROSParams()
 {
     param("use_gnss_time", settings_.use_gnss_time, true);
@@ -93,8 +116,47 @@ bool rosaic_node::ROSaicNode::getROSParams()
     param("device", settings_.device, std::string("/dev/ttyACM0"));
     getUint32Param("serial/baudrate", settings_.baudrate, static_cast<uint32_t>(921600));
     param("serial/hw_flow_control", settings_.hw_flow_control, std::string("off"));
+    param("serial/autobaud", settings_.autobaud, true);
     param("serial/rx_serial_port", settings_.rx_serial_port, std::string("USB1"));
-    settings_.reconnect_delay_s = 2.0f; // Removed from ROS parameter list.
+    param("reconnect/initial_delay_s", settings_.reconnect_delay_s, 0.5f);
+    param("reconnect/max_delay_s", settings_.reconnect_max_delay_s, 30.0f);
+    param("reconnect/data_timeout_s", settings_.reconnect_data_timeout_s, 0.0f);
+    param("low_latency/enabled", settings_.low_latency, false);
+    getUint32Param("low_latency/busy_poll_us", settings_.low_latency_busy_poll_us,
+                   static_cast<uint32_t>(0));
+    io_comm_rx::getThreadSettings(this, "io", settings_.realtime_io);
+    io_comm_rx::getThreadSettings(this, "parsing", settings_.realtime_parsing);
+    param("realtime/lock_memory", settings_.realtime_lock_memory, false);
+    getUint32Param("realtime/prefault_heap_mb", settings_.realtime_prefault_heap_mb,
+                   static_cast<uint32_t>(16));
+    getUint32Param("file_reading/decode_threads", settings_.decode_threads,
+                   static_cast<uint32_t>(1));
+    param("file_reading/realtime", settings_.file_reading_realtime, true);
+    param("raw_recording/path", settings_.raw_recording_path, std::string(""));
+    getUint32Param("raw_recording/max_file_size_mb",
+                   settings_.raw_recording_max_file_size_mb,
+                   static_cast<uint32_t>(1024));
+    getUint32Param("raw_recording/rotation_period_s",
+                   settings_.raw_recording_rotation_period_s,
+                   static_cast<uint32_t>(3600));
+    param("raw_recording/compress", settings_.raw_recording_compress, false);
+    getUint32Param("raw_recording/buffer_size_mb",
+                   settings_.raw_recording_buffer_size_mb, static_cast<uint32_t>(16));
+    getUint32Param("black_box/size_mb", settings_.black_box_size_mb,
+                   static_cast<uint32_t>(0));
+    param("black_box/path", settings_.black_box_path, std::string("black_box"));
+    // Rxs sharing the top-level paths would write to the same files otherwise
+    if (!receiverName().empty())
+    {
+        if (!settings_.raw_recording_path.empty())
+            settings_.raw_recording_path += "_" + receiverName();
+        settings_.black_box_path += "_" + receiverName();
+    }
+    param("rinex/path", settings_.rinex_path, std::string(""));
+    // Each Rx writes files of its own station
+    param("rinex/marker_name", settings_.rinex_marker_name,
+          receiverName().empty() ? std::string("SEPT") : receiverName());
+    param("trace/path", settings_.trace_path, std::string("trace"));
     param("receiver_type", settings_.septentrio_receiver_type, std::string("gnss"));
     if (!((settings_.septentrio_receiver_type == "gnss") || (settings_.septentrio_receiver_type == "ins")))
     {
@@ -139,6 +201,42 @@ bool rosaic_node::ROSaicNode::getROSParams()
     param("publish/gpsfix", settings_.publish_gpsfix, false);
     param("publish/pose", settings_.publish_pose, false);
     param("publish/diagnostics", settings_.publish_diagnostics, false);
+    param("publish/latency_diagnostics", settings_.publish_latency_diagnostics, false);
+    getUint32Param("latency_diagnostics/period", settings_.latency_diagnostics_period,
+                   static_cast<uint32_t>(10));
+    if (settings_.latency_diagnostics_period == 0)
+    {
+        this->log(LogLevel::ERROR, "latency_diagnostics/period must be at least 1 s, using 1 s.");
+        settings_.latency_diagnostics_period = 1;
+    }
+    param("publish/message_counters", settings_.publish_message_counters, false);
+    getUint32Param("message_counters/period", settings_.message_counters_period,
+                   static_cast<uint32_t>(10));
+    if (settings_.message_counters_period == 0)
+    {
+        this->log(LogLevel::ERROR, "message_counters/period must be at least 1 s, using 1 s.");
+        settings_.message_counters_period = 1;
+    }
+    getUint32Param("prometheus/port", settings_.prometheus_port,
+                   static_cast<uint32_t>(0));
+    if (settings_.prometheus_port > 65535)
+    {
+        this->log(LogLevel::ERROR, "prometheus/port must be at most 65535, disabling the exporter.");
+        settings_.prometheus_port = 0;
+    }
+    param("prometheus/address", settings_.prometheus_address,
+          static_cast<std::string>("127.0.0.1"));
+    param("publish/raw_sbf", settings_.publish_raw_sbf, false);
+    param("raw_sbf_block_ids", settings_.raw_sbf_block_ids, std::vector<int32_t>());
+    param("publish/clockestimate", settings_.publish_clockestimate, false);
+    param("clock_estimate/window", settings_.clock_estimate_window, 30.0);
+    param("clock_estimate/correct_stamps", settings_.clock_estimate_correct_stamps, false);
+    param("ntp_shm/unit", settings_.ntp_shm_unit, static_cast<int32_t>(-1));
+    if (settings_.clock_estimate_window < 2.0)
+    {
+        this->log(LogLevel::ERROR, "clock_estimate/window must be at least 2 s, using 2 s.");
+        settings_.clock_estimate_window = 2.0;
+    }
     param("publish/gpgga", settings_.publish_gpgga, false);
     param("publish/gprmc", settings_.publish_gprmc, false);
     param("publish/gpgsa", settings_.publish_gpgsa, false);
@@ -389,4 +487,53 @@ void rosaic_node::ROSaicNode::getRPY(const QuaternionMsg& qm, double& roll, doub
 	roll  = std::atan2(C(2, 1), C(2, 2));
 	pitch = std::asin(-C(2, 0));
 	yaw   = std::atan2(C(1, 0), C(0, 0));
-}
\ No newline at end of file
+}
+
+rosaic_node::ROSaicMultiNode::ROSaicMultiNode(const std::vector<std::string>& receivers) :
+    io_service_(new boost::asio::io_service),
+    work_(new boost::asio::io_service::work(*io_service_)),
+    nodes_(receivers.size())
+{
+    uint32_t io_threads;
+    getUint32Param("io_threads", io_threads, static_cast<uint32_t>(2));
+    if (io_threads == 0)
+        io_threads = 1;
+    this->log(LogLevel::INFO, "Handling " + std::to_string(receivers.size()) +
+                                  " Rxs with " + std::to_string(io_threads) +
+                                  " I/O threads.");
+    // The I/O threads are shared by all Rxs, hence their scheduling is only taken
+    // from the top level realtime/io parameters
+    io_comm_rx::ThreadSettings io_thread_settings;
+    io_comm_rx::getThreadSettings(this, "io", io_thread_settings);
+    for (uint32_t i = 0; i < io_threads; ++i)
+    {
+        boost::thread* thread = io_threads_.create_thread(
+            boost::bind(&boost::asio::io_service::run, io_service_.get()));
+        if (!io_thread_settings.isDefault())
+            io_comm_rx::configureThread(this, thread->native_handle(),
+                                        "I/O " + std::to_string(i),
+                                        io_thread_settings);
+    }
+
+    for (std::size_t i = 0; i < receivers.size(); ++i)
+    {
+        std::unique_ptr<ROSaicNode>* node = &nodes_[i];
+        std::string receiver_name = receivers[i];
+        startup_threads_.create_thread([this, node, receiver_name]() {
+            node->reset(new ROSaicNode(receiver_name, io_service_));
+        });
+    }
+}
+
+rosaic_node::ROSaicMultiNode::~ROSaicMultiNode()
+{
+    // Rxs that never connected are still waiting in their constructors
+    startup_threads_.interrupt_all();
+    startup_threads_.join_all();
+    // Stop the I/O before destroying the nodes, such that no handler of theirs
+    // is running anymore
+    work_.reset();
+    io_service_->stop();
+    io_threads_.join_all();
+    nodes_.clear();
+}
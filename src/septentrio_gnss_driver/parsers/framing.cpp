@@ -0,0 +1,94 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/crc/crc.h>
+#include <septentrio_gnss_driver/parsers/framing.hpp>
+#include <septentrio_gnss_driver/parsers/parsing_utilities.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @file framing.cpp
+ * @date 19/10/26
+ * @brief Defines functions that find SBF blocks and NMEA sentences in raw data
+ */
+
+namespace framing {
+
+    bool isValidNMEA(const uint8_t* sentence, std::size_t length)
+    {
+        // $<body>*hh<CR><LF>
+        if (length < 7 || sentence[length - 2] != CARRIAGE_RETURN ||
+            sentence[length - 5] != '*')
+            return false;
+        return parsing_utilities::checkNMEAChecksum(sentence, length - 2);
+    }
+
+    std::size_t findFrame(const uint8_t* data, std::size_t size, std::size_t pos,
+                          std::size_t end, std::size_t& length)
+    {
+        while (pos < end)
+        {
+            const uint8_t* sync = static_cast<const uint8_t*>(
+                memchr(data + pos, SBF_SYNC_BYTE_1, end - pos));
+            if (!sync)
+                return end;
+            pos = sync - data;
+            if (pos + 1 < size)
+            {
+                uint8_t id = data[pos + 1];
+                if (id == SBF_SYNC_BYTE_2 && pos + 8 <= size)
+                {
+                    // SBF block lengths are multiples of 4 bytes
+                    uint16_t block_length = parsing_utilities::getLength(data + pos);
+                    if (block_length >= 8 && block_length % 4 == 0 &&
+                        pos + block_length <= size && isValid(data + pos))
+                    {
+                        length = block_length;
+                        return pos;
+                    }
+                } else if (id == NMEA_SYNC_BYTE_2_1 || id == NMEA_SYNC_BYTE_2_2)
+                {
+                    const uint8_t* lf = static_cast<const uint8_t*>(
+                        memchr(data + pos, LINE_FEED,
+                               std::min(MAX_NMEA_LENGTH, size - pos)));
+                    if (lf && isValidNMEA(data + pos, lf - (data + pos) + 1))
+                    {
+                        length = lf - (data + pos) + 1;
+                        return pos;
+                    }
+                }
+            }
+            ++pos;
+        }
+        return end;
+    }
+} // namespace framing
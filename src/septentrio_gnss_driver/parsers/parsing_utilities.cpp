@@ -32,6 +32,7 @@
 #include <septentrio_gnss_driver/parsers/parsing_utilities.hpp>
 #include <septentrio_gnss_driver/parsers/string_utilities.h>
 // C++ library includes
+#include <cstdlib>
 #include <limits>
 // Boost
 #include <boost/spirit/include/qi_binary.hpp>
@@ -365,4 +366,20 @@ namespace parsing_utilities {
     {
         return parseUInt16(buffer + 12);
     }
+
+    bool checkNMEAChecksum(const uint8_t* sentence, std::size_t size)
+    {
+        // $<body>*hh, the checksum being the XOR of all body characters. The Rx
+        // always sends it, hence a sentence without is corrupt.
+        if (size < 4 || sentence[size - 3] != '*')
+            return false;
+        uint8_t checksum = 0;
+        for (std::size_t i = 1; i < size - 3; ++i)
+            checksum ^= sentence[i];
+        char hex[3] = {static_cast<char>(sentence[size - 2]),
+                       static_cast<char>(sentence[size - 1]), '\0'};
+        char* hex_end;
+        unsigned long expected = std::strtoul(hex, &hex_end, 16);
+        return (hex_end == hex + 2) && (expected == checksum);
+    }
 } // namespace parsing_utilities
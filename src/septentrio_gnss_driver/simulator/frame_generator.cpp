@@ -0,0 +1,577 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/simulator/frame_generator.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+// ROSaic includes
+#include <septentrio_gnss_driver/crc/crc.h>
+
+/**
+ * @file frame_generator.cpp
+ * @date 19/10/26
+ * @brief Implements the generator of synthetic SBF blocks and NMEA sentences
+ *
+ * The layouts are those of benchmark/corpus/generate_corpus.py.
+ */
+
+namespace rx_simulator {
+
+    namespace {
+        const double PI = 3.14159265358979323846;
+        const double DEG2RAD = PI / 180.0;
+        //! Center of the trajectory
+        const double LATITUDE = 50.8503 * DEG2RAD;
+        const double LONGITUDE = 4.3517 * DEG2RAD;
+        const double HEIGHT = 112.3;
+        const double UNDULATION = 47.0;
+        //! [m]
+        const double RADIUS = 50.0;
+        //! [m/s]
+        const double SPEED = 5.0;
+        //! WGS84
+        const double SEMI_MAJOR_AXIS = 6378137.0;
+        const double ECCENTRICITY2 = 6.69437999014e-3;
+        //! Seconds from 1970-01-01 to 1980-01-06 and GPS-UTC leap seconds
+        const int64_t GPS_EPOCH_UNIX = 315964800;
+        const int64_t LEAP_SECONDS = 18;
+        const uint64_t NS_PER_WEEK = 604800ULL * 1000000000ULL;
+        //! Maximum number of MeasEpoch type-1 sub-blocks the parser accepts
+        const uint32_t MAX_SATELLITES = 81;
+        const uint32_t MAX_SIGNALS_PER_SATELLITE = 3;
+
+        //! Appends the little-endian representation of value, SBF being
+        //! little-endian as are the hosts the simulator runs on
+        template <typename T>
+        void put(std::string& s, T value)
+        {
+            char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            s.append(bytes, sizeof(T));
+        }
+
+        void put3f(std::string& s, float a, float b, float c)
+        {
+            put(s, a);
+            put(s, b);
+            put(s, c);
+        }
+
+        void pad(std::string& s, size_t n) { s.append(n, '\0'); }
+
+        //! Appends a text field of the size given, padded with '\0'
+        void text(std::string& s, const std::string& value, size_t size)
+        {
+            s.append(value.substr(0, size));
+            pad(s, size - std::min(size, value.size()));
+        }
+
+        //! SVID of the i-th satellite: GPS, GLONASS, then Galileo
+        uint8_t svid(uint32_t i)
+        {
+            if (i < 32)
+                return static_cast<uint8_t>(1 + i);
+            if (i < 56)
+                return static_cast<uint8_t>(38 + i - 32);
+            return static_cast<uint8_t>(71 + i - 56);
+        }
+
+        //! Signal type of the k-th signal of the i-th satellite
+        uint8_t signalType(uint32_t i, uint32_t k)
+        {
+            static const uint8_t GPS[] = {0, 3, 4};       // L1CA, L2C, L5
+            static const uint8_t GLONASS[] = {8, 11, 9};  // L1CA, L2CA, L1P
+            static const uint8_t GALILEO[] = {17, 20, 21}; // E1, E5a, E5b
+            if (i < 32)
+                return GPS[k];
+            if (i < 56)
+                return GLONASS[k];
+            return GALILEO[k];
+        }
+
+        //! PVTGeodetic and PVTCartesian fields following the velocity
+        void pvtTail(std::string& p, double heading, uint8_t nr_sv)
+        {
+            put(p, static_cast<float>(heading)); // COG
+            put(p, 0.123);                        // RxClkBias
+            put(p, 0.01f);                        // RxClkDrift
+            put<uint8_t>(p, 0);                   // TimeSystem
+            put<uint8_t>(p, 0);                   // Datum
+            put<uint8_t>(p, nr_sv);
+            put<uint8_t>(p, 0);        // WACorrInfo
+            put<uint16_t>(p, 0);       // ReferenceID
+            put<uint16_t>(p, 100);     // MeanCorrAge
+            put<uint32_t>(p, 0x0F5F);  // SignalInfo
+            put<uint8_t>(p, 0);        // AlertFlag
+            put<uint8_t>(p, 1);        // NrBases
+            put<uint16_t>(p, 0);       // PPPInfo
+            put<uint16_t>(p, 20);      // Latency
+            put<uint16_t>(p, 2);       // HAccuracy
+            put<uint16_t>(p, 3);       // VAccuracy
+            put<uint8_t>(p, 0);        // Misc
+        }
+
+        //! Standard deviations, attitude and velocity sub-blocks of INSNav
+        void insSubBlocks(std::string& p, double heading, float v0, float v1,
+                          float v2)
+        {
+            put3f(p, 0.02f, 0.02f, 0.04f);
+            put3f(p, static_cast<float>(heading), 1.5f, -0.8f);
+            put3f(p, 0.1f, 0.05f, 0.05f);
+            put3f(p, v0, v1, v2);
+            put3f(p, 0.01f, 0.01f, 0.02f);
+            put3f(p, 1e-4f, 2e-4f, 3e-4f);
+        }
+
+        //! Covariance blocks have the same layout
+        std::string covariance()
+        {
+            std::string p;
+            put<uint8_t>(p, 4);
+            put<uint8_t>(p, 0);
+            const float cov[] = {4e-4f, 4e-4f, 16e-4f, 1e-4f, 1e-5f,
+                                 2e-5f, 1e-6f, 3e-5f,  2e-6f, 3e-6f};
+            for (float c : cov)
+                put(p, c);
+            return p;
+        }
+
+        //! Latitude or longitude in NMEA format
+        std::string nmeaAngle(double rad, int degree_digits)
+        {
+            double deg = std::fabs(rad) / DEG2RAD;
+            int whole = static_cast<int>(deg);
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%0*d%010.7f", degree_digits, whole,
+                          (deg - whole) * 60.0);
+            return buf;
+        }
+    } // namespace
+
+    FrameGenerator::FrameGenerator(uint32_t meas_signals) :
+        meas_signals_(std::max<uint32_t>(
+            1, std::min(meas_signals, MAX_SATELLITES * MAX_SIGNALS_PER_SATELLITE)))
+    {
+    }
+
+    std::vector<std::string> FrameGenerator::messages()
+    {
+        return {"PVTGeodetic",  "PVTCartesian",   "PosCovGeodetic",
+                "PosCovCartesian", "VelCovGeodetic", "VelCovCartesian",
+                "AttEuler",     "AttCovEuler",    "DOP",
+                "INSNavGeod",   "INSNavCart",     "ExtSensorMeas",
+                "MeasEpoch",    "ChannelStatus",  "ReceiverStatus",
+                "QualityInd",   "ReceiverSetup",  "IMUSetup",
+                "VelSensorSetup", "GPGGA",        "GPRMC",
+                "GPGSA",        "GPGSV"};
+    }
+
+    FrameGenerator::State FrameGenerator::state(uint64_t gps_time) const
+    {
+        State s;
+        s.wnc = static_cast<uint16_t>(gps_time / NS_PER_WEEK);
+        uint64_t in_week = gps_time % NS_PER_WEEK;
+        s.tow = static_cast<uint32_t>(in_week / 1000000ULL);
+        s.t = static_cast<double>(in_week) * 1e-9;
+
+        double omega = SPEED / RADIUS;
+        double angle = omega * s.t;
+        double north = RADIUS * std::cos(angle);
+        double east = RADIUS * std::sin(angle);
+        double n = SEMI_MAJOR_AXIS /
+                   std::sqrt(1.0 - ECCENTRICITY2 * std::sin(LATITUDE) *
+                                       std::sin(LATITUDE));
+        s.latitude = LATITUDE + north / n;
+        s.longitude = LONGITUDE + east / (n * std::cos(LATITUDE));
+        s.height = HEIGHT;
+        s.vn = -SPEED * std::sin(angle);
+        s.ve = SPEED * std::cos(angle);
+        s.heading = std::atan2(s.ve, s.vn) / DEG2RAD;
+        if (s.heading < 0.0)
+            s.heading += 360.0;
+        return s;
+    }
+
+    void FrameGenerator::appendBlock(uint16_t id, uint8_t revision, const State& s,
+                                     const std::string& payload, std::string& out)
+    {
+        std::string block("$@\0\0", 4);
+        put<uint16_t>(block, static_cast<uint16_t>(id | (revision << 13)));
+        size_t length = 14 + payload.size();
+        length += (4 - length % 4) % 4;
+        put<uint16_t>(block, static_cast<uint16_t>(length));
+        put<uint32_t>(block, s.tow);
+        put<uint16_t>(block, s.wnc);
+        block.append(payload);
+        pad(block, length - block.size());
+        uint16_t crc = compute16CCITT(
+            reinterpret_cast<const uint8_t*>(block.data()) + 4, length - 4);
+        std::memcpy(&block[2], &crc, sizeof(crc));
+        out.append(block);
+    }
+
+    void FrameGenerator::appendSentence(const std::string& body, std::string& out)
+    {
+        uint8_t checksum = 0;
+        for (char c : body)
+            checksum ^= static_cast<uint8_t>(c);
+        char tail[8];
+        std::snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+        out.append("$").append(body).append(tail);
+    }
+
+    bool FrameGenerator::generate(const std::string& name, uint64_t gps_time,
+                                  std::string& out) const
+    {
+        const State s = state(gps_time);
+        const uint32_t nr_sat =
+            (meas_signals_ + MAX_SIGNALS_PER_SATELLITE - 1) / MAX_SIGNALS_PER_SATELLITE;
+        const uint8_t nr_sv = static_cast<uint8_t>(std::min<uint32_t>(nr_sat, 255));
+
+        // ECEF position and velocity, the vertical velocity being 0
+        double n = SEMI_MAJOR_AXIS /
+                   std::sqrt(1.0 - ECCENTRICITY2 * std::sin(s.latitude) *
+                                       std::sin(s.latitude));
+        double x = (n + s.height) * std::cos(s.latitude) * std::cos(s.longitude);
+        double y = (n + s.height) * std::cos(s.latitude) * std::sin(s.longitude);
+        double z = (n * (1.0 - ECCENTRICITY2) + s.height) * std::sin(s.latitude);
+        float vx = static_cast<float>(-std::sin(s.longitude) * s.ve -
+                                      std::sin(s.latitude) * std::cos(s.longitude) * s.vn);
+        float vy = static_cast<float>(std::cos(s.longitude) * s.ve -
+                                      std::sin(s.latitude) * std::sin(s.longitude) * s.vn);
+        float vz = static_cast<float>(std::cos(s.latitude) * s.vn);
+
+        std::string p;
+        if (name == "PVTGeodetic" || name == "PVTCartesian")
+        {
+            put<uint8_t>(p, 4); // Mode: RTK fixed
+            put<uint8_t>(p, 0);
+            if (name == "PVTGeodetic")
+            {
+                put(p, s.latitude);
+                put(p, s.longitude);
+                put(p, s.height);
+                put(p, static_cast<float>(UNDULATION));
+                put3f(p, static_cast<float>(s.vn), static_cast<float>(s.ve), 0.0f);
+            } else
+            {
+                put(p, x);
+                put(p, y);
+                put(p, z);
+                put(p, static_cast<float>(UNDULATION));
+                put3f(p, vx, vy, vz);
+            }
+            pvtTail(p, s.heading, nr_sv);
+            appendBlock(name == "PVTGeodetic" ? 4007 : 4006, 2, s, p, out);
+        } else if (name == "PosCovGeodetic")
+            appendBlock(5906, 0, s, covariance(), out);
+        else if (name == "PosCovCartesian")
+            appendBlock(5905, 0, s, covariance(), out);
+        else if (name == "VelCovGeodetic")
+            appendBlock(5908, 0, s, covariance(), out);
+        else if (name == "VelCovCartesian")
+            appendBlock(5907, 0, s, covariance(), out);
+        else if (name == "AttEuler")
+        {
+            put<uint8_t>(p, nr_sv);
+            put<uint8_t>(p, 0);
+            put<uint16_t>(p, 4);
+            pad(p, 2);
+            put3f(p, static_cast<float>(s.heading), 1.5f, -0.8f);
+            put3f(p, 0.01f, -0.02f, static_cast<float>(SPEED / RADIUS / DEG2RAD));
+            appendBlock(5938, 0, s, p, out);
+        } else if (name == "AttCovEuler")
+        {
+            pad(p, 1);
+            put<uint8_t>(p, 0);
+            put3f(p, 0.01f, 0.0025f, 0.0025f);
+            put3f(p, 1e-4f, 2e-4f, 3e-4f);
+            appendBlock(5939, 0, s, p, out);
+        } else if (name == "DOP")
+        {
+            put<uint8_t>(p, nr_sv);
+            pad(p, 1);
+            put<uint16_t>(p, 120);
+            put<uint16_t>(p, 80);
+            put<uint16_t>(p, 60);
+            put<uint16_t>(p, 100);
+            put(p, 1.2f);
+            put(p, 1.8f);
+            appendBlock(4001, 0, s, p, out);
+        } else if (name == "INSNavGeod" || name == "INSNavCart")
+        {
+            put<uint8_t>(p, 4); // GNSSMode
+            put<uint8_t>(p, 0);
+            put<uint16_t>(p, 0x0D);
+            put<uint16_t>(p, 10); // GNSSAge
+            if (name == "INSNavGeod")
+            {
+                put(p, s.latitude);
+                put(p, s.longitude);
+                put(p, s.height);
+                put(p, static_cast<float>(UNDULATION));
+            } else
+            {
+                put(p, x);
+                put(p, y);
+                put(p, z);
+            }
+            put<uint16_t>(p, 3);  // Accuracy
+            put<uint16_t>(p, 12); // Latency
+            put<uint8_t>(p, 0);   // Datum
+            pad(p, 1);
+            put<uint16_t>(p, 0x3F); // SBList
+            if (name == "INSNavGeod")
+            {
+                insSubBlocks(p, s.heading, static_cast<float>(s.ve),
+                             static_cast<float>(s.vn), 0.0f);
+                appendBlock(4226, 0, s, p, out);
+            } else
+            {
+                insSubBlocks(p, s.heading, vx, vy, vz);
+                appendBlock(4225, 0, s, p, out);
+            }
+        } else if (name == "ExtSensorMeas")
+        {
+            put<uint8_t>(p, 3);
+            put<uint8_t>(p, 28);
+            // Acceleration, the centripetal one along y
+            put<uint32_t>(p, 0x00000000);
+            put(p, 0.012);
+            put(p, SPEED * SPEED / RADIUS);
+            put(p, 9.806);
+            // Angular rate [deg/s]
+            put<uint32_t>(p, 0x00010000);
+            put(p, 0.1);
+            put(p, -0.2);
+            put(p, SPEED / RADIUS / DEG2RAD);
+            // Temperature [0.01 deg C]
+            put<uint32_t>(p, 0x00030000);
+            put<int16_t>(p, 3512);
+            pad(p, 22);
+            appendBlock(4050, 0, s, p, out);
+        } else if (name == "MeasEpoch")
+        {
+            put<uint8_t>(p, static_cast<uint8_t>(nr_sat));
+            put<uint8_t>(p, 20); // SB1Length
+            put<uint8_t>(p, 12); // SB2Length
+            put<uint8_t>(p, 0);
+            put<uint8_t>(p, 0);
+            pad(p, 1);
+            uint32_t k = static_cast<uint32_t>(s.tow);
+            for (uint32_t ch = 0; ch < nr_sat; ++ch)
+            {
+                // Signals spread over the satellites as evenly as possible
+                uint32_t signals = meas_signals_ / nr_sat +
+                                   (ch < meas_signals_ % nr_sat ? 1 : 0);
+                put<uint8_t>(p, static_cast<uint8_t>(ch));
+                put<uint8_t>(p, signalType(ch, 0));
+                put<uint8_t>(p, svid(ch));
+                put<uint8_t>(p, 0);
+                put<uint32_t>(p, 20000000 + 1000 * ch + k);
+                put<int32_t>(p, -1500 + 37 * static_cast<int32_t>(ch));
+                put<uint16_t>(p, static_cast<uint16_t>(5000 * ch + k));
+                put<int8_t>(p, static_cast<int8_t>(ch % 8) - 4);
+                put<uint8_t>(p, static_cast<uint8_t>(180 + ch % 40));
+                put<uint16_t>(p, static_cast<uint16_t>(600 + ch));
+                put<uint8_t>(p, 0x1D);
+                put<uint8_t>(p, static_cast<uint8_t>(signals - 1));
+                for (uint32_t sig = 1; sig < signals; ++sig)
+                {
+                    put<uint8_t>(p, signalType(ch, sig));
+                    put<uint8_t>(p, 60);
+                    put<uint8_t>(p, static_cast<uint8_t>(170 + ch % 40));
+                    put<uint8_t>(p, 0x11);
+                    put<int8_t>(p, -1);
+                    put<uint8_t>(p, 0x1D);
+                    put<uint16_t>(p, static_cast<uint16_t>(120 + ch));
+                    put<uint16_t>(p, static_cast<uint16_t>(3000 + ch * 7));
+                    put<uint16_t>(p, static_cast<uint16_t>(300 + sig));
+                }
+            }
+            appendBlock(4027, 1, s, p, out);
+        } else if (name == "ChannelStatus")
+        {
+            put<uint8_t>(p, static_cast<uint8_t>(nr_sat));
+            put<uint8_t>(p, 12);
+            put<uint8_t>(p, 8);
+            pad(p, 3);
+            for (uint32_t sat = 0; sat < nr_sat; ++sat)
+            {
+                put<uint8_t>(p, svid(sat));
+                put<uint8_t>(p, 0);
+                pad(p, 2);
+                put<uint16_t>(p, static_cast<uint16_t>(0x3000 + (11 * sat) % 360));
+                put<uint16_t>(p, 0);
+                put<int8_t>(p, static_cast<int8_t>(10 + (2 * sat) % 80));
+                put<uint8_t>(p, 1);
+                put<uint8_t>(p, static_cast<uint8_t>(sat));
+                pad(p, 1);
+                put<uint8_t>(p, 0);
+                pad(p, 1);
+                put<uint16_t>(p, 0x3333);
+                put<uint16_t>(p, 0);
+                put<uint16_t>(p, 0);
+            }
+            appendBlock(4013, 0, s, p, out);
+        } else if (name == "ReceiverStatus")
+        {
+            put<uint8_t>(p, 35);
+            put<uint8_t>(p, 0);
+            put<uint32_t>(p, s.tow / 1000);
+            put<uint32_t>(p, 0x00000101);
+            put<uint32_t>(p, 0);
+            put<uint8_t>(p, 3);
+            put<uint8_t>(p, 4);
+            put<uint8_t>(p, 0);
+            put<uint8_t>(p, 145);
+            for (uint8_t i = 0; i < 3; ++i)
+            {
+                put<uint8_t>(p, i);
+                put<int8_t>(p, 40);
+                put<uint8_t>(p, 50);
+                put<uint8_t>(p, 0);
+            }
+            appendBlock(4014, 0, s, p, out);
+        } else if (name == "QualityInd")
+        {
+            put<uint8_t>(p, 4);
+            pad(p, 1);
+            put<uint16_t>(p, 0x0A01);
+            put<uint16_t>(p, 0x0A02);
+            put<uint16_t>(p, 0x0911);
+            put<uint16_t>(p, 0x0A15);
+            appendBlock(4082, 0, s, p, out);
+        } else if (name == "ReceiverSetup")
+        {
+            pad(p, 2);
+            text(p, "ROVER", 60);
+            text(p, "0001", 20);
+            text(p, "ROSaic", 20);
+            text(p, "Septentrio", 40);
+            text(p, "3234567", 20);
+            text(p, "AsteRx SBi3", 20);
+            text(p, "1.4.0", 20);
+            text(p, "12345", 20);
+            text(p, "PolaNt-x MF", 20);
+            put3f(p, 0.1f, 0.0f, 0.0f);
+            text(p, "GEODETIC", 20);
+            text(p, "4.12.1", 40);
+            text(p, "AsteRx SBi3 Pro+", 40);
+            put(p, LATITUDE);
+            put(p, LONGITUDE);
+            put(p, static_cast<float>(HEIGHT));
+            text(p, "ROVR", 10);
+            put<uint8_t>(p, 0);
+            put<uint8_t>(p, 0);
+            text(p, "BEL", 3);
+            appendBlock(5902, 4, s, p, out);
+        } else if (name == "IMUSetup")
+        {
+            pad(p, 1);
+            put<uint8_t>(p, 1);
+            put3f(p, 0.5f, 0.1f, -0.3f);
+            put3f(p, 0.0f, 0.0f, 90.0f);
+            appendBlock(4224, 0, s, p, out);
+        } else if (name == "VelSensorSetup")
+        {
+            pad(p, 1);
+            put<uint8_t>(p, 2);
+            put3f(p, -0.4f, 0.0f, 0.2f);
+            appendBlock(4244, 0, s, p, out);
+        } else if (name.size() == 5 && name.compare(0, 2, "GP") == 0)
+        {
+            // UTC of the epoch
+            std::time_t unix_time = static_cast<std::time_t>(
+                static_cast<int64_t>(gps_time / 1000000000ULL) + GPS_EPOCH_UNIX -
+                LEAP_SECONDS);
+            std::tm utc;
+            gmtime_r(&unix_time, &utc);
+            char hhmmss[16];
+            std::snprintf(hhmmss, sizeof(hhmmss), "%02d%02d%05.2f", utc.tm_hour,
+                          utc.tm_min,
+                          utc.tm_sec + static_cast<double>(gps_time % 1000000000ULL) * 1e-9);
+            std::string lat = nmeaAngle(s.latitude, 2) + ",N,";
+            std::string lon = nmeaAngle(s.longitude, 3) + ",E,";
+            char body[160];
+            if (name == "GPGGA")
+            {
+                std::snprintf(body, sizeof(body),
+                              "GPGGA,%s,%s%s4,%02u,0.6,%.3f,M,%.3f,M,1.0,0000",
+                              hhmmss, lat.c_str(), lon.c_str(),
+                              static_cast<unsigned>(std::min<uint32_t>(nr_sat, 99)),
+                              HEIGHT, UNDULATION);
+                appendSentence(body, out);
+            } else if (name == "GPRMC")
+            {
+                std::snprintf(body, sizeof(body),
+                              "GPRMC,%s,A,%s%s%.1f,%.1f,%02d%02d%02d,0.0,E,R",
+                              hhmmss, lat.c_str(), lon.c_str(), SPEED * 1.943844,
+                              s.heading, utc.tm_mday, utc.tm_mon + 1,
+                              utc.tm_year % 100);
+                appendSentence(body, out);
+            } else if (name == "GPGSA")
+            {
+                appendSentence("GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.2,0.6,1.0",
+                               out);
+            } else if (name == "GPGSV")
+            {
+                // The GPS satellites in view, 4 per sentence
+                uint32_t in_view = std::min<uint32_t>(nr_sat, 32);
+                uint32_t sentences = std::max<uint32_t>((in_view + 3) / 4, 1);
+                for (uint32_t msg = 0; msg < sentences; ++msg)
+                {
+                    std::string gsv = "GPGSV," + std::to_string(sentences) + "," +
+                                      std::to_string(msg + 1) + "," +
+                                      std::to_string(in_view);
+                    for (uint32_t sat = 4 * msg; sat < std::min(4 * msg + 4, in_view);
+                         ++sat)
+                    {
+                        char fields[32];
+                        std::snprintf(fields, sizeof(fields), ",%02u,%02u,%03u,%02u",
+                                      static_cast<unsigned>(svid(sat)),
+                                      static_cast<unsigned>(10 + (7 * sat) % 80),
+                                      static_cast<unsigned>((40 * sat) % 360),
+                                      static_cast<unsigned>(38 + sat % 10));
+                        gsv += fields;
+                    }
+                    appendSentence(gsv, out);
+                }
+            } else
+                return false;
+        } else
+            return false;
+        return true;
+    }
+} // namespace rx_simulator
@@ -0,0 +1,534 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/simulator/rx_simulator.hpp>
+// C++ library includes
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+// POSIX includes
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * @file rx_simulator.cpp
+ * @date 19/10/26
+ * @brief Implements the simulator of a Septentrio Rx
+ */
+
+namespace rx_simulator {
+
+    namespace {
+        //! Seconds from 1970-01-01 to 1980-01-06 and GPS-UTC leap seconds
+        const int64_t GPS_EPOCH_UNIX = 315964800;
+        const int64_t LEAP_SECONDS = 18;
+        //! Period of the polls of the threads for stopping [ms]
+        const int POLL_PERIOD_MS = 100;
+        //! Pauses longer than this in a recorded file are skipped [ms]
+        const uint32_t MAX_REPLAY_PAUSE_MS = 60000;
+        //! Longest NMEA sentence searched for in a recorded file
+        const size_t MAX_NMEA_SIZE = 128;
+        //! Shortest SBF block, i.e. header and time stamp
+        const size_t MIN_SBF_SIZE = 14;
+
+        //! Nanoseconds since the start of GPS time
+        uint64_t gpsTime()
+        {
+            int64_t unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count();
+            return static_cast<uint64_t>(unix_ns -
+                                         (GPS_EPOCH_UNIX - LEAP_SECONDS) * 1000000000LL);
+        }
+
+        int64_t steadySeconds()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        //! Size of the SBF block or NMEA sentence at data, 0 if none
+        size_t frameSize(const uint8_t* data, size_t available)
+        {
+            if (available < 8 || data[0] != '$')
+                return 0;
+            if (data[1] == '@')
+            {
+                // The time stamp is read from every block, e.g. a stray "$@" must
+                // not claim to end before it
+                uint16_t length = static_cast<uint16_t>(data[6] | (data[7] << 8));
+                if (length < MIN_SBF_SIZE || length % 4 != 0 || length > available)
+                    return 0;
+                return length;
+            }
+            for (size_t i = 1; i + 1 < std::min(available, MAX_NMEA_SIZE); ++i)
+            {
+                if (data[i] == '\r' && data[i + 1] == '\n')
+                    return i + 2;
+            }
+            return 0;
+        }
+    } // namespace
+
+    RxSimulator::RxSimulator(const SimulatorSettings& settings) :
+        settings_(settings), generator_(settings.meas_signals),
+        random_(settings.seed)
+    {
+    }
+
+    RxSimulator::~RxSimulator()
+    {
+        stopping_ = true;
+        if (acceptor_.joinable())
+            acceptor_.join();
+        for (const auto& connection : connections_)
+        {
+            if (connection->reader.joinable())
+                connection->reader.join();
+            if (connection->fd != pty_master_fd_)
+                ::close(connection->fd);
+        }
+        if (listen_fd_ >= 0)
+            ::close(listen_fd_);
+        if (pty_master_fd_ >= 0)
+            ::close(pty_master_fd_);
+        if (!settings_.pty_link.empty())
+            ::unlink(settings_.pty_link.c_str());
+    }
+
+    bool RxSimulator::open(std::string& error)
+    {
+        if (settings_.tcp_port != 0)
+        {
+            listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+            int reuse = 1;
+            ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            sockaddr_in address;
+            std::memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_ANY);
+            address.sin_port = htons(settings_.tcp_port);
+            if (listen_fd_ < 0 ||
+                ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+                       sizeof(address)) != 0 ||
+                ::listen(listen_fd_, 8) != 0)
+            {
+                error = "cannot listen on TCP port " +
+                        std::to_string(settings_.tcp_port) + ": " + std::strerror(errno);
+                return false;
+            }
+            acceptor_ = std::thread(&RxSimulator::acceptClients, this);
+        }
+        if (settings_.pty)
+        {
+            pty_master_fd_ = ::posix_openpt(O_RDWR | O_NOCTTY);
+            if (pty_master_fd_ < 0 || ::grantpt(pty_master_fd_) != 0 ||
+                ::unlockpt(pty_master_fd_) != 0)
+            {
+                error = std::string("cannot open a pseudo terminal: ") +
+                        std::strerror(errno);
+                return false;
+            }
+            pty_name_ = ::ptsname(pty_master_fd_);
+            int slave_fd = ::open(pty_name_.c_str(), O_RDWR | O_NOCTTY);
+            termios tio;
+            if (slave_fd < 0 || ::tcgetattr(slave_fd, &tio) != 0)
+            {
+                error = "cannot open " + pty_name_ + ": " + std::strerror(errno);
+                return false;
+            }
+            // No echo of the streamed messages nor line editing, as on a serial
+            // port of the Rx. The settings outlive the slave, which is closed
+            // such that the master sees whether a client has it open.
+            ::cfmakeraw(&tio);
+            ::tcsetattr(slave_fd, TCSANOW, &tio);
+            ::close(slave_fd);
+            ::fcntl(pty_master_fd_, F_SETFL,
+                    ::fcntl(pty_master_fd_, F_GETFL) | O_NONBLOCK);
+            if (!settings_.pty_link.empty())
+            {
+                ::unlink(settings_.pty_link.c_str());
+                if (::symlink(pty_name_.c_str(), settings_.pty_link.c_str()) != 0)
+                {
+                    error = "cannot link " + settings_.pty_link + ": " +
+                            std::strerror(errno);
+                    return false;
+                }
+            }
+            std::shared_ptr<Connection> connection = std::make_shared<Connection>();
+            connection->fd = pty_master_fd_;
+            connection->descriptor = "COM1";
+            connection->drop_on_block = true;
+            connection->reader = std::thread(&RxSimulator::serve, this, connection);
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            connections_.push_back(connection);
+        }
+        return true;
+    }
+
+    void RxSimulator::acceptClients()
+    {
+        while (!stopping_)
+        {
+            pollfd readable = {listen_fd_, POLLIN, 0};
+            if (::poll(&readable, 1, POLL_PERIOD_MS) <= 0)
+                continue;
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+            // A client that does not read for that long is dropped
+            timeval timeout = {2, 0};
+            ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            std::shared_ptr<Connection> connection = std::make_shared<Connection>();
+            connection->fd = fd;
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            connection->descriptor = "IP" + std::to_string(next_ip_descriptor_);
+            // IP10 to IP19, as many as the Rx offers
+            next_ip_descriptor_ = next_ip_descriptor_ == 19 ? 10 : next_ip_descriptor_ + 1;
+            std::fprintf(stderr, "Client connected on %s\n",
+                         connection->descriptor.c_str());
+            connection->reader = std::thread(&RxSimulator::serve, this, connection);
+            connections_.push_back(connection);
+        }
+    }
+
+    void RxSimulator::serve(std::shared_ptr<Connection> connection)
+    {
+        // The Rx greets TCP clients with the prompt
+        if (!connection->drop_on_block)
+            write(*connection, connection->descriptor + ">");
+        std::string line;
+        char buffer[1024];
+        char previous = 0;
+        while (!stopping_ && !connection->closed)
+        {
+            pollfd readable = {connection->fd, POLLIN, 0};
+            int ready = ::poll(&readable, 1, POLL_PERIOD_MS);
+            if (ready <= 0)
+                continue;
+            ssize_t n = ::read(connection->fd, buffer, sizeof(buffer));
+            if (n < 0 && (errno == EINTR || errno == EAGAIN))
+                continue;
+            if (n <= 0)
+            {
+                // The master of the pseudo terminal hangs up while no client has
+                // the slave open, it stays open for the next one
+                if (connection->drop_on_block)
+                {
+                    line.clear();
+                    std::this_thread::sleep_for(
+                        std::chrono::milliseconds(POLL_PERIOD_MS));
+                    continue;
+                }
+                connection->closed = true;
+                break;
+            }
+            for (ssize_t i = 0; i < n; ++i)
+            {
+                char c = buffer[i];
+                // Commands end with CR, or with LF when typed in a terminal
+                if (c == '\r' || (c == '\n' && previous != '\r'))
+                {
+                    write(*connection, answer(line, *connection));
+                    line.clear();
+                } else if (c != '\n')
+                    line.push_back(c);
+                previous = c;
+            }
+        }
+        connection->finished = true;
+    }
+
+    std::string RxSimulator::answer(const std::string& line,
+                                    const Connection& connection)
+    {
+        std::string prompt = connection.descriptor + ">";
+        // Empty lines and the escape sequence "SSSS..." only yield the prompt
+        if (line.find_first_not_of("S ") == std::string::npos)
+            return "\r\n" + prompt;
+        ++commands_;
+        std::string reply = "$R: " + line + "\r\n";
+        // Setup blocks are output once when their stream is set
+        if (line.compare(0, 3, "sso") == 0)
+        {
+            for (const char* setup : {"ReceiverSetup", "IMUSetup", "VelSensorSetup"})
+            {
+                if (line.find(setup) != std::string::npos)
+                    generator_.generate(setup, gpsTime(), reply);
+            }
+        }
+        return reply + prompt;
+    }
+
+    void RxSimulator::write(Connection& connection, const std::string& data)
+    {
+        std::lock_guard<std::mutex> lock(connection.write_mutex);
+        if (connection.drop_on_block)
+        {
+            // Output is lost while no client listens, as on a serial line
+            pollfd hangup = {connection.fd, 0, 0};
+            if (::poll(&hangup, 1, 0) > 0 && (hangup.revents & POLLHUP))
+                return;
+        }
+        size_t written = 0;
+        while (written < data.size() && !connection.closed)
+        {
+            ssize_t n =
+                connection.drop_on_block
+                    ? ::write(connection.fd, data.data() + written,
+                              data.size() - written)
+                    : ::send(connection.fd, data.data() + written,
+                             data.size() - written, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && connection.drop_on_block &&
+                (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                // The serial output buffer of the Rx overflows
+                ++overflows_;
+                return;
+            }
+            if (n < 0)
+            {
+                connection.closed = true;
+                return;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+
+    void RxSimulator::broadcast(const std::string& data)
+    {
+        std::list<std::shared_ptr<Connection>> connections;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            for (auto it = connections_.begin(); it != connections_.end();)
+            {
+                // Closed connections are removed once their reader is done
+                if ((*it)->closed && (*it)->finished)
+                {
+                    std::fprintf(stderr, "Client disconnected from %s\n",
+                                 (*it)->descriptor.c_str());
+                    (*it)->reader.join();
+                    ::close((*it)->fd);
+                    it = connections_.erase(it);
+                } else
+                {
+                    if (!(*it)->closed)
+                        connections.push_back(*it);
+                    ++it;
+                }
+            }
+        }
+        for (const auto& connection : connections)
+            write(*connection, data);
+    }
+
+    void RxSimulator::tamper(const char* frame, size_t size, std::string& out)
+    {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        ++frames_;
+        if (settings_.garbage_probability > 0.0 &&
+            uniform(random_) < settings_.garbage_probability)
+        {
+            size_t garbage = std::uniform_int_distribution<size_t>(1, 64)(random_);
+            for (size_t i = 0; i < garbage; ++i)
+                out.push_back(static_cast<char>(random_()));
+            ++garbage_;
+        }
+        if (settings_.drop_probability > 0.0 &&
+            uniform(random_) < settings_.drop_probability)
+        {
+            ++dropped_;
+            return;
+        }
+        size_t start = out.size();
+        out.append(frame, size);
+        if (settings_.corrupt_probability > 0.0 &&
+            uniform(random_) < settings_.corrupt_probability)
+        {
+            size_t byte = std::uniform_int_distribution<size_t>(0, size - 1)(random_);
+            out[start + byte] ^= static_cast<char>(1 << (random_() % 8));
+            ++corrupted_;
+        }
+    }
+
+    void RxSimulator::run(const std::atomic<bool>& stopping)
+    {
+        last_statistics_ = steadySeconds();
+        if (settings_.file_name.empty())
+            streamSynthetic(stopping);
+        else
+            streamRecorded(stopping);
+        printStatistics(true);
+    }
+
+    void RxSimulator::streamSynthetic(const std::atomic<bool>& stopping)
+    {
+        struct Stream
+        {
+            std::string name;
+            uint64_t period;
+            uint64_t next;
+        };
+        std::vector<Stream> streams;
+        const uint64_t start = gpsTime();
+        const auto steady_start = std::chrono::steady_clock::now();
+        for (const auto& stream : settings_.streams)
+        {
+            uint64_t period = static_cast<uint64_t>(1e9 / stream.second);
+            // Epochs are aligned on multiples of the period, as by the Rx
+            streams.push_back({stream.first, period, (start / period + 1) * period});
+        }
+        if (streams.empty())
+            return;
+
+        std::string frame;
+        std::string out;
+        while (!stopping)
+        {
+            uint64_t epoch = streams.front().next;
+            for (const auto& stream : streams)
+                epoch = std::min(epoch, stream.next);
+            std::this_thread::sleep_until(steady_start +
+                                          std::chrono::nanoseconds(epoch - start));
+            out.clear();
+            for (auto& stream : streams)
+            {
+                if (stream.next != epoch)
+                    continue;
+                frame.clear();
+                generator_.generate(stream.name, epoch, frame);
+                tamper(frame.data(), frame.size(), out);
+                stream.next += stream.period;
+            }
+            bytes_ += out.size();
+            broadcast(out);
+            printStatistics(false);
+        }
+    }
+
+    void RxSimulator::streamRecorded(const std::atomic<bool>& stopping)
+    {
+        std::ifstream file(settings_.file_name, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+        if (data.empty())
+        {
+            std::fprintf(stderr, "Nothing to replay in %s\n",
+                         settings_.file_name.c_str());
+            return;
+        }
+
+        std::string out;
+        do
+        {
+            auto target = std::chrono::steady_clock::now();
+            bool have_tow = false;
+            uint32_t last_tow = 0;
+            size_t pos = 0;
+            while (pos < data.size() && !stopping)
+            {
+                size_t size = frameSize(&data[pos], data.size() - pos);
+                if (size == 0)
+                {
+                    ++pos;
+                    continue;
+                }
+                // Frames of an epoch are sent at once, when the first block of
+                // the next epoch is met
+                if (data[pos + 1] == '@')
+                {
+                    uint32_t tow = static_cast<uint32_t>(
+                        data[pos + 8] | (data[pos + 9] << 8) |
+                        (data[pos + 10] << 16) | (data[pos + 11] << 24));
+                    if (tow != 4294967295u && (!have_tow || tow != last_tow))
+                    {
+                        bytes_ += out.size();
+                        broadcast(out);
+                        out.clear();
+                        printStatistics(false);
+                        // Going back in time, e.g. at week rollovers, or long
+                        // pauses do not delay the replay
+                        if (have_tow && tow > last_tow &&
+                            tow - last_tow <= MAX_REPLAY_PAUSE_MS)
+                        {
+                            target += std::chrono::microseconds(static_cast<int64_t>(
+                                (tow - last_tow) * 1000.0 / settings_.speed));
+                            std::this_thread::sleep_until(target);
+                        } else
+                            target = std::chrono::steady_clock::now();
+                        have_tow = true;
+                        last_tow = tow;
+                    }
+                }
+                tamper(reinterpret_cast<const char*>(&data[pos]), size, out);
+                pos += size;
+            }
+            bytes_ += out.size();
+            broadcast(out);
+            out.clear();
+        } while (settings_.loop && !stopping);
+    }
+
+    void RxSimulator::printStatistics(bool force)
+    {
+        int64_t now = steadySeconds();
+        if (!force && (settings_.stats_period <= 0.0 ||
+                       now - last_statistics_ < settings_.stats_period))
+            return;
+        last_statistics_ = now;
+        size_t clients;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            clients = connections_.size();
+        }
+        std::fprintf(stderr,
+                     "frames %llu, bytes %llu, corrupted %llu, dropped %llu, "
+                     "garbage %llu, commands %llu, overflows %llu, clients %zu\n",
+                     static_cast<unsigned long long>(frames_),
+                     static_cast<unsigned long long>(bytes_),
+                     static_cast<unsigned long long>(corrupted_),
+                     static_cast<unsigned long long>(dropped_),
+                     static_cast<unsigned long long>(garbage_),
+                     static_cast<unsigned long long>(commands_.load()),
+                     static_cast<unsigned long long>(overflows_.load()), clients);
+    }
+} // namespace rx_simulator
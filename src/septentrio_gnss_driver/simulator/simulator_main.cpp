@@ -0,0 +1,189 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <septentrio_gnss_driver/simulator/rx_simulator.hpp>
+// C++ library includes
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <stdexcept>
+
+/**
+ * @file simulator_main.cpp
+ * @date 19/10/26
+ * @brief Main function of the Rx simulator
+ */
+
+namespace {
+    std::atomic<bool> stopping{false};
+
+    void stop(int) { stopping = true; }
+
+    void usage(const char* name)
+    {
+        std::fprintf(
+            stderr,
+            "Usage: %s [options]\n"
+            "  --tcp-port N         TCP port to listen on, 0 for none (28784)\n"
+            "  --pty                Open a pseudo terminal standing in for COM1\n"
+            "  --pty-link PATH      Symbolic link to the pseudo terminal\n"
+            "  --rate NAME=HZ       Stream the synthetic message NAME at HZ,\n"
+            "                       repeatable\n"
+            "  --meas-signals N     Signals in MeasEpoch, up to 243 (100)\n"
+            "  --file PATH          Replay the SBF/NMEA file PATH instead\n"
+            "  --speed X            Replay speed relative to real time (1)\n"
+            "  --loop               Replay the file in a loop\n"
+            "  --corrupt P          Probability of a flipped bit in a frame\n"
+            "  --drop P             Probability of a frame to be dropped\n"
+            "  --garbage P          Probability of random bytes before a frame\n"
+            "  --seed N             Seed of the corruption (0)\n"
+            "  --stats-period S     Period of the statistics on stderr, 0 for none "
+            "(10)\n"
+            "Messages:",
+            name);
+        for (const auto& message : rx_simulator::FrameGenerator::messages())
+            std::fprintf(stderr, " %s", message.c_str());
+        std::fprintf(stderr, "\n");
+    }
+
+    double probability(const std::string& value)
+    {
+        double p = std::stod(value);
+        if (p < 0.0 || p > 1.0)
+            throw std::invalid_argument("probability out of [0, 1]: " + value);
+        return p;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    rx_simulator::SimulatorSettings settings;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string option = argv[i];
+            if (option == "--help" || option == "-h")
+            {
+                usage(argv[0]);
+                return 0;
+            }
+            if (option == "--pty")
+            {
+                settings.pty = true;
+                continue;
+            }
+            if (option == "--loop")
+            {
+                settings.loop = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+                throw std::invalid_argument("missing value of " + option);
+            std::string value = argv[++i];
+            if (option == "--tcp-port")
+                settings.tcp_port = static_cast<uint16_t>(std::stoul(value));
+            else if (option == "--pty-link")
+            {
+                settings.pty = true;
+                settings.pty_link = value;
+            } else if (option == "--rate")
+            {
+                std::size_t equal = value.find('=');
+                std::vector<std::string> messages =
+                    rx_simulator::FrameGenerator::messages();
+                if (equal == std::string::npos ||
+                    std::find(messages.begin(), messages.end(),
+                              value.substr(0, equal)) == messages.end())
+                    throw std::invalid_argument("unknown message in " + value);
+                double rate = std::stod(value.substr(equal + 1));
+                if (rate <= 0.0 || rate > 1000.0)
+                    throw std::invalid_argument("rate out of ]0, 1000]: " + value);
+                settings.streams.emplace_back(value.substr(0, equal), rate);
+            } else if (option == "--meas-signals")
+                settings.meas_signals = static_cast<uint32_t>(std::stoul(value));
+            else if (option == "--file")
+                settings.file_name = value;
+            else if (option == "--speed")
+            {
+                settings.speed = std::stod(value);
+                if (settings.speed <= 0.0)
+                    throw std::invalid_argument("speed must be positive");
+            } else if (option == "--corrupt")
+                settings.corrupt_probability = probability(value);
+            else if (option == "--drop")
+                settings.drop_probability = probability(value);
+            else if (option == "--garbage")
+                settings.garbage_probability = probability(value);
+            else if (option == "--seed")
+                settings.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (option == "--stats-period")
+                settings.stats_period = std::stod(value);
+            else
+                throw std::invalid_argument("unknown option " + option);
+        }
+    } catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        usage(argv[0]);
+        return 1;
+    }
+    if (settings.streams.empty() && settings.file_name.empty())
+    {
+        // A GNSS Rx at 10 Hz
+        for (const char* message : {"PVTGeodetic", "PosCovGeodetic", "AttEuler",
+                                    "AttCovEuler", "VelCovGeodetic"})
+            settings.streams.emplace_back(message, 10.0);
+        for (const char* message :
+             {"ReceiverStatus", "QualityInd", "DOP", "GPGGA", "GPRMC"})
+            settings.streams.emplace_back(message, 1.0);
+    }
+
+    rx_simulator::RxSimulator simulator(settings);
+    std::string error;
+    if (!simulator.open(error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (settings.tcp_port != 0)
+        std::fprintf(stderr, "Listening on tcp://0.0.0.0:%u\n",
+                     static_cast<unsigned>(settings.tcp_port));
+    if (!simulator.ptyName().empty())
+        std::fprintf(stderr, "Serial port on %s\n",
+                     (settings.pty_link.empty() ? simulator.ptyName()
+                                                : settings.pty_link)
+                         .c_str());
+
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+    simulator.run(stopping);
+    return 0;
+}
@@ -0,0 +1,778 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+#
+# © Copyright 2020, Septentrio NV/SA.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#    1. Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#    2. Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#    3. Neither the name of the copyright holder nor the names of its
+#       contributors may be used to endorse or promote products derived
+#       from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+# *****************************************************************************
+
+"""Generates the captures of the replay test and their golden messages.
+
+rover.sbf holds EPOCHS epochs of a single-antenna rover at 10 Hz, each consisting
+of the blocks PVTGeodetic, PosCovGeodetic, VelCovGeodetic, DOP, AttEuler,
+AttCovEuler, ChannelStatus, MeasEpoch, INSNavGeod and ExtSensorMeas and, once
+per second, of QualityInd and ReceiverStatus. The first epoch is preceded by
+ReceiverSetup. Between two epochs, bytes that do not start a message and a
+PVTGeodetic block with a wrong CRC are inserted, both of which the node has to
+skip. rover.pcap carries the same bytes as TCP stream of the Rx, cut into
+segments regardless of the block boundaries and with a retransmitted segment and
+pure ACKs in between.
+
+rover.golden holds the messages the node publishes for both captures, printed as
+by the replay tool, i.e. as `rostopic echo` would, each preceded by a line
+`--- <topic>`. The node is run with the parameters of ../replay.test, such that
+it publishes the decoded blocks as well as NavSatFix, PoseWithCovarianceStamped,
+GPSFix and DiagnosticArray. The latter are published once the last of their
+blocks arrived, i.e. after PosCovGeodetic, AttCovEuler, MeasEpoch and
+ReceiverStatus, respectively, and their fields are computed as by RxMessage, in
+single precision where it computes in float.
+"""
+
+import math
+import struct
+import sys
+
+EPOCHS = 25
+TOW_START = 475200000  # ms, Saturday 12:00 GPST
+TOW_STEP = 100  # ms
+WNC = 2337
+
+# Parameters of the node in ../replay.test
+FRAME_ID = "gnss"
+IMU_FRAME_ID = "imu"
+LEAP_SECONDS = 18
+
+GPS_EPOCH = 315964800  # s, 1980-01-06 in Unix time
+SECONDS_PER_WEEK = 7 * 24 * 60 * 60
+
+CRC_POLY = 0x1021
+
+SEGMENT_SIZE = 230  # bytes of TCP payload
+RX_ADDRESS = (192, 168, 3, 1)
+HOST_ADDRESS = (192, 168, 3, 100)
+RX_PORT = 28784
+HOST_PORT = 3001
+
+DEGREE = math.pi / 180
+DO_NOT_USE = -2e10
+
+# status of NavSatStatus and GPSStatus for the PVT mode 4, RTK with fixed
+# ambiguities
+STATUS_GBAS_FIX = 2
+
+# Satellites of ChannelStatus: SVID, azimuth, elevation and PVTStatus, of which a
+# 2-bit field of 2 marks the satellite as used in the PVT
+SATELLITES = [
+    (5, 123, 45, 0x0002),
+    (13, 250, 30, 0x0080),
+    (40, 45, 10, 0x0001),
+    (72, 300, 60, 0x0008),
+]
+# Satellites of MeasEpoch in their order: SVID and signal type. 40 is only
+# searched for, hence not in sync.
+MEASUREMENTS = [(72, 17), (5, 0), (13, 1)]
+
+
+def crc16_ccitt(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ CRC_POLY) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def sbf_block(block_id, revision, tow, payload):
+    """Frames payload as SBF block, padded to a multiple of 4 bytes."""
+    length = 14 + len(payload)
+    payload += b"\x00" * (-length % 4)
+    length = 14 + len(payload)
+    body = struct.pack("<HHIH", block_id | (revision << 13), length, tow, WNC)
+    body += payload
+    return b"$@" + struct.pack("<H", crc16_ccitt(body)) + body
+
+
+def f32(value):
+    """Rounds value as stored in a float32 field."""
+    return struct.unpack("<f", struct.pack("<f", value))[0]
+
+
+def text(value, size):
+    return value.encode("ascii").ljust(size, b"\x00")
+
+
+def pvt_geodetic(k):
+    """Fields of PVTGeodetic revision 2 in block order, with their formats."""
+    return [
+        ("mode", "B", 4),
+        ("error", "B", 0),
+        ("latitude", "d", math.radians(50.8503 + 1e-6 * k)),
+        ("longitude", "d", math.radians(4.3517 + 2e-6 * k)),
+        ("height", "d", 112.3 + 0.01 * k),
+        ("undulation", "f", 47.0),
+        ("vn", "f", 0.5 + 0.01 * k),
+        ("ve", "f", 0.25),
+        ("vu", "f", -0.002 * k),
+        ("cog", "f", 26.565),
+        ("rx_clk_bias", "d", 0.123 + 1e-6 * k),
+        ("rx_clk_drift", "f", 0.01),
+        ("time_system", "B", 0),
+        ("datum", "B", 0),
+        ("nr_sv", "B", 24 - k % 3),
+        ("wa_corr_info", "B", 0),
+        ("reference_id", "H", 100),
+        ("mean_corr_age", "H", 50 + k),
+        ("signal_info", "I", 0x0F5F),
+        ("alert_flag", "B", 0),
+        ("nr_bases", "B", 1),
+        ("ppp_info", "H", 0),
+        ("latency", "H", 20 + k % 4),
+        ("h_accuracy", "H", 2),
+        ("v_accuracy", "H", 3),
+        ("misc", "B", 0),
+    ]
+
+
+def pos_cov_geodetic(k):
+    """Fields of PosCovGeodetic revision 0 in block order, with their formats."""
+    scale = 1.0 + 0.05 * k
+    return [
+        ("mode", "B", 4),
+        ("error", "B", 0),
+        ("cov_latlat", "f", 4e-4 * scale),
+        ("cov_lonlon", "f", 4e-4 * scale),
+        ("cov_hgthgt", "f", 16e-4 * scale),
+        ("cov_bb", "f", 1e-4),
+        ("cov_latlon", "f", 1e-5 * scale),
+        ("cov_lathgt", "f", -2e-5 * scale),
+        ("cov_latb", "f", 1e-6),
+        ("cov_lonhgt", "f", 3e-5 * scale),
+        ("cov_lonb", "f", 2e-6),
+        ("cov_hb", "f", -3e-6),
+    ]
+
+
+def vel_cov_geodetic(k):
+    """Fields of VelCovGeodetic revision 0 in block order, with their formats."""
+    scale = 1.0 + 0.02 * k
+    return [
+        ("mode", "B", 4),
+        ("error", "B", 0),
+        ("cov_vnvn", "f", 2.5e-5 * scale),
+        ("cov_veve", "f", 2.5e-5 * scale),
+        ("cov_vuvu", "f", 9e-5 * scale),
+        ("cov_dtdt", "f", 1e-6),
+        ("cov_vnve", "f", 1e-6),
+        ("cov_vnvu", "f", -2e-6),
+        ("cov_vndt", "f", 1e-7),
+        ("cov_vevu", "f", 3e-6),
+        ("cov_vedt", "f", 2e-7),
+        ("cov_vudt", "f", -1e-7),
+    ]
+
+
+def dop(k):
+    """Fields of DOP revision 0 in block order, the DOPs scaled by 100."""
+    return [
+        ("nr_sv", "B", 24 - k % 3),
+        ("reserved", "B", 0),
+        ("pdop", "H", 150 + k % 5),
+        ("tdop", "H", 90),
+        ("hdop", "H", 80),
+        ("vdop", "H", 120),
+        ("hpl", "f", 1.2),
+        ("vpl", "f", 1.8),
+    ]
+
+
+def att_euler(k):
+    """Fields of AttEuler revision 0 in block order, with their formats."""
+    return [
+        ("nr_sv", "B", 12),
+        ("error", "B", 0),
+        ("mode", "H", 4),
+        ("reserved", "H", 0),
+        ("heading", "f", 30.0 + 0.2 * k),
+        ("pitch", "f", 1.5),
+        ("roll", "f", -0.75 + 0.01 * k),
+        ("pitch_dot", "f", 0.02),
+        ("roll_dot", "f", -0.01),
+        ("heading_dot", "f", 2.0),
+    ]
+
+
+def att_cov_euler(k):
+    """Fields of AttCovEuler revision 0 in block order, with their formats."""
+    return [
+        ("reserved", "B", 0),
+        ("error", "B", 0),
+        ("cov_headhead", "f", 0.01),
+        ("cov_pitchpitch", "f", 0.04),
+        ("cov_rollroll", "f", 0.04 * (1.0 + 0.05 * k)),
+        ("cov_headpitch", "f", 0.001),
+        ("cov_headroll", "f", -0.002),
+        ("cov_pitchroll", "f", 0.003),
+    ]
+
+
+def ins_nav_geod(k):
+    """Fields of INSNavGeod revision 0 in block order, with their formats.
+
+    All sub-blocks but the velocity standard deviations and covariances (16 and
+    128 of sb_list) are present.
+    """
+    return [
+        ("gnss_mode", "B", 4),
+        ("error", "B", 0),
+        ("info", "H", 0x0400),
+        ("gnss_age", "H", 10),
+        ("latitude", "d", math.radians(50.8503 + 1e-6 * k)),
+        ("longitude", "d", math.radians(4.3517 + 2e-6 * k)),
+        ("height", "d", 112.25 + 0.01 * k),
+        ("undulation", "f", 47.0),
+        ("accuracy", "H", 3),
+        ("latency", "H", 15),
+        ("datum", "B", 0),
+        ("reserved", "B", 0),
+        ("sb_list", "H", 1 | 2 | 4 | 8 | 32 | 64),
+        ("latitude_std_dev", "f", 0.02),
+        ("longitude_std_dev", "f", 0.02),
+        ("height_std_dev", "f", 0.04),
+        ("heading", "f", 31.0 + 0.2 * k),
+        ("pitch", "f", 1.2),
+        ("roll", "f", -0.8),
+        ("heading_std_dev", "f", 0.1),
+        ("pitch_std_dev", "f", 0.05),
+        ("roll_std_dev", "f", 0.05),
+        ("ve", "f", 0.25),
+        ("vn", "f", 0.5 + 0.01 * k),
+        ("vu", "f", -0.002 * k),
+        ("latitude_longitude_cov", "f", 1e-5),
+        ("latitude_height_cov", "f", -2e-5),
+        ("longitude_height_cov", "f", 3e-5),
+        ("heading_pitch_cov", "f", 1e-3),
+        ("heading_roll_cov", "f", -2e-3),
+        ("pitch_roll_cov", "f", 3e-3),
+    ]
+
+
+# Fields of the INSNavGeod message in its order, which differs from the block's
+INS_NAV_GEOD_MESSAGE = [
+    "gnss_mode", "error", "info", "gnss_age", "latitude", "longitude", "height",
+    "undulation", "accuracy", "latency", "datum", "sb_list", "latitude_std_dev",
+    "longitude_std_dev", "height_std_dev", "latitude_longitude_cov",
+    "latitude_height_cov", "longitude_height_cov", "heading", "pitch", "roll",
+    "heading_std_dev", "pitch_std_dev", "roll_std_dev", "heading_pitch_cov",
+    "heading_roll_cov", "pitch_roll_cov", "ve", "vn", "vu", "ve_std_dev",
+    "vn_std_dev", "vu_std_dev", "ve_vn_cov", "ve_vu_cov", "vn_vu_cov"]
+
+
+def ext_sensor_meas(k):
+    """Measurement sets of ExtSensorMeas revision 0: source, sensor model, type
+    (0 for accelerations, 1 for angular rates), obs info and the three axes."""
+    return [(0, 1, 0, 0, (0.05, -0.02, 9.81 + 0.001 * k)),
+            (0, 1, 1, 0, (0.1, -0.05, 2.0))]
+
+
+def receiver_setup():
+    """Payload of ReceiverSetup revision 0."""
+    return b"\x00\x00" + text("ROVER", 60) + text("0001", 20) + \
+        text("ROSaic", 20) + text("Septentrio", 40) + text("3101234", 20) + \
+        text("mosaic-X5", 20) + text("4.14.4", 20) + text("12345", 20) + \
+        text("SEPCHOKE_B3E6   SPKE", 20) + struct.pack("<fff", 0.1, 0.0, 0.0)
+
+
+def channel_status():
+    """Payload of ChannelStatus revision 0, with one ChannelStateInfo per
+    satellite."""
+    payload = struct.pack("<BBBxxx", len(SATELLITES), 12, 8)
+    for channel, (sv_id, azimuth, elevation, pvt_status) in \
+            enumerate(SATELLITES):
+        # Bits 14-15 of AzRiseSet, 1 for rising, are masked by the node
+        payload += struct.pack("<BBxxHHbBBx", sv_id, 0, azimuth | 0x4000, 0,
+                               elevation, 1, channel)
+        payload += struct.pack("<BxHHH", 0, 0x3333, pvt_status, 0)
+    return payload
+
+
+def cn0(k, channel):
+    return 160 + 8 * channel + k % 4
+
+
+def meas_epoch(k):
+    """Payload of MeasEpoch revision 1 without MeasEpochChannelType2."""
+    payload = struct.pack("<BBBBBx", len(MEASUREMENTS), 20, 12, 0, 0)
+    for channel, (sv_id, signal_type) in enumerate(MEASUREMENTS):
+        payload += struct.pack("<BBBBIiHbBHBB", channel, signal_type, sv_id, 0,
+                               20000000 + 1000 * channel + k, -1500 + 37 * channel,
+                               5000 * channel + k, channel - 1, cn0(k, channel),
+                               600 + k, 0x1D, 0)
+    return payload
+
+
+def quality_indicators(k):
+    """Types and values of the indicators of QualityInd. The overall one, type 0,
+    comes last, since the node stores the others at their index."""
+    return [(1, 10), (11, 9), (21, 8), (0, 2 if k == 10 else 10)]
+
+
+def rx_error(k):
+    """RxError of ReceiverStatus, with a missed event once."""
+    return 0x40 if k == 20 else 0
+
+
+def quality_ind(k):
+    indicators = quality_indicators(k)
+    return struct.pack("<Bx%dH" % len(indicators), len(indicators),
+                       *[value << 8 | indicator for indicator, value in indicators])
+
+
+def receiver_status(k):
+    """Payload of ReceiverStatus revision 1 with one AGCState."""
+    return struct.pack("<BBIIIBBBB", 30, 0, 3600 + k // 10, 0x00000101,
+                       rx_error(k), 1, 4, 0, 140) + \
+        struct.pack("<BbBB", 0, 40, 50, 0)
+
+
+def pack(fields):
+    return b"".join(struct.pack("<" + fmt, value) for _, fmt, value in fields)
+
+
+def values(fields):
+    """Values of fields as parsed by the node."""
+    return {name: f32(value) if fmt == "f" else value
+            for name, fmt, value in fields}
+
+
+def ros_axes(fields, negated):
+    """Fields as parsed with use_ros_axis_orientation, i.e. the heading counted
+    counterclockwise from east and the fields in negated negated."""
+    parsed = []
+    for name, fmt, value in fields:
+        if name == "heading":
+            value = 90 - f32(value)
+        elif name in negated:
+            value = -value
+        parsed.append((name, fmt, value))
+    return parsed
+
+
+def print_value(fmt, value):
+    """Prints a field as the ROS message printer does, via std::ostream."""
+    if fmt == "f":
+        value = f32(value)
+    if fmt in ("f", "d"):
+        return "%g" % value
+    if fmt == "t":
+        return "%d.%09d" % (value // 10**9, value % 10**9)
+    return str(value)
+
+
+def print_fields(fields, indent=""):
+    """Prints the fields of a message, nested messages and arrays indented."""
+    lines = []
+    for name, fmt, value in fields:
+        if name.startswith("reserved"):
+            continue
+        if fmt == "msg":
+            lines.append("%s%s: " % (indent, name))
+            lines += print_fields(value, indent + "  ")
+        elif fmt == "msg[]":
+            lines.append("%s%s[]" % (indent, name))
+            for i, item in enumerate(value):
+                lines.append("%s  %s[%d]: " % (indent, name, i))
+                lines += print_fields(item, indent + "    ")
+        elif fmt.endswith("[]"):
+            lines.append("%s%s[]" % (indent, name))
+            lines += ["%s  %s[%d]: %s" % (indent, name, i,
+                                          print_value(fmt[:-2], item))
+                      for i, item in enumerate(value)]
+        else:
+            lines.append("%s%s: %s" % (indent, name, print_value(fmt, value)))
+    return lines
+
+
+def header(tow, frame_id=FRAME_ID):
+    nsec = (GPS_EPOCH - LEAP_SECONDS + WNC * SECONDS_PER_WEEK) * 10**9 + \
+        tow * 10**6
+    return ("header", "msg", [("seq", "I", 0), ("stamp", "t", nsec),
+                              ("frame_id", "s", frame_id)])
+
+
+def print_message(topic, fields):
+    """Prints a message as the replay tool records it."""
+    return "".join(line + "\n" for line in ["--- " + topic] + print_fields(fields))
+
+
+def print_block(topic, block, tow, fields, frame_id=FRAME_ID):
+    """Prints the message of an SBF block, preceded by its header."""
+    block_id, length = struct.unpack_from("<HH", block, 4)
+    block_header = [
+        ("sync_1", "B", block[0]),
+        ("sync_2", "B", block[1]),
+        ("crc", "H", struct.unpack_from("<H", block, 2)[0]),
+        ("id", "H", block_id & 0x1FFF),
+        ("revision", "B", block_id >> 13),
+        ("length", "H", length),
+        ("tow", "I", tow),
+        ("wnc", "H", WNC)]
+    return print_message(topic, [header(tow, frame_id),
+                                 ("block_header", "msg", block_header)] + fields)
+
+
+def ins_nav_geod_message(fields):
+    parsed = values(ros_axes(fields, ("pitch", "heading_roll_cov",
+                                      "pitch_roll_cov")))
+    formats = {name: fmt for name, fmt, _ in fields}
+    return [(name, formats.get(name, "f"), parsed.get(name, DO_NOT_USE))
+            for name in INS_NAV_GEOD_MESSAGE]
+
+
+def ext_sensor_meas_message(sets):
+    axes = {0: "acceleration", 1: "angular_rate"}
+    fields = [("n", "B", len(sets)), ("sb_length", "B", 28)]
+    fields += [(name, "B[]", [measurement[i] for measurement in sets])
+               for i, name in enumerate(("source", "sensor_model", "type",
+                                         "obs_info"))]
+    for measurement_type in sorted(axes):
+        measured = [measurement[4] for measurement in sets
+                    if measurement[2] == measurement_type][0]
+        fields += [("%s_%s" % (axes[measurement_type], axis), "d", value)
+                   for axis, value in zip("xyz", measured)]
+    fields += [(name, "f", float("nan"))
+               for name in ("velocity_x", "velocity_y", "velocity_z",
+                            "std_dev_x", "std_dev_y", "std_dev_z")]
+    fields += [("sensor_temperature", "f", -32768.0),
+               ("zero_velocity_flag", "d", float("nan"))]
+    return fields
+
+
+def service(signal_info):
+    """service of NavSatStatus from the SignalInfo field of PVTGeodetic."""
+    bits = [bit for bit in range(31) if signal_info >> bit & 1]
+    gps = any(bit <= 5 for bit in bits)
+    glonass = any(8 <= bit <= 12 for bit in bits)
+    compass = any(13 <= bit <= 14 or 28 <= bit <= 30 for bit in bits)
+    galileo = any(bit == 17 or 19 <= bit <= 22 for bit in bits)
+    return gps * 1 + glonass * 2 + compass * 4 + galileo * 8
+
+
+def position_covariance(cov):
+    """Covariance of east, north and up in row-major order."""
+    return [cov["cov_lonlon"], cov["cov_latlon"], cov["cov_lonhgt"],
+            cov["cov_latlon"], cov["cov_latlat"], cov["cov_lathgt"],
+            cov["cov_lonhgt"], cov["cov_lathgt"], cov["cov_hgthgt"]]
+
+
+def nav_sat_fix(tow, pvt, cov):
+    return [
+        header(tow),
+        ("status", "msg", [("status", "b", STATUS_GBAS_FIX),
+                           ("service", "H", service(pvt["signal_info"]))]),
+        ("latitude", "d", math.degrees(pvt["latitude"])),
+        ("longitude", "d", math.degrees(pvt["longitude"])),
+        ("altitude", "d", pvt["height"]),
+        ("position_covariance", "d[]", position_covariance(cov)),
+        ("position_covariance_type", "B", 3),
+    ]
+
+
+def deg2rad_sq(value):
+    """Converts deg^2 to rad^2 in single precision."""
+    return f32(f32(value * f32(DEGREE)) * f32(DEGREE))
+
+
+def pose(tow, pvt, cov, att, att_cov):
+    yaw, pitch, roll = [att[name] * DEGREE for name in ("heading", "pitch", "roll")]
+    cy, sy = math.cos(yaw * 0.5), math.sin(yaw * 0.5)
+    cp, sp = math.cos(pitch * 0.5), math.sin(pitch * 0.5)
+    cr, sr = math.cos(roll * 0.5), math.sin(roll * 0.5)
+    covariance = [0.0] * 36
+    for row, column, value in [
+            (0, 0, cov["cov_lonlon"]), (0, 1, cov["cov_latlon"]),
+            (0, 2, cov["cov_lonhgt"]), (1, 1, cov["cov_latlat"]),
+            (1, 2, cov["cov_lathgt"]), (2, 2, cov["cov_hgthgt"]),
+            (3, 3, deg2rad_sq(att_cov["cov_rollroll"])),
+            (3, 4, deg2rad_sq(att_cov["cov_pitchroll"])),
+            (3, 5, deg2rad_sq(att_cov["cov_headroll"])),
+            (4, 4, deg2rad_sq(att_cov["cov_pitchpitch"])),
+            (4, 5, deg2rad_sq(att_cov["cov_headpitch"])),
+            (5, 5, deg2rad_sq(att_cov["cov_headhead"]))]:
+        covariance[6 * row + column] = value
+        covariance[6 * column + row] = value
+    position = [("x", "d", math.degrees(pvt["longitude"])),
+                ("y", "d", math.degrees(pvt["latitude"])),
+                ("z", "d", pvt["height"])]
+    orientation = [("x", "d", sr * cp * cy - cr * sp * sy),
+                   ("y", "d", cr * sp * cy + sr * cp * sy),
+                   ("z", "d", cr * cp * sy - sr * sp * cy),
+                   ("w", "d", cr * cp * cy + sr * sp * sy)]
+    return [
+        header(tow),
+        ("pose", "msg", [
+            ("pose", "msg", [("position", "msg", position),
+                             ("orientation", "msg", orientation)]),
+            ("covariance", "d[]", covariance)]),
+    ]
+
+
+def gps_fix(k, tow, pvt, cov, vel_cov, att, att_cov, dops):
+    """GPSFix as built from the blocks of epoch k, see RxMessage::GPSFixCallback()
+    for the single precision terms."""
+    in_sync = [sv_id for sv_id, _ in MEASUREMENTS]
+    snr = [cn0(k, channel) // 4 + (0 if signal_type & 15 in (1, 2) else 10)
+           for channel, (_, signal_type) in enumerate(MEASUREMENTS)]
+    visible = [satellite for satellite in SATELLITES if satellite[0] in in_sync]
+    used = [sv_id for sv_id, _, _, pvt_status in SATELLITES
+            if any(pvt_status >> bit & 3 == 2 for bit in range(0, 16, 2))]
+    vn, ve = pvt["vn"], pvt["ve"]
+    horizontal = f32(f32(vn * vn) + f32(ve * ve))
+    pdop, tdop, hdop, vdop = [dops[name] / 100.0
+                              for name in ("pdop", "tdop", "hdop", "vdop")]
+    err_track = 2 * math.sqrt(
+        (1.0 / f32(vn + f32(f32(ve * ve) / vn)))**2 * cov["cov_lonlon"] +
+        f32(f32(f32(ve / horizontal)**2) * cov["cov_latlat"]))
+    status = [
+        header(tow),
+        ("satellites_used", "H", pvt["nr_sv"]),
+        ("satellite_used_prn", "i[]", used),
+        ("satellites_visible", "H", len(in_sync)),
+        ("satellite_visible_prn", "i[]", [sat[0] for sat in visible]),
+        ("satellite_visible_z", "i[]", [sat[2] for sat in visible]),
+        ("satellite_visible_azimuth", "i[]", [sat[1] for sat in visible]),
+        ("satellite_visible_snr", "i[]",
+         [snr[in_sync.index(sat[0])] for sat in visible]),
+        ("status", "h", STATUS_GBAS_FIX),
+        ("motion_source", "H", 2),
+        ("orientation_source", "H", 2),
+        ("position_source", "H", 1),
+    ]
+    return [
+        header(tow),
+        ("status", "msg", status),
+        ("latitude", "d", math.degrees(pvt["latitude"])),
+        ("longitude", "d", math.degrees(pvt["longitude"])),
+        ("altitude", "d", pvt["height"]),
+        ("track", "d", pvt["cog"]),
+        ("speed", "d", f32(math.sqrt(horizontal))),
+        ("climb", "d", pvt["vu"]),
+        ("pitch", "d", att["pitch"]),
+        ("roll", "d", att["roll"]),
+        ("dip", "d", 0.0),
+        ("time", "d", pvt_time(tow)),
+        ("gdop", "d", math.sqrt(pdop * pdop + tdop * tdop)),
+        ("pdop", "d", pdop),
+        ("hdop", "d", hdop),
+        ("vdop", "d", vdop),
+        ("tdop", "d", tdop),
+        ("err", "d", 2 * math.sqrt(cov["cov_latlat"] + cov["cov_lonlon"] +
+                                   cov["cov_hgthgt"])),
+        ("err_horz", "d", 2 * math.sqrt(cov["cov_latlat"] + cov["cov_lonlon"])),
+        ("err_vert", "d", 2 * math.sqrt(cov["cov_hgthgt"])),
+        ("err_track", "d", err_track),
+        ("err_speed", "d", 2 * math.sqrt(vel_cov["cov_vnvn"] +
+                                         vel_cov["cov_veve"])),
+        ("err_climb", "d", 2 * math.sqrt(vel_cov["cov_vuvu"])),
+        ("err_time", "d", 2 * f32(math.sqrt(cov["cov_bb"]))),
+        ("err_pitch", "d", 2 * math.sqrt(att_cov["cov_pitchpitch"])),
+        ("err_roll", "d", 2 * math.sqrt(att_cov["cov_rollroll"])),
+        ("err_dip", "d", 0.0),
+        ("position_covariance", "d[]", position_covariance(cov)),
+        ("position_covariance_type", "B", 3),
+    ]
+
+
+def pvt_time(tow):
+    """time of GPSFix, in seconds since the start of GPS time."""
+    return tow / 1000 + WNC * SECONDS_PER_WEEK
+
+
+def diagnostic_array(k, tow):
+    keys = {1: "GNSS Signals, Main Antenna", 2: "GNSS Signals, Aux1 Antenna",
+            11: "RF Power, Main Antenna", 12: "RF Power, Aux1 Antenna",
+            21: "CPU Headroom", 25: "OCXO Stability",
+            30: "Base Station Measurements", 31: "RTK Post-Processing"}
+    indicators = quality_indicators(k)
+    overall = dict(indicators)[0]
+    # OK, WARN, ERROR and STALE are 0 to 3
+    level = 2 if rx_error(k) else 3 if overall == 0 else \
+        1 if overall in (1, 2) else 0
+    status = [
+        ("level", "b", level),
+        ("name", "s", "gnss"),
+        ("message", "s", "Quality Indicators (from 0 for low quality to 10 for "
+                         "high quality, 15 if unknown)"),
+        ("hardware_id", "s", "3101234"),
+        ("values", "msg[]", [[("key", "s", keys[indicator]),
+                              ("value", "s", str(value))]
+                             for indicator, value in indicators if indicator]),
+    ]
+    return [header(tow), ("status", "msg[]", [status])]
+
+
+def epoch(k):
+    """Returns the bytes of epoch k and the golden messages."""
+    tow = TOW_START + TOW_STEP * k
+    stream = b""
+    golden = ""
+    if k == 0:
+        stream += sbf_block(5902, 0, tow, receiver_setup())
+
+    pvt = pvt_geodetic(k)
+    block = sbf_block(4007, 2, tow, pack(pvt))
+    stream += block
+    golden += print_block("/pvtgeodetic", block, tow, pvt)
+    cov = pos_cov_geodetic(k)
+    block = sbf_block(5906, 0, tow, pack(cov))
+    stream += block
+    golden += print_block("/poscovgeodetic", block, tow, cov)
+    golden += print_message("/navsatfix", nav_sat_fix(tow, values(pvt),
+                                                      values(cov)))
+    vel_cov = vel_cov_geodetic(k)
+    block = sbf_block(5908, 0, tow, pack(vel_cov))
+    stream += block
+    golden += print_block("/velcovgeodetic", block, tow, vel_cov)
+    dops = dop(k)
+    stream += sbf_block(4001, 0, tow, pack(dops))
+    att = att_euler(k)
+    block = sbf_block(5938, 0, tow, pack(att))
+    stream += block
+    att = ros_axes(att, ("pitch", "pitch_dot", "heading_dot"))
+    golden += print_block("/atteuler", block, tow, att)
+    att_cov = att_cov_euler(k)
+    block = sbf_block(5939, 0, tow, pack(att_cov))
+    stream += block
+    att_cov = ros_axes(att_cov, ("cov_headroll", "cov_pitchroll"))
+    golden += print_block("/attcoveuler", block, tow, att_cov)
+    golden += print_message("/pose", pose(tow, values(pvt), values(cov),
+                                          values(att), values(att_cov)))
+    stream += sbf_block(4013, 0, tow, channel_status())
+    stream += sbf_block(4027, 1, tow, meas_epoch(k))
+    golden += print_message("/gpsfix", gps_fix(
+        k, tow, values(pvt), values(cov), values(vel_cov), values(att),
+        values(att_cov), values(dops)))
+
+    ins = ins_nav_geod(k)
+    block = sbf_block(4226, 0, tow, pack(ins))
+    stream += block
+    golden += print_block("/insnavgeod", block, tow, ins_nav_geod_message(ins))
+    sets = ext_sensor_meas(k)
+    block = sbf_block(4050, 0, tow, struct.pack("<BB", len(sets), 28) + b"".join(
+        struct.pack("<BBBBddd", *measurement[:4], *measurement[4])
+        for measurement in sets))
+    stream += block
+    golden += print_block("/extsensormeas", block, tow,
+                          ext_sensor_meas_message(sets), IMU_FRAME_ID)
+
+    if k % 10 == 0:
+        stream += sbf_block(4082, 0, tow, quality_ind(k))
+        stream += sbf_block(4014, 1, tow, receiver_status(k))
+        golden += print_message("/diagnostics", diagnostic_array(k, tow))
+    return stream, golden
+
+
+def sbf_stream():
+    """Returns the bytes of the SBF capture and the golden messages."""
+    stream = b""
+    golden = ""
+    for k in range(EPOCHS):
+        epoch_stream, epoch_golden = epoch(k)
+        stream += epoch_stream
+        golden += epoch_golden
+        if k % 10 == 4:
+            # Line noise, e.g. after reconnecting
+            stream += bytes(range(0x30, 0x30 + 3 + k))
+        if k % 10 == 7:
+            corrupted = bytearray(sbf_block(4007, 2, TOW_START + TOW_STEP * k + 50,
+                                            pack(pvt_geodetic(k))))
+            corrupted[20] ^= 0x01
+            # Must not contain a sync byte that makes the node skip the next block
+            assert b"$" not in corrupted[1:]
+            stream += bytes(corrupted)
+    return stream, golden
+
+
+def checksum(data):
+    if len(data) % 2:
+        data += b"\x00"
+    total = sum(struct.unpack("!%dH" % (len(data) // 2), data))
+    while total >> 16:
+        total = (total & 0xFFFF) + (total >> 16)
+    return ~total & 0xFFFF
+
+
+def tcp_frame(src, dst, sport, dport, seq, ack, payload):
+    """Frames payload as Ethernet/IPv4/TCP packet with valid checksums."""
+    tcp = struct.pack("!HHIIBBHHH", sport, dport, seq, ack, 5 << 4, 0x18, 65535,
+                      0, 0)
+    pseudo = struct.pack("!4B4BBBH", *src, *dst, 0, 6, len(tcp) + len(payload))
+    tcp = tcp[:16] + struct.pack("!H", checksum(pseudo + tcp + payload)) + \
+        tcp[18:]
+    ip = struct.pack("!BBHHHBBH4B4B", 0x45, 0, 20 + len(tcp) + len(payload), 0,
+                     0x4000, 64, 6, 0, *src, *dst)
+    ip = ip[:10] + struct.pack("!H", checksum(ip)) + ip[12:]
+    ethernet = bytes([0x02, 0, 0, 0, 0, 0x64, 0x02, 0, 0, 0, 0, 0x01]) + \
+        struct.pack("!H", 0x0800)
+    return ethernet + ip + tcp + payload
+
+
+def pcap(stream):
+    """Returns a PCAP capture of stream sent by the Rx via TCP."""
+    packets = []
+    seq = 1000
+    ack = 5000
+    for offset in range(0, len(stream), SEGMENT_SIZE):
+        segment = stream[offset:offset + SEGMENT_SIZE]
+        packets.append(tcp_frame(RX_ADDRESS, HOST_ADDRESS, RX_PORT, HOST_PORT,
+                                 seq, ack, segment))
+        if offset // SEGMENT_SIZE % 8 == 3:
+            # Retransmission of a segment whose ACK got lost
+            packets.append(packets[-1])
+        seq += len(segment)
+        # Pure ACK of the host, 54 bytes
+        packets.append(tcp_frame(HOST_ADDRESS, RX_ADDRESS, HOST_PORT, RX_PORT,
+                                 ack, seq, b""))
+    capture = struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535, 1)
+    for i, packet in enumerate(packets):
+        capture += struct.pack("<IIII", 1729339200, 1000 * i, len(packet),
+                               len(packet))
+        capture += packet
+    return capture
+
+
+def main(directory):
+    stream, golden = sbf_stream()
+    with open(directory + "/rover.sbf", "wb") as out:
+        out.write(stream)
+    with open(directory + "/rover.pcap", "wb") as out:
+        out.write(pcap(stream))
+    with open(directory + "/rover.golden", "w") as out:
+        out.write(golden)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else ".")
@@ -0,0 +1,131 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <gtest/gtest.h>
+#include <septentrio_gnss_driver/communication/ntp_shm.hpp>
+// C++ library includes
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <sys/shm.h>
+#include <unistd.h>
+
+/**
+ * @file ntp_shm_test.cpp
+ * @date 19/10/26
+ * @brief Reads the samples written to the NTP shared memory segment back as
+ * ntpd and chrony do in mode 1
+ *
+ * Runs without ROS master. The unit is derived from the process ID, such that
+ * the segments of time servers, usually units 0 to 3, are not touched.
+ */
+
+namespace {
+    //! Difference between the Rx and the host time of all samples, in ns
+    const Timestamp OFFSET = 50000000;
+
+    class NtpShmTest : public testing::Test
+    {
+    protected:
+        NtpShmTest() :
+            node_(ROSaicNodeBase::Offline()),
+            unit_(100 + static_cast<uint32_t>(getpid()) % 100000)
+        {
+        }
+
+        //! Removes the segment, which outlives the process otherwise
+        ~NtpShmTest() override
+        {
+            int id = shmget(static_cast<key_t>(io_comm_rx::NtpShm::KEY_BASE + unit_),
+                            0, 0);
+            if (id != -1)
+                shmctl(id, IPC_RMID, nullptr);
+        }
+
+        ROSaicNodeBase node_;
+        uint32_t unit_;
+    };
+} // namespace
+
+TEST_F(NtpShmTest, readsWrittenSample)
+{
+    io_comm_rx::NtpShm shm(&node_, unit_);
+    ASSERT_TRUE(shm.attached());
+    Timestamp clock_time = 0;
+    Timestamp receive_time = 0;
+    EXPECT_FALSE(shm.read(clock_time, receive_time)) << "No sample written yet";
+
+    shm.write(1729857582123456789, 1729857582173456000);
+    ASSERT_TRUE(shm.read(clock_time, receive_time));
+    EXPECT_EQ(1729857582123456789u, clock_time);
+    EXPECT_EQ(1729857582173456000u, receive_time);
+    EXPECT_FALSE(shm.read(clock_time, receive_time)) << "Sample read twice";
+}
+
+TEST_F(NtpShmTest, readsNoTornSamples)
+{
+    io_comm_rx::NtpShm writer(&node_, unit_);
+    io_comm_rx::NtpShm reader(&node_, unit_);
+    ASSERT_TRUE(writer.attached());
+    ASSERT_TRUE(reader.attached());
+
+    const std::size_t SAMPLES = 200;
+    std::atomic<bool> done(false);
+    std::thread writing([&]() {
+        // Both halves of every field change with each sample
+        for (Timestamp i = 1; !done; ++i)
+        {
+            writer.write(i * 1000000001 + OFFSET, i * 1000000001);
+            std::this_thread::yield();
+        }
+    });
+    std::size_t read = 0;
+    std::size_t torn = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (read < SAMPLES && std::chrono::steady_clock::now() < deadline)
+    {
+        Timestamp clock_time, receive_time;
+        if (!reader.read(clock_time, receive_time))
+            continue;
+        ++read;
+        if (clock_time - receive_time != OFFSET)
+            ++torn;
+    }
+    done = true;
+    writing.join();
+    EXPECT_EQ(SAMPLES, read);
+    EXPECT_EQ(0u, torn) << "of " << read << " samples read";
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
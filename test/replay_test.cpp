@@ -0,0 +1,175 @@
+// *****************************************************************************
+//
+// © Copyright 2020, Septentrio NV/SA.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. Neither the name of the copyright holder nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <gtest/gtest.h>
+#include <septentrio_gnss_driver/node/replay.hpp>
+// C++ library includes
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @file replay_test.cpp
+ * @date 19/10/26
+ * @brief Replays the captures in test/data through the whole node and compares
+ * the messages with the golden ones of test/data/rover.golden
+ *
+ * The node parameters are those of test/replay.test, the captures and the golden
+ * file are generated by test/data/generate_captures.py. Like the replay tool,
+ * the node hands the messages over to a PublishSink instead of publishing them.
+ * The throughput is checked on a larger capture against a baseline recorded in
+ * the build directory by the first run there.
+ */
+
+namespace {
+    //! Number of differing messages reported per capture
+    const std::size_t MAX_REPORTED = 10;
+
+    std::string readFile(const std::string& file_name)
+    {
+        std::ifstream in(file_name, std::ios::binary);
+        std::stringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+
+    //! Decodes a capture with the node into a recorder
+    void replay(const std::string& file_name,
+                rosaic_replay::MessageRecorder& recorder)
+    {
+        ros::NodeHandle("~").setParam("device", "file_name:" + file_name);
+        rosaic_replay::replay(recorder);
+    }
+
+    /**
+     * @brief Replays a capture and checks its messages and the throughput
+     *
+     * The throughput has to reach the parameter min_rate in messages per second,
+     * which also fails if the capture is paced by its time stamps.
+     */
+    void checkReplay(const std::string& capture)
+    {
+        std::vector<std::string> golden =
+            rosaic_replay::splitMessages(
+                readFile(std::string(ROSAIC_TEST_DATA) + "/rover.golden"));
+        ASSERT_FALSE(golden.empty()) << "Cannot read the golden messages";
+
+        rosaic_replay::MessageRecorder recorder(true);
+        replay(std::string(ROSAIC_TEST_DATA) + "/" + capture, recorder);
+        std::vector<std::string> actual =
+            rosaic_replay::splitMessages(recorder.text());
+
+        EXPECT_EQ(golden.size(), actual.size()) << "Number of messages differs";
+        std::size_t differences = 0;
+        for (std::size_t i = 0; i < std::min(golden.size(), actual.size()) &&
+                                differences < MAX_REPORTED;
+             ++i)
+        {
+            if (golden[i] == actual[i])
+                continue;
+            ++differences;
+            EXPECT_EQ(golden[i], actual[i]) << "Message " << i << " differs";
+        }
+
+        double min_rate;
+        ros::NodeHandle("~").param("min_rate", min_rate, 0.0);
+        double rate = recorder.rate();
+        ROS_INFO_STREAM("Decoded " << recorder.count() << " messages of " << capture
+                                   << " in " << recorder.seconds() << " s, " << rate
+                                   << " messages/s");
+        EXPECT_GE(rate, min_rate) << "Throughput of " << capture << " too low";
+    }
+} // namespace
+
+TEST(ReplayTest, sbfFile) { checkReplay("rover.sbf"); }
+
+TEST(ReplayTest, pcapFile) { checkReplay("rover.pcap"); }
+
+/**
+ * Decodes rover.sbf repeated throughput/repetitions times, such that the time
+ * between the first and the last message, which excludes the start of the node,
+ * is long enough to be measured. The rate is compared with the one in
+ * throughput.baseline of the build directory, which is recorded if missing and
+ * has to be deleted to record a new one, e.g. after moving to another machine.
+ */
+TEST(ReplayTest, throughput)
+{
+    ros::NodeHandle nh("~");
+    int repetitions;
+    double max_slowdown;
+    nh.param("throughput/repetitions", repetitions, 200);
+    nh.param("throughput/max_slowdown", max_slowdown, 0.2);
+
+    std::string sbf = readFile(std::string(ROSAIC_TEST_DATA) + "/rover.sbf");
+    ASSERT_FALSE(sbf.empty()) << "Cannot read rover.sbf";
+    std::string capture = std::string(ROSAIC_TEST_OUTPUT) + "/throughput.sbf";
+    std::string baseline_file =
+        std::string(ROSAIC_TEST_OUTPUT) + "/throughput.baseline";
+    {
+        std::ofstream out(capture, std::ios::binary | std::ios::trunc);
+        for (int i = 0; i < repetitions; ++i)
+            out << sbf;
+        ASSERT_TRUE(out.good()) << "Cannot write " << capture;
+    }
+
+    rosaic_replay::MessageRecorder recorder(false);
+    replay(capture, recorder);
+    std::remove(capture.c_str());
+    std::size_t messages = rosaic_replay::splitMessages(
+        readFile(std::string(ROSAIC_TEST_DATA) + "/rover.golden")).size();
+    EXPECT_EQ(repetitions * messages, recorder.count()) << "Messages were lost";
+    double rate = recorder.rate();
+    ROS_INFO_STREAM("Decoded " << recorder.count() << " messages in "
+                               << recorder.seconds() << " s, " << rate
+                               << " messages/s");
+
+    double baseline = 0.0;
+    std::ifstream in(baseline_file);
+    if (!(in >> baseline))
+    {
+        std::ofstream(baseline_file) << rate << std::endl;
+        ROS_INFO_STREAM("Recorded the baseline of " << rate << " messages/s in "
+                                                    << baseline_file);
+    }
+    double min_rate;
+    nh.param("min_rate", min_rate, 0.0);
+    EXPECT_GE(rate, min_rate) << "Throughput too low";
+    EXPECT_GE(rate, baseline * (1.0 - max_slowdown))
+        << "Throughput more than " << max_slowdown * 100.0
+        << " % below the baseline of " << baseline << " messages/s";
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    ros::init(argc, argv, "replay_test");
+    return RUN_ALL_TESTS();
+}